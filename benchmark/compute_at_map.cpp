@@ -0,0 +1,119 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <compute_at_map.h>
+#include <csrc/exceptions.h>
+#include <disjoint_set.h>
+#include <fusion.h>
+#include <ir/utils.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+#include <random>
+
+using namespace nvfuser;
+
+// Builds a chain of pointwise ops over 2D tensors with roughly num_ids
+// IterDomains. Every op maps its IterDomains to those of its producers, so
+// the exact and permissive sets grow as long as the chain.
+static std::unique_ptr<Fusion> makeWideFusion(int64_t num_ids) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  auto tv = tv0;
+  for (int64_t i = 0; i < num_ids / 2 - 2; i += 2) {
+    tv = sin(tv);
+    tv = add(tv, tv1);
+  }
+  fusion->addOutput(tv);
+  return fusion;
+}
+
+// Time to build ComputeAtMap, which builds its exact, almost exact,
+// permissive and loop maps from DisjointSets, over fusions with 1k to 50k
+// IterDomains.
+static void NvFuserScheduler_ComputeAtMapBuild(
+    benchmark::State& benchmark_state) {
+  auto fusion = makeWideFusion(benchmark_state.range(0));
+  FusionGuard fg(fusion.get());
+
+  int64_t num_ids = 0;
+  for (auto tv : ir_utils::allTvs(fusion.get())) {
+    num_ids += (int64_t)ir_utils::allIDsOf(tv).size();
+  }
+
+  for (auto _ : benchmark_state) {
+    ComputeAtMap ca_map(fusion.get());
+    benchmark::DoNotOptimize(ca_map);
+  }
+
+  benchmark_state.counters["iter_domains"] = (double)num_ids;
+  benchmark_state.SetComplexityN(num_ids);
+}
+
+BENCHMARK(NvFuserScheduler_ComputeAtMapBuild)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(10000)
+    ->Arg(20000)
+    ->Arg(50000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// Raw DisjointSets cost of merging num_entries entries into a few large sets
+// in random order, then querying and materializing all sets.
+static void NvFuserScheduler_DisjointSetsMapEntries(
+    benchmark::State& benchmark_state) {
+  const auto num_entries = benchmark_state.range(0);
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> dist(0, num_entries - 1);
+  std::vector<std::pair<int64_t, int64_t>> pairs;
+  pairs.reserve(num_entries);
+  for (auto i : c10::irange(num_entries)) {
+    // Entries with the same residue modulo 8 end up in the same set
+    auto j = dist(gen);
+    pairs.emplace_back(i, j - j % 8 + i % 8);
+  }
+
+  for (auto _ : benchmark_state) {
+    DisjointSets<int64_t> sets;
+    for (const auto& [a, b] : pairs) {
+      if (b < num_entries) {
+        sets.mapEntries(a, b);
+      } else {
+        sets.initializeSet(a);
+      }
+    }
+    int64_t num_mapped = 0;
+    for (const auto& [a, b] : pairs) {
+      num_mapped += sets.permissiveAreMapped(a, b);
+    }
+    benchmark::DoNotOptimize(num_mapped);
+    benchmark::DoNotOptimize(sets.disjointSets());
+  }
+
+  benchmark_state.SetComplexityN(num_entries);
+}
+
+BENCHMARK(NvFuserScheduler_DisjointSetsMapEntries)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(10000)
+    ->Arg(20000)
+    ->Arg(50000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
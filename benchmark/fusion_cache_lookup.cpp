@@ -0,0 +1,75 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <python_frontend/fusion_cache.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+
+using namespace nvfuser;
+using namespace nvfuser::python_frontend;
+
+// Measures the lookup of a cached definition in the Python FusionCache trie,
+// which is done record by record every time a FusionDefinition is built. The
+// root has num_definitions children, each leading to a chain of records, and
+// all threads look up definitions concurrently.
+static void NvFuserScheduler_FusionCacheLookup(
+    benchmark::State& benchmark_state) {
+  static FusionCache* fusion_cache = nullptr;
+  static std::vector<std::vector<std::unique_ptr<RecordFunctor>>> definitions;
+  constexpr int64_t kDepth = 16;
+
+  const auto num_definitions = benchmark_state.range(0);
+
+  if (benchmark_state.thread_index() == 0) {
+    FusionCache::reset();
+    fusion_cache = FusionCache::get();
+    definitions.clear();
+    for (auto i : c10::irange(num_definitions)) {
+      auto& records = definitions.emplace_back();
+      for (auto level : c10::irange(kDepth)) {
+        records.emplace_back(new TensorRecord(
+            {State(0, serde::StateType::Tensor)},
+            {level == 0 ? i + 2 : level + 2},
+            {true},
+            DataType::Float));
+      }
+      records.emplace_back(new EndRecord());
+
+      TrieNode* node = fusion_cache->rootTriePtr();
+      for (auto& rec : records) {
+        node = fusion_cache->createChild(node, rec.get());
+      }
+    }
+  }
+
+  // The other threads only read the statics set up by thread 0 once the
+  // benchmark loop has started
+  int64_t def_idx = benchmark_state.thread_index();
+  for (auto _ : benchmark_state) {
+    const auto& records = definitions.at(def_idx++ % num_definitions);
+    TrieNode* node = fusion_cache->rootTriePtr();
+    for (auto& rec : records) {
+      node = fusion_cache->queryChildren(node, rec.get()).value();
+    }
+    benchmark::DoNotOptimize(node);
+  }
+
+  benchmark_state.SetItemsProcessed(benchmark_state.iterations());
+}
+
+BENCHMARK(NvFuserScheduler_FusionCacheLookup)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32)
+    ->UseRealTime()
+    ->Unit(benchmark::kNanosecond);
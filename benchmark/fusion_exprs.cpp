@@ -0,0 +1,71 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/lower2device.h>
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <scheduler/all_schedulers.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// A chain of num_ops pointwise ops over 2D tensors, with a broadcast input
+// mixed in every few ops so that the chain isn't trivially inlined.
+static std::unique_ptr<Fusion> makeChainFusion(int64_t num_ops) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  auto bcast = broadcast(tv1, {true, false});
+  auto tv = tv0;
+  for (auto i : c10::irange(num_ops)) {
+    tv = (i % 4 == 3) ? add(tv, bcast) : sin(tv);
+  }
+  fusion->addOutput(tv);
+  return fusion;
+}
+
+// Host cost of scheduling and lowering a chain of pointwise ops. Reports how
+// many times Fusion::exprs() was queried and how many of those queries had
+// to sort the graph, per compile.
+static void NvFuserScheduler_ExprsTraversalsPerCompile(
+    benchmark::State& benchmark_state) {
+  auto fusion = makeChainFusion(benchmark_state.range(0));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs = {
+      at::randn({128, 1024}, options), at::randn({1024}, options)};
+
+  const auto stats_before = Fusion::exprsStats();
+  for (auto _ : benchmark_state) {
+    Fusion fusion_copy = *fusion;
+    schedulePointwise(&fusion_copy, inputs);
+    GpuLower(&fusion_copy).run();
+  }
+  const auto stats_after = Fusion::exprsStats();
+
+  const auto num_compiles = (double)benchmark_state.iterations();
+  benchmark_state.counters["exprs_queries"] =
+      (double)(stats_after.queries - stats_before.queries) / num_compiles;
+  benchmark_state.counters["traversals"] =
+      (double)(stats_after.traversals - stats_before.traversals) /
+      num_compiles;
+}
+
+BENCHMARK(NvFuserScheduler_ExprsTraversalsPerCompile)
+    ->Arg(16)
+    ->Arg(128)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,142 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+#include <cstdlib>
+#include <new>
+
+using namespace nvfuser;
+
+namespace {
+
+// Heap allocations made by the current thread while counting is enabled
+thread_local bool count_allocations = false;
+thread_local int64_t num_allocations = 0;
+
+} // namespace
+
+// Count every operator new made by the benchmarking thread. The default
+// operator delete releases memory with std::free, which matches the
+// std::malloc below.
+void* operator new(std::size_t size) {
+  if (count_allocations) {
+    ++num_allocations;
+  }
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+// Measures the host overhead of running a fully cached fusion with
+// num_segments segments. Kernel launches are disabled, so the time and the
+// number of heap allocations per run come from argument handling, cache
+// lookups and output allocation only.
+static void NvFuserScheduler_SegmentedHostOverhead(
+    benchmark::State& benchmark_state) {
+  const auto num_segments = benchmark_state.range(0);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion_ptr->addInput(tv0);
+  TensorView* tv = tv0;
+  for (auto i : c10::irange(num_segments)) {
+    tv = add(tv, IrBuilder::create<Val>((double)i));
+    if (i + 1 < num_segments) {
+      tv = segment_set(tv);
+    }
+  }
+  fusion_ptr->addOutput(tv);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> aten_inputs = {at::randn({128, 1024}, options)};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  fec.runFusionWithInputs(aten_inputs);
+  NVF_ERROR(
+      (int64_t)fec.getMostRecentKernelRuntime()->executors().size() ==
+      num_segments);
+  fec.disableKernelLaunch();
+
+  int64_t total_allocations = 0;
+  for (auto _ : benchmark_state) {
+    num_allocations = 0;
+    count_allocations = true;
+    auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+    count_allocations = false;
+    total_allocations += num_allocations;
+  }
+
+  benchmark_state.counters["allocs_per_run"] = benchmark::Counter(
+      (double)total_allocations / (double)benchmark_state.iterations());
+}
+
+// Measures the host cost of FusionExecutor::runFusion for a small pointwise
+// kernel whose ExecutorEntry is cached. The kernel is not launched, so this
+// isolates output allocation and kernel parameter packing.
+static void NvFuserScheduler_ExecutorHostLaunch(
+    benchmark::State& benchmark_state) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  auto s2 = IrBuilder::create<Val>(DataType::Double);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(s2);
+  auto tv3 = add(mul(tv0, s2), tv1);
+  fusion.addOutput(tv3);
+
+  tv3->merge(0);
+  tv3->split(0, 128);
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(1)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> aten_inputs = {
+      at::randn({64, 64}, options), at::randn({64, 64}, options), 2.0};
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, aten_inputs);
+  fe.setExecuteKernelFlag(false);
+
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+
+  for (auto _ : benchmark_state) {
+    // runFusion appends outputs and intermediates to the arguments, so give
+    // it a fresh view of the inputs each time
+    KernelArgumentHolder run_args;
+    run_args.setCacheId(0);
+    for (auto i : c10::irange(args.size())) {
+      run_args.pushView(args[i]);
+    }
+    auto cg_outputs = fe.runFusion(run_args);
+  }
+}
+
+BENCHMARK(NvFuserScheduler_ExecutorHostLaunch)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(NvFuserScheduler_SegmentedHostOverhead)
+    ->Arg(1)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,60 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <kernel_cache.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+
+using namespace nvfuser;
+
+// Measures InputsIdLookup::lookupId on the cache-hit path, which is taken on
+// every FusionExecutorCache::runFusionWithInputs call. All threads share one
+// lookup table, as several Python threads driving one fusion would. Tensors
+// are only inspected for their metadata, so CPU tensors are used.
+static void NvFuserScheduler_InputsIdLookup(
+    benchmark::State& benchmark_state) {
+  static std::unique_ptr<InputsIdLookup> inputs_id_lookup;
+  static std::vector<std::vector<c10::IValue>> input_sets;
+
+  const auto num_shapes = benchmark_state.range(0);
+
+  if (benchmark_state.thread_index() == 0) {
+    inputs_id_lookup = std::make_unique<InputsIdLookup>();
+    input_sets.clear();
+    auto options = at::TensorOptions().dtype(at::kFloat);
+    for (auto i : c10::irange(num_shapes)) {
+      input_sets.push_back(
+          {at::empty({8, 16 + i, 32, 64}, options),
+           at::empty({32, 64}, options),
+           at::empty({64}, options),
+           (int64_t)128,
+           2.0});
+      inputs_id_lookup->lookupId(input_sets.back());
+    }
+  }
+
+  int64_t shape_idx = benchmark_state.thread_index();
+  for (auto _ : benchmark_state) {
+    auto ret = inputs_id_lookup->lookupId(
+        input_sets.at(shape_idx++ % num_shapes), {3, 4});
+    benchmark::DoNotOptimize(ret);
+  }
+
+  benchmark_state.SetItemsProcessed(benchmark_state.iterations());
+}
+
+BENCHMARK(NvFuserScheduler_InputsIdLookup)
+    ->Arg(1)
+    ->Arg(16)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32)
+    ->UseRealTime()
+    ->Unit(benchmark::kNanosecond);
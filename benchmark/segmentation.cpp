@@ -0,0 +1,136 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <fusion.h>
+#include <fusion_segmenter.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <ops/all_ops.h>
+#include <scheduler/all_schedulers.h>
+
+#include <benchmark/benchmark.h>
+
+#include <benchmark/utils.h>
+#include <test/utils.h>
+
+using namespace nvfuser;
+
+// Host time of segmenting timm-style graphs when the input sizes keep
+// changing, as when a FusionExecutorCache can't re-use a kernel runtime. Each
+// iteration segments the same fusion for the next sizes, either from scratch
+// or seeded with the segmentation of the previous sizes.
+
+namespace {
+
+// A stack of vit blocks in the style of benchmark/timm.cpp. Each block is a
+// layer norm, a pointwise MLP stand-in with a residual add, and the
+// reductions of the bias gradients over the batch dimensions, which the
+// segmenter can't fuse with the inner reductions of the layer norm.
+void setupTimmBlocks(Fusion* fusion, int64_t num_blocks) {
+  FusionGuard fg(fusion);
+
+  auto x = makeContigTensor(3, DataType::Half);
+  fusion->addInput(x);
+  auto hidden = castOp(DataType::Float, x);
+
+  auto eps = IrBuilder::create<Val>(1e-5);
+  for (auto block : c10::irange(num_blocks)) {
+    (void)block;
+    auto weight = makeContigTensor(1, DataType::Half);
+    auto bias = makeContigTensor(1, DataType::Half);
+    fusion->addInput(weight);
+    fusion->addInput(bias);
+
+    auto norm = layer_norm(
+        hidden,
+        1,
+        castOp(DataType::Float, weight),
+        castOp(DataType::Float, bias),
+        eps);
+    auto mlp = tanh_gelu(norm.output);
+    hidden = add(hidden, mlp);
+
+    auto bias_grad = sum(mlp, {0, 1});
+    fusion->addOutput(castOp(DataType::Half, bias_grad));
+  }
+  fusion->addOutput(castOp(DataType::Half, hidden));
+}
+
+KernelArgumentHolder makeTimmArgs(
+    int64_t num_blocks,
+    const std::vector<int64_t>& shape) {
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  std::vector<c10::IValue> aten_inputs{at::empty(shape, options)};
+  for (auto block : c10::irange(num_blocks)) {
+    (void)block;
+    aten_inputs.emplace_back(at::empty({shape[2]}, options));
+    aten_inputs.emplace_back(at::empty({shape[2]}, options));
+  }
+  return KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+}
+
+} // namespace
+
+static void NvFuserScheduler_Segmentation_TIMM(
+    benchmark::State& benchmark_state,
+    bool incremental) {
+  const int64_t num_blocks = benchmark_state.range(0);
+  Fusion fusion;
+  setupTimmBlocks(&fusion, num_blocks);
+
+  // Batch sizes and sequence lengths of the vit_base_patch16 family
+  std::vector<KernelArgumentHolder> all_args;
+  for (int64_t batch : {8, 32, 128}) {
+    for (int64_t tokens : {50, 197, 577}) {
+      all_args.emplace_back(makeTimmArgs(num_blocks, {batch, tokens, 768}));
+    }
+  }
+
+  std::unique_ptr<SegmentedFusion> segmented_fusion;
+  int64_t num_groups = 0;
+  int64_t num_seeded_groups = 0;
+  size_t args_idx = 0;
+  for (auto _ : benchmark_state) {
+    benchmark_state.PauseTiming();
+    const auto& args = all_args.at(args_idx++ % all_args.size());
+    auto fusion_copy = std::make_unique<Fusion>(fusion);
+    SchedulerRuntimeInfo runtime_info(fusion_copy.get(), args);
+    const SegmentedFusion* seed =
+        incremental ? segmented_fusion.get() : nullptr;
+    benchmark_state.ResumeTiming();
+
+    auto new_segmented_fusion = SegmentCandidateFinder::segment(
+        std::move(fusion_copy), args, runtime_info, seed);
+
+    benchmark_state.PauseTiming();
+    num_groups += (int64_t)new_segmented_fusion->groups().size();
+    num_seeded_groups += new_segmented_fusion->numSeededGroups();
+    segmented_fusion = std::move(new_segmented_fusion);
+    benchmark_state.ResumeTiming();
+  }
+
+  benchmark_state.counters["groups"] = benchmark::Counter(
+      (double)num_groups, benchmark::Counter::kAvgIterations);
+  benchmark_state.counters["seeded_groups"] = benchmark::Counter(
+      (double)num_seeded_groups, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_Segmentation_TIMM,
+    from_scratch,
+    /*incremental=*/false)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 8}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(
+    NvFuserScheduler_Segmentation_TIMM,
+    incremental,
+    /*incremental=*/true)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 8}})
+    ->Unit(benchmark::kMillisecond);
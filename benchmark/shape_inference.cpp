@@ -13,6 +13,7 @@
 #include <ir/builder.h>
 #include <ir/utils.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <scheduler/all_schedulers.h>
 
 #include <benchmark/benchmark.h>
@@ -213,6 +214,56 @@ static void NvFuserScheduler_LayerNormForward_ShapeInference(
   LayerNormForward_ShapeInferenceBase(benchmark_state, true);
 }
 
+// Measures PrecomputedValues::bindInputs + evaluate on the complete layer
+// norm backward fusion, i.e. the extent and index math evaluated on every
+// kernel launch. typed_value_machine selects between the int64/bool register
+// fast path and the PolymorphicValue fallback.
+void LayerNormBackward_PrecomputedValues_Base(
+    benchmark::State& benchmark_state,
+    bool typed_value_machine) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  std::unique_ptr<FusionExecutorCache> fec;
+  std::vector<c10::IValue> aten_inputs;
+
+  std::vector<int64_t> shape{20, 100, 35, 67};
+  std::vector<int64_t> norm_shape{67};
+
+  getLayerBackwardNormRuntime(
+      std::move(fusion_ptr), fec, aten_inputs, shape, norm_shape);
+
+  KernelArgumentHolder args =
+      KernelArgumentHolder::createKernelArgumentHolder(aten_inputs);
+
+  DisableOptionsGuard og;
+  if (!typed_value_machine) {
+    DisableOptionsGuard::getCurOptions().set(
+        DisableOption::TypedValueMachine);
+  }
+
+  // Evaluator indices can only be assigned once per fusion, so work on a copy
+  // of the complete fusion. The option is read when the value machine is
+  // built.
+  Fusion fusion = *fec->fusion();
+  PrecomputedValues precomputed_values(&fusion);
+
+  for (auto _ : benchmark_state) {
+    precomputed_values.bindInputs(args);
+    precomputed_values.evaluate();
+  }
+}
+
+static void NvFuserScheduler_LayerNormBackward_PrecomputedValues(
+    benchmark::State& benchmark_state) {
+  LayerNormBackward_PrecomputedValues_Base(benchmark_state, true);
+}
+
+static void NvFuserScheduler_LayerNormBackward_PrecomputedValuesGeneric(
+    benchmark::State& benchmark_state) {
+  LayerNormBackward_PrecomputedValues_Base(benchmark_state, false);
+}
+
 BENCHMARK(NvFuserScheduler_LayerNormBackward_ShapeInference)
     ->Unit(benchmark::kMicrosecond);
 BENCHMARK(NvFuserScheduler_LayerNormForward_ShapeInference)
@@ -221,3 +272,7 @@ BENCHMARK(NvFuserScheduler_LayerNormBackward_NoShapeInferenceCachedBaseline)
     ->Unit(benchmark::kMicrosecond);
 BENCHMARK(NvFuserScheduler_LayerNormForward_NoShapeInferenceCachedBaseline)
     ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_LayerNormBackward_PrecomputedValues)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(NvFuserScheduler_LayerNormBackward_PrecomputedValuesGeneric)
+    ->Unit(benchmark::kMicrosecond);
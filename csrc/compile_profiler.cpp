@@ -0,0 +1,284 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <compile_profiler.h>
+#include <exceptions.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace nvfuser {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t heapBytesInUse() {
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const auto info = mallinfo2();
+  return (int64_t)(info.uordblks + info.hblkhd);
+#else
+  return 0;
+#endif
+}
+
+int64_t currentThreadId() {
+  static std::atomic<int64_t> next_id{0};
+  thread_local int64_t id = next_id++;
+  return id;
+}
+
+// Innermost recorded event that is running on this thread, used as the parent
+// of the next event. It is only valid in the recording it was set in.
+thread_local int64_t current_session = -1;
+thread_local int64_t current_event = -1;
+
+struct Recording {
+  std::mutex mutex;
+  int64_t session = -1;
+  Clock::time_point start;
+  std::vector<CompileEvent> events;
+  // Values when each event started, to compute the differences at its end
+  std::vector<int64_t> start_statements;
+  std::vector<int64_t> start_heap_bytes;
+  std::vector<bool> running;
+
+  double sinceStartUs(Clock::time_point time) const {
+    return std::chrono::duration<double, std::micro>(time - start).count();
+  }
+};
+
+// Never destroyed, since events may end during static destruction
+Recording& recording() {
+  static auto* recording = new Recording();
+  return *recording;
+}
+
+std::string escapeJson(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+} // namespace
+
+thread_local int64_t CompileProfiler::num_statements_ = 0;
+
+bool CompileProfiler::start() {
+  auto& rec = recording();
+  std::lock_guard<std::mutex> lock(rec.mutex);
+  if (recording_) {
+    return false;
+  }
+  rec.session++;
+  rec.start = Clock::now();
+  rec.events.clear();
+  rec.start_statements.clear();
+  rec.start_heap_bytes.clear();
+  rec.running.clear();
+  recording_ = true;
+  return true;
+}
+
+CompileProfile CompileProfiler::stop() {
+  const auto now = Clock::now();
+  const int64_t heap_bytes = heapBytesInUse();
+
+  auto& rec = recording();
+  std::lock_guard<std::mutex> lock(rec.mutex);
+  CompileProfile profile;
+  if (!recording_) {
+    return profile;
+  }
+  recording_ = false;
+  for (auto i : c10::irange(rec.events.size())) {
+    if (!rec.running[i]) {
+      continue;
+    }
+    // The IR statements created by other threads aren't known
+    auto& event = rec.events[i];
+    event.duration_us = rec.sinceStartUs(now) - event.start_us;
+    event.heap_bytes = heap_bytes - rec.start_heap_bytes[i];
+    if (event.thread == currentThreadId()) {
+      event.statements = num_statements_ - rec.start_statements[i];
+    }
+  }
+  profile.events = std::move(rec.events);
+  profile.wall_time_ms = rec.sinceStartUs(now) / 1000.0;
+  rec.events.clear();
+  rec.start_statements.clear();
+  rec.start_heap_bytes.clear();
+  rec.running.clear();
+  return profile;
+}
+
+CompileProfiler::EventHandle CompileProfiler::beginEvent(const char* name) {
+  const int64_t heap_bytes = heapBytesInUse();
+  const auto now = Clock::now();
+
+  auto& rec = recording();
+  std::lock_guard<std::mutex> lock(rec.mutex);
+  if (!recording_) {
+    return EventHandle();
+  }
+  EventHandle handle{rec.session, (int64_t)rec.events.size()};
+
+  CompileEvent event;
+  event.name = name == nullptr ? "" : name;
+  event.parent = current_session == rec.session ? current_event : -1;
+  event.thread = currentThreadId();
+  event.start_us = rec.sinceStartUs(now);
+  rec.events.push_back(std::move(event));
+  rec.start_statements.push_back(num_statements_);
+  rec.start_heap_bytes.push_back(heap_bytes);
+  rec.running.push_back(true);
+
+  current_session = rec.session;
+  current_event = handle.index;
+  return handle;
+}
+
+void CompileProfiler::recordEnd(const EventHandle& handle) {
+  const auto now = Clock::now();
+  const int64_t heap_bytes = heapBytesInUse();
+
+  auto& rec = recording();
+  std::lock_guard<std::mutex> lock(rec.mutex);
+  // The recording the event started in was stopped
+  if (handle.session != rec.session || !recording_) {
+    current_event = -1;
+    return;
+  }
+  auto& event = rec.events.at(handle.index);
+  event.duration_us = rec.sinceStartUs(now) - event.start_us;
+  event.statements = num_statements_ - rec.start_statements[handle.index];
+  event.heap_bytes = heap_bytes - rec.start_heap_bytes[handle.index];
+  rec.running[handle.index] = false;
+  current_event = event.parent;
+}
+
+CompileProfile CompileProfileGuard::stop() {
+  NVF_ERROR(recording_, "This guard is not recording a compile profile");
+  recording_ = false;
+  return CompileProfiler::stop();
+}
+
+std::vector<CompileProfile::Entry> CompileProfile::summary() const {
+  std::vector<double> nested_us(events.size(), 0.0);
+  for (const auto& event : events) {
+    if (event.parent >= 0) {
+      nested_us.at(event.parent) += event.duration_us;
+    }
+  }
+
+  std::vector<Entry> entries;
+  std::unordered_map<std::string, size_t> entry_of_name;
+  for (auto i : c10::irange(events.size())) {
+    const auto& event = events[i];
+    auto it = entry_of_name.find(event.name);
+    if (it == entry_of_name.end()) {
+      it = entry_of_name.emplace(event.name, entries.size()).first;
+      entries.emplace_back();
+      entries.back().name = event.name;
+    }
+    auto& entry = entries.at(it->second);
+    const double ms = event.duration_us / 1000.0;
+    entry.calls++;
+    entry.self_ms += (event.duration_us - nested_us[i]) / 1000.0;
+    entry.max_ms = std::max(entry.max_ms, ms);
+
+    // Inclusive values of recursive events would otherwise be counted twice
+    bool nested_in_same_name = false;
+    for (auto parent = event.parent; parent >= 0;
+         parent = events.at(parent).parent) {
+      if (events.at(parent).name == event.name) {
+        nested_in_same_name = true;
+        break;
+      }
+    }
+    if (!nested_in_same_name) {
+      entry.total_ms += ms;
+      entry.statements += event.statements;
+      entry.heap_bytes += event.heap_bytes;
+    }
+  }
+
+  std::stable_sort(
+      entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.total_ms > b.total_ms;
+      });
+  return entries;
+}
+
+std::string CompileProfile::toChromeTrace() const {
+  std::stringstream ss;
+  ss << "{\n\"traceEvents\": [\n";
+  for (auto i : c10::irange(events.size())) {
+    const auto& event = events[i];
+    ss << "{ \"name\": \"" << escapeJson(event.name)
+       << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << event.thread
+       << ", \"ts\": " << std::fixed << std::setprecision(3) << event.start_us
+       << ", \"dur\": " << event.duration_us
+       << ", \"args\": { \"statements\": " << event.statements
+       << ", \"heap_bytes\": " << event.heap_bytes << " } }"
+       << (i + 1 < events.size() ? "," : "") << "\n";
+  }
+  ss << "],\n\"displayTimeUnit\": \"ms\"\n}\n";
+  return ss.str();
+}
+
+void CompileProfile::writeChromeTrace(const std::string& path) const {
+  std::ofstream file(path);
+  NVF_CHECK(file.good(), "Can't open compile profile file ", path);
+  file << toChromeTrace();
+}
+
+std::ostream& operator<<(std::ostream& os, const CompileProfile& profile) {
+  const auto entries = profile.summary();
+
+  size_t name_width = 4;
+  for (const auto& entry : entries) {
+    name_width = std::max(name_width, entry.name.size());
+  }
+
+  os << "Compile profile: " << std::fixed << std::setprecision(3)
+     << profile.wall_time_ms << " ms wall time, " << profile.events.size()
+     << " events\n";
+  os << std::left << std::setw((int)name_width) << "Name" << std::right
+     << std::setw(8) << "Calls" << std::setw(12) << "Total (ms)"
+     << std::setw(12) << "Self (ms)" << std::setw(12) << "Max (ms)"
+     << std::setw(12) << "IR stmts" << std::setw(14) << "Heap (KiB)"
+     << "\n";
+  for (const auto& entry : entries) {
+    os << std::left << std::setw((int)name_width) << entry.name << std::right
+       << std::setw(8) << entry.calls << std::setw(12) << entry.total_ms
+       << std::setw(12) << entry.self_ms << std::setw(12) << entry.max_ms
+       << std::setw(12) << entry.statements << std::setw(14)
+       << (double)entry.heap_bytes / 1024.0 << "\n";
+  }
+  return os;
+}
+
+} // namespace nvfuser
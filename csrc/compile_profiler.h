@@ -0,0 +1,148 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+//! \struct CompileEvent
+//! \brief A scope marked with FUSER_PERF_SCOPE that ran while the
+//! CompileProfiler was recording
+struct CompileEvent {
+  std::string name;
+  //! Index in CompileProfile::events of the innermost recorded event of the
+  //! same thread that encloses this one, or -1 if there is none
+  int64_t parent = -1;
+  //! Sequential id of the thread the event ran on
+  int64_t thread = 0;
+  //! Start time relative to the start of the recording
+  double start_us = 0.0;
+  double duration_us = 0.0;
+  //! Number of IR statements created by the thread during the event,
+  //! including nested events
+  int64_t statements = 0;
+  //! Change of the heap memory in use by the whole process during the event.
+  //! It includes the allocations of other threads, and is always 0 where the
+  //! C library can't report it.
+  int64_t heap_bytes = 0;
+};
+
+//! \struct CompileProfile
+//! \brief Hierarchical host time profile recorded by the CompileProfiler
+struct CompileProfile {
+  //! Events aggregated by name in the summary table
+  struct Entry {
+    std::string name;
+    int64_t calls = 0;
+    //! Time including nested events. An event nested in an event of the same
+    //! name is not counted again.
+    double total_ms = 0.0;
+    //! Time excluding nested events of the same thread
+    double self_ms = 0.0;
+    double max_ms = 0.0;
+    int64_t statements = 0;
+    int64_t heap_bytes = 0;
+  };
+
+  //! Events in the order they started. Events still running when the
+  //! recording stopped end at that time.
+  std::vector<CompileEvent> events;
+  double wall_time_ms = 0.0;
+
+  //! Returns the events aggregated by name, sorted by decreasing total time
+  std::vector<Entry> summary() const;
+
+  //! Returns the events in the Chrome Tracing (Catapult) format, like the
+  //! trace written with NVFUSER_TRACE
+  std::string toChromeTrace() const;
+  void writeChromeTrace(const std::string& path) const;
+};
+
+//! Prints the summary table
+std::ostream& operator<<(std::ostream&, const CompileProfile&);
+
+//! \class CompileProfiler
+//! \brief Records every FUSER_PERF_SCOPE of every thread, with its nesting,
+//! wall time, IR statements created and heap usage, to find the passes that
+//! dominate host compile time.
+//!
+//! It records while a CompileProfileGuard is alive. This is done by
+//! FusionExecutorCache::runFusionWithInputs when the compile_profile option
+//! is enabled, and by FusionDefinition::execute with
+//! capture_compile_profile=True. Only one profile is recorded at a time.
+class CompileProfiler {
+ public:
+  struct EventHandle {
+    int64_t session = -1;
+    int64_t index = -1;
+  };
+
+  static bool isRecording() {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  //! Starts recording. Returns false and does nothing if already recording.
+  static bool start();
+  //! Stops recording and returns what was recorded
+  static CompileProfile stop();
+
+  //! Used by inst::TraceScope
+  static EventHandle beginEvent(const char* name);
+  static void endEvent(const EventHandle& handle) {
+    if (handle.index >= 0) {
+      recordEnd(handle);
+    }
+  }
+
+  //! Called by IrContainer for each statement registered
+  static void countStatement() {
+    num_statements_++;
+  }
+
+ private:
+  static void recordEnd(const EventHandle& handle);
+
+ private:
+  inline static std::atomic<bool> recording_{false};
+  static thread_local int64_t num_statements_;
+};
+
+//! \class CompileProfileGuard
+//! \brief Records a CompileProfile during its lifetime, unless one is
+//! already being recorded
+class CompileProfileGuard {
+ public:
+  CompileProfileGuard() : recording_(CompileProfiler::start()) {}
+  ~CompileProfileGuard() {
+    if (recording_) {
+      CompileProfiler::stop();
+    }
+  }
+
+  CompileProfileGuard(const CompileProfileGuard&) = delete;
+  CompileProfileGuard& operator=(const CompileProfileGuard&) = delete;
+
+  //! Whether this guard is the one recording
+  bool isRecording() const {
+    return recording_;
+  }
+
+  //! Stops recording early and returns the profile. Only valid if this
+  //! guard is the one recording.
+  CompileProfile stop();
+
+ private:
+  bool recording_ = false;
+};
+
+} // namespace nvfuser
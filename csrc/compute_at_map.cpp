@@ -267,15 +267,15 @@ std::optional<std::pair<IterDomain*, IterDomain*>> detectMappablePair(
         continue;
       }
       if (mode == IdMappingMode::EXACT) {
-        if (id_graph.exactNodes().disjointSetMap().at(id1)->has(id2)) {
+        if (id_graph.exactNodes().strictAreMapped(id1, id2)) {
           return std::make_pair(id1, id2);
         }
       } else if (mode == IdMappingMode::PERMISSIVE) {
-        if (id_graph.permissiveNodes().disjointSetMap().at(id1)->has(id2)) {
+        if (id_graph.permissiveNodes().strictAreMapped(id1, id2)) {
           return std::make_pair(id1, id2);
         }
       } else if (mode == IdMappingMode::LOOP) {
-        if (id_graph.loopNodes().disjointSetMap().at(id1)->has(id2)) {
+        if (id_graph.loopNodes().strictAreMapped(id1, id2)) {
           return std::make_pair(id1, id2);
         }
       } else {
@@ -1484,7 +1484,7 @@ const std::shared_ptr<VectorOfUniqueEntries<IterDomain*>>& ComputeAtMap::
       idExistsInMap(id),
       id->toString(),
       " has not been processed in this Compute At Map, yet the disjoint set for it was requested.");
-  return getIdSets(mode).disjointSetMap().at(id);
+  return getIdSets(mode).disjointSetOf(id);
 }
 
 const DisjointSets<IterDomain*>& ComputeAtMap::getIdSets(
@@ -1507,8 +1507,7 @@ const DisjointSets<IterDomain*>& ComputeAtMap::getIdSets(
 }
 
 bool ComputeAtMap::idExistsInMap(IterDomain* id) const {
-  return getIdSets(IdMappingMode::EXACT).disjointSetMap().find(id) !=
-      getIdSets(IdMappingMode::EXACT).disjointSetMap().end();
+  return getIdSets(IdMappingMode::EXACT).mappingExists(id);
 }
 
 VectorOfUniqueEntries<std::shared_ptr<VectorOfUniqueEntries<IterDomain*>>>
@@ -1669,6 +1668,19 @@ ComputeAtMap::getAllDisjointSetConsumers(
   return visited;
 }
 
+void IterDomainGraph::prepareConcurrentReads() const {
+  for (const auto* nodes :
+       {&permissive_nodes_,
+        &exact_nodes_,
+        &almost_exact_nodes_,
+        &loop_nodes_,
+        &permissive_resize_nodes_,
+        &innermost_nodes_,
+        &sibling_sets_}) {
+    nodes->prepareConcurrentReads();
+  }
+}
+
 void IterDomainGraph::updateComputeWith(TensorView* compute_with_tv) {
   NVF_ERROR(
       compute_with_tv->hasResolvedComputeWith(),
@@ -1688,7 +1700,7 @@ void IterDomainGraph::updateComputeWith(TensorView* compute_with_tv) {
         consumer_tv->getLeafDomain().begin(),
         consumer_tv->getLeafDomain().end(),
         [&](auto consumer_id) {
-          return permissiveNodes().disjointSetMap().at(id)->has(consumer_id);
+          return permissiveNodes().strictAreMapped(id, consumer_id);
         });
     NVF_ERROR(
         it != consumer_tv->getLeafDomain().end(),
@@ -137,6 +137,10 @@ class IterDomainGraph {
   // Update the LOOP nodes with resolved computeWith
   void updateComputeWith(TensorView* compute_with_tv);
 
+  // Prepares all the disjoint sets of the graph for concurrent reads. See
+  // DisjointSets::prepareConcurrentReads.
+  void prepareConcurrentReads() const;
+
  private:
   void build(Fusion* fusion);
 
@@ -293,6 +297,12 @@ class ComputeAtMap {
   // Update the LOOP map with resolved computeWith
   void updateComputeWith(TensorView* compute_with_tv);
 
+  //! Makes the const queries of this map safe to call from multiple threads
+  //! until the map is modified again
+  void prepareConcurrentReads() const {
+    id_graph_.prepareConcurrentReads();
+  }
+
   // Traverses through definitions of exact maps (unique_exact_definitions_) to
   // all input ID's from provided exact_sets. Returns all the exact map concrete
   // IDs of all the exact sets that on the path to and including the inputs
@@ -0,0 +1,405 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_descriptor.h>
+#include <utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAMacros.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+using IntegerField = int64_t TargetDeviceDescriptor::*;
+
+//! All integer fields of TargetDeviceDescriptor with their JSON keys
+const std::array<std::pair<const char*, IntegerField>, 15> kIntegerFields = {{
+    {"major", &TargetDeviceDescriptor::major},
+    {"minor", &TargetDeviceDescriptor::minor},
+    {"multi_processor_count", &TargetDeviceDescriptor::multi_processor_count},
+    {"warp_size", &TargetDeviceDescriptor::warp_size},
+    {"max_threads_per_block", &TargetDeviceDescriptor::max_threads_per_block},
+    {"max_threads_per_multi_processor",
+     &TargetDeviceDescriptor::max_threads_per_multi_processor},
+    {"max_blocks_per_multi_processor",
+     &TargetDeviceDescriptor::max_blocks_per_multi_processor},
+    {"regs_per_block", &TargetDeviceDescriptor::regs_per_block},
+    {"regs_per_multiprocessor",
+     &TargetDeviceDescriptor::regs_per_multiprocessor},
+    {"shared_mem_per_block", &TargetDeviceDescriptor::shared_mem_per_block},
+    {"shared_mem_per_block_optin",
+     &TargetDeviceDescriptor::shared_mem_per_block_optin},
+    {"shared_mem_per_multiprocessor",
+     &TargetDeviceDescriptor::shared_mem_per_multiprocessor},
+    {"reserved_shared_mem_per_block",
+     &TargetDeviceDescriptor::reserved_shared_mem_per_block},
+    {"l2_cache_size", &TargetDeviceDescriptor::l2_cache_size},
+    {"clock_rate", &TargetDeviceDescriptor::clock_rate},
+}};
+
+//! Builtin profiles, keyed by lower case name
+const std::unordered_map<std::string, const char*>& builtinProfiles() {
+  static const std::unordered_map<std::string, const char*> profiles = {
+      {"v100",
+       R"({"name": "Tesla V100-SXM2-32GB", "major": 7, "minor": 0,
+           "multi_processor_count": 80, "warp_size": 32,
+           "max_threads_per_block": 1024,
+           "max_threads_per_multi_processor": 2048,
+           "max_blocks_per_multi_processor": 32,
+           "regs_per_block": 65536, "regs_per_multiprocessor": 65536,
+           "shared_mem_per_block": 49152,
+           "shared_mem_per_block_optin": 98304,
+           "shared_mem_per_multiprocessor": 98304,
+           "reserved_shared_mem_per_block": 0,
+           "l2_cache_size": 6291456, "clock_rate": 1530000})"},
+      {"t4",
+       R"({"name": "Tesla T4", "major": 7, "minor": 5,
+           "multi_processor_count": 40, "warp_size": 32,
+           "max_threads_per_block": 1024,
+           "max_threads_per_multi_processor": 1024,
+           "max_blocks_per_multi_processor": 16,
+           "regs_per_block": 65536, "regs_per_multiprocessor": 65536,
+           "shared_mem_per_block": 49152,
+           "shared_mem_per_block_optin": 65536,
+           "shared_mem_per_multiprocessor": 65536,
+           "reserved_shared_mem_per_block": 0,
+           "l2_cache_size": 4194304, "clock_rate": 1590000})"},
+      {"a100",
+       R"({"name": "NVIDIA A100-SXM4-80GB", "major": 8, "minor": 0,
+           "multi_processor_count": 108, "warp_size": 32,
+           "max_threads_per_block": 1024,
+           "max_threads_per_multi_processor": 2048,
+           "max_blocks_per_multi_processor": 32,
+           "regs_per_block": 65536, "regs_per_multiprocessor": 65536,
+           "shared_mem_per_block": 49152,
+           "shared_mem_per_block_optin": 166912,
+           "shared_mem_per_multiprocessor": 167936,
+           "reserved_shared_mem_per_block": 1024,
+           "l2_cache_size": 41943040, "clock_rate": 1410000})"},
+      {"h100",
+       R"({"name": "NVIDIA H100 80GB HBM3", "major": 9, "minor": 0,
+           "multi_processor_count": 132, "warp_size": 32,
+           "max_threads_per_block": 1024,
+           "max_threads_per_multi_processor": 2048,
+           "max_blocks_per_multi_processor": 32,
+           "regs_per_block": 65536, "regs_per_multiprocessor": 65536,
+           "shared_mem_per_block": 49152,
+           "shared_mem_per_block_optin": 232448,
+           "shared_mem_per_multiprocessor": 233472,
+           "reserved_shared_mem_per_block": 1024,
+           "l2_cache_size": 52428800, "clock_rate": 1980000})"},
+  };
+  return profiles;
+}
+
+//! Parser for the subset of JSON used by profiles: a single flat object
+//! whose values are strings, integers or booleans.
+class ProfileParser {
+ public:
+  explicit ProfileParser(const std::string& json) : json_(json) {}
+
+  //! Returns the members of the object. String values are unquoted,
+  //! booleans are returned as "0" or "1".
+  std::vector<std::pair<std::string, std::string>> parse() {
+    std::vector<std::pair<std::string, std::string>> members;
+    expect('{');
+    if (peek() == '}') {
+      ++pos_;
+    } else {
+      while (true) {
+        auto key = parseString();
+        expect(':');
+        members.emplace_back(std::move(key), parseValue());
+        if (peek() == ',') {
+          ++pos_;
+          continue;
+        }
+        expect('}');
+        break;
+      }
+    }
+    NVF_CHECK(
+        peek() == '\0',
+        "Unexpected trailing characters in device profile at offset ",
+        pos_);
+    return members;
+  }
+
+ private:
+  //! Returns the next non-whitespace character, or '\0' at the end
+  char peek() {
+    while (pos_ < json_.size() &&
+           std::isspace(static_cast<unsigned char>(json_[pos_]))) {
+      ++pos_;
+    }
+    return pos_ < json_.size() ? json_[pos_] : '\0';
+  }
+
+  void expect(char c) {
+    NVF_CHECK(
+        peek() == c,
+        "Malformed device profile: expected '",
+        c,
+        "' at offset ",
+        pos_);
+    ++pos_;
+  }
+
+  std::string parseString() {
+    expect('"');
+    std::string str;
+    while (pos_ < json_.size() && json_[pos_] != '"') {
+      if (json_[pos_] == '\\') {
+        ++pos_;
+        NVF_CHECK(
+            pos_ < json_.size(), "Unterminated string in device profile");
+      }
+      str.push_back(json_[pos_++]);
+    }
+    NVF_CHECK(pos_ < json_.size(), "Unterminated string in device profile");
+    ++pos_;
+    return str;
+  }
+
+  std::string parseValue() {
+    const char c = peek();
+    if (c == '"') {
+      return parseString();
+    }
+    for (const auto& [literal, value] :
+         {std::make_pair("true", "1"), std::make_pair("false", "0")}) {
+      if (json_.compare(pos_, std::strlen(literal), literal) == 0) {
+        pos_ += std::strlen(literal);
+        return value;
+      }
+    }
+    const auto begin = pos_;
+    if (c == '-') {
+      ++pos_;
+    }
+    while (pos_ < json_.size() &&
+           std::isdigit(static_cast<unsigned char>(json_[pos_]))) {
+      ++pos_;
+    }
+    NVF_CHECK(
+        pos_ > begin && json_[pos_ - 1] != '-',
+        "Malformed device profile: expected a string, an integer or a boolean "
+        "at offset ",
+        begin);
+    return json_.substr(begin, pos_ - begin);
+  }
+
+  const std::string& json_;
+  size_t pos_ = 0;
+};
+
+// Set by TargetDeviceGuard. Only accessed with std::atomic_load/store.
+std::shared_ptr<const TargetDeviceDescriptor> target_override;
+// Whether target_override is set. The atomic accesses of a shared_ptr take a
+// lock, so getTargetDevice only does them when a guard is active.
+std::atomic<bool> has_target_override{false};
+
+//! The target given by NVFUSER_TARGET_DEVICE, if any
+const std::shared_ptr<const TargetDeviceDescriptor>& environmentTarget() {
+  static const std::shared_ptr<const TargetDeviceDescriptor> target =
+      []() -> std::shared_ptr<const TargetDeviceDescriptor> {
+    const char* env = getNvFuserEnv("TARGET_DEVICE");
+    if (env == nullptr || env[0] == '\0') {
+      return nullptr;
+    }
+    if (auto builtin = TargetDeviceDescriptor::builtin(env)) {
+      return builtin;
+    }
+    return std::make_shared<const TargetDeviceDescriptor>(
+        TargetDeviceDescriptor::fromFile(env));
+  }();
+  return target;
+}
+
+//! The descriptors of the physical devices, built once per device
+std::shared_ptr<const TargetDeviceDescriptor> physicalDevice(int device) {
+  static std::array<std::once_flag, C10_COMPILE_TIME_MAX_GPUS> flags;
+  static std::array<
+      std::shared_ptr<const TargetDeviceDescriptor>,
+      C10_COMPILE_TIME_MAX_GPUS>
+      devices;
+  NVF_ERROR(
+      device >= 0 && device < C10_COMPILE_TIME_MAX_GPUS,
+      "Invalid device index: ",
+      device);
+  std::call_once(flags.at(device), [device]() {
+    devices.at(device) = std::make_shared<const TargetDeviceDescriptor>(
+        TargetDeviceDescriptor::fromDeviceProperties(
+            *at::cuda::getDeviceProperties(device)));
+  });
+  return devices.at(device);
+}
+
+} // namespace
+
+TargetDeviceDescriptor TargetDeviceDescriptor::fromDeviceProperties(
+    const cudaDeviceProp& prop) {
+  TargetDeviceDescriptor target;
+  target.name = prop.name;
+  target.major = prop.major;
+  target.minor = prop.minor;
+  target.multi_processor_count = prop.multiProcessorCount;
+  target.warp_size = prop.warpSize;
+  target.max_threads_per_block = prop.maxThreadsPerBlock;
+  target.max_threads_per_multi_processor = prop.maxThreadsPerMultiProcessor;
+  target.max_blocks_per_multi_processor = prop.maxBlocksPerMultiProcessor;
+  target.regs_per_block = prop.regsPerBlock;
+  target.regs_per_multiprocessor = prop.regsPerMultiprocessor;
+  target.shared_mem_per_block = (int64_t)prop.sharedMemPerBlock;
+  target.shared_mem_per_block_optin = (int64_t)prop.sharedMemPerBlockOptin;
+  target.shared_mem_per_multiprocessor =
+      (int64_t)prop.sharedMemPerMultiprocessor;
+  target.reserved_shared_mem_per_block =
+      (int64_t)prop.reservedSharedMemPerBlock;
+  target.l2_cache_size = prop.l2CacheSize;
+  target.clock_rate = prop.clockRate;
+  return target;
+}
+
+TargetDeviceDescriptor TargetDeviceDescriptor::fromJson(
+    const std::string& json) {
+  TargetDeviceDescriptor target;
+  for (const auto& [key, value] : ProfileParser(json).parse()) {
+    if (key == "name") {
+      target.name = value;
+      continue;
+    }
+    auto it = std::find_if(
+        kIntegerFields.begin(), kIntegerFields.end(), [&](const auto& field) {
+          return key == field.first;
+        });
+    NVF_CHECK(
+        it != kIntegerFields.end(), "Unknown key in device profile: ", key);
+    try {
+      target.*(it->second) = std::stoll(value);
+    } catch (const std::exception&) {
+      NVF_CHECK(false, "Expected an integer for ", key, ", got: ", value);
+    }
+  }
+  return target;
+}
+
+TargetDeviceDescriptor TargetDeviceDescriptor::fromFile(
+    const std::string& path) {
+  std::ifstream file(path);
+  NVF_CHECK(file.good(), "Could not open device profile: ", path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return fromJson(ss.str());
+}
+
+std::unique_ptr<TargetDeviceDescriptor> TargetDeviceDescriptor::builtin(
+    const std::string& name) {
+  std::string lower_name = name;
+  std::transform(
+      lower_name.begin(), lower_name.end(), lower_name.begin(), [](char c) {
+        return (char)std::tolower(static_cast<unsigned char>(c));
+      });
+  const auto& profiles = builtinProfiles();
+  auto it = profiles.find(lower_name);
+  if (it == profiles.end()) {
+    return nullptr;
+  }
+  return std::make_unique<TargetDeviceDescriptor>(fromJson(it->second));
+}
+
+std::string TargetDeviceDescriptor::toJson() const {
+  std::stringstream ss;
+  ss << "{\n  \"name\": \"";
+  for (char c : name) {
+    if (c == '"' || c == '\\') {
+      ss << '\\';
+    }
+    ss << c;
+  }
+  ss << "\"";
+  for (const auto& [key, field] : kIntegerFields) {
+    ss << ",\n  \"" << key << "\": " << this->*field;
+  }
+  ss << "\n}\n";
+  return ss.str();
+}
+
+cudaDeviceProp TargetDeviceDescriptor::toDeviceProperties() const {
+  cudaDeviceProp prop;
+  std::memset(&prop, 0, sizeof(prop));
+  std::strncpy(prop.name, name.c_str(), sizeof(prop.name) - 1);
+  prop.major = (int)major;
+  prop.minor = (int)minor;
+  prop.multiProcessorCount = (int)multi_processor_count;
+  prop.warpSize = (int)warp_size;
+  prop.maxThreadsPerBlock = (int)max_threads_per_block;
+  prop.maxThreadsPerMultiProcessor = (int)max_threads_per_multi_processor;
+  prop.maxBlocksPerMultiProcessor = (int)max_blocks_per_multi_processor;
+  prop.regsPerBlock = (int)regs_per_block;
+  prop.regsPerMultiprocessor = (int)regs_per_multiprocessor;
+  prop.sharedMemPerBlock = (size_t)shared_mem_per_block;
+  prop.sharedMemPerBlockOptin = (size_t)shared_mem_per_block_optin;
+  prop.sharedMemPerMultiprocessor = (size_t)shared_mem_per_multiprocessor;
+  prop.reservedSharedMemPerBlock = (size_t)reserved_shared_mem_per_block;
+  prop.l2CacheSize = (int)l2_cache_size;
+  prop.clockRate = (int)clock_rate;
+  return prop;
+}
+
+bool TargetDeviceDescriptor::operator==(
+    const TargetDeviceDescriptor& other) const {
+  if (name != other.name) {
+    return false;
+  }
+  return std::all_of(
+      kIntegerFields.begin(), kIntegerFields.end(), [&](const auto& field) {
+        return this->*(field.second) == other.*(field.second);
+      });
+}
+
+std::shared_ptr<const TargetDeviceDescriptor> getTargetDevice() {
+  if (has_target_override.load(std::memory_order_acquire)) {
+    if (auto target = std::atomic_load(&target_override)) {
+      return target;
+    }
+  }
+  if (const auto& target = environmentTarget()) {
+    return target;
+  }
+  return physicalDevice(at::cuda::current_device());
+}
+
+TargetDeviceGuard::TargetDeviceGuard(TargetDeviceDescriptor target)
+    : prev_target_(std::atomic_exchange(
+          &target_override,
+          std::shared_ptr<const TargetDeviceDescriptor>(
+              std::make_shared<const TargetDeviceDescriptor>(
+                  std::move(target))))) {
+  has_target_override.store(true, std::memory_order_release);
+}
+
+TargetDeviceGuard::~TargetDeviceGuard() {
+  std::atomic_store(&target_override, prev_target_);
+  has_target_override.store(
+      prev_target_ != nullptr, std::memory_order_release);
+}
+
+} // namespace nvfuser
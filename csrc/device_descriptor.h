@@ -0,0 +1,122 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nvfuser {
+
+//! The properties of a GPU that scheduling, lowering and code generation
+//! depend on. Everything up to CUDA source generation reads device
+//! properties through this descriptor instead of querying the CUDA runtime,
+//! so it can run for a device that is not present, e.g. to pre-generate
+//! kernels or to measure host compile latency on a CPU-only machine.
+//!
+//! The descriptor of the current target is returned by getTargetDevice().
+//! By default that is the current CUDA device. It can be overridden by
+//! setting NVFUSER_TARGET_DEVICE to the name of a builtin profile ("a100",
+//! "h100", ...) or to the path of a JSON profile, or programmatically with
+//! TargetDeviceGuard. A JSON profile is a flat object whose keys are the
+//! field names below, for example:
+//!
+//!   {
+//!     "name": "NVIDIA A100-SXM4-80GB",
+//!     "major": 8,
+//!     "minor": 0,
+//!     "multi_processor_count": 108,
+//!     ...
+//!   }
+//!
+//! Fields missing from a profile keep their default values. toJson()
+//! produces a complete profile, so the profile of a physical device can be
+//! captured with getTargetDevice()->toJson().
+struct TargetDeviceDescriptor {
+  std::string name = "unknown";
+
+  //! Compute capability
+  int64_t major = 0;
+  int64_t minor = 0;
+
+  int64_t multi_processor_count = 0;
+  int64_t warp_size = 32;
+  int64_t max_threads_per_block = 1024;
+  int64_t max_threads_per_multi_processor = 2048;
+  int64_t max_blocks_per_multi_processor = 32;
+
+  //! Number of 32-bit registers
+  int64_t regs_per_block = 65536;
+  int64_t regs_per_multiprocessor = 65536;
+
+  //! Sizes in bytes
+  int64_t shared_mem_per_block = 49152;
+  int64_t shared_mem_per_block_optin = 49152;
+  int64_t shared_mem_per_multiprocessor = 65536;
+  int64_t reserved_shared_mem_per_block = 0;
+  int64_t l2_cache_size = 0;
+
+  //! Clock rate in kHz
+  int64_t clock_rate = 0;
+
+  //! Major and minor packed as in 80 for sm_80
+  int64_t computeCapability() const {
+    return major * 10 + minor;
+  }
+
+  //! Build the descriptor of a physical device
+  static TargetDeviceDescriptor fromDeviceProperties(
+      const cudaDeviceProp& prop);
+
+  //! Parse a JSON profile. See the class comment for the format.
+  static TargetDeviceDescriptor fromJson(const std::string& json);
+
+  //! Read a JSON profile from a file
+  static TargetDeviceDescriptor fromFile(const std::string& path);
+
+  //! Look up a builtin profile by case-insensitive name, e.g. "a100".
+  //! Returns nullptr if there is no such profile.
+  static std::unique_ptr<TargetDeviceDescriptor> builtin(
+      const std::string& name);
+
+  std::string toJson() const;
+
+  //! A cudaDeviceProp with the fields of this descriptor set and all others
+  //! zeroed. Used for the CUDA occupancy calculator.
+  cudaDeviceProp toDeviceProperties() const;
+
+  bool operator==(const TargetDeviceDescriptor& other) const;
+  bool operator!=(const TargetDeviceDescriptor& other) const {
+    return !(*this == other);
+  }
+};
+
+//! Return the descriptor of the device that is currently being compiled
+//! for. See TargetDeviceDescriptor for how the target is selected.
+std::shared_ptr<const TargetDeviceDescriptor> getTargetDevice();
+
+//! Override the target device for the lifetime of this guard. The override
+//! is process-wide, not thread-local, so that it also applies to
+//! compilations done on the thread pool.
+class TargetDeviceGuard {
+ public:
+  explicit TargetDeviceGuard(TargetDeviceDescriptor target);
+  ~TargetDeviceGuard();
+
+  TargetDeviceGuard(const TargetDeviceGuard&) = delete;
+  TargetDeviceGuard& operator=(const TargetDeviceGuard&) = delete;
+
+ private:
+  std::shared_ptr<const TargetDeviceDescriptor> prev_target_;
+};
+
+} // namespace nvfuser
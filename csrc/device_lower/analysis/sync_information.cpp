@@ -438,7 +438,7 @@ SyncMap::SyncMap(Fusion* fusion) {
   const auto& ca_map = GpuLower::current()->caMap();
   const auto& pred_map = GpuLower::current()->threadPredMap();
 
-  auto exprs = StmtSort::getExprs(fusion);
+  auto exprs = fusion->exprs();
 
   // Run through expressions and check for communication across threads/blocks
   // occuring from producer to consumer of the expression
@@ -0,0 +1,251 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/analysis_scheduler.h>
+#include <exceptions.h>
+#include <instrumentation.h>
+
+#include <c10/util/irange.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// State of a batch of consecutive read-only analyses. It's shared with the
+// tasks submitted to the pool, which may start after the batch is over if
+// the calling thread ran their analyses in the meantime. Those tasks find
+// nothing to claim and only touch this state.
+struct ConcurrentBatch {
+  std::mutex mutex;
+  std::condition_variable finished_one;
+
+  std::vector<std::string> names;
+  std::vector<std::function<void()>> runs;
+  std::function<void(const std::function<void()>&)> run_in_worker;
+
+  // Number of unfinished dependencies of each analysis in the batch
+  std::vector<int64_t> pending_deps;
+  // Analyses of the batch that depend on each analysis
+  std::vector<std::vector<size_t>> dependents;
+  std::vector<bool> claimed;
+  std::vector<double> wall_time_ms;
+  std::vector<std::exception_ptr> errors;
+
+  int64_t num_running = 0;
+  int64_t num_finished = 0;
+  bool failed = false;
+
+  // The following must be called with mutex held
+
+  std::optional<size_t> claimReady() {
+    if (failed) {
+      return std::nullopt;
+    }
+    for (auto i : c10::irange(runs.size())) {
+      if (!claimed[i] && pending_deps[i] == 0) {
+        claimed[i] = true;
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
+  bool hasReady() const {
+    if (failed) {
+      return false;
+    }
+    for (auto i : c10::irange(runs.size())) {
+      if (!claimed[i] && pending_deps[i] == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool done() const {
+    return num_finished == (int64_t)runs.size() ||
+        (failed && num_running == 0);
+  }
+
+  // Runs an analysis whose dependencies have finished, if any. Returns false
+  // if there was none. in_worker is false on the calling thread of
+  // runAnalyses, whose thread-local state is already set up.
+  bool runOne(bool in_worker) {
+    size_t i = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto ready = claimReady();
+      if (!ready.has_value()) {
+        return false;
+      }
+      i = ready.value();
+      num_running++;
+    }
+
+    std::exception_ptr error;
+    const auto start = Clock::now();
+    try {
+      FUSER_PERF_SCOPE(names[i].c_str());
+      if (in_worker) {
+        run_in_worker(runs[i]);
+      } else {
+        runs[i]();
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    const double ms = elapsedMs(start);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      wall_time_ms[i] = ms;
+      errors[i] = error;
+      failed = failed || error != nullptr;
+      num_running--;
+      num_finished++;
+      for (auto dependent : dependents[i]) {
+        pending_deps[dependent]--;
+      }
+    }
+    finished_one.notify_all();
+    return true;
+  }
+};
+
+} // namespace
+
+std::vector<LowerAnalysisTime> runAnalyses(
+    const std::vector<LowerAnalysis>& analyses,
+    c10::ThreadPool* pool,
+    const std::function<void(const std::function<void()>&)>& run_in_worker,
+    const std::function<void()>& prepare_concurrent_reads,
+    const std::function<void(const LowerAnalysis&)>& after_each) {
+  std::unordered_map<std::string, size_t> index_of;
+  for (auto i : c10::irange(analyses.size())) {
+    const auto& analysis = analyses[i];
+    for (const auto& dep : analysis.deps) {
+      NVF_ERROR(
+          index_of.count(dep),
+          "Analysis ",
+          analysis.name,
+          " depends on ",
+          dep,
+          ", which is not an analysis added before it");
+    }
+    NVF_ERROR(
+        index_of.emplace(analysis.name, i).second,
+        "Duplicate analysis: ",
+        analysis.name);
+  }
+
+  std::vector<LowerAnalysisTime> times(analyses.size());
+  for (auto i : c10::irange(analyses.size())) {
+    times[i].name = analyses[i].name;
+  }
+
+  size_t begin = 0;
+  while (begin < analyses.size()) {
+    // A barrier, or anything when there's no pool to run concurrently on
+    if (pool == nullptr || !analyses[begin].read_only) {
+      const auto start = Clock::now();
+      {
+        FUSER_PERF_SCOPE(analyses[begin].name.c_str());
+        analyses[begin].run();
+      }
+      times[begin].wall_time_ms = elapsedMs(start);
+      after_each(analyses[begin]);
+      begin++;
+      continue;
+    }
+
+    size_t end = begin + 1;
+    while (end < analyses.size() && analyses[end].read_only) {
+      end++;
+    }
+
+    prepare_concurrent_reads();
+
+    const size_t size = end - begin;
+    auto batch = std::make_shared<ConcurrentBatch>();
+    batch->run_in_worker = run_in_worker;
+    batch->pending_deps.resize(size, 0);
+    batch->dependents.resize(size);
+    batch->claimed.resize(size, false);
+    batch->wall_time_ms.resize(size, 0.0);
+    batch->errors.resize(size);
+    for (auto i : c10::irange(begin, end)) {
+      batch->names.push_back(analyses[i].name);
+      batch->runs.push_back(analyses[i].run);
+      for (const auto& dep : analyses[i].deps) {
+        // Dependencies before the batch have already finished
+        const size_t dep_index = index_of.at(dep);
+        if (dep_index >= begin) {
+          batch->pending_deps[i - begin]++;
+          batch->dependents[dep_index - begin].push_back(i - begin);
+        }
+      }
+    }
+
+    // The calling thread takes one analysis, the pool the others
+    for (size_t i = 1; i < size; i++) {
+      pool->run([batch]() {
+        while (batch->runOne(/*in_worker=*/true)) {
+        }
+      });
+    }
+    while (true) {
+      if (batch->runOne(/*in_worker=*/false)) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(batch->mutex);
+      batch->finished_one.wait(
+          lock, [&batch]() { return batch->done() || batch->hasReady(); });
+      if (batch->done()) {
+        break;
+      }
+    }
+
+    // No analysis of the batch is running anymore. Read the results under
+    // the mutex anyway to synchronize with the threads that ran them.
+    std::vector<std::exception_ptr> errors;
+    {
+      std::lock_guard<std::mutex> lock(batch->mutex);
+      errors = batch->errors;
+      for (auto i : c10::irange(size)) {
+        times[begin + i].wall_time_ms = batch->wall_time_ms[i];
+        times[begin + i].concurrent = true;
+      }
+    }
+    for (const auto& error : errors) {
+      if (error != nullptr) {
+        std::rethrow_exception(error);
+      }
+    }
+    for (auto i : c10::irange(begin, end)) {
+      after_each(analyses[i]);
+    }
+    begin = end;
+  }
+  return times;
+}
+
+} // namespace nvfuser
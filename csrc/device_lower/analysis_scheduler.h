@@ -0,0 +1,65 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <c10/core/thread_pool.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+//! One step of the lowering analysis. See runAnalyses.
+struct LowerAnalysis {
+  std::string name;
+  std::function<void()> run;
+  //! Names of analyses that must finish before this one starts. They must
+  //! have been added before this one.
+  std::vector<std::string> deps;
+  //! The analysis only reads the fusion and the results of other analyses,
+  //! and writes nothing but its own result. Such analyses may run
+  //! concurrently with each other.
+  bool read_only = false;
+};
+
+//! Wall time taken by an analysis
+struct LowerAnalysisTime {
+  std::string name;
+  double wall_time_ms = 0.0;
+  //! Whether the analysis ran concurrently with others
+  bool concurrent = false;
+};
+
+//! Runs analyses in the order they are given, except that consecutive
+//! read-only analyses run concurrently on pool as far as their dependencies
+//! allow. An analysis that is not read-only is a barrier: it runs alone on
+//! the calling thread once all the analyses given before it have finished.
+//! With a null pool, everything runs on the calling thread in order.
+//!
+//! The calling thread runs pending analyses itself while it waits, so this
+//! can't deadlock when called from a task of the same pool.
+//!
+//! run_in_worker is called on the thread running a read-only analysis with a
+//! function that runs the analysis. It sets up the thread-local state the
+//! analysis expects. prepare_concurrent_reads is called on the calling thread
+//! before read-only analyses start. after_each is called on the calling
+//! thread for every analysis, in order, once it has finished.
+//!
+//! If an analysis throws, no further analysis is started and the error of
+//! the first analysis in order that failed is rethrown.
+//!
+//! Returns the wall time of each analysis in the given order.
+std::vector<LowerAnalysisTime> runAnalyses(
+    const std::vector<LowerAnalysis>& analyses,
+    c10::ThreadPool* pool,
+    const std::function<void(const std::function<void()>&)>& run_in_worker,
+    const std::function<void()>& prepare_concurrent_reads,
+    const std::function<void(const LowerAnalysis&)>& after_each);
+
+} // namespace nvfuser
@@ -10,6 +10,7 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <debug.h>
 #include <device_lower/analysis/divisible_split.h>
+#include <device_lower/analysis_scheduler.h>
 #include <device_lower/analysis/shift.h>
 #include <device_lower/pass/alias_memory.h>
 #include <device_lower/pass/allocation.h>
@@ -38,6 +39,7 @@
 #include <instrumentation.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
+#include <utils.h>
 
 #include <list>
 #include <unordered_map>
@@ -147,7 +149,7 @@ class KIRCleaner : public OptOutDispatch {
 void GpuLower::collectPaddedParallelDims() {
   bool can_be_single_warp = true;
 
-  auto warp_size = at::cuda::warp_size();
+  auto warp_size = targetDevice().warp_size;
 
   auto used_vals = fusion_->usedMathVals();
   for (auto tv : ir_utils::filterByType<TensorView>(used_vals)) {
@@ -256,7 +258,10 @@ void dumpExprsIfEnabled(
   }
 }
 
-GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
+GpuLower::GpuLower(
+    Fusion* fusion,
+    const CompileParams& cparams,
+    std::shared_ptr<const TargetDeviceDescriptor> target_device)
     : passes_(
           // Passes will be executed in the order they are added here
           // Each pass is a pair of (name, function), where the name will be
@@ -282,7 +287,10 @@ GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
            {"KIRCleaner", KIRCleaner::cleanUp},
            {"instrumentKernel", instrumentKernel},
            {"lowerToInlinePtx", lowerToInlinePtx}}),
-      cparams_(cparams) {
+      cparams_(cparams),
+      target_device_(
+          target_device != nullptr ? std::move(target_device)
+                                   : getTargetDevice()) {
   analysis(fusion);
 }
 
@@ -299,6 +307,7 @@ struct LowerGuard {
 } // namespace
 
 kir::Kernel* GpuLower::run() {
+  FUSER_PERF_SCOPE("GpuLower::run");
   FusionGuard fg(fusion_);
   LowerGuard lower_guard(this);
   // Reorder expressions for loop-nest generation respecting computeAt
@@ -316,6 +325,7 @@ kir::Kernel* GpuLower::run() {
   assignRNGOffset(fusion_);
 
   for (auto [name, pass] : passes()) {
+    FUSER_PERF_SCOPE(name.c_str());
     exprs_lowered = pass(exprs_lowered);
     dumpExprsIfEnabled(exprs_lowered, name);
   }
@@ -359,133 +369,250 @@ void GpuLower::analysis(Fusion* fusion) {
   allKnownVals() = kernel_->inputs();
   dumpExprsIfEnabled(fusion_->exprs(), "set allKnownVals");
 
+  // The analyses below are run by runAnalyses in the order they are listed.
+  // The ones marked read_only only read the fusion and the results of the
+  // analyses listed before them, and write nothing but their own result.
+  // With NVFUSER_ENABLE=parallel_lower_analysis, consecutive read-only
+  // analyses run concurrently on the thread pool. The other ones mutate the
+  // fusion or create IR nodes, which is not thread-safe, so they run alone.
+  std::vector<LowerAnalysis> analyses;
+
   // prepare for lowering
-  validateIr(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateIr");
+  analyses.push_back({"validateIr", [this]() { validateIr(fusion_); }});
 
   // Checks if any TIDx dim is marked as padded to a warp. Also checks if we can
   // determine the padding is explicitly a single warp.
-  collectPaddedParallelDims();
-  dumpExprsIfEnabled(fusion_->exprs(), "collectPaddedParallelDims");
+  analyses.push_back(
+      {"collectPaddedParallelDims", [this]() { collectPaddedParallelDims(); }});
 
   // Replaces integers that are tensor sizes by named scalars as "T0.size[0]"
-  replaceSymbolicSizes(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "replaceSymbolicSizes");
+  analyses.push_back(
+      {"replaceSymbolicSizes", [this]() { replaceSymbolicSizes(fusion_); }});
 
   // Build what's refered to as the compute at map. This map contains the
   // mappings of all iteration domains across the fusion. There are three types
   // of mappings Permissive, Exact, and Loop, see compute_at_map.h/cpp for more
   // information.
-  compute_at_map_ = std::make_shared<ComputeAtMap>(fusion_);
-
-  // Transitory testing of IdModel if enabled. No existing
-  // functionality should be affected. New IterDomains may be created,
-  // so it is expected that generated code may use diffrent variable
-  // names
-  if (isOptionEnabled(EnableOption::IdModel)) {
-    IdModel id_model(fusion_);
-    // Only the exact graph is genereated at this moment
-    IdModelValidator::checkExactGraphEquivalence(
-        id_model.idGraph(IdMappingMode::EXACT));
-  }
-
-  resolveComputeWith(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "resolveComputeWith");
-
-  if (isDebugDumpEnabled(DebugDumpOption::ComputeAtMap)) {
-    debug() << compute_at_map_->toString() << std::endl;
-  }
-  compute_at_map_->validateAndPropagatePType();
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndPropagatePType");
+  analyses.push_back(
+      {"build ComputeAtMap",
+       [this]() {
+         compute_at_map_ = std::make_shared<ComputeAtMap>(fusion_);
+
+         // Transitory testing of IdModel if enabled. No existing
+         // functionality should be affected. New IterDomains may be created,
+         // so it is expected that generated code may use diffrent variable
+         // names
+         if (isOptionEnabled(EnableOption::IdModel)) {
+           IdModel id_model(fusion_);
+           // Only the exact graph is genereated at this moment
+           IdModelValidator::checkExactGraphEquivalence(
+               id_model.idGraph(IdMappingMode::EXACT));
+         }
+       },
+       {"replaceSymbolicSizes"}});
+
+  analyses.push_back(
+      {"resolveComputeWith",
+       [this]() { resolveComputeWith(fusion_); },
+       {"build ComputeAtMap"}});
+
+  analyses.push_back(
+      {"validateAndPropagatePType",
+       [this]() {
+         if (isDebugDumpEnabled(DebugDumpOption::ComputeAtMap)) {
+           debug() << compute_at_map_->toString() << std::endl;
+         }
+         compute_at_map_->validateAndPropagatePType();
+       },
+       {"resolveComputeWith"}});
 
   // Uses compute_at_map, find all splits that are enforced to be divisible
-  divisible_splits_ = getAllDivisibleSplits(fusion_, compute_at_map_.get());
-  dumpExprsIfEnabled(fusion_->exprs(), "getAllDivisibleSplits");
+  analyses.push_back(
+      {"getAllDivisibleSplits",
+       [this]() {
+         divisible_splits_ =
+             getAllDivisibleSplits(fusion_, compute_at_map_.get());
+       },
+       {"validateAndPropagatePType"},
+       /*read_only=*/true});
 
   // Used in parallel dimension map
-  concretized_broadcast_domains_ =
-      std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build ConcretizedBroadcastDomains");
-
-  parallelDimensionMap().build(fusion_);
-  if (isDebugDumpEnabled(DebugDumpOption::ParallelDimensions)) {
-    debug() << "Parallel dimension map:" << std::endl;
-    debug() << parallel_dimension_map_.toString() << std::endl;
-  }
-  dumpExprsIfEnabled(fusion_->exprs(), "build parallelDimensionMap");
-
-  // Validate mma data format and compatibility if any on the fusion.
-  validateMma(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateMma");
+  analyses.push_back(
+      {"build ConcretizedBroadcastDomains",
+       [this]() {
+         concretized_broadcast_domains_ =
+             std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
+       },
+       {"replaceSymbolicSizes"},
+       /*read_only=*/true});
 
   // Validate swizzle usage on the fusion schedule.
-  validateSwizzle(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateSwizzle");
+  analyses.push_back(
+      {"validateSwizzle",
+       [this]() { validateSwizzle(fusion_); },
+       {"validateAndPropagatePType"},
+       /*read_only=*/true});
+
+  analyses.push_back(
+      {"validateResize",
+       [this]() { validateResize(fusion_); },
+       {"replaceSymbolicSizes"},
+       /*read_only=*/true});
 
-  validateResize(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateResize");
+  // all of the lookup TVs are fusion inputs
+  analyses.push_back(
+      {"validateLookupTV",
+       [this]() { validateLookupTV(fusion_); },
+       {},
+       /*read_only=*/true});
+
+  analyses.push_back(
+      {"build parallelDimensionMap",
+       [this]() {
+         parallelDimensionMap().build(fusion_);
+         if (isDebugDumpEnabled(DebugDumpOption::ParallelDimensions)) {
+           debug() << "Parallel dimension map:" << std::endl;
+           debug() << parallel_dimension_map_.toString() << std::endl;
+         }
+       },
+       {"build ConcretizedBroadcastDomains"}});
+
+  // Validate mma data format and compatibility if any on the fusion. Not
+  // read-only as it compares extents with simplified expressions.
+  analyses.push_back(
+      {"validateMma",
+       [this]() { validateMma(fusion_); },
+       {"build parallelDimensionMap"}});
 
   // Compute thread predicates. Depends on parallel_dimension_map_
-  thread_pred_map_.build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build thread_pred_map_");
+  analyses.push_back(
+      {"build thread_pred_map_",
+       [this]() { thread_pred_map_.build(fusion_); },
+       {"build parallelDimensionMap"}});
 
   // Fuse cetain patterns of reductions, such as a grid reduction
   // followed by a grid broadcast. Only depends on parallelization and
   // thread predicate map.
-  fuseReductionsAndBroadcasts(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "fuseReductionsAndBroadcasts");
+  analyses.push_back(
+      {"fuseReductionsAndBroadcasts",
+       [this]() { fuseReductionsAndBroadcasts(fusion_); },
+       {"build thread_pred_map_"}});
 
   // Scan the whole fusion and build mappings about halo extensions of
   // all IterDomains
-  halo_info_ = std::make_shared<HaloInfo>(fusion_, compute_at_map_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build HaloInfo");
+  analyses.push_back(
+      {"build HaloInfo",
+       [this]() {
+         halo_info_ = std::make_shared<HaloInfo>(fusion_, compute_at_map_);
+       },
+       {"validateAndPropagatePType"}});
 
   // Want to run this after parallel map and halo info map are
   // created. vectorized_accesses_ and vectorized_set_info_ are filled.
-  validateAndCollectVectorizeInfo(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndCollectVectorizeInfo");
+  analyses.push_back(
+      {"validateAndCollectVectorizeInfo",
+       [this]() { validateAndCollectVectorizeInfo(fusion_); },
+       {"build parallelDimensionMap", "build HaloInfo"}});
 
   // Depends on ComputeAtMap and HaloInfo.
-  validateAndConvertIterDomainGrouping(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndConvertIterDomainGrouping");
+  analyses.push_back(
+      {"validateAndConvertIterDomainGrouping",
+       [this]() { validateAndConvertIterDomainGrouping(fusion_); },
+       {"build HaloInfo"}});
 
   // Assumes all grouped reductions are convered to
   // GroupedReductionOp, which is done by
   // validateAndConvertIterDomainGrouping
-  validateGroupedReductions(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateGroupedReductions");
-
-  // all of the lookup TVs are fusion inputs
-  validateLookupTV(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateLookupTV");
+  analyses.push_back(
+      {"validateGroupedReductions",
+       [this]() { validateGroupedReductions(fusion_); },
+       {"validateAndConvertIterDomainGrouping"},
+       /*read_only=*/true});
 
   // Depends on thread_pred_map_, validates parallelization collects which
   // tensor views need WAR or RAW syncs
-  sync_map_ = std::make_shared<const SyncMap>(fusion_);
-  if (isDebugDumpEnabled(DebugDumpOption::SyncMap)) {
-    debug() << sync_map_->toString() << std::endl;
-  }
-  dumpExprsIfEnabled(fusion_->exprs(), "SyncMap");
-
-  partialSplitMap().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build partialSplitMap");
-
-  validatePartialSplit(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validatePartialSplit");
-
-  nonDivisibleSplitInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build nonDivisibleSplitInfo");
+  analyses.push_back(
+      {"SyncMap",
+       [this]() {
+         sync_map_ = std::make_shared<const SyncMap>(fusion_);
+         if (isDebugDumpEnabled(DebugDumpOption::SyncMap)) {
+           debug() << sync_map_->toString() << std::endl;
+         }
+       },
+       {"fuseReductionsAndBroadcasts", "build HaloInfo"},
+       /*read_only=*/true});
+
+  analyses.push_back(
+      {"build partialSplitMap",
+       [this]() { partialSplitMap().build(fusion_); },
+       {},
+       /*read_only=*/true});
+
+  analyses.push_back(
+      {"validatePartialSplit",
+       [this]() { validatePartialSplit(fusion_); },
+       {},
+       /*read_only=*/true});
+
+  analyses.push_back(
+      {"build nonDivisibleSplitInfo",
+       [this]() { nonDivisibleSplitInfo().build(fusion_); },
+       {"getAllDivisibleSplits"},
+       /*read_only=*/true});
+
+  analyses.push_back(
+      {"build doubleBufferInfo",
+       [this]() { doubleBufferInfo().build(fusion_); },
+       {"validateAndPropagatePType"},
+       /*read_only=*/true});
 
   // Detects all exprssions that don't need predicates. Depends on
   // nonDivisibleSplitInfo.
-  pred_elimination_ = std::make_unique<PredicateElimination>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build predicateElimination");
-
-  doubleBufferInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build doubleBufferInfo");
+  analyses.push_back(
+      {"build predicateElimination",
+       [this]() {
+         pred_elimination_ = std::make_unique<PredicateElimination>(fusion_);
+       },
+       {"build nonDivisibleSplitInfo", "build HaloInfo"}});
+
+  analyses.push_back(
+      {"allocateIndexVariables",
+       [this]() { compute_at_map_->allocateIndexVariables(); },
+       {"build doubleBufferInfo"}});
+
+  // Analyses running on the pool see the same lowering, fusion and debug
+  // stream as this thread
+  std::ostream& debug_stream = debug();
+  auto run_in_worker = [this,
+                        &debug_stream](const std::function<void()>& run) {
+    LowerGuard lower_guard(this);
+    FusionGuard fg(fusion_);
+    DebugStreamGuard dsg(debug_stream);
+    run();
+  };
+  auto prepare_concurrent_reads = [this]() {
+    fusion_->prepareConcurrentReads();
+    compute_at_map_->prepareConcurrentReads();
+  };
+  auto after_each = [this](const LowerAnalysis& finished) {
+    dumpExprsIfEnabled(fusion_->exprs(), finished.name);
+  };
 
-  compute_at_map_->allocateIndexVariables();
-  dumpExprsIfEnabled(fusion_->exprs(), "allocateIndexVariables");
+  analysis_times_ = runAnalyses(
+      analyses,
+      isOptionEnabled(EnableOption::ParallelLowerAnalysis) ? getThreadPool()
+                                                           : nullptr,
+      run_in_worker,
+      prepare_concurrent_reads,
+      after_each);
+
+  if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+    debug() << "Lowering analysis wall times:" << std::endl;
+    for (const auto& time : analysis_times_) {
+      debug() << "  " << time.name << ": " << time.wall_time_ms << " ms"
+              << (time.concurrent ? " (concurrent)" : "") << std::endl;
+    }
+  }
 }
 
 kir::Kernel* GpuLower::kernel() const {
@@ -11,12 +11,14 @@
 #include <exceptions.h>
 
 #include <compute_at_map.h>
+#include <device_descriptor.h>
 #include <device_lower/analysis/fused_reduction.h>
 #include <device_lower/analysis/predicate_elimination.h>
 #include <device_lower/analysis/shift.h>
 #include <device_lower/analysis/sync_information.h>
 #include <device_lower/analysis/thread_predicate.h>
 #include <device_lower/analysis/trivial_broadcast.h>
+#include <device_lower/analysis_scheduler.h>
 #include <device_lower/pass/allocation.h>
 #include <device_lower/pass/double_buffer.h>
 #include <device_lower/pass/predicate.h>
@@ -58,11 +60,13 @@ class GpuLower : public NonCopyable {
 
   // GpuLower lowers the provided fusion into a kernel which can be translated
   // into cuda code. index_type allows to compile the kernel based on int32
-  // indexing instead of int64 for additional performance.
+  // indexing instead of int64 for additional performance. target_device is
+  // the device to generate code for and defaults to getTargetDevice().
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
   explicit GpuLower(
       Fusion* fusion,
-      const CompileParams& cparams = CompileParams());
+      const CompileParams& cparams = CompileParams(),
+      std::shared_ptr<const TargetDeviceDescriptor> target_device = nullptr);
 
   kir::Kernel* kernel() const;
 
@@ -77,6 +81,11 @@ class GpuLower : public NonCopyable {
   //! passes_
   kir::Kernel* run();
 
+  //! The device the kernel is generated for
+  const TargetDeviceDescriptor& targetDevice() const {
+    return *target_device_;
+  }
+
   const PrimDataType& indexType() const {
     return cparams_.index_type.value();
   }
@@ -130,6 +139,12 @@ class GpuLower : public NonCopyable {
     return warp_pad_info_;
   }
 
+  //! Wall time of each analysis run before the lowering passes, in the order
+  //! they ran
+  const std::vector<LowerAnalysisTime>& analysisTimes() const {
+    return analysis_times_;
+  }
+
   PartialSplitMap& partialSplitMap() {
     return partial_split_map_;
   }
@@ -270,6 +285,7 @@ class GpuLower : public NonCopyable {
   kir::KernelPerformanceProfile profile_;
   std::unordered_set<Split*> divisible_splits_;
   CompileParams cparams_;
+  std::shared_ptr<const TargetDeviceDescriptor> target_device_;
 
   // Track which tensor views are inputs or outputs of a vectorized operation
   // and their maximum vectorized access size
@@ -285,6 +301,8 @@ class GpuLower : public NonCopyable {
   // keep track of the mbarrier used for each load/store operation
   std::unordered_map<const Expr*, TensorView*> ldst_mbarrier_map_;
 
+  std::vector<LowerAnalysisTime> analysis_times_;
+
   Fusion* fusion_ = nullptr;
 };
 
@@ -193,6 +193,9 @@ void replaceSymbolicSizes(Fusion* fusion) {
     // Replace the domain with one based on Ti.size[j]
     const std::vector<IterDomain*>& root_td = tv->getRootDomain();
 
+    // The sizes of tv share a single T.logical_size, interned so that the
+    // sizes of tensors visited twice also share their nodes
+    Val* logical_size = nullptr;
     int64_t dim = 0;
     for (auto id : root_td) {
       Val* orig_size = id->getMaybeExpandedExtent();
@@ -209,9 +212,13 @@ void replaceSymbolicSizes(Fusion* fusion) {
       //  since FusionKernelRuntime will provide these as integer inputs
       if (tensor_dim_map.find(orig_size) == tensor_dim_map.end() &&
           !orig_size->isFusionInput() && !orig_size->isConstScalar()) {
-        tensor_dim_map[orig_size] = IrBuilder::getItemExpr(
-            IrBuilder::getAttrExpr(IrBuilder::metadataExpr(tv), "logical_size"),
-            dim++);
+        auto& hash_cons = fusion->scalarHashConsTable();
+        if (logical_size == nullptr) {
+          logical_size = hash_cons.intern(IrBuilder::getAttrExpr(
+              IrBuilder::metadataExpr(tv), "logical_size"));
+        }
+        tensor_dim_map[orig_size] =
+            hash_cons.intern(IrBuilder::getItemExpr(logical_size, dim++));
       } else {
         dim++;
       }
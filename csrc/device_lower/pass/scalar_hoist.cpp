@@ -94,6 +94,10 @@ int64_t findOutermostPosWithSatisfiedDependency(
   return pos;
 }
 
+ScalarHashConsTable& hashConsTable() {
+  return GpuLower::current()->kernel()->scalarHashConsTable();
+}
+
 // Get the key for `common_scalar_map_`
 kir::ForLoop* getLoopAtPos(
     const std::vector<kir::ForLoop*>& loops,
@@ -113,7 +117,7 @@ Val* findRefAsSubexprOf(Val* from, Val* reference, bool exact) {
       return from;
     }
   } else {
-    if (from->sameAs(reference)) {
+    if (hashConsTable().sameAs(from, reference)) {
       return from;
     }
   }
@@ -154,7 +158,7 @@ bool isHelpfulToReuse(Val* value) {
 // return the host value, else return nullptr.
 Val* reuseValsKnownToKernel(Val* value) {
   for (auto val : GpuLower::current()->allKnownVals()) {
-    if (val->sameAs(value)) {
+    if (hashConsTable().sameAs(val, value)) {
       return val;
     }
   }
@@ -216,8 +220,8 @@ std::pair<Val*, bool> CommonScalarMap::hoistScalarImpl(
   }
 
   for (auto existing_subexpr : seen_subexprs) {
-    if (value->sameAs(existing_subexpr)) {
-      common_scalar_map_[my_loop].emplace_back(existing_subexpr);
+    if (hashConsTable().sameAs(value, existing_subexpr)) {
+      addScalar(my_loop, existing_subexpr);
       hoisted_or_reused_.emplace(existing_subexpr);
       return {existing_subexpr, false};
     }
@@ -255,7 +259,7 @@ std::pair<Val*, bool> CommonScalarMap::hoistScalarImpl(
   // `value` is a subexpression of the given value, then we insert it into
   // `common_scalar_map_` only if it can be hoisted to outer loops.
   if (!has_tensor_index_dependency && (is_given || my_pos < parent_pos)) {
-    common_scalar_map_[my_loop].emplace_back(value);
+    addScalar(my_loop, value);
     if (my_pos < parent_pos) {
       hoisted_or_reused_.emplace(value);
     }
@@ -357,7 +361,13 @@ Val* CommonScalarMap::reuseScalarIfAlreadyComputed(
   if (auto host_val = reuseValsKnownToKernel(value)) {
     return host_val;
   }
-  // Find if loop already contain `value`.
+  // Find if loop already contain `value`. Most values are not, which is known
+  // without scanning the list if no subexpression has the same hash.
+  auto hashes_it = subexpr_hashes_.find(loop);
+  if (hashes_it == subexpr_hashes_.end() ||
+      hashes_it->second.count(hashConsTable().hash(value)) == 0) {
+    return nullptr;
+  }
   auto it = common_scalar_map_.find(loop);
   if (it != common_scalar_map_.end()) {
     auto& scalars = it->second;
@@ -379,6 +389,25 @@ Val* CommonScalarMap::reuseScalarIfAlreadyComputed(
   return nullptr;
 }
 
+void CommonScalarMap::addScalar(kir::ForLoop* loop, Val* value) {
+  common_scalar_map_[loop].emplace_back(value);
+  // Same traversal as findRefAsSubexprOf
+  auto& hashes = subexpr_hashes_[loop];
+  std::vector<Val*> to_visit{value};
+  while (!to_visit.empty()) {
+    auto subexpr = to_visit.back();
+    to_visit.pop_back();
+    hashes.insert(hashConsTable().hash(subexpr));
+    if (subexpr->isOneOf<TensorView, kir::TensorIndex>()) {
+      continue;
+    }
+    if (auto def = subexpr->definition()) {
+      to_visit.insert(
+          to_visit.end(), def->inputs().begin(), def->inputs().end());
+    }
+  }
+}
+
 std::vector<Val*> CommonScalarMap::getHoistedScalars(kir::ForLoop* loop) const {
   // In codegen, parallel type group may not be generated as a for loop, so
   // don't allocate in this loop
@@ -405,7 +434,7 @@ void CommonScalarMap::initialize(const std::vector<Expr*> exprs) {
       "CommonScalarMap used before initialization.");
   for (auto expr : exprs) {
     if (lower_utils::isScalarExpr(expr) && expr->outputs().size() == 1) {
-      common_scalar_map_[nullptr].emplace_back(expr->output(0));
+      addScalar(nullptr, expr->output(0));
     } else if (ir_utils::isTvOp(expr)) {
       // We only try to reuse scalar expressions placed at the beginning of the
       // top level scope. For example, if I have
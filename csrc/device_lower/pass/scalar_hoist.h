@@ -96,11 +96,21 @@ class CommonScalarMap {
   //! return nullptr.
   Val* reuseScalarIfAlreadyComputed(Val* value, kir::ForLoop* loop);
 
+  //! Append value to common_scalar_map_[loop] and record the hashes of its
+  //! subexpressions
+  void addScalar(kir::ForLoop* loop, Val* value);
+
  private:
   //! Map to hold hoisted common indices. The order matters and indicates data
   //! dependency. For example, my list might have [i1*4, i1*4+2, i1*4/16]
   std::unordered_map<kir::ForLoop*, std::list<Val*>> common_scalar_map_;
 
+  //! Structural hashes of the scalars in common_scalar_map_ and of their
+  //! subexpressions, by loop. A value whose hash is not here can't be reused
+  //! from the loop, which is known without calling sameAs on the list.
+  std::unordered_map<kir::ForLoop*, std::unordered_set<size_t>>
+      subexpr_hashes_;
+
   //! A set to identify that if a val is hoisted (an expression used in the
   //! inner loop, but its value only depend on outer loop variables, so the
   //! computation of this expression is hoisted to an outer loop) or reused (one
@@ -385,7 +385,7 @@ class FuseBroadcastWithWarpReduce : private kir::IrVisitor {
   // Checks if the given IterDomain is mapped to a single warp,
   //  i.e. they are known at compile time to be of constant
   //   size of warp_size and they are paralleled on TIDx
-  int warp_size = at::cuda::warp_size();
+  int64_t warp_size = GpuLower::current()->targetDevice().warp_size;
   bool isSingleWarp(IterDomain* id) {
     if (id->getParallelType() != ParallelType::TIDx) {
       return false;
@@ -342,7 +342,10 @@ std::optional<IterDomain*> getMaybeWarpReductionDim(
 
   if (reduction_on_xdim->extent()->isConstInt()) {
     auto extent_value = reduction_on_xdim->extent()->evaluate();
-    if (extent_value % at::cuda::warp_size() == 0) {
+    const auto warp_size = GpuLower::hasCurrent()
+        ? GpuLower::current()->targetDevice().warp_size
+        : getTargetDevice()->warp_size;
+    if (extent_value % warp_size == 0) {
       return std::optional<IterDomain*>(reduction_on_xdim);
     }
   }
@@ -713,7 +713,7 @@ namespace {
 // each tensor that needs to be computed.
 std::unordered_map<IterDomain*, std::pair<int64_t, int64_t>> getLiveRangeOffsets(
     Fusion* fusion) {
-  auto exprs = StmtSort::getExprs(fusion);
+  auto exprs = fusion->exprs();
 
   std::unordered_map<IterDomain*, std::pair<int64_t, int64_t>> map;
 
@@ -902,7 +902,7 @@ void validateMmaTensors(MmaOp* mma) {
               lower_utils::isExtentEqualToMaxParallelTypeExtent(id) &&
                   paralel_dim_map.get(ptype)->isConstInt() &&
                   paralel_dim_map.get(ptype)->evaluate() ==
-                      at::cuda::warp_size(),
+                      GpuLower::current()->targetDevice().warp_size,
               "TIDx is reserved for lane id in mma kernels, and it needs to be exactly a warp");
           tidx_validated = true;
         }
@@ -1063,7 +1063,7 @@ void validateArchMemoryOp(LoadStoreOp* ldst) {
 //! Validate data format and GPU arch compatibility of scheduled
 //!  mma operators on the fusion.
 void validateMma(Fusion* fusion) {
-  auto exprs = StmtSort::getExprs(fusion);
+  auto exprs = fusion->exprs();
 
   for (auto expr : exprs) {
     if (auto mma = dynamic_cast<MmaOp*>(expr)) {
@@ -1307,7 +1307,7 @@ void validateAndConvertIterDomainGrouping(Fusion* fusion) {
 }
 
 void validateGroupedReductions(Fusion* fusion) {
-  for (auto expr : StmtSort::getExprs(fusion)) {
+  for (auto expr : fusion->exprs()) {
     if (auto grouped_reduction_op = dynamic_cast<GroupedReductionOp*>(expr)) {
       const auto num_exprs =
           grouped_reduction_op->numHorizontallyGroupedExprs();
@@ -11,7 +11,9 @@
 #include <exceptions.h>
 
 #include <algorithm>
+#include <deque>
 #include <initializer_list>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -266,11 +268,22 @@ class VectorOfUniqueEntries {
 //! DisjointSet::mapEntries(a,b) makes the full set of a and b equivalent
 //! DisjointSet::*AreMapped(a,b) checks if a and b belong to the same disjoint
 //! set
+//!
+//! Equivalence is tracked with a union-find forest using union by rank and
+//! path compression. Members of a set are chained in a linked list kept at
+//! its root, so merging two sets never copies entries. The
+//! VectorOfUniqueEntries of a set is only materialized when requested and is
+//! cached until the set is merged with another one. Sets are ordered by when
+//! they were last created or merged, and members of a set by when they joined
+//! it, so iteration order is deterministic.
+//!
+//! Materialization and path compression happen in const accessors, so a
+//! DisjointSets must not be read from multiple threads concurrently unless
+//! prepareConcurrentReads() was called after the last modification.
 template <typename T, typename Hash = std::hash<T>>
 class DisjointSets {
  public:
-  using DisjointSetMap = std::
-      unordered_map<T, std::shared_ptr<VectorOfUniqueEntries<T, Hash>>, Hash>;
+  using DisjointSetPtr = std::shared_ptr<VectorOfUniqueEntries<T, Hash>>;
 
   DisjointSets() = default;
 
@@ -284,140 +297,202 @@ class DisjointSets {
 
   friend void swap(DisjointSets<T, Hash>& sets1, DisjointSets<T, Hash>& sets2) {
     using std::swap;
+    swap(sets1.entry_to_node_, sets2.entry_to_node_);
+    swap(sets1.nodes_, sets2.nodes_);
+    swap(sets1.materialized_sets_, sets2.materialized_sets_);
+    swap(sets1.set_order_, sets2.set_order_);
+    swap(sets1.clock_, sets2.clock_);
+    swap(sets1.num_sets_, sets2.num_sets_);
     swap(sets1.disjoint_sets_, sets2.disjoint_sets_);
-    swap(sets1.disjoint_set_maps_, sets2.disjoint_set_maps_);
+    swap(sets1.disjoint_sets_valid_, sets2.disjoint_sets_valid_);
   }
 
   // Warning: returned values should never be modified. This accessor isn't
   // strictly safe as VectorOfUniqueEntries is not returned as a const.
-  const DisjointSetMap& disjointSetMap() const {
-    return disjoint_set_maps_;
+  //
+  // Materializes every set that isn't already, and the returned vector is
+  // only valid until this container is modified.
+  const std::vector<DisjointSetPtr>& disjointSets() const {
+    if (!disjoint_sets_valid_) {
+      // Drop sets that have been merged away or emptied since the last call.
+      // set_order_ is appended to with increasing stamps, so what remains is
+      // in creation order.
+      set_order_.erase(
+          std::remove_if(
+              set_order_.begin(),
+              set_order_.end(),
+              [this](const std::pair<uint64_t, int64_t>& stamp_and_root) {
+                const auto& root = nodes_.at(stamp_and_root.second);
+                return root.parent != stamp_and_root.second ||
+                    root.stamp != stamp_and_root.first || root.size == 0;
+              }),
+          set_order_.end());
+
+      disjoint_sets_.clear();
+      disjoint_sets_.reserve(set_order_.size());
+      for (const auto& stamp_and_root : set_order_) {
+        disjoint_sets_.push_back(materialize(stamp_and_root.second));
+      }
+      disjoint_sets_valid_ = true;
+    }
+    return disjoint_sets_;
   }
 
+  // Return the disjoint set of provided entry. The returned pointer is
+  // replaced when the set is merged with another one.
+  //
   // Warning: returned values should never be modified. This accessor isn't
   // strictly safe as VectorOfUniqueEntries is not returned as a const.
-  const std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>>&
-  disjointSets() const {
-    return disjoint_sets_;
+  const DisjointSetPtr& disjointSetOf(T entry) const {
+    auto node_it = entry_to_node_.find(entry);
+    NVF_ERROR(
+        node_it != entry_to_node_.end(),
+        "Could not find entry for ",
+        entry->toString());
+    return materialize(findRoot(node_it->second));
   }
 
   // Return the entire disjoint set of provided entry
   const VectorOfUniqueEntries<T, Hash>& getDisjointSetOf(T entry) const {
-    auto set_it = disjoint_set_maps_.find(entry);
-    NVF_ERROR(
-        set_it != disjoint_set_maps_.end(),
-        "Could not find entry for ",
-        entry->toString());
-    return *(set_it->second);
+    return *disjointSetOf(entry);
   }
 
-  // Initializes a new set for provided entry
-  std::pair<typename DisjointSetMap::iterator, bool> initializeSet(T entry) {
-    auto disjoint_set_maps_it = disjoint_set_maps_.find(entry);
-    if (disjoint_set_maps_it != disjoint_set_maps_.end()) {
-      return std::make_pair(disjoint_set_maps_it, false);
+  // Initializes a new set for provided entry. Returns false if entry already
+  // belongs to a set.
+  bool initializeSet(T entry) {
+    if (entry_to_node_.find(entry) != entry_to_node_.end()) {
+      return false;
     }
-
-    disjoint_sets_.push_back(
-        std::make_shared<VectorOfUniqueEntries<T, Hash>>());
-    disjoint_sets_.back()->pushBack(entry);
-    return disjoint_set_maps_.emplace(
-        std::make_pair(entry, disjoint_sets_.back()));
+    makeNode(entry);
+    return true;
   }
 
-  // Adds all of the disjoint set belonging to entry1 to the disjoint set
-  // belonging to entry0, maps all entries of disjoint set belonging to entry1
-  // to entry0, removes original disjoint set belonging to entry1.
+  // Merges the disjoint set belonging to entry1 into the disjoint set
+  // belonging to entry0. Entries without a set are added first. The merged
+  // set is ordered after all existing sets, and lists the members of entry0's
+  // set before those of entry1's set.
   void mapEntries(T entry0, T entry1) {
-    auto set_it_0 = disjoint_set_maps_.find(entry0);
-    auto set_it_1 = disjoint_set_maps_.find(entry1);
+    auto findOrMakeNode = [this](const T& entry) {
+      auto node_it = entry_to_node_.find(entry);
+      return node_it != entry_to_node_.end() ? node_it->second
+                                             : makeNode(entry);
+    };
 
-    auto set_0_found = set_it_0 != disjoint_set_maps_.end();
-    auto set_1_found = set_it_1 != disjoint_set_maps_.end();
+    int64_t node0 = findOrMakeNode(entry0);
 
-    // Sets already joined
-    if (set_0_found && set_1_found && set_it_0->second == set_it_1->second) {
+    // This should be after we enter a new set in case it doesn't exist.
+    if (entry0 == entry1) {
       return;
     }
 
-    // Make and map new set
-    disjoint_sets_.push_back(
-        std::make_shared<VectorOfUniqueEntries<T, Hash>>());
-    auto new_set = disjoint_sets_.back();
-
-    // Add an entry to new_set along with the other entries previously
-    // grouped together with the entry. The existing set is erased.
-    auto mergeSets = [this](const T& entry, auto& new_set) {
-      if (auto it = disjoint_set_maps_.find(entry);
-          it != disjoint_set_maps_.end()) {
-        auto existing_set = it->second;
-        for (const auto& existing_entry : *existing_set) {
-          new_set->pushBack(existing_entry);
-          disjoint_set_maps_[existing_entry] = new_set;
-        }
-        disjoint_sets_.erase(std::find(
-            disjoint_sets_.begin(), disjoint_sets_.end(), existing_set));
-      } else {
-        new_set->pushBack(entry);
-        disjoint_set_maps_[entry] = new_set;
-      }
-    };
+    int64_t node1 = findOrMakeNode(entry1);
 
-    mergeSets(entry0, new_set);
+    int64_t root0 = findRoot(node0);
+    int64_t root1 = findRoot(node1);
 
-    // This should be after we enter a new set in case it doesn't exist.
-    if (entry0 == entry1) {
+    // Sets already joined
+    if (root0 == root1) {
       return;
     }
 
-    mergeSets(entry1, new_set);
+    // Append the members of set 1 to the members of set 0
+    const int64_t head = nodes_.at(root0).head;
+    const int64_t tail = nodes_.at(root1).tail;
+    const int64_t size = nodes_.at(root0).size + nodes_.at(root1).size;
+    nodes_.at(nodes_.at(root0).tail).next = nodes_.at(root1).head;
+    nodes_.at(nodes_.at(root1).head).prev = nodes_.at(root0).tail;
+
+    materialized_sets_.at(root0).reset();
+    materialized_sets_.at(root1).reset();
+
+    // Union by rank
+    if (nodes_.at(root0).rank < nodes_.at(root1).rank) {
+      std::swap(root0, root1);
+    }
+    nodes_.at(root1).parent = root0;
+    if (nodes_.at(root0).rank == nodes_.at(root1).rank) {
+      nodes_.at(root0).rank++;
+    }
+
+    auto& root = nodes_.at(root0);
+    root.head = head;
+    root.tail = tail;
+    root.size = size;
+    root.stamp = ++clock_;
+    set_order_.emplace_back(root.stamp, root0);
+    num_sets_--;
+    disjoint_sets_valid_ = false;
   }
 
   // Will assert if provided entry0 is not in any disjoint set, otherwise
   // returns if entry0 and entry1 are in the same disjoint set.
   bool strictAreMapped(T entry0, T entry1) const {
-    auto entry_it = disjointSetMap().find(entry0);
+    auto node_it_0 = entry_to_node_.find(entry0);
     NVF_ERROR(
-        entry_it != disjointSetMap().end(),
+        node_it_0 != entry_to_node_.end(),
         "Strict mapping failed on element: ",
         abstractToString(entry0),
         " either an error occurred, or non strict mapping should have been used.");
-    return entry_it->second->has(entry1);
+    auto node_it_1 = entry_to_node_.find(entry1);
+    if (node_it_1 == entry_to_node_.end()) {
+      return false;
+    }
+    return findRoot(node_it_0->second) == findRoot(node_it_1->second);
   }
 
   // If entry0 doesn't have a disjoint set returns false, otherwise returns if
   // entry0 and entry1 are in the same disjoint set.
   bool permissiveAreMapped(T entry0, T entry1) const {
-    auto entry_it = disjointSetMap().find(entry0);
-    if (entry_it == disjointSetMap().end()) {
+    auto node_it_0 = entry_to_node_.find(entry0);
+    auto node_it_1 = entry_to_node_.find(entry1);
+    if (node_it_0 == entry_to_node_.end() ||
+        node_it_1 == entry_to_node_.end()) {
       return false;
     }
-    return entry_it->second->has(entry1);
+    return findRoot(node_it_0->second) == findRoot(node_it_1->second);
   }
 
   // Returns if a set exists with provided entry
   bool mappingExists(T entry) const {
-    return disjoint_set_maps_.find(entry) != disjoint_set_maps_.end();
+    return entry_to_node_.find(entry) != entry_to_node_.end();
   }
 
   // Erases element if it exists in the disjoint set. Returns true if element
   // found.
   bool erase(T entry) {
-    auto entry_it = disjoint_set_maps_.find(entry);
-    if (entry_it == disjoint_set_maps_.end()) {
+    auto node_it = entry_to_node_.find(entry);
+    if (node_it == entry_to_node_.end()) {
       return false;
     }
 
-    auto set = entry_it->second;
-    if (set->size() == 1) {
-      NVF_ERROR(
-          set->front() == entry,
-          "Disjoint set container found to be in inconsistent state.");
-      disjoint_set_maps_.erase(entry);
-      disjoint_sets_.erase(
-          std::find(disjoint_sets_.begin(), disjoint_sets_.end(), set));
+    // The node of an erased entry stays in the forest as other nodes may
+    // still point to it. It's only unlinked from the member list.
+    const int64_t node_idx = node_it->second;
+    entry_to_node_.erase(node_it);
+    const int64_t root_idx = findRoot(node_idx);
+
+    auto& node = nodes_.at(node_idx);
+    auto& root = nodes_.at(root_idx);
+    if (node.prev != -1) {
+      nodes_.at(node.prev).next = node.next;
     } else {
-      disjoint_set_maps_.erase(entry);
+      root.head = node.next;
+    }
+    if (node.next != -1) {
+      nodes_.at(node.next).prev = node.prev;
+    } else {
+      root.tail = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+
+    root.size--;
+    auto& set = materialized_sets_.at(root_idx);
+    if (root.size == 0) {
+      set.reset();
+      num_sets_--;
+      disjoint_sets_valid_ = false;
+    } else if (set != nullptr) {
       set->erase(entry);
     }
 
@@ -430,7 +505,7 @@ class DisjointSets {
   // Warning: constructed on every call, consider caching result.
   VectorOfUniqueEntries<T, Hash> getAllElements() const {
     VectorOfUniqueEntries<T, Hash> all_elements;
-    for (auto set : disjoint_sets_) {
+    for (const auto& set : disjointSets()) {
       for (auto entry : set->vector()) {
         all_elements.pushBack(entry);
       }
@@ -440,15 +515,21 @@ class DisjointSets {
 
   // Completely clears all disjoint sets
   void clear() {
-    disjoint_set_maps_.clear();
+    entry_to_node_.clear();
+    nodes_.clear();
+    materialized_sets_.clear();
+    set_order_.clear();
+    clock_ = 0;
+    num_sets_ = 0;
     disjoint_sets_.clear();
+    disjoint_sets_valid_ = true;
   }
 
   std::string toString() const {
     std::stringstream ss;
     ss << "disjoint sets{\n";
     const std::string sep("  ");
-    for (auto s_ptr : disjoint_sets_) {
+    for (const auto& s_ptr : disjointSets()) {
       auto& set = *s_ptr;
       ss << sep << abstractToString(set) << "\n";
     }
@@ -456,51 +537,125 @@ class DisjointSets {
     return ss.str();
   }
 
-  auto size() const {
-    return disjoint_sets_.size();
+  size_t size() const {
+    return num_sets_;
+  }
+
+  //! Compresses every path and materializes every set. Until the next
+  //! non-const call, const accessors then only read this container, so they
+  //! can be called from multiple threads.
+  void prepareConcurrentReads() const {
+    for (int64_t index = 0; index < (int64_t)nodes_.size(); index++) {
+      findRoot(index);
+    }
+    disjointSets();
   }
 
  private:
-  // Disjoint sets
-  DisjointSetMap disjoint_set_maps_;
+  // Node of the union-find forest. Every entry ever added gets one.
+  struct Node {
+    Node(T entry, int64_t index, uint64_t stamp)
+        : entry(std::move(entry)),
+          parent(index),
+          head(index),
+          tail(index),
+          stamp(stamp) {}
+
+    T entry;
+    // Equal to the own index for roots. Mutable for path compression.
+    int64_t parent = -1;
+    int64_t rank = 0;
+    // Neighbors in the member list of the set, -1 at either end
+    int64_t prev = -1;
+    int64_t next = -1;
+    // Only meaningful for roots: number of members, ends of the member list
+    // and when the set was created or last merged.
+    int64_t size = 1;
+    int64_t head = -1;
+    int64_t tail = -1;
+    uint64_t stamp = 0;
+  };
+
+  int64_t makeNode(T entry) {
+    const auto index = (int64_t)nodes_.size();
+    nodes_.emplace_back(entry, index, ++clock_);
+    materialized_sets_.emplace_back();
+    set_order_.emplace_back(clock_, index);
+    entry_to_node_.emplace(entry, index);
+    num_sets_++;
+    disjoint_sets_valid_ = false;
+    return index;
+  }
+
+  int64_t findRoot(int64_t index) const {
+    int64_t root = index;
+    while (nodes_[root].parent != root) {
+      root = nodes_[root].parent;
+    }
+    // Path compression
+    while (nodes_[index].parent != root) {
+      auto parent = nodes_[index].parent;
+      nodes_[index].parent = root;
+      index = parent;
+    }
+    return root;
+  }
 
-  // Keep a list of disjoint_sets that's deterministic to iterate over
-  //
-  // TODO: Should this just be a
-  // VectorOfUniqueEntries<std::shared_ptr<VectorOfUniqueEntries ?
-  std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>> disjoint_sets_;
+  const DisjointSetPtr& materialize(int64_t root) const {
+    auto& set = materialized_sets_.at(root);
+    if (set == nullptr) {
+      set = std::make_shared<VectorOfUniqueEntries<T, Hash>>();
+      for (int64_t index = nodes_[root].head; index != -1;
+           index = nodes_[index].next) {
+        set->pushBack(nodes_[index].entry);
+      }
+    }
+    return set;
+  }
+
+ private:
+  // Union-find node of each entry
+  std::unordered_map<T, int64_t, Hash> entry_to_node_;
+
+  mutable std::vector<Node> nodes_;
+
+  // Materialized member list of each root, created on demand. A deque so
+  // that references handed out by disjointSetOf stay valid as nodes are
+  // added.
+  mutable std::deque<DisjointSetPtr> materialized_sets_;
+
+  // Roots paired with their stamp at the time they were created or merged
+  // into. Entries become stale once the root is merged away, merged into
+  // again or emptied, and are dropped by disjointSets().
+  mutable std::vector<std::pair<uint64_t, int64_t>> set_order_;
+
+  uint64_t clock_ = 0;
+
+  size_t num_sets_ = 0;
+
+  // Keep a list of disjoint_sets that's deterministic to iterate over, built
+  // lazily by disjointSets()
+  mutable std::vector<DisjointSetPtr> disjoint_sets_;
+  mutable bool disjoint_sets_valid_ = true;
 };
 
 template <typename T, typename Hash>
-DisjointSets<T, Hash>::DisjointSets(const DisjointSets<T, Hash>& other) {
-  std::unordered_map<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>, int>
-      ptr_map;
-
-  // Deep copy the vector of the disjoint sets, keeping the same
-  // ordering of the sets.
-  for (const auto& other_set : other.disjoint_sets_) {
-    auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>(*other_set);
-    int new_set_index = disjoint_sets_.size();
-    disjoint_sets_.emplace_back(new_set);
-    NVF_ERROR(
-        ptr_map.emplace(other_set, new_set_index).second,
-        "Duplicated set found: ",
-        other_set->toString());
-  }
-
-  // Copy the mappings using the new sets
-  for (const auto& kv : other.disjoint_set_maps_) {
-    const auto key = kv.first;
-    const auto new_set_index = ptr_map.at(kv.second);
-    disjoint_set_maps_.emplace(key, disjoint_sets_.at(new_set_index));
-  }
+DisjointSets<T, Hash>::DisjointSets(const DisjointSets<T, Hash>& other)
+    : entry_to_node_(other.entry_to_node_),
+      nodes_(other.nodes_),
+      set_order_(other.set_order_),
+      clock_(other.clock_),
+      num_sets_(other.num_sets_),
+      disjoint_sets_valid_(false) {
+  // Materialized sets are not shared so that the copies can be modified
+  // independently. They are rebuilt on demand keeping the same ordering.
+  materialized_sets_.resize(nodes_.size());
 }
 
 template <typename T, typename Hash>
 DisjointSets<T, Hash>& DisjointSets<T, Hash>::operator=(
     const DisjointSets<T, Hash>& other) {
-  disjoint_set_maps_.clear();
-  disjoint_sets_.clear();
+  clear();
 
   DisjointSets<T, Hash> copy(other);
   swap(*this, copy);
@@ -13,8 +13,11 @@
 #include <expr_evaluator.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
+#include <options.h>
 #include <tensor_metadata.h>
 
+#include <cstdlib>
+#include <numeric>
 #include <optional>
 
 namespace nvfuser {
@@ -122,7 +125,7 @@ PrecomputedValues::PrecomputedValues(Fusion* fusion) : fusion_(fusion) {
   loadSymbols(collectRuntimeUsedValues(fusion));
   initializeValueList(symbols());
   initializeNamedScalars();
-  initializeIntegerMachine();
+  initializeValueMachine();
 }
 
 void PrecomputedValues::bindParallelExtents(
@@ -361,8 +364,37 @@ void PrecomputedValues::bindTensorMetaData(
   bindValue(metadata_val->evaluatorIndex(), metadata);
 }
 
-NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
-    : precomputed_values_(precomputed_values), num_of_instructions_{0} {
+ValueMachine::RegisterKind ValueMachine::registerKindOf(const Val* val) {
+  auto dtype = val->dtype();
+  if (dtype == DataType::Bool) {
+    return RegisterKind::Bool;
+  }
+  if (isIntegralType(dtype)) {
+    return RegisterKind::Int;
+  }
+  return RegisterKind::Generic;
+}
+
+ValueMachine::ValueMachine(PrecomputedValues& precomputed_values)
+    : precomputed_values_(precomputed_values) {
+  generic_only_ = isOptionDisabled(DisableOption::TypedValueMachine);
+
+  const auto num_of_values = precomputed_values_.symbols_.size();
+  register_kinds_.reserve(num_of_values);
+  registers_.resize(num_of_values, 0);
+  known_.resize(num_of_values, 0);
+  for (auto i : c10::irange(num_of_values)) {
+    register_kinds_.push_back(
+        generic_only_ ? RegisterKind::Generic
+                      : registerKindOf(precomputed_values_.symbols_[i]));
+    // Constants are never rebound, so their registers are loaded once. A
+    // constant that doesn't have the type of its IR node is only handled
+    // through PolymorphicValue.
+    if (precomputed_values_.is_constant_[i] && !loadRegister((int)i)) {
+      register_kinds_[i] = RegisterKind::Generic;
+    }
+  }
+
   for (auto val : precomputed_values_.symbols_) {
     auto def = val->definition();
     if (def) {
@@ -378,315 +410,530 @@ NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
       }
     }
   }
-}
-
-void NaiveValueMachine::copyFrom(const NaiveValueMachine& other) {
-  num_of_instructions_ = other.num_of_instructions_;
-
-  inst_type_.clear();
-  inst_type_.insert(
-      inst_type_.end(), other.inst_type_.begin(), other.inst_type_.end());
 
-  uop_type_.clear();
-  uop_type_.insert(
-      uop_type_.end(), other.uop_type_.begin(), other.uop_type_.end());
-
-  data_type_.clear();
-  data_type_.insert(
-      data_type_.end(), other.data_type_.begin(), other.data_type_.end());
-
-  bop_type_.clear();
-  bop_type_.insert(
-      bop_type_.end(), other.bop_type_.begin(), other.bop_type_.end());
-
-  src0_.clear();
-  src0_.insert(src0_.end(), other.src0_.begin(), other.src0_.end());
-
-  src1_.clear();
-  src1_.insert(src1_.end(), other.src1_.begin(), other.src1_.end());
-
-  dest_.clear();
-  dest_.insert(dest_.end(), other.dest_.begin(), other.dest_.end());
+  markSyncedResults();
 }
 
-void NaiveValueMachine::run() {
-  for (const auto i : c10::irange(num_of_instructions_)) {
-    // Skip this instruction if the dest location
-    //  has already been computed or is constant.
-    if (precomputed_values_.defined_[dest_[i]] ||
-        precomputed_values_.is_constant_[dest_[i]]) {
-      continue;
-    }
-    runInstruction(i);
-  }
+void ValueMachine::copyFrom(const ValueMachine& other) {
+  instructions_ = other.instructions_;
+  register_kinds_ = other.register_kinds_;
+  registers_ = other.registers_;
+  known_ = other.known_;
+  generic_only_ = other.generic_only_;
 }
 
-void NaiveValueMachine::makeUnaryOp(UnaryOp* uop) {
+void ValueMachine::makeUnaryOp(UnaryOp* uop) {
   int in = uop->inputs()[0]->evaluatorIndex();
   int out = uop->outputs()[0]->evaluatorIndex();
-  NVF_ERROR(in >= 0, "Integer Machine: unknown input: ", uop);
-  NVF_ERROR(out >= 0, "Integer Machine: unknown out: ", uop);
-
-  int index = makeInstructionEntry();
-  inst_type_[index] = InstructionType::UNARY_OP;
-  uop_type_[index] = uop->getUnaryOpType();
-  if (uop_type_[index] == UnaryOpType::Cast) {
-    data_type_[index] = uop->out()->getDataType().value();
+  NVF_ERROR(in >= 0, "Value Machine: unknown input: ", uop);
+  NVF_ERROR(out >= 0, "Value Machine: unknown out: ", uop);
+
+  Instruction inst;
+  inst.opcode = Opcode::GenericUnary;
+  inst.uop_type = uop->getUnaryOpType();
+  if (inst.uop_type == UnaryOpType::Cast) {
+    inst.data_type = uop->out()->getDataType().value();
   }
-  src0_[index] = in;
-  dest_[index] = out;
-}
-
-void NaiveValueMachine::makeBinaryOp(BinaryOp* bop) {
-  int in0 = bop->inputs()[0]->evaluatorIndex();
-  int in1 = bop->inputs()[1]->evaluatorIndex();
-  int out = bop->outputs()[0]->evaluatorIndex();
-
-  NVF_ERROR(in0 >= 0, "Integer Machine: unknown lhs: ", bop);
-  NVF_ERROR(in1 >= 0, "Integer Machine: unknown rhs: ", bop);
-  NVF_ERROR(out >= 0, "Integer Machine: unknown out: ", bop);
-
-  int index = makeInstructionEntry();
-  inst_type_[index] = InstructionType::BINARY_OP;
-  bop_type_[index] = bop->getBinaryOpType();
-  src0_[index] = in0;
-  src1_[index] = in1;
-  dest_[index] = out;
-}
-
-void NaiveValueMachine::makeTernaryOp(TernaryOp* top) {
-  int in0 = top->inputs()[0]->evaluatorIndex();
-  int in1 = top->inputs()[1]->evaluatorIndex();
-  int in2 = top->inputs()[2]->evaluatorIndex();
-  int out = top->outputs()[0]->evaluatorIndex();
-
-  NVF_ERROR(in0 >= 0, "Integer Machine: unknown first input: ", top);
-  NVF_ERROR(in1 >= 0, "Integer Machine: unknown second input: ", top);
-  NVF_ERROR(in2 >= 0, "Integer Machine: unknown third input: ", top);
-  NVF_ERROR(out >= 0, "Integer Machine: unknown out: ", top);
-
-  int index = makeInstructionEntry();
-  inst_type_[index] = InstructionType::TERNARY_OP;
-  top_type_[index] = top->getTernaryOpType();
-  src0_[index] = in0;
-  src1_[index] = in1;
-  src2_[index] = in2;
-  dest_[index] = out;
-}
-
-int NaiveValueMachine::makeInstructionEntry() {
-  int index = num_of_instructions_++;
-  inst_type_.emplace_back(InstructionType::UNARY_OP);
-  uop_type_.emplace_back(UnaryOpType::Abs);
-  bop_type_.emplace_back(BinaryOpType::Add);
-  top_type_.emplace_back(TernaryOpType::Where);
-  data_type_.emplace_back(DataType::Null);
-  src0_.emplace_back(-1);
-  src1_.emplace_back(-1);
-  src2_.emplace_back(-1);
-  dest_.emplace_back(-1);
-  return index;
-}
-
-void NaiveValueMachine::runInstruction(int index) {
-  switch (inst_type_[index]) {
-    case InstructionType::SET_OP:
-      precomputed_values_.values_[dest_[index]] =
-          precomputed_values_.values_[src0_[index]];
-      break;
-    case InstructionType::UNARY_OP:
-      runUnaryOp(index);
-      break;
-    case InstructionType::BINARY_OP:
-      runBinaryOp(index);
+  inst.src0 = in;
+  inst.dest = out;
+
+  const auto in_kind = register_kinds_[in];
+  const auto out_kind = register_kinds_[out];
+  const bool typed_in = in_kind != RegisterKind::Generic;
+  const bool int_in_out =
+      in_kind == RegisterKind::Int && out_kind == RegisterKind::Int;
+  switch (inst.uop_type) {
+    case UnaryOpType::Neg:
+      inst.opcode = int_in_out ? Opcode::Neg : inst.opcode;
       break;
-    case InstructionType::TERNARY_OP:
-      runTernaryOp(index);
+    case UnaryOpType::Abs:
+      inst.opcode = int_in_out ? Opcode::Abs : inst.opcode;
       break;
-  }
-}
-
-void NaiveValueMachine::runUnaryOp(int index) {
-  using namespace PolymorphicValue_functions;
-  int src_index = src0_[index];
-  bool src_defined = precomputed_values_.defined_[src_index];
-  bool src_is_const = precomputed_values_.is_constant_[src_index];
-  if (!src_defined && !src_is_const) {
-    return;
-  }
-
-  int dest_index = dest_[index];
-
-  auto& src = precomputed_values_.values_[src_index];
-  auto& dest = precomputed_values_.values_[dest_index];
-
-  switch (uop_type_[index]) {
-    case UnaryOpType::Neg:
-      dest = -src;
+    case UnaryOpType::BitwiseNot:
+      inst.opcode = int_in_out ? Opcode::BitwiseNot : inst.opcode;
       break;
     case UnaryOpType::Cast:
-      if (isFloatingPointType(data_type_[index])) {
-        dest = PolymorphicValue((double)src);
-      } else if (isIntegralType(data_type_[index])) {
-        dest = PolymorphicValue((int64_t)src);
-      } else if (data_type_[index] == DataType::Bool) {
-        dest = PolymorphicValue((bool)src);
-      } else {
-        NVF_ERROR(
-            false, "dtype not supported in evaluator: ", data_type_[index]);
+      if (typed_in && out_kind == RegisterKind::Int) {
+        inst.opcode = Opcode::Set;
+      } else if (typed_in && out_kind == RegisterKind::Bool) {
+        inst.opcode = Opcode::ToBool;
       }
       break;
-    case UnaryOpType::Abs:
-      dest = abs(src);
-      break;
     case UnaryOpType::LogicalNot:
-      dest = !src;
-      break;
-    case UnaryOpType::BitwiseNot:
-      dest = ~src;
+      if (typed_in && out_kind == RegisterKind::Bool) {
+        inst.opcode = Opcode::LogicalNot;
+      }
       break;
     default:
-      NVF_CHECK(!"Unexpected operator type ", uop_type_[index]);
+      break;
   }
-
-  precomputed_values_.defined_[dest_index] = true;
+  instructions_.push_back(inst);
 }
 
-void NaiveValueMachine::runBinaryOp(int index) {
-  using namespace PolymorphicValue_functions;
-  int src0_index = src0_[index];
-  int src1_index = src1_[index];
-  bool src0_is_const = precomputed_values_.is_constant_[src0_index];
-  bool src1_is_const = precomputed_values_.is_constant_[src1_index];
-
-  bool src_defined =
-      (precomputed_values_.defined_[src0_index] || src0_is_const) &&
-      (precomputed_values_.defined_[src1_index] || src1_is_const);
-
-  if (!src_defined) {
-    return;
-  }
-  int dest_index = dest_[index];
-
-  auto& lhs = precomputed_values_.values_[src0_index];
-  auto& rhs = precomputed_values_.values_[src1_index];
-  auto& dest = precomputed_values_.values_[dest_index];
+void ValueMachine::makeBinaryOp(BinaryOp* bop) {
+  int in0 = bop->inputs()[0]->evaluatorIndex();
+  int in1 = bop->inputs()[1]->evaluatorIndex();
+  int out = bop->outputs()[0]->evaluatorIndex();
 
-  switch (bop_type_[index]) {
+  NVF_ERROR(in0 >= 0, "Value Machine: unknown lhs: ", bop);
+  NVF_ERROR(in1 >= 0, "Value Machine: unknown rhs: ", bop);
+  NVF_ERROR(out >= 0, "Value Machine: unknown out: ", bop);
+
+  Instruction inst;
+  inst.opcode = Opcode::GenericBinary;
+  inst.bop_type = bop->getBinaryOpType();
+  inst.src0 = in0;
+  inst.src1 = in1;
+  inst.dest = out;
+
+  const bool typed_in = register_kinds_[in0] != RegisterKind::Generic &&
+      register_kinds_[in1] != RegisterKind::Generic;
+  const bool int_in_out = register_kinds_[in0] == RegisterKind::Int &&
+      register_kinds_[in1] == RegisterKind::Int &&
+      register_kinds_[out] == RegisterKind::Int;
+  const bool bool_out = typed_in && register_kinds_[out] == RegisterKind::Bool;
+
+  // Opcode to use if int_in_out or bool_out respectively holds
+  std::optional<Opcode> int_opcode;
+  std::optional<Opcode> bool_opcode;
+  switch (inst.bop_type) {
     case BinaryOpType::Add:
-      dest = lhs + rhs;
+      int_opcode = Opcode::Add;
       break;
     case BinaryOpType::Sub:
-      dest = lhs - rhs;
+      int_opcode = Opcode::Sub;
       break;
     case BinaryOpType::Mul:
-      dest = lhs * rhs;
+      int_opcode = Opcode::Mul;
       break;
     case BinaryOpType::Div:
-      NVF_CHECK(rhs != 0);
-      dest = lhs / rhs;
+      int_opcode = Opcode::Div;
       break;
     case BinaryOpType::Mod:
-      NVF_CHECK(rhs != 0);
-      dest = lhs % rhs;
+      int_opcode = Opcode::Mod;
       break;
     case BinaryOpType::CeilDiv:
-      NVF_CHECK(rhs != 0);
-      dest = ceildiv(lhs, rhs);
-      break;
-    case BinaryOpType::LogicalAnd:
-      dest = lhs && rhs;
+      int_opcode = Opcode::CeilDiv;
       break;
     case BinaryOpType::BitwiseAnd:
-      dest = lhs & rhs;
-      break;
-    case BinaryOpType::LogicalOr:
-      dest = lhs || rhs;
+      int_opcode = Opcode::BitwiseAnd;
       break;
     case BinaryOpType::BitwiseOr:
-      dest = lhs | rhs;
+      int_opcode = Opcode::BitwiseOr;
       break;
     case BinaryOpType::BitwiseXor:
-      dest = lhs ^ rhs;
+      int_opcode = Opcode::BitwiseXor;
       break;
     case BinaryOpType::Max:
-      dest = lhs > rhs ? lhs : rhs;
+      int_opcode = Opcode::Max;
       break;
     case BinaryOpType::Min:
-      dest = lhs < rhs ? lhs : rhs;
+      int_opcode = Opcode::Min;
       break;
     case BinaryOpType::Gcd:
-      dest = gcd(lhs, rhs);
+      int_opcode = Opcode::Gcd;
       break;
     case BinaryOpType::LT:
-      dest = lhs < rhs;
+      bool_opcode = Opcode::LT;
       break;
     case BinaryOpType::LE:
-      dest = lhs <= rhs;
+      bool_opcode = Opcode::LE;
       break;
     case BinaryOpType::Eq:
-      dest = lhs == rhs;
+      bool_opcode = Opcode::Eq;
       break;
     case BinaryOpType::NE:
-      dest = lhs != rhs;
+      bool_opcode = Opcode::NE;
       break;
     case BinaryOpType::GE:
-      dest = lhs >= rhs;
+      bool_opcode = Opcode::GE;
       break;
     case BinaryOpType::GT:
-      dest = lhs > rhs;
+      bool_opcode = Opcode::GT;
+      break;
+    case BinaryOpType::LogicalAnd:
+      bool_opcode = Opcode::LogicalAnd;
+      break;
+    case BinaryOpType::LogicalOr:
+      bool_opcode = Opcode::LogicalOr;
       break;
     default:
-      NVF_CHECK(false, "Unexpected operator type ", bop_type_[index]);
+      break;
+  }
+  if (int_opcode.has_value() && int_in_out) {
+    inst.opcode = int_opcode.value();
+  } else if (bool_opcode.has_value() && bool_out) {
+    inst.opcode = bool_opcode.value();
   }
+  instructions_.push_back(inst);
+}
+
+void ValueMachine::makeTernaryOp(TernaryOp* top) {
+  int in0 = top->inputs()[0]->evaluatorIndex();
+  int in1 = top->inputs()[1]->evaluatorIndex();
+  int in2 = top->inputs()[2]->evaluatorIndex();
+  int out = top->outputs()[0]->evaluatorIndex();
 
-  precomputed_values_.defined_[dest_index] = true;
+  NVF_ERROR(in0 >= 0, "Value Machine: unknown first input: ", top);
+  NVF_ERROR(in1 >= 0, "Value Machine: unknown second input: ", top);
+  NVF_ERROR(in2 >= 0, "Value Machine: unknown third input: ", top);
+  NVF_ERROR(out >= 0, "Value Machine: unknown out: ", top);
+
+  Instruction inst;
+  inst.opcode = Opcode::GenericTernary;
+  inst.top_type = top->getTernaryOpType();
+  inst.src0 = in0;
+  inst.src1 = in1;
+  inst.src2 = in2;
+  inst.dest = out;
+
+  const auto out_kind = register_kinds_[out];
+  switch (inst.top_type) {
+    case TernaryOpType::Where:
+      if (register_kinds_[in0] != RegisterKind::Generic &&
+          out_kind != RegisterKind::Generic &&
+          register_kinds_[in1] == out_kind &&
+          register_kinds_[in2] == out_kind) {
+        inst.opcode = Opcode::Where;
+      }
+      break;
+    case TernaryOpType::Clamp:
+      if (out_kind == RegisterKind::Int &&
+          register_kinds_[in0] == RegisterKind::Int &&
+          register_kinds_[in1] == RegisterKind::Int &&
+          register_kinds_[in2] == RegisterKind::Int) {
+        inst.opcode = Opcode::Clamp;
+      }
+      break;
+    default:
+      break;
+  }
+  instructions_.push_back(inst);
 }
 
-void NaiveValueMachine::runTernaryOp(int index) {
-  using namespace PolymorphicValue_functions;
-  int src0_index = src0_[index];
-  int src1_index = src1_[index];
-  int src2_index = src2_[index];
-  bool src0_is_const = precomputed_values_.is_constant_[src0_index];
-  bool src1_is_const = precomputed_values_.is_constant_[src1_index];
-  bool src2_is_const = precomputed_values_.is_constant_[src2_index];
+void ValueMachine::markSyncedResults() {
+  std::vector<bool> read_by_generic(register_kinds_.size(), false);
+  for (const auto& inst : instructions_) {
+    if (inst.opcode == Opcode::GenericUnary ||
+        inst.opcode == Opcode::GenericBinary ||
+        inst.opcode == Opcode::GenericTernary) {
+      for (auto src : {inst.src0, inst.src1, inst.src2}) {
+        if (src >= 0) {
+          read_by_generic[src] = true;
+        }
+      }
+    }
+  }
+  for (auto& inst : instructions_) {
+    inst.sync = read_by_generic[inst.dest];
+  }
+}
 
-  bool src_defined =
-      (precomputed_values_.defined_[src0_index] || src0_is_const) &&
-      (precomputed_values_.defined_[src1_index] || src1_is_const) &&
-      (precomputed_values_.defined_[src2_index] || src2_is_const);
+bool ValueMachine::loadRegister(int index) {
+  const auto& value = precomputed_values_.values_[index];
+  switch (register_kinds_[index]) {
+    case RegisterKind::Int:
+      if (!value.is<int64_t>()) {
+        return false;
+      }
+      registers_[index] = value.as<int64_t>();
+      return true;
+    case RegisterKind::Bool:
+      if (!value.is<bool>()) {
+        return false;
+      }
+      registers_[index] = value.as<bool>();
+      return true;
+    case RegisterKind::Generic:
+      return true;
+  }
+  return true;
+}
 
-  if (!src_defined) {
-    return;
+PolymorphicValue ValueMachine::registerValue(int index) const {
+  if (register_kinds_[index] == RegisterKind::Bool) {
+    return PolymorphicValue(registers_[index] != 0);
   }
-  int dest_index = dest_[index];
+  return PolymorphicValue(registers_[index]);
+}
 
-  auto& a = precomputed_values_.values_[src0_index];
-  auto& b = precomputed_values_.values_[src1_index];
-  auto& c = precomputed_values_.values_[src2_index];
-  auto& dest = precomputed_values_.values_[dest_index];
+void ValueMachine::run() {
+  if (generic_only_ || !runTyped()) {
+    runGeneric();
+  }
+}
+
+bool ValueMachine::runTyped() {
+  auto& pv = precomputed_values_;
+
+  // Load the registers of bound values. Those of constants have been loaded
+  // at compile time.
+  for (const auto i : c10::irange(known_.size())) {
+    known_[i] = pv.defined_[i] || pv.is_constant_[i];
+    if (known_[i] && !pv.is_constant_[i] && !loadRegister((int)i)) {
+      return false;
+    }
+  }
 
-  switch (top_type_[index]) {
+  int64_t* regs = registers_.data();
+  const uint8_t* known = known_.data();
+  for (const auto& inst : instructions_) {
+    // Skip this instruction if the dest location
+    //  has already been computed or is constant.
+    if (known[inst.dest]) {
+      continue;
+    }
+    if (!known[inst.src0] || (inst.src1 >= 0 && !known[inst.src1]) ||
+        (inst.src2 >= 0 && !known[inst.src2])) {
+      continue;
+    }
+
+    const int64_t a = regs[inst.src0];
+    const int64_t b = inst.src1 >= 0 ? regs[inst.src1] : 0;
+    int64_t& dest = regs[inst.dest];
+    switch (inst.opcode) {
+      case Opcode::Neg:
+        dest = -a;
+        break;
+      case Opcode::Abs:
+        dest = std::abs(a);
+        break;
+      case Opcode::BitwiseNot:
+        dest = ~a;
+        break;
+      case Opcode::Set:
+        dest = a;
+        break;
+      case Opcode::ToBool:
+        dest = a != 0;
+        break;
+      case Opcode::LogicalNot:
+        dest = !a;
+        break;
+      case Opcode::Add:
+        dest = a + b;
+        break;
+      case Opcode::Sub:
+        dest = a - b;
+        break;
+      case Opcode::Mul:
+        dest = a * b;
+        break;
+      case Opcode::Div:
+        NVF_CHECK(b != 0);
+        dest = a / b;
+        break;
+      case Opcode::Mod:
+        NVF_CHECK(b != 0);
+        dest = a % b;
+        break;
+      case Opcode::CeilDiv:
+        NVF_CHECK(b != 0);
+        dest = b > 0 ? (a + b - 1) / b : (a + b + 1) / b;
+        break;
+      case Opcode::BitwiseAnd:
+        dest = a & b;
+        break;
+      case Opcode::BitwiseOr:
+        dest = a | b;
+        break;
+      case Opcode::BitwiseXor:
+        dest = a ^ b;
+        break;
+      case Opcode::Max:
+        dest = a > b ? a : b;
+        break;
+      case Opcode::Min:
+        dest = a < b ? a : b;
+        break;
+      case Opcode::Gcd:
+        dest = std::gcd(a, b);
+        break;
+      case Opcode::LT:
+        dest = a < b;
+        break;
+      case Opcode::LE:
+        dest = a <= b;
+        break;
+      case Opcode::Eq:
+        dest = a == b;
+        break;
+      case Opcode::NE:
+        dest = a != b;
+        break;
+      case Opcode::GE:
+        dest = a >= b;
+        break;
+      case Opcode::GT:
+        dest = a > b;
+        break;
+      case Opcode::LogicalAnd:
+        dest = a && b;
+        break;
+      case Opcode::LogicalOr:
+        dest = a || b;
+        break;
+      case Opcode::Where:
+        dest = a ? b : regs[inst.src2];
+        break;
+      case Opcode::Clamp:
+        dest = std::min(std::max(a, b), regs[inst.src2]);
+        break;
+      case Opcode::GenericUnary:
+      case Opcode::GenericBinary:
+      case Opcode::GenericTernary:
+        pv.values_[inst.dest] = evaluateGeneric(inst);
+        if (!loadRegister(inst.dest)) {
+          return false;
+        }
+        break;
+    }
+    if (inst.sync) {
+      pv.values_[inst.dest] = registerValue(inst.dest);
+    }
+    known_[inst.dest] = 1;
+  }
+
+  // Write results back to the workspace. Each value has a single definition,
+  // so instructions that computed a value are exactly those whose dest was
+  // not known before this run.
+  for (const auto& inst : instructions_) {
+    if (!known[inst.dest] || pv.defined_[inst.dest] ||
+        pv.is_constant_[inst.dest]) {
+      continue;
+    }
+    if (!inst.sync && inst.opcode != Opcode::GenericUnary &&
+        inst.opcode != Opcode::GenericBinary &&
+        inst.opcode != Opcode::GenericTernary) {
+      pv.values_[inst.dest] = registerValue(inst.dest);
+    }
+    pv.defined_[inst.dest] = true;
+  }
+  return true;
+}
+
+void ValueMachine::runGeneric() {
+  auto& pv = precomputed_values_;
+  auto has_value = [&pv](int index) {
+    return index < 0 || pv.defined_[index] || pv.is_constant_[index];
+  };
+  for (const auto& inst : instructions_) {
+    // Skip this instruction if the dest location
+    //  has already been computed or is constant.
+    if (pv.defined_[inst.dest] || pv.is_constant_[inst.dest]) {
+      continue;
+    }
+    if (!has_value(inst.src0) || !has_value(inst.src1) ||
+        !has_value(inst.src2)) {
+      continue;
+    }
+    pv.values_[inst.dest] = evaluateGeneric(inst);
+    pv.defined_[inst.dest] = true;
+  }
+}
+
+PolymorphicValue ValueMachine::evaluateGeneric(const Instruction& inst) const {
+  using namespace PolymorphicValue_functions;
+  const auto& values = precomputed_values_.values_;
+
+  if (inst.src1 < 0) {
+    const auto& src = values[inst.src0];
+    switch (inst.uop_type) {
+      case UnaryOpType::Neg:
+        return -src;
+      case UnaryOpType::Cast:
+        if (isFloatingPointType(inst.data_type)) {
+          return PolymorphicValue((double)src);
+        }
+        if (isIntegralType(inst.data_type)) {
+          return PolymorphicValue((int64_t)src);
+        }
+        NVF_ERROR(
+            inst.data_type == DataType::Bool,
+            "dtype not supported in evaluator: ",
+            inst.data_type);
+        return PolymorphicValue((bool)src);
+      case UnaryOpType::Abs:
+        return abs(src);
+      case UnaryOpType::LogicalNot:
+        return !src;
+      case UnaryOpType::BitwiseNot:
+        return ~src;
+      default:
+        NVF_CHECK(false, "Unexpected operator type ", inst.uop_type);
+    }
+  }
+
+  if (inst.src2 < 0) {
+    const auto& lhs = values[inst.src0];
+    const auto& rhs = values[inst.src1];
+    switch (inst.bop_type) {
+      case BinaryOpType::Add:
+        return lhs + rhs;
+      case BinaryOpType::Sub:
+        return lhs - rhs;
+      case BinaryOpType::Mul:
+        return lhs * rhs;
+      case BinaryOpType::Div:
+        NVF_CHECK(rhs != 0);
+        return lhs / rhs;
+      case BinaryOpType::Mod:
+        NVF_CHECK(rhs != 0);
+        return lhs % rhs;
+      case BinaryOpType::CeilDiv:
+        NVF_CHECK(rhs != 0);
+        return ceildiv(lhs, rhs);
+      case BinaryOpType::LogicalAnd:
+        return lhs && rhs;
+      case BinaryOpType::BitwiseAnd:
+        return lhs & rhs;
+      case BinaryOpType::LogicalOr:
+        return lhs || rhs;
+      case BinaryOpType::BitwiseOr:
+        return lhs | rhs;
+      case BinaryOpType::BitwiseXor:
+        return lhs ^ rhs;
+      case BinaryOpType::Max:
+        return lhs > rhs ? lhs : rhs;
+      case BinaryOpType::Min:
+        return lhs < rhs ? lhs : rhs;
+      case BinaryOpType::Gcd:
+        return gcd(lhs, rhs);
+      case BinaryOpType::LT:
+        return lhs < rhs;
+      case BinaryOpType::LE:
+        return lhs <= rhs;
+      case BinaryOpType::Eq:
+        return lhs == rhs;
+      case BinaryOpType::NE:
+        return lhs != rhs;
+      case BinaryOpType::GE:
+        return lhs >= rhs;
+      case BinaryOpType::GT:
+        return lhs > rhs;
+      default:
+        NVF_CHECK(false, "Unexpected operator type ", inst.bop_type);
+    }
+  }
+
+  const auto& a = values[inst.src0];
+  const auto& b = values[inst.src1];
+  const auto& c = values[inst.src2];
+  switch (inst.top_type) {
     case TernaryOpType::Clamp:
-      dest = std::min(std::max(a, b), c);
-      break;
+      return std::min(std::max(a, b), c);
     case TernaryOpType::Lerp:
       // This is the same lerp computed in helpers.cu
       // https://math.stackexchange.com/a/1798323
-      dest = (c < 0.5) ? a + c * (b - a) : b - (b - a) * (1.0 - c);
-      break;
+      return (c < 0.5) ? a + c * (b - a) : b - (b - a) * (1.0 - c);
     case TernaryOpType::Threshold:
-      dest = a <= b ? c : a;
-      break;
+      return a <= b ? c : a;
     case TernaryOpType::Where:
-      dest = a ? b : c;
-      break;
+      return a ? b : c;
     default:
-      NVF_CHECK(!"Unexpected operator type");
+      NVF_CHECK(false, "Unexpected operator type ", inst.top_type);
   }
-
-  precomputed_values_.defined_[dest_index] = true;
+  return PolymorphicValue();
 }
 
 } // namespace nvfuser
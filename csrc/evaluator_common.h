@@ -22,33 +22,113 @@ class PrecomputedValues;
 class KernelArgumentHolder;
 struct TensorArgAbstract;
 
-//! NaiveValueMachine:
-//!  This is an un-optimized runtime for evaluating a
-//!   set of values in one run. The runtime contains
-//!   a vector of instructions inferred from IR at compile-time
-//!   and it currently must be associated with an instance of
-//!   PrecomputedValues that will provide the workspace
-//!   containing the concrete values for the values.
-class NaiveValueMachine {
-  //! The generic types of instructions supported for this machine.
-  enum class InstructionType { UNARY_OP, BINARY_OP, TERNARY_OP, SET_OP };
+//! ValueMachine:
+//!  Runtime for evaluating a set of values in one run. The
+//!   runtime contains a vector of instructions inferred from
+//!   IR at compile-time and it currently must be associated
+//!   with an instance of PrecomputedValues that will provide
+//!   the workspace containing the concrete values.
+//!
+//!  Almost all precomputed values are integer index math, so
+//!   instructions whose operands and result are integral or
+//!   boolean are compiled to typed opcodes that run on a plain
+//!   int64_t register file, with one register per workspace
+//!   entry and booleans stored as 0 or 1. Only the remaining
+//!   instructions are evaluated through PolymorphicValue. If a
+//!   bound value doesn't have the type its IR node implies, the
+//!   run falls back to evaluating every instruction through
+//!   PolymorphicValue.
+class ValueMachine {
+  //! Operations of the typed fast path work on registers. The
+  //!  Generic* ones evaluate the original IR op on PolymorphicValue.
+  enum class Opcode : uint8_t {
+    // int64 -> int64
+    Neg,
+    Abs,
+    BitwiseNot,
+    // int64 or bool -> same register value
+    Set,
+    // int64 or bool -> bool
+    ToBool,
+    LogicalNot,
+    // int64 x int64 -> int64
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    CeilDiv,
+    BitwiseAnd,
+    BitwiseOr,
+    BitwiseXor,
+    Max,
+    Min,
+    Gcd,
+    // int64 or bool x int64 or bool -> bool
+    LT,
+    LE,
+    Eq,
+    NE,
+    GE,
+    GT,
+    LogicalAnd,
+    LogicalOr,
+    // bool x T x T -> T
+    Where,
+    // int64 x int64 x int64 -> int64
+    Clamp,
+    GenericUnary,
+    GenericBinary,
+    GenericTernary
+  };
+
+  //! How the value of a workspace entry is held while running
+  enum class RegisterKind : uint8_t { Int, Bool, Generic };
+
+  struct Instruction {
+    Opcode opcode = Opcode::GenericUnary;
+
+    //! IR op types, only used by the generic opcodes
+    UnaryOpType uop_type = UnaryOpType::Abs;
+    BinaryOpType bop_type = BinaryOpType::Add;
+    TernaryOpType top_type = TernaryOpType::Where;
+
+    //! Data type for unary op of type UnaryOpType::Cast
+    DataType data_type = DataType::Null;
+
+    //! Indexes of operands and destination. The indexes
+    //!  correspond to positions in the workspace where concrete
+    //!  values are hosted, and to registers.
+    int src0 = -1;
+    int src1 = -1;
+    int src2 = -1;
+    int dest = -1;
+
+    //! Result of a typed opcode that is read by a generic
+    //!  opcode, so it has to be written to the workspace
+    //!  right away.
+    bool sync = false;
+  };
 
  public:
   //! Constructor lowers all the expr IR nodes stored in precomputed_values
   //!  and stores them in the private state.
-  NaiveValueMachine(PrecomputedValues& precomputed_values);
+  ValueMachine(PrecomputedValues& precomputed_values);
 
   //! Copy all values other than `precomputed_values_` from other
   //! This would be better implemented as a copy constructor, except that would
   //! also presumably bind precomputed_values_ which we could not then rebind,
   //! as we need to during cloning.
-  void copyFrom(const NaiveValueMachine& other);
+  void copyFrom(const ValueMachine& other);
 
   //! Runs all the instructions and write results to the associated
   //!  precomputed_values.
   void run();
 
  private:
+  //! Register kind implied by the data type of val
+  static RegisterKind registerKindOf(const Val* val);
+
   //! Convert an unary IR expr to an instruction
   void makeUnaryOp(UnaryOp* uop);
 
@@ -58,23 +138,28 @@ class NaiveValueMachine {
   //! Convert an ternary IR expr to an instruction
   void makeTernaryOp(TernaryOp* bop);
 
-  //! Create an empty instruction with all default values
-  //!  and place it at the end of the instruction buffer.
-  int makeInstructionEntry();
+  //! Marks results of typed instructions that are read by
+  //!  generic instructions.
+  void markSyncedResults();
+
+  //! Runs all instructions on the register file. Returns false,
+  //!  without having modified the workspace flags, if a value
+  //!  doesn't have the type its register expects.
+  bool runTyped();
 
-  //! Run a single instruction at the given index of
-  //!  the instruction buffer. Decodes and dispatches
-  //!  to the corresponding instruction handle functions.
-  void runInstruction(int index);
+  //! Runs all instructions through PolymorphicValue
+  void runGeneric();
 
-  //! Runs a unary operation at given index of instruction buffer
-  void runUnaryOp(int index);
+  //! Evaluates a generic instruction, or the IR op of a typed
+  //!  one, through PolymorphicValue.
+  PolymorphicValue evaluateGeneric(const Instruction& inst) const;
 
-  //! Runs a binary operation at given index of instruction buffer
-  void runBinaryOp(int index);
+  //! Load the workspace value at index into its register.
+  //!  Returns false if it doesn't have the expected type.
+  bool loadRegister(int index);
 
-  //! Runs a ternary operation at given index of instruction buffer
-  void runTernaryOp(int index);
+  //! Returns the PolymorphicValue held by the register at index
+  PolymorphicValue registerValue(int index) const;
 
  private:
   friend PrecomputedValues;
@@ -84,50 +169,22 @@ class NaiveValueMachine {
   //!   values in this workspace.
   PrecomputedValues& precomputed_values_;
 
-  //! Instruction buffer. All states are in separate vectors and
-  //!  the entry of each vector at the same index correspond to
-  //!  the same instruction.
-
-  //! Total number of instructions
-  int num_of_instructions_ = 0;
-
-  //! Machine instruction type for each instruction i.e.
-  //!  unary or binary
-  std::vector<InstructionType> inst_type_;
-
-  //! Unary operator type if applicable, contains a default
-  //!  value at each index corresponding to a binary op.
-  std::vector<UnaryOpType> uop_type_;
-
-  //! Data type for unary op of type UnaryOpType::Cast, contains a default
-  //!  value at each index corresponding other ops.
-  std::vector<DataType> data_type_;
-
-  //! Binary operator type if applicable, contains a default
-  //!  value at each index corresponding to a binary op.
-  std::vector<BinaryOpType> bop_type_;
-
-  //! Ternary operator type if applicable, contains a default
-  //!  value at each index corresponding to a ternary op.
-  std::vector<TernaryOpType> top_type_;
-
-  //! Indexes of operands and destination of each instruction.
-  //!  The indexes corresponds to positions in the workspace
-  //!  where concrete values are hosted.
+  //! Instruction buffer, in evaluation order
+  std::vector<Instruction> instructions_;
 
-  //! Operand 0 of each instruction.
-  std::vector<int> src0_;
+  //! Register kind of each workspace entry
+  std::vector<RegisterKind> register_kinds_;
 
-  //! Operand 1 of each instruction, a default value at
-  //!  each index corresponding to a unary op.
-  std::vector<int> src1_;
+  //! Register file, one register per workspace entry. Registers of
+  //!  constants are loaded at compile time.
+  std::vector<int64_t> registers_;
 
-  //! Operand 2 of each instruction, a default value at
-  //!  each index corresponding to a unary or binary op.
-  std::vector<int> src2_;
+  //! Whether each workspace entry is bound or computed in the
+  //!  current run.
+  std::vector<uint8_t> known_;
 
-  //! Destination of each instruction.
-  std::vector<int> dest_;
+  //! Set if DisableOption::TypedValueMachine was given at compile time
+  bool generic_only_ = false;
 };
 
 //! PrecomputedValues:
@@ -223,8 +280,8 @@ class PrecomputedValues {
 
   //! Initialize the value runtime that will
   //!  infer instructions from the workspace.
-  void initializeIntegerMachine() {
-    value_machine_ = std::make_unique<NaiveValueMachine>(*this);
+  void initializeValueMachine() {
+    value_machine_ = std::make_unique<ValueMachine>(*this);
   }
 
   bool hasValidValues() {
@@ -251,7 +308,7 @@ class PrecomputedValues {
   void bindTensorMetaData(TensorView* tv, const at::Tensor& tensor);
 
  private:
-  friend NaiveValueMachine;
+  friend ValueMachine;
 
   //! Marks if an evaluation has finished
   bool has_valid_values_ = false;
@@ -282,8 +339,8 @@ class PrecomputedValues {
   //!  consistency check.
   std::vector<std::pair<int, PolymorphicValue>> binding_log_;
 
-  //! Integer runtime for realizing the values computations.
-  std::unique_ptr<NaiveValueMachine> value_machine_;
+  //! Runtime for realizing the values computations.
+  std::unique_ptr<ValueMachine> value_machine_;
 };
 
 } // namespace nvfuser
@@ -35,7 +35,9 @@
 #include <c10/util/irange.h>
 
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <memory>
 
 namespace nvfuser {
 
@@ -921,14 +923,64 @@ int64_t IndexOfFusionInput(const Val* in, const Fusion* fusion) {
   return std::distance(fusion->inputs().begin(), i);
 }
 
-// Returns the at::Tensor allocated for `out_info`.
+// Returns the number of bytes between the first and the last element of a
+// tensor with the given sizes and strides, both included.
+int64_t spannedBytes(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides,
+    at::ScalarType type) {
+  int64_t span = 1;
+  for (const auto i : c10::irange(sizes.size())) {
+    if (sizes[i] == 0) {
+      return 0;
+    }
+    span += (sizes[i] - 1) * strides[i];
+  }
+  return span * (int64_t)c10::elementSize(type);
+}
+
+std::vector<int64_t> contiguousStrides(const std::vector<int64_t>& sizes) {
+  std::vector<int64_t> strides(sizes.size(), 1);
+  for (int64_t i = (int64_t)sizes.size() - 2; i >= 0; --i) {
+    strides[i] = strides[i + 1] * std::max(sizes[i + 1], (int64_t)1);
+  }
+  return strides;
+}
+
+// Returns a tensor with the given sizes and strides that lives at offset in
+// workspace, or an undefined tensor if the buffer is not placed or does not
+// fit in the planned capacity.
+at::Tensor placeInWorkspace(
+    const at::Tensor& workspace,
+    int64_t offset,
+    int64_t capacity,
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides,
+    at::ScalarType type) {
+  if (offset < 0 || spannedBytes(sizes, strides, type) > capacity) {
+    return at::Tensor();
+  }
+  const auto element_size = (int64_t)c10::elementSize(type);
+  NVF_ERROR(
+      offset % element_size == 0 &&
+          workspace.numel() % element_size == 0 &&
+          offset + capacity <= workspace.numel(),
+      "Invalid workspace placement at offset ",
+      offset);
+  return workspace.view(type).as_strided(
+      sizes, strides, offset / element_size);
+}
+
+// Returns the at::Tensor allocated for `out_info`. If placed_tensor is
+// defined, it is used instead of a fresh allocation.
 at::Tensor allocateOutput(
     const FusionExecutor::GlobalBufferInfo& out_info,
     Val* aliased_in,
     const AliasInfo* alias_info,
     const at::Tensor& aliased_in_tensor,
     const c10::Device& device,
-    ExpressionEvaluator& ee) {
+    ExpressionEvaluator& ee,
+    const at::Tensor& placed_tensor = at::Tensor()) {
   TensorView* out_tv = out_info.tv;
 
   // Note: aliased output is not returned as output. But we still need it
@@ -958,13 +1010,15 @@ at::Tensor allocateOutput(
     }
   }
 
-  auto alloc_tensor = at::native::empty_strided_cuda(
-      out_info.sizes,
-      out_info.strides,
-      out_info.type,
-      c10::nullopt,
-      device,
-      c10::nullopt);
+  auto alloc_tensor = placed_tensor.defined()
+      ? placed_tensor
+      : at::native::empty_strided_cuda(
+            out_info.sizes,
+            out_info.strides,
+            out_info.type,
+            c10::nullopt,
+            device,
+            c10::nullopt);
   if (shouldFillAllocationWithNan()) {
     fillTensorWithNan(alloc_tensor);
   }
@@ -976,13 +1030,15 @@ at::Tensor allocateOutput(
 }
 
 // Allocate output tensors for a given kernel. Outputs may alias inputs, in
-// that case output tensors are shallow copies of the aliased inputs
+// that case output tensors are shallow copies of the aliased inputs. Outputs
+// given a place in the workspace of placement are created there.
 std::vector<at::Tensor> allocateOutputs(
     const kir::Kernel* kernel,
     const std::vector<FusionExecutor::GlobalBufferInfo>& output_info,
     const KernelArgumentHolder& inputs,
     const c10::Device& device,
-    ExpressionEvaluator& ee) {
+    ExpressionEvaluator& ee,
+    const FusionExecutor::WorkspacePlacement* placement = nullptr) {
   FUSER_PERF_SCOPE("allocateOutputs");
 
   std::vector<at::Tensor> outputs;
@@ -1000,13 +1056,26 @@ std::vector<at::Tensor> allocateOutputs(
           PolymorphicValue_functions::toString(aliased_in_val));
       aliased_in_tensor = aliased_in_val.as<at::Tensor>();
     }
+    at::Tensor placed_tensor;
+    if (placement != nullptr && aliased_in == nullptr &&
+        output_idx < placement->output_offsets.size()) {
+      const auto& info = output_info[output_idx];
+      placed_tensor = placeInWorkspace(
+          placement->workspace,
+          placement->output_offsets.at(output_idx),
+          placement->output_capacities.at(output_idx),
+          info.sizes,
+          info.strides,
+          info.type);
+    }
     outputs.push_back(allocateOutput(
         output_info[output_idx],
         aliased_in,
         alias_info,
         aliased_in_tensor,
         device,
-        ee));
+        ee,
+        placed_tensor));
   }
   return outputs;
 }
@@ -1496,6 +1565,123 @@ void FusionExecutor::initializeExecutorEntry(
   executor_entry.init = true;
 }
 
+namespace {
+
+// Alignment of each parameter in the kernel parameter buffer. This is the
+// largest alignment of any kernel parameter type, e.g. complex double.
+constexpr size_t kParameterAlignment = 16;
+
+} // namespace
+
+void FusionExecutor::computeArgs(
+    ExecutorEntry& executor_entry,
+    ExpressionEvaluator& expr_eval,
+    const KernelArgumentHolder& args,
+    std::vector<std::byte>& args_buffer,
+    std::vector<void*>& arg_ptrs) const {
+  FUSER_PERF_SCOPE("FusionExecutor::computeArgs");
+  const auto& params = kernel()->parameters();
+  const PrimDataType index_type = kernel()->indexType();
+
+  // Fast path: the layout is known, so patch what may have changed in a copy
+  // of it. Other threads may be launching with the same entry.
+  auto layout = std::atomic_load(&executor_entry.parameter_layout);
+  if (layout != nullptr && layout->slots.size() == params.size() &&
+      !params.empty()) {
+    args_buffer = layout->buffer;
+    bool layout_changed = false;
+    for (const auto i : c10::irange(params.size())) {
+      const auto& slot = layout->slots[i];
+      std::byte* dst = args_buffer.data() + slot.offset;
+      if (slot.arg_index >= 0) {
+        const auto& tensor = args[slot.arg_index]->as<at::Tensor>();
+        if (tensor.sizes().equals(slot.sizes) &&
+            tensor.strides().equals(slot.strides)) {
+          // Only the data pointer, which leads the tensor metadata, differs
+          void* data = tensor.data_ptr();
+          std::memcpy(dst, &data, sizeof(void*));
+          continue;
+        }
+      }
+      auto bytes = getKernelArgument(expr_eval, params[i], index_type);
+      if (bytes.size() != slot.size) {
+        layout_changed = true;
+        break;
+      }
+      std::memcpy(dst, bytes.data(), bytes.size());
+    }
+    if (!layout_changed) {
+      arg_ptrs.clear();
+      for (const auto& slot : layout->slots) {
+        arg_ptrs.push_back(args_buffer.data() + slot.offset);
+      }
+      return;
+    }
+  }
+
+  // Lay out the buffer from scratch. Parameters that are tensors bound
+  // directly to an argument are recorded so that later launches can patch
+  // their data pointer only.
+  std::unordered_map<Val*, int64_t> tensor_arg_index;
+  const auto& inputs = kernel()->inputs();
+  const auto& outputs = kernel()->outputs();
+  const auto& global_allocations = kernel()->summary().global_allocations;
+  for (const auto i : c10::irange(inputs.size())) {
+    tensor_arg_index.emplace(inputs[i], i);
+  }
+  for (const auto i : c10::irange(outputs.size())) {
+    tensor_arg_index.emplace(outputs[i], inputs.size() + i);
+  }
+  for (const auto i : c10::irange(global_allocations.size())) {
+    tensor_arg_index.emplace(
+        global_allocations[i]->buffer(), inputs.size() + outputs.size() + i);
+  }
+
+  auto new_layout = std::make_shared<ExecutorEntry::ParameterLayout>();
+  auto& slots = new_layout->slots;
+  std::vector<std::vector<std::byte>> arg_buffers;
+  arg_buffers.reserve(params.size());
+  slots.reserve(params.size());
+  size_t buffer_size = 0;
+  for (auto param : params) {
+    arg_buffers.emplace_back(getKernelArgument(expr_eval, param, index_type));
+    ExecutorEntry::ParameterSlot slot;
+    slot.offset = buffer_size;
+    slot.size = arg_buffers.back().size();
+    auto tv = dynamic_cast<TensorView*>(param);
+    auto it = tensor_arg_index.find(param);
+    if (tv != nullptr && !tv->isCpuScalar() && it != tensor_arg_index.end() &&
+        it->second < (int64_t)args.size() &&
+        args[it->second]->is<at::Tensor>()) {
+      const auto& tensor = args[it->second]->as<at::Tensor>();
+      slot.arg_index = it->second;
+      slot.sizes = tensor.sizes().vec();
+      slot.strides = tensor.strides().vec();
+    }
+    buffer_size += (slot.size + kParameterAlignment - 1) /
+        kParameterAlignment * kParameterAlignment;
+    slots.push_back(std::move(slot));
+  }
+
+  new_layout->buffer.assign(buffer_size, std::byte{0});
+  for (const auto i : c10::irange(params.size())) {
+    std::memcpy(
+        new_layout->buffer.data() + slots[i].offset,
+        arg_buffers[i].data(),
+        arg_buffers[i].size());
+  }
+  args_buffer = new_layout->buffer;
+  arg_ptrs.clear();
+  for (const auto& slot : slots) {
+    arg_ptrs.push_back(args_buffer.data() + slot.offset);
+  }
+  // A concurrent launch may publish its own layout too. Either one is valid.
+  std::atomic_store(
+      &executor_entry.parameter_layout,
+      std::shared_ptr<const ExecutorEntry::ParameterLayout>(
+          std::move(new_layout)));
+}
+
 void FusionExecutor::recompileKernel(
     const LaunchParams& new_launch_params,
     const CompileParams& new_compile_params) {
@@ -1596,7 +1782,8 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     KernelArgumentHolder& args,
     const LaunchParams& launch_constraints,
     CompileParams compile_params,
-    std::vector<at::Tensor> outputs) {
+    std::vector<at::Tensor> outputs,
+    const WorkspacePlacement* placement) {
   FUSER_PERF_SCOPE("FusionExecutor::runFusion");
   NVF_ERROR(isCompiled());
   NVF_ERROR(validKernelId(), "Invalid kernel id for FusionExecutor.");
@@ -1667,7 +1854,12 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   // only allocate outputs when not given
   if (outputs.empty()) {
     outputs = allocateOutputs(
-        kernel(), executor_entry->outputs, args, options_.device, expr_eval);
+        kernel(),
+        executor_entry->outputs,
+        args,
+        options_.device,
+        expr_eval,
+        placement);
   } else {
     // TODO: Use validateKernelOutputs
     NVF_ERROR(
@@ -1696,7 +1888,23 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     for (const auto i : c10::irange(executor_entry->intermediates.size())) {
       const auto& buf_info = executor_entry->intermediates.at(i);
       at::Tensor intermediate_buffer;
-      if (buf_info.zero_init) {
+      if (placement != nullptr && !buf_info.is_profile_buffer &&
+          i < placement->intermediate_offsets.size()) {
+        intermediate_buffer = placeInWorkspace(
+            placement->workspace,
+            placement->intermediate_offsets.at(i),
+            placement->intermediate_capacities.at(i),
+            buf_info.sizes,
+            contiguousStrides(buf_info.sizes),
+            buf_info.type);
+      }
+      if (intermediate_buffer.defined()) {
+        if (buf_info.zero_init) {
+          intermediate_buffer.zero_();
+        } else if (shouldFillAllocationWithNan()) {
+          fillTensorWithNan(intermediate_buffer);
+        }
+      } else if (buf_info.zero_init) {
         intermediate_buffer = at::zeros(
             buf_info.sizes,
             at::TensorOptions().dtype(buf_info.type).device(options_.device));
@@ -1722,15 +1930,12 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     }
   }
 
-  std::vector<std::vector<std::byte>> arg_buffers;
-  {
-    FUSER_PERF_SCOPE("ExecutorRunFusion::GetArgsBuffers");
-    arg_buffers.reserve(kernel()->parameters().size());
-    for (auto v : kernel()->parameters()) {
-      arg_buffers.emplace_back(
-          getKernelArgument(expr_eval, v, kernel()->indexType()));
-    }
-  }
+  // The packed parameters belong to this launch only, since other threads
+  // may launch with the same entry. They are copied by cuLaunchKernel, so the
+  // buffers of the thread are reused.
+  thread_local std::vector<std::byte> args_buffer;
+  thread_local std::vector<void*> arg_ptrs;
+  computeArgs(*executor_entry, expr_eval, args, args_buffer, arg_ptrs);
 
   if (isDebugDumpEnabled(DebugDumpOption::LaunchParam)) {
     launch_params_.print();
@@ -1759,12 +1964,6 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   if (execute_kernel_) {
     ensureAvailableDynamicSmemSize(executor_entry->launch_params.smem());
 
-    std::vector<void*> arg_buffer_ptrs;
-    arg_buffer_ptrs.reserve(arg_buffers.size());
-    for (auto& arg_buffer : arg_buffers) {
-      arg_buffer_ptrs.push_back(arg_buffer.data());
-    }
-
     if (isDebugDumpEnabled(DebugDumpOption::Occupancy) ||
         isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
       int blocks_per_sm = -1;
@@ -1804,7 +2003,7 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
           launch_params_.bdimz(),
           launch_params_.smem(),
           stream,
-          arg_buffer_ptrs.data(),
+          arg_ptrs.data(),
           nullptr));
     } else {
       FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchCooperativeKernel");
@@ -1818,7 +2017,7 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
           launch_params_.bdimz(),
           launch_params_.smem(),
           stream,
-          arg_buffer_ptrs.data()));
+          arg_ptrs.data()));
     }
 
     if (measure_kernel_time) {
@@ -2157,6 +2356,10 @@ void FusionExecutor::deserialize(
   compile_params.maxrregcount = maxrregcount_high_water_mark_;
 
   // Get lowered fusion
+  // TODO: Serialize the kernel IR bound and evaluated at launch, i.e. the
+  // kernel parameters, global allocations and launch parameter expressions,
+  // so that a cache hit doesn't need to schedule and lower the fusion again.
+  // See "Known limitations" in serde/Serde.md.
   lowered_ = std::make_unique<GpuLower>(fusion, compile_params);
   lowered_->run();
 
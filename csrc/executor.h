@@ -45,6 +45,19 @@ class FusionExecutor : public NonCopyable {
     bool is_profile_buffer = false;
   };
 
+  //! Placement of the global buffers of a launch in a caller-owned workspace,
+  //! see FusionKernelRuntime::planWorkspace. Offsets and capacities are in
+  //! bytes and indexed like the kernel outputs and the intermediates of the
+  //! executor entry. An offset of -1 means the buffer is allocated as usual,
+  //! as does a buffer that turns out to be larger than its capacity.
+  struct WorkspacePlacement {
+    at::Tensor workspace;
+    std::vector<int64_t> output_offsets;
+    std::vector<int64_t> output_capacities;
+    std::vector<int64_t> intermediate_offsets;
+    std::vector<int64_t> intermediate_capacities;
+  };
+
   // Unsafe compilation that's useful for debugging kernels, iterating over
   // slight modifications of a generated kernel
   void debugCompileFusionFromStr(
@@ -117,7 +130,8 @@ class FusionExecutor : public NonCopyable {
       KernelArgumentHolder& args,
       const LaunchParams& launch_constraints = LaunchParams(),
       CompileParams compile_params = CompileParams(),
-      std::vector<at::Tensor> outputs = {});
+      std::vector<at::Tensor> outputs = {},
+      const WorkspacePlacement* placement = nullptr);
 
   std::vector<at::Tensor> runFusion(
       const at::ArrayRef<c10::IValue>& inputs,
@@ -160,6 +174,18 @@ class FusionExecutor : public NonCopyable {
     executor_entry_lookup_.erase(cache_id);
   }
 
+  //! Returns the temporary and intermediate global buffers allocated by
+  //! launches with the given input cache id, or nullptr if the kernel has
+  //! not been launched with it yet.
+  const std::vector<GlobalBufferInfo>* intermediateBufferInfo(
+      size_t cache_id) const {
+    auto it = executor_entry_lookup_.find(cache_id);
+    if (it == executor_entry_lookup_.end() || !it->second.init) {
+      return nullptr;
+    }
+    return &it->second.intermediates;
+  }
+
   // struct used to hold necessary information to launch compiled kernel on a
   // given input set.
   //
@@ -172,6 +198,30 @@ class FusionExecutor : public NonCopyable {
     std::vector<GlobalBufferInfo> outputs;
     // Temporary work buffers and intemediate global-memory tensors
     std::vector<GlobalBufferInfo> intermediates;
+
+    // Location of a kernel parameter in ParameterLayout::buffer
+    struct ParameterSlot {
+      size_t offset = 0;
+      size_t size = 0;
+      // Index of the tensor argument this parameter is bound to, or -1 if
+      // the parameter has to be evaluated
+      int64_t arg_index = -1;
+      // Sizes and strides of the tensor the buffer was packed with
+      std::vector<int64_t> sizes;
+      std::vector<int64_t> strides;
+    };
+
+    // Kernel parameters packed back to back, as laid out on the first launch
+    // with this entry. A layout is never modified once published, so that
+    // concurrent launches can share it.
+    struct ParameterLayout {
+      std::vector<std::byte> buffer;
+      std::vector<ParameterSlot> slots;
+    };
+
+    // Accessed with std::atomic_load and std::atomic_store. See
+    // FusionExecutor::computeArgs.
+    std::shared_ptr<const ParameterLayout> parameter_layout;
   };
 
   using ExecutorCompileTimeInfoCache =
@@ -416,6 +466,18 @@ class FusionExecutor : public NonCopyable {
       const std::vector<at::Tensor>& outputs,
       DataType index_type);
 
+  //! Pack the kernel parameters of a launch in args_buffer and point arg_ptrs
+  //! to each of them. The parameter layout of executor_entry is made on first
+  //! use. Afterwards, args_buffer starts as a copy of it, tensor parameters
+  //! whose sizes and strides are unchanged only get their data pointer
+  //! patched, and other parameters are re-evaluated.
+  void computeArgs(
+      ExecutorEntry& executor_entry,
+      ExpressionEvaluator& expr_eval,
+      const KernelArgumentHolder& args,
+      std::vector<std::byte>& args_buffer,
+      std::vector<void*>& arg_ptrs) const;
+
   std::unique_ptr<PrecomputedValues>& evaluatorPrecomputedValues();
 
   // Recompile the kernel if the number of threads in the block has increased
@@ -72,6 +72,43 @@ PrimDataType getSmallestIndexType(const at::Tensor& tensor) {
 
 } // namespace
 
+KernelArgumentHolder::KernelArgumentHolder(const KernelArgumentHolder& other)
+    : device_index_(other.device_index_), cache_id_(other.cache_id_) {
+  arguments_.reserve(other.size());
+  for (const auto arg : other.arguments_) {
+    push(*arg);
+  }
+}
+
+KernelArgumentHolder& KernelArgumentHolder::operator=(
+    const KernelArgumentHolder& other) {
+  if (this == &other) {
+    return *this;
+  }
+  // Build the copy first in case other holds views into this holder
+  KernelArgumentHolder copy(other);
+  *this = std::move(copy);
+  return *this;
+}
+
+const PolymorphicValue* KernelArgumentHolder::allocate(PolymorphicValue val) {
+  if (num_allocated_ >= blocks_.size() * kBlockSize) {
+    blocks_.push_back(std::make_unique<Block>());
+    num_allocated_ = (blocks_.size() - 1) * kBlockSize;
+  }
+  PolymorphicValue& slot =
+      (*blocks_[num_allocated_ / kBlockSize])[num_allocated_ % kBlockSize];
+  ++num_allocated_;
+  slot = std::move(val);
+  return &slot;
+}
+
+bool KernelArgumentHolder::owns(const PolymorphicValue* val) const {
+  return std::any_of(blocks_.begin(), blocks_.end(), [&](const auto& block) {
+    return val >= block->data() && val < block->data() + kBlockSize;
+  });
+}
+
 void KernelArgumentHolder::push(const c10::ArrayRef<c10::IValue>& args) {
   // Naive I/O setup, I'm ignoring all the potential transformation (i.e. I/O
   // allocated here from the subgraph could be, and very likely are, different
@@ -88,23 +125,25 @@ void KernelArgumentHolder::push(const std::vector<at::Tensor>& tensors) {
 }
 
 void KernelArgumentHolder::erase(const PolymorphicValue* arg_to_delete) {
-  auto iter = std::remove_if(
-      arguments_.begin(), arguments_.end(), [&](const auto& ref) {
-        return arg_to_delete == ref.get();
-      });
+  auto iter = std::remove(arguments_.begin(), arguments_.end(), arg_to_delete);
   arguments_.erase(iter, arguments_.end());
+  // Release the value right away so erased tensors do not hold on to memory.
+  // The slot itself is not reused.
+  if (owns(arg_to_delete)) {
+    *const_cast<PolymorphicValue*>(arg_to_delete) = std::monostate{};
+  }
 }
 
 std::string KernelArgumentHolder::toString() const {
   std::stringstream ss;
-  for (const auto& arg : arguments_) {
+  for (const auto arg : arguments_) {
     ss << *arg << "\n";
   }
   return ss.str();
 }
 
 PrimDataType KernelArgumentHolder::getSmallestIndexTypeOfArguments() const {
-  for (const auto& arg : arguments_) {
+  for (const auto arg : arguments_) {
     if (arg->is<at::Tensor>()) {
       if (getSmallestIndexType(arg->as<at::Tensor>()) == PrimDataType::Int) {
         return PrimDataType::Int;
@@ -138,8 +177,8 @@ flatbuffers::Offset<serde::KernelArgumentHolder> KernelArgumentHolder::
 
   std::vector<fb_poly_value> arguments_fb;
   arguments_fb.reserve(arguments_.size());
-  for (auto& arg : arguments_) {
-    arguments_fb.push_back(serde::serializePolymorphicValue(builder, arg));
+  for (const auto arg : arguments_) {
+    arguments_fb.push_back(serde::serializePolymorphicValue(builder, *arg));
   }
 
   return serde::CreateKernelArgumentHolderDirect(
@@ -9,6 +9,7 @@
 
 #include <ATen/core/ivalue.h>
 #include <c10/util/Exception.h>
+#include <c10/util/SmallVector.h>
 #include <exceptions.h>
 #include <expr_evaluator.h>
 #include <ir/all_nodes.h>
@@ -16,7 +17,9 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <type.h>
 
+#include <array>
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -27,6 +30,14 @@ namespace nvfuser {
 //! for both compilation as well as kernel execution. The important thing is to
 //! strip ownership of tensor from KernelArgumentHolder, so that during async
 //! compilation, we are not unnecessarily holding memory that is not needed.
+//!
+//! Arguments owned by the holder are stored in fixed-size blocks that never
+//! move, so pointers returned by operator[] and back() stay valid until the
+//! argument is erased, and pushing an argument does not allocate except when a
+//! new block is needed. A holder can also refer to arguments owned by another
+//! holder through pushView, which is how per-segment inputs are gathered
+//! without copying. Copying a holder always produces one that owns all of its
+//! arguments, so copies are safe to hand to other threads.
 class KernelArgumentHolder {
  public:
   static KernelArgumentHolder createKernelArgumentHolder(
@@ -35,7 +46,13 @@ class KernelArgumentHolder {
 
   KernelArgumentHolder() = default;
 
-  KernelArgumentHolder(const KernelArgumentHolder& self) = default;
+  KernelArgumentHolder(const KernelArgumentHolder& other);
+
+  KernelArgumentHolder& operator=(const KernelArgumentHolder& other);
+
+  KernelArgumentHolder(KernelArgumentHolder&& other) = default;
+
+  KernelArgumentHolder& operator=(KernelArgumentHolder&& other) = default;
 
   //! Computes the smallest index type for the currently held
   //! arguments. It does not consider any other tensors used in a kernel.
@@ -54,27 +71,29 @@ class KernelArgumentHolder {
   void erase(const PolymorphicValue* arg_to_delete);
 
   void push(PolymorphicValue val) {
-    arguments_.push_back(std::make_shared<PolymorphicValue>(std::move(val)));
+    arguments_.push_back(allocate(std::move(val)));
+  }
+
+  //! Push an argument owned by someone else without copying it. The argument
+  //! must outlive this holder.
+  void pushView(const PolymorphicValue* val) {
+    arguments_.push_back(val);
   }
 
-  PolymorphicValue* back() {
-    return arguments_.back().get();
+  const PolymorphicValue* back() const {
+    return arguments_.back();
   }
 
-  PolymorphicValue* operator[](size_t ind) const {
-    return arguments_.at(ind).get();
+  const PolymorphicValue* operator[](size_t ind) const {
+    return arguments_.at(ind);
   };
 
   auto cbegin() const {
-    return arguments_.cbegin();
+    return arguments_.begin();
   }
 
   auto cend() const {
-    return arguments_.cend();
-  }
-
-  auto getBackInserter() {
-    return std::back_inserter(arguments_);
+    return arguments_.end();
   }
 
   size_t size() const {
@@ -85,6 +104,10 @@ class KernelArgumentHolder {
     return arguments_.empty();
   }
 
+  void reserve(size_t size) {
+    arguments_.reserve(size);
+  }
+
   void setDeviceIndex(int8_t index) {
     device_index_ = index;
   }
@@ -111,7 +134,29 @@ class KernelArgumentHolder {
   void deserialize(const serde::KernelArgumentHolder* buffer);
 
  private:
-  std::vector<std::shared_ptr<PolymorphicValue>> arguments_;
+  //! Number of arguments per storage block. Most kernels take fewer arguments
+  //! than this, so a holder usually needs a single block.
+  static constexpr size_t kBlockSize = 16;
+
+  using Block = std::array<PolymorphicValue, kBlockSize>;
+
+  //! Move val into the next free slot of the storage blocks
+  const PolymorphicValue* allocate(PolymorphicValue val);
+
+  //! Returns true if val lives in one of the storage blocks of this holder
+  bool owns(const PolymorphicValue* val) const;
+
+ private:
+  //! Arguments in order. Each points either into blocks_ or into storage
+  //! owned by another holder (see pushView).
+  c10::SmallVector<const PolymorphicValue*, kBlockSize> arguments_;
+
+  //! Storage for arguments owned by this holder. Slots are handed out in
+  //! order and are not reused after an erase.
+  c10::SmallVector<std::unique_ptr<Block>, 2> blocks_;
+
+  //! Number of slots handed out from blocks_
+  size_t num_allocated_ = 0;
 
   int8_t device_index_ = 0;
   std::optional<size_t> cache_id_ = std::nullopt;
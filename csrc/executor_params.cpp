@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <debug.h>
+#include <device_descriptor.h>
 #include <executor_params.h>
 
 #include <ATen/cuda/CUDAContext.h>
@@ -16,8 +17,7 @@ void LaunchParams::assertValid() {
   NVF_ERROR(
       bdimx() * bdimy() * bdimz() > 0 &&
           bdimx() * bdimy() * bdimz() <=
-              (int64_t)at::cuda::getCurrentDeviceProperties()
-                  ->maxThreadsPerMultiProcessor,
+              getTargetDevice()->max_threads_per_multi_processor,
       "Selected invalid number of threads for cuda: ",
       bdimx() * bdimy() * bdimz());
   NVF_ERROR(
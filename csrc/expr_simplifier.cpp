@@ -151,6 +151,15 @@ Val* flatten(Val* value);
 
 namespace {
 
+// a->sameAs(b), skipping the recursive comparison when the structural hashes
+// of the container differ
+bool hashedSameAs(Val* a, Val* b) {
+  if (a->container() != b->container()) {
+    return a->sameAs(b);
+  }
+  return a->container()->scalarHashConsTable().sameAs(a, b);
+}
+
 // An ordered mapping of variable -> VarInfo
 class Context {
  public:
@@ -1161,7 +1170,7 @@ Val* divideFactorized(Val* x, Val* y) {
   for (auto yf : y_factors.second) {
     auto it = std::find_if(
         x_factors.second.begin(), x_factors.second.end(), [yf](Val* v) {
-          return v->sameAs(yf);
+          return hashedSameAs(v, yf);
         });
     if (it == x_factors.second.end()) {
       // not divisible
@@ -1208,7 +1217,7 @@ Val* greatestCommonDivisor(const std::vector<Val*>& inputs) {
       for (auto f : (*common_symbolic_factors)) {
         auto it = std::find_if(
             factors.second.begin(), factors.second.end(), [f](Val* v) {
-              return v->sameAs(f);
+              return hashedSameAs(v, f);
             });
         if (it != factors.second.end()) {
           new_common_symbolic_factors.emplace_back(f);
@@ -1687,7 +1696,7 @@ namespace rules {
 // pointers to find variables, without canonicalization, this finding will fail.
 Val* canonicalizeVariables(Val* value, const Context& context) {
   for (auto v : context.variableOrder()) {
-    if (v->sameAs(value)) {
+    if (hashedSameAs(v, value)) {
       return v;
     }
   }
@@ -1741,7 +1750,7 @@ Val* eliminateTrivialComputation(Val* value, const Context& context) {
           if (remove.count(idx) || remove.count(idx2)) {
             continue;
           }
-          if (inp->sameAs(inv)) {
+          if (hashedSameAs(inp, inv)) {
             remove.emplace(idx);
             remove.emplace(idx2);
           }
@@ -1811,7 +1820,7 @@ Val* eliminateTrivialComputation(Val* value, const Context& context) {
         for (auto v : fop->inputs()) {
           bool found_dup = false;
           for (auto v2 : dedup_input) {
-            if (v->sameAs(v2)) {
+            if (hashedSameAs(v, v2)) {
               found_dup = true;
               break;
             }
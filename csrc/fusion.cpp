@@ -22,6 +22,7 @@
 #include <kernel.h>
 #include <ops/arith.h>
 
+#include <atomic>
 #include <iterator>
 
 namespace nvfuser {
@@ -58,6 +59,9 @@ void swap(Fusion& a, Fusion& b) noexcept {
   swap(a.io_alias_, b.io_alias_);
   swap(a.permuted_input_map_, b.permuted_input_map_);
   swap(a.permuted_output_map_, b.permuted_output_map_);
+
+  swap(a.exprs_cache_, b.exprs_cache_);
+  swap(a.exprs_cache_vals_, b.exprs_cache_vals_);
 }
 
 std::unique_ptr<SegmentedFusion> Fusion::segment(
@@ -117,6 +121,55 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
   return ir_cloner;
 }
 
+IrCloner Fusion::copySubgraph(
+    Fusion* from,
+    Fusion* to,
+    const std::vector<Val*>& inputs,
+    const std::vector<Val*>& outputs) {
+  FUSER_PERF_SCOPE("Fusion::copySubgraph");
+  to->clear();
+  IrCloner ir_cloner(to);
+
+  // Cloning an expression registers it with the new fusion, which sets the
+  // definitions of its outputs and the uses of its inputs, so only the
+  // statements in the subgraph end up connected.
+  auto stmts = StmtSort::getStmtsBetween(
+      from,
+      inputs,
+      outputs,
+      /*traverse_members=*/true,
+      /*traverse_attributes=*/true,
+      /*traverse_siblings=*/true);
+  for (auto inp : inputs) {
+    ir_cloner.clone(inp);
+  }
+  for (auto stmt : stmts) {
+    ir_cloner.clone(stmt);
+  }
+
+  // Keep newly created statements from colliding with the cloned names
+  to->val_type_name_map_ = from->val_type_name_map_;
+  to->expr_name_counter_ = from->expr_name_counter_;
+
+  for (auto inp : inputs) {
+    to->addInput(ir_cloner.clone(inp));
+  }
+  for (auto out : outputs) {
+    to->addOutput(ir_cloner.clone(out));
+  }
+
+  std::unordered_set<Statement*> in_subgraph(stmts.begin(), stmts.end());
+  in_subgraph.insert(inputs.begin(), inputs.end());
+  for (const auto& [output, alias] : from->io_alias_) {
+    if (in_subgraph.count(output) && in_subgraph.count(alias.first)) {
+      to->io_alias_[ir_cloner.clone(output)] = {
+          ir_cloner.clone(alias.first), alias.second};
+    }
+  }
+
+  return ir_cloner;
+}
+
 // Clang tidy complains when using default constructor for IrContainer instead
 // of copy constructor. Fusion::copy has a call to IrContainer::copy, so it's
 // redundant to use the IrContainer copy constructor, but it is harmless since
@@ -170,6 +223,8 @@ void Fusion::clear() noexcept {
 
   all_tv_uses_valid_ = false;
   is_during_update_uses_ = false;
+
+  invalidateExprs();
 }
 
 void Fusion::removeExpr(Expr* expr) {
@@ -179,6 +234,7 @@ void Fusion::removeExpr(Expr* expr) {
   // we're going with the strictest model which errors.
 
   for (auto out : expr->outputs()) {
+    invalidateScalarHash(out);
     out->setDefinition(nullptr);
   }
 
@@ -188,6 +244,7 @@ void Fusion::removeExpr(Expr* expr) {
     inp->removeUse(expr);
   }
 
+  maybeInvalidateExprs(expr);
   IrContainer::removeExpr(expr);
 }
 
@@ -246,6 +303,7 @@ void Fusion::addInput(Val* input) {
   input->setIsFusionInput(true);
 
   all_tv_uses_valid_ = false;
+  invalidateExprs();
 }
 
 void Fusion::addOutput(Val* output) {
@@ -276,6 +334,7 @@ void Fusion::addOutput(Val* output) {
   output->setIsFusionOutput(true);
 
   all_tv_uses_valid_ = false;
+  invalidateExprs();
 }
 
 void Fusion::removeInput(Val* input) {
@@ -285,6 +344,7 @@ void Fusion::removeInput(Val* input) {
   }
   input->setIsFusionInput(false);
   all_tv_uses_valid_ = false;
+  invalidateExprs();
 }
 
 void Fusion::removeOutput(Val* output) {
@@ -294,6 +354,7 @@ void Fusion::removeOutput(Val* output) {
   }
   output->setIsFusionOutput(false);
   all_tv_uses_valid_ = false;
+  invalidateExprs();
 }
 
 void Fusion::replaceOutput(Val* output, Val* replacement) {
@@ -317,6 +378,7 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
     }
     // Mark uses invalid so that they will be reset next time uses() is called
     invalidateTvUses();
+    invalidateExprs();
   }
 
   // Temporary WAR for issue #1112
@@ -328,8 +390,50 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
   }
 }
 
+namespace {
+
+std::atomic<int64_t> exprs_queries{0};
+std::atomic<int64_t> exprs_traversals{0};
+
+} // namespace
+
 std::vector<Expr*> Fusion::exprs() {
-  return StmtSort::getExprs(this);
+  exprs_queries++;
+  if (!exprs_cache_.has_value()) {
+    exprs_traversals++;
+    // Sorting may call resetTvUses, which sorts with stale uses. Don't cache
+    // that order.
+    if (is_during_update_uses_) {
+      return StmtSort::getExprs(this);
+    }
+    exprs_cache_ = StmtSort::getExprs(this);
+    exprs_cache_vals_.insert(outputs_.begin(), outputs_.end());
+    for (auto expr : *exprs_cache_) {
+      exprs_cache_vals_.insert(expr->inputs().begin(), expr->inputs().end());
+    }
+  }
+  return *exprs_cache_;
+}
+
+void Fusion::invalidateExprs() {
+  exprs_cache_.reset();
+  exprs_cache_vals_.clear();
+}
+
+void Fusion::maybeInvalidateExprs(Expr* expr) {
+  if (!exprs_cache_.has_value()) {
+    return;
+  }
+  if (std::any_of(
+          expr->outputs().begin(), expr->outputs().end(), [this](Val* out) {
+            return exprs_cache_vals_.count(out) > 0;
+          })) {
+    invalidateExprs();
+  }
+}
+
+/*static*/ Fusion::ExprsStats Fusion::exprsStats() {
+  return {exprs_queries.load(), exprs_traversals.load()};
 }
 
 namespace {
@@ -583,6 +687,7 @@ void Fusion::registerExpr(Expr* expr) {
   }
 
   IrContainer::registerExpr(expr);
+  maybeInvalidateExprs(expr);
 
   for (Val* input : expr->inputs()) {
     assertInContainer(input, "Input to expr is invalid, ");
@@ -606,6 +711,7 @@ void Fusion::registerExpr(Expr* expr) {
       removeExpr(output->definition());
     }
     if (is_ssa || (!is_ssa && output->definition() == nullptr)) {
+      invalidateScalarHash(output);
       output->setDefinition(expr);
       if (output->isA<TensorView>()) {
         // Updating the definition might change the path to output TVs.
@@ -626,7 +732,7 @@ void Fusion::resetTvUses() {
   // remove dead exprs, this could reinsert them. getExprs is also boundeds by
   // inputs as registered inputs will return nullptr as their definition.
   const auto all_tvs = ir_utils::filterByType<TensorView>(vals_);
-  const auto used_exprs = StmtSort::getExprs(this);
+  const auto used_exprs = exprs();
 
   for (auto tv : all_tvs) {
     tv->setUses({});
@@ -643,6 +749,13 @@ void Fusion::resetTvUses() {
   is_during_update_uses_ = false;
 }
 
+void Fusion::prepareConcurrentReads() {
+  if (!all_tv_uses_valid_) {
+    resetTvUses();
+  }
+  exprs();
+}
+
 std::vector<Val*> Fusion::usedMathVals() {
   // Note that using fusion->inputs() as the argument for the first
   // parameter of getAllValsBetween does not grab all used vals as
@@ -19,6 +19,7 @@
 #include <iter_visitor.h>
 
 #include <any>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -187,8 +188,24 @@ class Fusion : public IrContainer {
 
   //! Return a list of topologically sorted expressions. This only includes
   //! exprs required to genereate registered outputs.
+  //!
+  //! The order is computed once and cached until the graph is mutated, i.e.
+  //! a live Expr is registered or removed or the inputs or outputs of the
+  //! fusion change. All mutations, including those of OptOutMutator, go
+  //! through registerExpr and removeExpr, so the cache never needs to be
+  //! invalidated by hand. Exprs that can't reach an output, like the scalar
+  //! exprs created while lowering, leave the cache intact.
   std::vector<Expr*> exprs();
 
+  //! Process-wide number of exprs() calls and of the full topological sorts
+  //! done by exprs() and resetTvUses(). Used to measure how often the cached
+  //! order is re-used.
+  struct ExprsStats {
+    int64_t queries = 0;
+    int64_t traversals = 0;
+  };
+  static ExprsStats exprsStats();
+
   //! Return a vector of fusion inputs that feed this Val
   std::vector<Val*> inputsOf(Val* val);
 
@@ -276,6 +293,12 @@ class Fusion : public IrContainer {
     return is_during_update_uses_;
   }
 
+  //! Brings the TensorView uses and the cached exprs() order up to date.
+  //! Queries that would otherwise fill them lazily, like Val::uses() and
+  //! exprs(), then only read the fusion until it is mutated again, so they can
+  //! be made from multiple threads.
+  void prepareConcurrentReads();
+
   // NOTE: [Fusion managed data]
   //
   // Fusion-managed data is a mechanism to communicate data that survives fusion
@@ -429,6 +452,16 @@ class Fusion : public IrContainer {
 
   static IrCloner copy(const Fusion* from, Fusion* to);
 
+  //! Like copy, but only clones the statements needed to compute outputs from
+  //! inputs, which become the inputs and outputs of the new fusion. Statement
+  //! names are preserved. Managed data, axioms and metadata are not carried
+  //! over; io aliases are kept when both ends are part of the subgraph.
+  static IrCloner copySubgraph(
+      Fusion* from,
+      Fusion* to,
+      const std::vector<Val*>& inputs,
+      const std::vector<Val*>& outputs);
+
   using IrContainer::registerExpr;
   using IrContainer::registerVal;
 
@@ -459,6 +492,14 @@ class Fusion : public IrContainer {
   // Same DataType, ValType, and number of dimensions
   bool isAliasCompatible(Val* left, Val* right);
 
+  // Drop the cached exprs() order
+  void invalidateExprs();
+
+  // Drop the cached exprs() order if expr may be part of it, i.e. if one of
+  // its outputs is consumed by a sorted expr or is a fusion output.
+  // Registering or removing any other expr can't change the order.
+  void maybeInvalidateExprs(Expr* expr);
+
  private:
   // Fusion inputs and outputs
   std::vector<Val*> inputs_;
@@ -478,6 +519,12 @@ class Fusion : public IrContainer {
   bool all_tv_uses_valid_ = false;
   bool is_during_update_uses_ = false;
 
+  // Topologically sorted exprs returned by exprs()
+  std::optional<std::vector<Expr*>> exprs_cache_;
+  // Inputs of the exprs in exprs_cache_ and the fusion outputs. An expr
+  // defining none of these is dead.
+  std::unordered_set<Val*> exprs_cache_vals_;
+
   std::vector<std::pair<std::any, CloneFn>> managed_data_;
   std::unordered_map<std::string, std::pair<std::any, CloneFn>>
       managed_named_data_;
@@ -1527,50 +1527,56 @@ void convertInputRfactorsToRoots(Fusion* fusion) {
 }
 
 std::unique_ptr<Fusion> SegmentedFusion::makeFusion(SegmentedGroup* sg) {
-  std::unique_ptr<Fusion> fusion_segment = std::make_unique<Fusion>();
-
-  auto complete_to_segment_map =
-      Fusion::copy(completeFusion(), fusion_segment.get());
-
-  std::vector<Val*> input_list(
-      fusion_segment->inputs().begin(), fusion_segment->inputs().end());
-  for (auto inp : input_list) {
-    fusion_segment->removeInput(inp);
-  }
-
-  std::vector<Val*> output_list(
-      fusion_segment->outputs().begin(), fusion_segment->outputs().end());
-  for (auto out : output_list) {
-    fusion_segment->removeOutput(out);
-  }
-
-  std::vector<TensorView*> view_tvs;
-  for (auto inp : getAllInputs(sg)) {
-    auto clone_tv = complete_to_segment_map.clone(inp);
-    fusion_segment->addInput(clone_tv);
-    if (inp->isDefinitionType<ViewOp>()) {
-      NVF_ERROR(clone_tv != nullptr && clone_tv->isA<TensorView>());
-      view_tvs.push_back(clone_tv->as<TensorView>());
+  FUSER_PERF_SCOPE("SegmentedFusion::makeFusion");
+  SegmentFusionCacheEntry* cached = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(segment_fusion_cache_mutex_);
+    auto& entry = segment_fusion_cache_[sg];
+    if (entry == nullptr) {
+      entry = std::make_unique<SegmentFusionCacheEntry>();
+    }
+    cached = entry.get();
+  }
+
+  std::call_once(cached->built, [this, sg, cached]() {
+    cached->fusion = std::make_unique<Fusion>();
+
+    // Only clone the statements between the group inputs and outputs rather
+    // than the complete fusion. Note, we would want to keep output consistent
+    // and not artificially drop duplicates.
+    Fusion::copySubgraph(
+        completeFusion(),
+        cached->fusion.get(),
+        getAllInputs(sg),
+        sg->output_vals);
+
+    if (isDebugDumpEnabled(DebugDumpOption::FusionSegmenterLog)) {
+      auto num_stmts = [](Fusion* fusion) {
+        return fusion->vals().size() + fusion->unordered_exprs().size();
+      };
+      debug() << "Segment fusion of group " << sg->groupId() << ": cloned "
+              << num_stmts(cached->fusion.get()) << " of "
+              << num_stmts(completeFusion()) << " statements" << std::endl;
     }
-  }
-
-  // note, we would want to keep output consistent and not artificially drop
-  // duplicates.
-  for (auto out : sg->output_vals) {
-    fusion_segment->addOutput(complete_to_segment_map.clone(out));
-  }
 
-  // Replace all vals that are rfactor extents in fusion_segment->inputs() with
-  // new Vals so that they can be bound to the segment inputs.
-  convertInputRfactorsToRoots(fusion_segment.get());
+    // Replace all vals that are rfactor extents in fusion_segment->inputs()
+    // with new Vals so that they can be bound to the segment inputs.
+    convertInputRfactorsToRoots(cached->fusion.get());
+  });
 
-  return fusion_segment;
+  // Callers schedule the returned fusion, so hand out a copy of the cached
+  // segment. The cached segment is no longer modified, so copies are made
+  // concurrently.
+  return std::make_unique<Fusion>(*cached->fusion);
 }
 
 std::unique_ptr<SegmentedFusion> SegmentCandidateFinder::segment(
     std::unique_ptr<Fusion> fusion,
     const KernelArgumentHolder& inputs,
-    SchedulerRuntimeInfo& runtime_info) {
+    SchedulerRuntimeInfo& runtime_info,
+    const SegmentedFusion* seed) {
+  // The complete fusion is still tried first even with a seed. It is a
+  // single query, and the one whose answer most often changes with sizes.
   if (!hasSegmentHints(fusion.get())) {
     scheduler_debug_utils::canScheduleMessage(
         "***Runtime***: Try to schedule fusion un-segmented:\n");
@@ -1582,6 +1588,15 @@ std::unique_ptr<SegmentedFusion> SegmentCandidateFinder::segment(
     }
   }
   if (fusion) {
+    if (seed != nullptr) {
+      if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
+        debug() << "Segment the fusion from a seed segmentation: " << std::endl;
+        fusion->printMath();
+      }
+      SegmentCandidateFinder scf(
+          std::move(fusion), inputs, SegmentCandidateFinderOptions(), seed);
+      return std::move(scf.segmented_fusion_);
+    }
     return SegmentCandidateFinder::segment(std::move(fusion), inputs);
   } else {
     NVF_ERROR(false, "unreachable!");
@@ -1819,7 +1834,8 @@ SegmentedGroup* SegmentCandidateFinder::mergeNodes() {
 //  in different phases of segmentation. Should consider
 //  a clean up and share the implementations.
 SegmentedGroup* SegmentCandidateFinder::mergeAllGivenGroups(
-    const std::vector<SegmentedGroup*>& groups_to_merge) {
+    const std::vector<SegmentedGroup*>& groups_to_merge,
+    std::optional<ScheduleHeuristic> heuristic) {
   NVF_ERROR(
       !groups_to_merge.empty(),
       "fusion segment :(mergeAllGivenGroups) tried to merge no groups")
@@ -1914,7 +1930,9 @@ SegmentedGroup* SegmentCandidateFinder::mergeAllGivenGroups(
 
   clean_up_edges_.clear();
 
-  joined_group->setHeuristic(deriveHeuristic(joined_group));
+  joined_group->setHeuristic(
+      heuristic.has_value() ? heuristic.value()
+                            : deriveHeuristic(joined_group));
   return joined_group;
 }
 
@@ -3266,8 +3284,10 @@ ScheduleHeuristic SegmentCandidateFinder::deriveHeuristic(
 SegmentCandidateFinder::SegmentCandidateFinder(
     std::unique_ptr<Fusion> fusion,
     const KernelArgumentHolder& inputs,
-    SegmentCandidateFinderOptions options)
+    SegmentCandidateFinderOptions options,
+    const SegmentedFusion* seed)
     : options_(options),
+      seed_(seed),
       runtime_info_(fusion.get(), inputs),
       runtime_inputs_(inputs) {
   segmented_fusion_ = std::make_unique<SegmentedFusion>(std::move(fusion));
@@ -3352,6 +3372,15 @@ void SegmentCandidateFinder::trySetUpMerge(
     candidates = group->getMergeCandidates();
   }
 
+  candidates.erase(
+      std::remove_if(
+          candidates.begin(),
+          candidates.end(),
+          [&](const SegmentedGroup::NeighborGroup& candidate) {
+            return isSeededPair(group, candidate.group);
+          }),
+      candidates.end());
+
   if (candidates.empty()) {
     return;
   }
@@ -3409,8 +3438,17 @@ void SegmentCandidateFinder::findSegments() {
   //  dependency among segmented groups.
   removeScalarEdges();
 
+  // CombineReductions expects at most one reduction per group, so it only
+  // runs when no seed group was merged. When every seed group was kept, its
+  // combined reductions don't need to be found again. When only some were,
+  // the initial groups left by the others are merged by the passes below.
+  const SeedResult seed_result =
+      seed_ != nullptr ? seedSegments() : SeedResult::NotSeeded;
+
   // Run pre-merge heuristics
-  if (options_.run_combine_reductions && CombineReductions::shouldRun(this)) {
+  if (seed_result == SeedResult::NotSeeded &&
+      options_.run_combine_reductions &&
+      CombineReductions::shouldRun(this)) {
     CombineReductions::run(this);
   }
 
@@ -3462,6 +3500,10 @@ void SegmentCandidateFinder::findSegments() {
   // Forwarded input groups are no longer used. Clean them up.
   cleanupForwardedInputs();
 
+  for (auto group : groups()) {
+    segmented_fusion_->num_seeded_groups_ += seeded_groups_.count(group);
+  }
+
   finalize();
 
   // Do sanity check on the final graph. At this point, the graph may
@@ -3474,6 +3516,117 @@ void SegmentCandidateFinder::findSegments() {
   }
 }
 
+SegmentCandidateFinder::SeedResult SegmentCandidateFinder::seedSegments() {
+  FUSER_PERF_SCOPE("SegmentCandidateFinder::seedSegments");
+
+  // An un-segmented seed is the complete fusion, which was just found not to
+  // be schedulable as is, so it has nothing to re-use
+  if (seed_->cgroups().size() <= 1) {
+    return SeedResult::NotSeeded;
+  }
+
+  // Expressions are matched by the name of their first output, which is kept
+  // by Fusion copies. Unlike the name of the expression, it is also kept when
+  // the seed replaced the expression to consume a tensor cast back from half
+  // precision, see castInputOutputToLowerPrecision. Forwarded input
+  // expressions are left out, as they are added back to every group that uses
+  // them when finalizing.
+  auto output_name = [](Expr* expr) { return expr->output(0)->name(); };
+  std::unordered_map<StmtNameType, SegmentedGroup*> name_to_group;
+  for (auto group : groups()) {
+    if (group->isFusionInputGroup()) {
+      continue;
+    }
+    NVF_ERROR(group->exprs().size() == 1);
+    auto expr = group->exprs().front();
+    if (!excluded_inp_unary_exprs_.has(expr)) {
+      name_to_group.emplace(output_name(expr), group);
+    }
+  }
+  std::unordered_map<StmtNameType, Expr*> name_to_expr;
+  for (auto expr : completeFusion()->exprs()) {
+    if (!expr->outputs().empty()) {
+      name_to_expr.emplace(output_name(expr), expr);
+    }
+  }
+
+  // Tensors of the edges of the seed cast to half precision. The casts to
+  // and from them were inserted by the seed and have no counterpart here.
+  std::unordered_set<Val*> half_edge_tvs;
+  for (auto edge : seed_->cedges()) {
+    auto def = dynamic_cast<UnaryOp*>(edge->val->definition());
+    if (def != nullptr && def->getUnaryOpType() == UnaryOpType::Cast &&
+        seed_->force_fp16_tv_set_.count(
+            dynamic_cast<TensorView*>(def->in()))) {
+      half_edge_tvs.insert(edge->val);
+    }
+  }
+  auto is_inserted_cast = [&half_edge_tvs](Expr* expr) {
+    auto uop = dynamic_cast<UnaryOp*>(expr);
+    return uop != nullptr && uop->getUnaryOpType() == UnaryOpType::Cast &&
+        (half_edge_tvs.count(uop->in()) || half_edge_tvs.count(uop->out()));
+  };
+
+  // Map the seed groups to initial groups before modifying anything
+  std::vector<std::vector<SegmentedGroup*>> seed_groups;
+  std::unordered_set<SegmentedGroup*> covered;
+  for (auto seed_group : seed_->cgroups()) {
+    std::vector<SegmentedGroup*>& initial_groups = seed_groups.emplace_back();
+    for (auto seed_expr : seed_group->exprs()) {
+      // Scalar expressions are resolved again when finalizing
+      if (ir_utils::isScalarOp(seed_expr) || is_inserted_cast(seed_expr) ||
+          seed_expr->outputs().empty()) {
+        continue;
+      }
+      auto expr_it = name_to_expr.find(output_name(seed_expr));
+      if (expr_it == name_to_expr.end() ||
+          std::string(expr_it->second->getOpString()) !=
+              seed_expr->getOpString()) {
+        return SeedResult::NotSeeded;
+      }
+      auto group_it = name_to_group.find(output_name(seed_expr));
+      if (group_it == name_to_group.end()) {
+        continue;
+      }
+      if (!covered.insert(group_it->second).second) {
+        return SeedResult::NotSeeded;
+      }
+      initial_groups.push_back(group_it->second);
+    }
+  }
+  if (covered.size() != name_to_group.size()) {
+    return SeedResult::NotSeeded;
+  }
+
+  // A group of a DAG partition stays convex when other groups are split, so
+  // merging each still schedulable seed group keeps the graph a DAG
+  bool all_kept = true;
+  for (const auto& initial_groups : seed_groups) {
+    if (initial_groups.empty()) {
+      continue;
+    }
+    auto heuristic =
+        tryMerge(segmented_fusion_.get(), runtime_info_, initial_groups);
+    if (!heuristic.has_value()) {
+      all_kept = false;
+      continue;
+    }
+    if (initial_groups.size() == 1) {
+      initial_groups.front()->setHeuristic(heuristic.value());
+      seeded_groups_.insert(initial_groups.front());
+    } else {
+      seeded_groups_.insert(
+          mergeAllGivenGroups(initial_groups, heuristic.value()));
+    }
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
+    debug() << "Kept " << seeded_groups_.size() << " of "
+            << seed_->cgroups().size() << " seed groups" << std::endl;
+  }
+  return all_kept ? SeedResult::AllKept : SeedResult::PartlyKept;
+}
+
 void SegmentCandidateFinder::forwardInputs() {
   excluded_inp_unary_exprs_ = {};
   input2group_.clear();
@@ -3588,7 +3741,8 @@ void SegmentCandidateFinder::finalMerge() {
           [](auto& it) { return it.first; });
 
       for (auto consumer : all_consumers_of_producer_group) {
-        if (!producer_check->isConsumerOfAny(
+        if (!isSeededPair(producer_group, consumer) &&
+            !producer_check->isConsumerOfAny(
                 consumer, all_consumers_of_producer_group) &&
             codeGenSupportedMerge(producer_group, consumer)) {
           to_merge_.emplace_back(producer_group);
@@ -19,6 +19,7 @@
 
 #include <deque>
 #include <list>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -290,6 +291,12 @@ class SegmentedFusion {
     return !groups_.empty();
   }
 
+  //! Number of groups taken as is from the seed segmentation, see
+  //!  SegmentCandidateFinder::segment
+  int64_t numSeededGroups() const {
+    return num_seeded_groups_;
+  }
+
   std::vector<SegmentedGroup*>& groups() {
     return groups_;
   }
@@ -327,7 +334,10 @@ class SegmentedFusion {
     return complete_fusion_->getOutputAlias(val).first;
   }
 
-  //! Make a clone of the group and convert to fusion
+  //! Make a clone of the group and convert to fusion. Only the statements
+  //! of the group are cloned, and the result is cached per group so that
+  //! subsequent calls only copy the segment. Must only be called once
+  //! segmentation is finalized. Thread-safe.
   std::unique_ptr<Fusion> makeFusion(SegmentedGroup* sg);
 
   //! Make heuristics for all groups in this segmented fusion
@@ -400,6 +410,9 @@ class SegmentedFusion {
   //! Unique name for segmented fusion
   size_t segmented_fusion_name_;
 
+  //! Groups re-used from a seed segmentation
+  int64_t num_seeded_groups_ = 0;
+
   //! States representing segmentation
   std::vector<SegmentedEdge*> edges_;
   std::vector<SegmentedGroup*> groups_;
@@ -436,6 +449,18 @@ class SegmentedFusion {
   std::unordered_map<SegmentedGroup*, std::unique_ptr<HeuristicSummary>>
       heuristic_summary_cache_;
 
+  //! Unscheduled fusion of a group, built once by the first makeFusion call
+  //!  for it
+  struct SegmentFusionCacheEntry {
+    std::once_flag built;
+    std::unique_ptr<Fusion> fusion;
+  };
+  std::unordered_map<SegmentedGroup*, std::unique_ptr<SegmentFusionCacheEntry>>
+      segment_fusion_cache_;
+  //! Only guards the lookup and insertion of segment_fusion_cache_ entries,
+  //!  so that segments of different groups are built concurrently
+  std::mutex segment_fusion_cache_mutex_;
+
   // TODO: this class needs cleanup
  protected:
   friend class SegmentCandidateFinder;
@@ -537,10 +562,18 @@ class SegmentCandidateFinder {
     return std::move(scf.segmented_fusion_);
   }
 
+  //! Perform segmentation for a kernel runtime. If a seed is given, it is a
+  //!  previous segmentation of a fusion this fusion was copied from, e.g. the
+  //!  segmentation of another kernel runtime of the same concretization.
+  //!  Instead of merging from single expressions, the groups of the seed are
+  //!  re-validated with the new runtime info, and only the groups that can
+  //!  no longer be scheduled are split and merged again. The seed is ignored
+  //!  if its expressions don't match the ones of this fusion.
   static std::unique_ptr<SegmentedFusion> segment(
       std::unique_ptr<Fusion> fusion,
       const KernelArgumentHolder& inputs,
-      SchedulerRuntimeInfo& runtime_info);
+      SchedulerRuntimeInfo& runtime_info,
+      const SegmentedFusion* seed = nullptr);
 
   static bool hasSegmentHints(Fusion* fusion);
 
@@ -553,7 +586,8 @@ class SegmentCandidateFinder {
   SegmentCandidateFinder(
       std::unique_ptr<Fusion> fusion,
       const KernelArgumentHolder& inputs,
-      SegmentCandidateFinderOptions options);
+      SegmentCandidateFinderOptions options,
+      const SegmentedFusion* seed = nullptr);
 
   void resetTraversal();
 
@@ -567,6 +601,27 @@ class SegmentCandidateFinder {
 
   void findSegments();
 
+  //! Outcome of seedSegments
+  enum class SeedResult {
+    //! The seed is a single group or doesn't cover the same expressions. No
+    //!  group was modified.
+    NotSeeded,
+    //! The groups of the seed that can still be scheduled were merged. The
+    //!  others are left as initial groups.
+    PartlyKept,
+    //! Every group of the seed was merged
+    AllKept
+  };
+
+  //! Merge the initial groups into the groups of seed_ that can still be
+  //!  scheduled
+  SeedResult seedSegments();
+
+  //! Groups of the seed are not merged with each other again
+  bool isSeededPair(SegmentedGroup* group1, SegmentedGroup* group2) const {
+    return seeded_groups_.count(group1) && seeded_groups_.count(group2);
+  }
+
   //! Find a group found in candidates that can be merged with the
   //! given group and set them to be merged if found. When no
   //! candidate is given, SegmentedGroup::getMergeCandidates is used
@@ -640,9 +695,11 @@ class SegmentCandidateFinder {
   void removeScalarEdges();
 
   //! Utility function to merge a vector of groups in one step,
-  //!  need to check for DAG condition before using this method
+  //!  need to check for DAG condition before using this method.
+  //!  The heuristic of the merged group is derived unless given.
   SegmentedGroup* mergeAllGivenGroups(
-      const std::vector<SegmentedGroup*>& groups);
+      const std::vector<SegmentedGroup*>& groups,
+      std::optional<ScheduleHeuristic> heuristic = std::nullopt);
 
   //! Utility to remove a group and corresponding edges
   //!  TODO: remove inline versions of this as much as possible
@@ -700,6 +757,12 @@ class SegmentCandidateFinder {
 
   std::unique_ptr<SegmenterAnalysis> group_dependency_;
 
+  //! Previous segmentation to start from, if any
+  const SegmentedFusion* seed_ = nullptr;
+
+  //! Groups of the seed that are still valid
+  std::unordered_set<SegmentedGroup*> seeded_groups_;
+
   //! List of vals to treat as complete fusion inputs for segmentation
   std::vector<Val*> forwarded_fusion_inputs_;
 
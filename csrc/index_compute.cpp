@@ -2400,7 +2400,7 @@ kir::TensorIndex* Index::getProducerIndex(
       generate_pointer);
   index = GpuLower::current()->commonScalarMap().hoistScalar(index, loops);
   if (ir_utils::isLdMatrixOp(consumer->definition())) {
-    if (at::cuda::getCurrentDeviceProperties()->major < 8) {
+    if (GpuLower::current()->targetDevice().major < 8) {
       // For Turing, unused indices for ldmatrix needs to be aligned, although
       // they are not used.
       auto orig_index = index;
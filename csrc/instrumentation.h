@@ -7,6 +7,7 @@
 // clang-format on
 #pragma once
 
+#include <compile_profiler.h>
 #include <exceptions.h>
 #include <utils.h>
 
@@ -78,18 +79,25 @@ class Trace : public NonCopyable {
 
 //! \internal Automatic scope for a perf marker
 //!   (normally used through the FUSER_PERF_SCOPE macro)
+//!
+//! The scope is also recorded by the CompileProfiler when it is recording.
 class TraceScope : public NonCopyable {
  public:
   explicit TraceScope(const char* event_name) : event_name_(event_name) {
     Trace::instance()->beginEvent(event_name_);
+    if (CompileProfiler::isRecording()) {
+      profile_event_ = CompileProfiler::beginEvent(event_name_);
+    }
   }
 
   ~TraceScope() {
+    CompileProfiler::endEvent(profile_event_);
     Trace::instance()->endEvent(event_name_);
   }
 
  private:
   const char* event_name_ = nullptr;
+  CompileProfiler::EventHandle profile_event_;
 };
 
 #define FUSER_MACRO_CONCAT2(a, b) a##b
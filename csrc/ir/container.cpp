@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <compile_profiler.h>
 #include <instrumentation.h>
 #include <ir/builder.h>
 #include <ir/cloner.h>
@@ -28,6 +29,7 @@ void swap(IrContainer& a, IrContainer& b) noexcept {
 
   swap(a.val_type_name_map_, b.val_type_name_map_);
   swap(a.expr_name_counter_, b.expr_name_counter_);
+  swap(a.scalar_hash_cons_table_, b.scalar_hash_cons_table_);
 
   swap(a.metadata_, b.metadata_);
 
@@ -165,6 +167,7 @@ void IrContainer::removeVal(Val* val) {
       val_in_deque != vals_up_.end(),
       "Wanted to remove a value but its unique ptr is missing.");
 
+  invalidateScalarHash(val);
   vals_.erase(val);
   vals_up_.erase(val_in_deque);
   raw_ptrs_.erase((void*)val);
@@ -180,6 +183,7 @@ void IrContainer::registerVal(Val* val) {
   vals_.emplace(vals_up_.back().get());
   val->setName(IrContainerPasskey(), getValName(vals_up_.back()->vtype()));
   raw_ptrs_.emplace((void*)vals_up_.back().get());
+  CompileProfiler::countStatement();
 }
 
 //! Register expr with this container.
@@ -191,6 +195,7 @@ void IrContainer::registerExpr(Expr* expr) {
   exprs_.emplace(exprs_up_.back().get());
   expr->setName(IrContainerPasskey(), getExprName());
   raw_ptrs_.emplace((void*)exprs_up_.back().get());
+  CompileProfiler::countStatement();
 }
 
 void IrContainer::clear() noexcept {
@@ -203,6 +208,7 @@ void IrContainer::clear() noexcept {
   axioms_.reset();
   val_type_name_map_.clear();
   metadata_.clear();
+  scalar_hash_cons_table_.reset();
   expr_name_counter_ = 0;
 }
 
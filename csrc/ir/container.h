@@ -11,6 +11,7 @@
 #include <exceptions.h>
 
 #include <ir/base_nodes.h>
+#include <ir/hash_cons.h>
 #include <utils.h>
 
 #include <deque>
@@ -103,6 +104,15 @@ class IrContainer : public PolymorphicBase {
   void assumePositive(Val* val);
   void assumeNonNegative(Val* val);
 
+  //! Structural hashes and interned scalars of this container, see
+  //! ScalarHashConsTable. Created on first use.
+  ScalarHashConsTable& scalarHashConsTable() {
+    if (!scalar_hash_cons_table_) {
+      scalar_hash_cons_table_ = std::make_unique<ScalarHashConsTable>();
+    }
+    return *scalar_hash_cons_table_;
+  }
+
  protected:
   static IrCloner copy(const IrContainer* from, IrContainer* to);
 
@@ -138,6 +148,13 @@ class IrContainer : public PolymorphicBase {
 
   void lazyInitAxioms();
 
+  //! Drops the hashes depending on val when its definition changes
+  void invalidateScalarHash(Val* val) {
+    if (scalar_hash_cons_table_) {
+      scalar_hash_cons_table_->invalidate(val);
+    }
+  }
+
   // Deque of unique pointer is the memory owning data structure
   std::deque<std::unique_ptr<Val>> vals_up_;
 
@@ -180,6 +197,7 @@ class IrContainer : public PolymorphicBase {
   std::unique_ptr<NamedScalar> magic_zero_val_;
   std::unique_ptr<std::vector<Val*>> axioms_;
   std::unordered_map<Val*, std::pair<Val*, Expr*>> metadata_;
+  std::unique_ptr<ScalarHashConsTable> scalar_hash_cons_table_;
 };
 
 } // namespace nvfuser
@@ -0,0 +1,125 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <ir/all_nodes.h>
+#include <ir/hash_cons.h>
+#include <utils.h>
+
+#include <functional>
+#include <string_view>
+#include <typeinfo>
+
+namespace nvfuser {
+
+namespace {
+
+size_t hashValue(const PolymorphicValue& value) {
+  if (value.is<int64_t>()) {
+    return std::hash<int64_t>()(value.as<int64_t>());
+  }
+  if (value.is<double>()) {
+    return std::hash<double>()(value.as<double>());
+  }
+  if (value.is<bool>()) {
+    return std::hash<bool>()(value.as<bool>());
+  }
+  // Values of other types, e.g. the opaque data attributes of exprs, are
+  // only compared by sameAs
+  return 0;
+}
+
+size_t hashOpType(const Expr* expr) {
+  if (auto uop = dynamic_cast<const UnaryOp*>(expr)) {
+    return (size_t)uop->getUnaryOpType();
+  }
+  if (auto bop = dynamic_cast<const BinaryOp*>(expr)) {
+    return (size_t)bop->getBinaryOpType();
+  }
+  if (auto top = dynamic_cast<const TernaryOp*>(expr)) {
+    return (size_t)top->getTernaryOpType();
+  }
+  return 0;
+}
+
+} // namespace
+
+size_t ScalarHashConsTable::hash(Val* val) {
+  auto it = hashes_.find(val);
+  if (it != hashes_.end()) {
+    return it->second;
+  }
+
+  size_t result = typeid(*val).hash_code();
+  if (!val->isScalar()) {
+    // Only scalars are hashed structurally
+  } else if (auto ns = dynamic_cast<NamedScalar*>(val)) {
+    // NamedScalar::sameAs only compares names
+    hashCombine(result, std::hash<std::string>()(ns->name()));
+  } else if (Expr* def = val->definition(); def == nullptr) {
+    // Leaves are sameAs only if they are constants of the same value
+    hashCombine(
+        result,
+        val->value().hasValue() ? hashValue(val->value())
+                                : std::hash<Val*>()(val));
+  } else {
+    hashCombine(result, std::hash<std::string_view>()(def->getOpString()));
+    hashCombine(result, hashOpType(def));
+    for (auto i : c10::irange(def->outputs().size())) {
+      if (def->output(i) == val) {
+        hashCombine(result, i);
+      }
+    }
+    for (auto i : c10::irange(def->attributes().size())) {
+      if (auto attr = def->attributeVal(i)) {
+        hashCombine(result, hash(attr));
+      }
+    }
+    // Sum the hashes of the inputs so that the order doesn't matter
+    size_t inputs_hash = def->inputs().size();
+    for (auto input : def->inputs()) {
+      size_t input_hash = 0;
+      hashCombine(input_hash, hash(input));
+      inputs_hash += input_hash;
+    }
+    hashCombine(result, inputs_hash);
+  }
+
+  hashes_.emplace(val, result);
+  return result;
+}
+
+Val* ScalarHashConsTable::find(Val* val) {
+  auto it = interned_.find(hash(val));
+  if (it == interned_.end()) {
+    return nullptr;
+  }
+  for (auto interned : it->second) {
+    if (interned->sameAs(val)) {
+      return interned;
+    }
+  }
+  return nullptr;
+}
+
+Val* ScalarHashConsTable::intern(Val* val) {
+  auto& bucket = interned_[hash(val)];
+  for (auto interned : bucket) {
+    if (interned->sameAs(val)) {
+      return interned;
+    }
+  }
+  bucket.push_back(val);
+  return val;
+}
+
+void ScalarHashConsTable::invalidate(Val* val) {
+  if (hashes_.count(val)) {
+    clear();
+  }
+}
+
+} // namespace nvfuser
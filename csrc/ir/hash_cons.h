@@ -0,0 +1,67 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <ir/base_nodes.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+//! \class ScalarHashConsTable
+//! \brief Structural hashes and interning of scalar expressions.
+//!
+//! Val::sameAs recursively compares definitions, so looking for an existing
+//! scalar in a list of candidates is linear in the number of candidates times
+//! the size of their definitions. The table gives each Val a structural hash,
+//! memoized by pointer, such that vals that are sameAs have the same hash.
+//! Candidates with a different hash are rejected in O(1), and interned
+//! scalars are found in O(1) by hash.
+//!
+//! Hashes don't depend on the order of the inputs of an expression, so that
+//! they are also consistent with the sameAs of commutative expressions such
+//! as the flattened ops of the expression simplifier. Only the definitions of
+//! scalars are hashed. Other vals, e.g. the tensors of GetMetaData, are
+//! hashed by type.
+//!
+//! Each IrContainer owns a table, see IrContainer::scalarHashConsTable. When
+//! the definition of a hashed val changes, the container drops the table, as
+//! the hashes of the vals using it would be stale.
+class ScalarHashConsTable {
+ public:
+  size_t hash(Val* val);
+
+  //! Same as a->sameAs(b), without recursing into definitions with a
+  //! different hash
+  bool sameAs(Val* a, Val* b) {
+    return a == b || (hash(a) == hash(b) && a->sameAs(b));
+  }
+
+  //! Returns the first interned val that is sameAs val, or nullptr
+  Val* find(Val* val);
+
+  //! Returns the first interned val that is sameAs val. If there is none,
+  //! val is interned and returned.
+  Val* intern(Val* val);
+
+  //! Called when the definition of val changes or val is removed
+  void invalidate(Val* val);
+
+  void clear() {
+    hashes_.clear();
+    interned_.clear();
+  }
+
+ private:
+  std::unordered_map<Val*, size_t> hashes_;
+  std::unordered_map<size_t, std::vector<Val*>> interned_;
+};
+
+} // namespace nvfuser
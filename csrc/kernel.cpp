@@ -441,7 +441,10 @@ std::string KernelPerformanceProfile::toString(const at::Tensor& buffer) const {
     return ss.str();
   }
 
-  double kilo_freq = at::cuda::getCurrentDeviceProperties()->clockRate;
+  // The profile was recorded on the device the kernel ran on, which may not
+  // be the target it was compiled for
+  double kilo_freq =
+      at::cuda::getDeviceProperties(buffer.device().index())->clockRate;
 
   ss << std::setprecision(3) << std::fixed;
 
@@ -7,6 +7,7 @@
 // clang-format on
 #include <kernel_cache.h>
 
+#include <compile_profiler.h>
 #include <debug.h>
 #include <driver_api.h>
 #include <dynamic_transform.h>
@@ -22,62 +23,74 @@
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <utils.h>
+#include <workspace_planner.h>
 
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
 #include <c10/util/irange.h>
 #include <torch/csrc/jit/jit_log.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace nvfuser {
 
 namespace {
 
 // Replace CUDA tensor with Meta tensor because storing tensors can cause
 // out-of-memory issues. Other arguments are returned as-is.
-std::shared_ptr<PolymorphicValue> convertMetadataArg(
-    std::shared_ptr<PolymorphicValue> arg) {
+PolymorphicValue convertMetadataArg(const PolymorphicValue* arg) {
   if (arg->is<at::Tensor>()) {
     if (const auto& tensor = arg->as<at::Tensor>(); tensor.is_cuda()) {
-      auto meta_tensor = at::Tensor(at::detail::empty_strided_meta(
+      return at::Tensor(at::detail::empty_strided_meta(
           tensor.sizes(),
           tensor.strides(),
           tensor.scalar_type(),
           c10::nullopt,
           c10::Device(c10::DeviceType::Meta, 0),
           c10::nullopt));
-      return std::make_shared<PolymorphicValue>(std::move(meta_tensor));
     }
   }
-  return arg;
+  return *arg;
 }
 
-// Copy bytes of value to back of buffer. This is templated in order to avoid
-// implicit cast such as int64_t -> size_t that might lose information.
+// Reinterpret the bits of a scalar as int64_t words of an InputsSignature.
+// This is templated in order to avoid implicit cast such as double -> int64_t
+// that might lose information.
 template <typename T>
-void encodeBuffer(T value, std::string& buffer) {
-  const char* v = reinterpret_cast<char*>(&value);
-  for (const auto i : c10::irange(sizeof(T))) {
-    (void)i; // Suppress unused variable warning
-    buffer.push_back(*(v++));
+void encodeSignature(const T& value, InputsSignature& signature) {
+  constexpr size_t num_words = (sizeof(T) + sizeof(int64_t) - 1) /
+      sizeof(int64_t);
+  std::array<int64_t, num_words> words = {};
+  std::memcpy(words.data(), &value, sizeof(T));
+  for (auto word : words) {
+    signature.append(word);
   }
 }
 
+// Tags separating the entries of an InputsSignature
+constexpr int64_t kTensorTag = -1;
+constexpr int64_t kScalarTag = -2;
+constexpr int64_t kRecordedScalarTag = -3;
+
 // This ArgumentManager do two things
 // (1) add outputs from a segment to the global fusion args to pass it to next
 // segment (2) delete args no longer being used to save memory. For task (2), it
-// checks the input and output arguments of each segment and make a map from val
-// to the segment_id where the val is lastly used. The arguments representing
-// these vals are then deleted after the segment runs.
+// uses the map from segment_id to the vals lastly used at that segment, which
+// is computed once with the run order. The arguments representing these vals
+// are then deleted after the segment runs.
 class ArgumentManager {
  public:
   ArgumentManager(
       KernelArgumentHolder& args,
       const RuntimeWorkSpace& runtime_workspace,
       const std::vector<Val*>& fusion_inputs)
-      : fusion_args_(args) {
+      : fusion_args_(args),
+        vals_last_used_at_segment_(
+            runtime_workspace.vals_last_used_at_segment) {
     // map from val to args
     mapFusionInputsToArgs(
         fusion_inputs, runtime_workspace.group_extent_binding_order);
-    setLastUsedSegmentID(runtime_workspace.group_run_order);
   }
   const std::unordered_map<Val*, const PolymorphicValue*>& getTensorMap() {
     return tensor_map_;
@@ -102,7 +115,8 @@ class ArgumentManager {
   // map from val to args
   std::unordered_map<Val*, const PolymorphicValue*> tensor_map_;
   // map segment_id to vector of fusion vals lastly used at this segment
-  std::unordered_map<int64_t, std::vector<Val*>> vals_last_used_at_segment_;
+  const std::unordered_map<int64_t, std::vector<Val*>>&
+      vals_last_used_at_segment_;
 
   void mapFusionInputsToArgs(
       const std::vector<Val*>& fusion_inputs,
@@ -131,53 +145,11 @@ class ArgumentManager {
     }
   }
 
-  void setLastUsedSegmentID(
-      const std::vector<SegmentedGroup*>& group_run_order) {
-    // never delete global fusion inputs and outputs
-    auto isFusionInputOrOutput = [](Val* val) {
-      return val->isFusionInput() || val->isFusionOutput();
-    };
-    // map val to segment_id where arg is lastly used
-    std::unordered_map<Val*, int64_t> last_used_segment_map;
-    const int64_t num_groups = (int64_t)group_run_order.size();
-    // only need to set lifetime of vals if there are more than 3 groups
-    if (num_groups >= 3) {
-      // start from the 2nd group, since the input of the first group is always
-      // the global input and its outputs are always used by at least one of the
-      // following groups
-      for (auto group_id : c10::irange(1l, num_groups)) {
-        auto group_to_run = group_run_order.at(group_id);
-        // set/update life of vals in inputs of this group
-        for (auto val : group_to_run->inputs()) {
-          // skip fusion inputs and outputs, they may be used by other fusions
-          // or code
-          if (!isFusionInputOrOutput(val)) {
-            last_used_segment_map[val] = group_id;
-          }
-        }
-        // set/update life of vals in outputs of this group
-        // skip the last group since its outputs are always the global outputs
-        if (group_id < num_groups - 1) {
-          for (auto val : group_to_run->outputs()) {
-            // skip fusion inputs and outputs, they may be used by other fusions
-            // or code
-            if (!isFusionInputOrOutput(val)) {
-              last_used_segment_map[val] = group_id;
-            }
-          }
-        }
-      }
-      // convert to vals_last_used_at_segment_, so we don't need to iterate over
-      // all vals when erasing
-      for (auto item : last_used_segment_map) {
-        vals_last_used_at_segment_[item.second].push_back(item.first);
-      }
-    }
-  }
   void deleteUnusedArgs(int64_t group_id) {
     // erase args corresponding to vals lastly used in this segment
-    if (group_id >= 1 && vals_last_used_at_segment_.count(group_id)) {
-      for (auto val : vals_last_used_at_segment_[group_id]) {
+    auto it = vals_last_used_at_segment_.find(group_id);
+    if (group_id >= 1 && it != vals_last_used_at_segment_.end()) {
+      for (auto val : it->second) {
         fusion_args_.erase(tensor_map_.at(val));
         tensor_map_.erase(val);
       }
@@ -214,6 +186,45 @@ class ArgumentManager {
 
 } // namespace
 
+InputsSignature::InputsSignature(const char* data, size_t num_bytes) {
+  NVF_ERROR(
+      num_bytes % sizeof(int64_t) == 0,
+      "Invalid InputsSignature size: ",
+      num_bytes);
+  for (size_t offset = 0; offset < num_bytes; offset += sizeof(int64_t)) {
+    int64_t word = 0;
+    std::memcpy(&word, data + offset, sizeof(int64_t));
+    append(word);
+  }
+}
+
+void InputsSignature::mix(int64_t word) {
+  // Each lane is a multiply-xorshift mix seeded differently, so the two 64-bit
+  // halves are effectively independent.
+  auto w = static_cast<uint64_t>(word);
+  hash_[0] ^= w;
+  hash_[0] *= 0xff51afd7ed558ccdULL;
+  hash_[0] ^= hash_[0] >> 33;
+  hash_[1] += w * 0x9e3779b97f4a7c15ULL;
+  hash_[1] = (hash_[1] << 31) | (hash_[1] >> 33);
+  hash_[1] *= 0xc4ceb9fe1a85ec53ULL;
+}
+
+std::vector<
+    const std::pair<const InputsSignature, InputsIdLookup::EncodingEntry>*>
+InputsIdLookup::entriesByRecency() const {
+  std::vector<const std::pair<const InputsSignature, EncodingEntry>*> entries;
+  entries.reserve(encoding_lookup_.size());
+  for (const auto& kv : encoding_lookup_) {
+    entries.push_back(&kv);
+  }
+  std::sort(entries.begin(), entries.end(), [](auto lhs, auto rhs) {
+    return lhs->second.last_used.load(std::memory_order_relaxed) >
+        rhs->second.last_used.load(std::memory_order_relaxed);
+  });
+  return entries;
+}
+
 flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
     flatbuffers::FlatBufferBuilder& builder) const {
   // See definitions in serde/fusion_cache.fbs for table
@@ -221,23 +232,22 @@ flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
 
   using fb_string = flatbuffers::Offset<flatbuffers::String>;
 
-  // For serialization, we require a consistent ordering for the
-  // encoding_lookup_ map.
-  std::unordered_map<std::string, size_t> str_key_ordering;
+  std::shared_lock<std::shared_mutex> guard(mutex_);
 
-  // 1. Serialize used_entry_ list
-  std::vector<fb_string> lru_cache_fb;
-  for (const auto& str : used_entry_) {
-    lru_cache_fb.push_back(builder.CreateString(str));
-    str_key_ordering.emplace(str, str_key_ordering.size());
-  }
+  // Signatures are stored as raw bytes. The lru_cache list holds them ordered
+  // by their recent usage, and each EncodingEntry refers to its position in
+  // that list.
+  auto entries = entriesByRecency();
 
-  // 2. Serialize encoding_lookup_ map
+  std::vector<fb_string> lru_cache_fb;
   std::vector<fb_string> encoding_lookup_keys_fb;
   std::vector<serde::EncodingEntry> encoding_lookup_values_fb;
-  for (auto&& [key, value] : encoding_lookup_) {
-    encoding_lookup_keys_fb.push_back(builder.CreateString(key));
-    encoding_lookup_values_fb.emplace_back(value.id, str_key_ordering.at(key));
+  for (auto idx : c10::irange(entries.size())) {
+    const auto& [signature, entry] = *entries.at(idx);
+    auto key_fb = builder.CreateString(signature.data(), signature.numBytes());
+    lru_cache_fb.push_back(key_fb);
+    encoding_lookup_keys_fb.push_back(key_fb);
+    encoding_lookup_values_fb.emplace_back(entry.id, idx);
   }
 
   return serde::CreateInputsIdLookupDirect(
@@ -253,111 +263,139 @@ void InputsIdLookup::deserialize(const serde::InputsIdLookup* buffer) {
   // See definitions in serde/fusion_cache.fbs for tables
   // InputsIdLookup and EncodingEntry
   NVF_ERROR(buffer != nullptr, "serde::InputsIdLookup is nullptr.");
-  using list_iter = std::list<std::string>::iterator;
-  std::vector<list_iter> used_entry_iterators;
+  std::unique_lock<std::shared_mutex> guard(mutex_);
 
   max_cache_size_ = buffer->max_cache_size();
   current_id_ = buffer->current_id();
-  for (auto fb_str : *buffer->lru_cache()) {
-    used_entry_.emplace_back(fb_str->str());
-    used_entry_iterators.emplace_back(std::prev(used_entry_.end()));
-  }
 
+  // The most recently used entry is first in lru_cache, so it gets the
+  // largest stamp.
+  const uint64_t num_entries = buffer->lru_cache()->size();
+  clock_.store(num_entries, std::memory_order_relaxed);
+
+  encoding_lookup_.clear();
   for (auto idx : c10::irange(buffer->encoding_lookup_keys()->size())) {
     auto fb_encoding_lookup_str = buffer->encoding_lookup_keys()->Get(idx);
     auto fb_encoding_entry = buffer->encoding_lookup_values()->Get(idx);
-
-    EncodingEntry entry{
-        fb_encoding_entry->id(),
-        used_entry_iterators.at(fb_encoding_entry->lru_iter())};
-    encoding_lookup_.emplace(fb_encoding_lookup_str->str(), entry);
+    encoding_lookup_.emplace(
+        std::piecewise_construct,
+        std::forward_as_tuple(
+            fb_encoding_lookup_str->data(), fb_encoding_lookup_str->size()),
+        std::forward_as_tuple(
+            fb_encoding_entry->id(),
+            num_entries - fb_encoding_entry->lru_iter()));
   }
 }
 
-InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
+InputsSignature InputsIdLookup::computeSignature(
     const at::ArrayRef<c10::IValue>& inputs,
     const std::unordered_set<size_t>& scalar_inputs_to_record,
     int8_t device) {
-  IdLookupReturn ret;
-
-  // lock mutex_ because we are touching encoding_
-  std::lock_guard<std::mutex> guard(mutex_);
-  encoding_.clear();
-  encodeBuffer(device, encoding_);
+  InputsSignature signature;
+  // NOTE: device is set for the whole set of inputs first using device arg
+  signature.append(device);
   for (const auto i : c10::irange(inputs.size())) {
-    auto input = inputs[i];
+    const auto& input = inputs[i];
     if (input.isTensor()) {
-      auto& input_tensor = input.toTensor();
-
+      const auto& input_tensor = input.toTensor();
+      signature.append(kTensorTag);
+      signature.append(input_tensor.dim());
       for (auto size : input_tensor.sizes()) {
-        encodeBuffer(size, encoding_);
-        encoding_.push_back(' ');
+        signature.append(size);
       }
-      encoding_.push_back('X');
-      encoding_.push_back(' ');
       for (auto stride : input_tensor.strides()) {
-        encodeBuffer(stride, encoding_);
-        encoding_.push_back(' ');
+        signature.append(stride);
       }
-      encoding_.push_back('a');
-      encodeBuffer(
-          SchedulerRuntimeInfo::computeAlignmentSize(
-              (size_t)input_tensor.data_ptr()),
-          encoding_);
-      // NOTE: device is set for the whole set of inputs first using device arg
+      signature.append((int64_t)SchedulerRuntimeInfo::computeAlignmentSize(
+          (size_t)input_tensor.data_ptr()));
+    } else if (
+        scalar_inputs_to_record.find(i) == scalar_inputs_to_record.end()) {
+      signature.append(kScalarTag);
     } else {
-      // encode s for scalar;
-      encoding_.push_back('s');
-      if (scalar_inputs_to_record.find(i) != scalar_inputs_to_record.end()) {
-        // Add value of scalars here only if it is one of the scalars
-        // provided, as these are used in determining concretization.
-        // Note that although most commonly these will be Int or Bool scalars,
-        // any DataType might appear via `cast` and `where`, so we handle all
-        // cases here.
-        if (input.isInt()) {
-          encodeBuffer(input.toInt(), encoding_);
-        } else if (input.isBool()) {
-          encodeBuffer(input.toBool(), encoding_);
-        } else if (input.isDouble()) {
-          encodeBuffer(input.toDouble(), encoding_);
-        } else if (input.isComplexDouble()) {
-          encodeBuffer(input.toComplexDouble(), encoding_);
-        } else {
-          NVF_ERROR(
-              false,
-              "Unhandled input type when creating input ID. Cannot record ",
-              input);
-        }
+      // Add value of scalars here only if it is one of the scalars
+      // provided, as these are used in determining concretization.
+      // Note that although most commonly these will be Int or Bool scalars,
+      // any DataType might appear via `cast` and `where`, so we handle all
+      // cases here. The scalar type is part of the signature so that e.g. 1
+      // and true do not collide.
+      signature.append(kRecordedScalarTag);
+      if (input.isInt()) {
+        signature.append(0);
+        encodeSignature(input.toInt(), signature);
+      } else if (input.isBool()) {
+        signature.append(1);
+        encodeSignature((int64_t)input.toBool(), signature);
+      } else if (input.isDouble()) {
+        signature.append(2);
+        encodeSignature(input.toDouble(), signature);
+      } else if (input.isComplexDouble()) {
+        signature.append(3);
+        encodeSignature(input.toComplexDouble(), signature);
+      } else {
+        NVF_ERROR(
+            false,
+            "Unhandled input type when creating input ID. Cannot record ",
+            input);
       }
     }
-    encoding_.push_back(';');
   }
+  return signature;
+}
 
-  auto& entry = encoding_lookup_[encoding_];
+InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::unordered_set<size_t>& scalar_inputs_to_record,
+    int8_t device) {
+  IdLookupReturn ret;
 
-  if (entry.id == 0) {
-    // no entry existed for given input set, set id for given entry
-    entry.id = current_id_++;
-    if (used_entry_.size() == max_cache_size_) {
-      // pop least recently used cache;
-      const auto& remove_iter = encoding_lookup_.find(used_entry_.back());
-      used_entry_.pop_back();
-      ret.evict_id = remove_iter->second.id;
-      ret.eviction = true;
-      encoding_lookup_.erase(remove_iter);
-    }
-  } else {
-    // short-cut to leave LRU entry as is
-    if (entry.lru_iter == used_entry_.begin()) {
-      ret.id = entry.id;
+  auto signature = computeSignature(inputs, scalar_inputs_to_record, device);
+
+  // Fast path: a hit only needs a shared lock
+  {
+    std::shared_lock<std::shared_mutex> read_guard(mutex_);
+    auto it = encoding_lookup_.find(signature);
+    if (it != encoding_lookup_.end()) {
+      touch(it->second);
+      ret.id = it->second.id;
       return ret;
     }
+  }
 
-    used_entry_.erase(entry.lru_iter);
+  std::unique_lock<std::shared_mutex> write_guard(mutex_);
+
+  // Another thread might have inserted the same signature since we released
+  // the shared lock
+  if (auto it = encoding_lookup_.find(signature);
+      it != encoding_lookup_.end()) {
+    touch(it->second);
+    ret.id = it->second.id;
+    return ret;
   }
 
-  ret.id = entry.id;
-  entry.lru_iter = used_entry_.insert(used_entry_.begin(), encoding_);
+  if (encoding_lookup_.size() >= max_cache_size_ &&
+      !encoding_lookup_.empty()) {
+    // pop least recently used cache. max_cache_size_ is small, so a linear
+    // scan is cheaper than maintaining an ordered structure on every hit.
+    auto lru_it = std::min_element(
+        encoding_lookup_.begin(),
+        encoding_lookup_.end(),
+        [](const auto& lhs, const auto& rhs) {
+          return lhs.second.last_used.load(std::memory_order_relaxed) <
+              rhs.second.last_used.load(std::memory_order_relaxed);
+        });
+    ret.evict_id = lru_it->second.id;
+    ret.eviction = true;
+    encoding_lookup_.erase(lru_it);
+  }
+
+  // no entry existed for given input set, set id for given entry
+  ret.id = current_id_++;
+  auto [it, inserted] = encoding_lookup_.emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple(std::move(signature)),
+      std::forward_as_tuple(ret.id, 0));
+  NVF_ERROR(inserted);
+  touch(it->second);
   return ret;
 }
 
@@ -406,6 +444,62 @@ bool FusionExecutorCache::isCompiled(
   return getKernelRuntimeFor(args)->isCompiled();
 }
 
+bool FusionExecutorCache::compileFusionAheadOfTime(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> selected_device) {
+  return compileKernelRuntimeAheadOfTime(inputs, selected_device).second;
+}
+
+std::pair<FusionKernelRuntime*, bool> FusionExecutorCache::
+    compileKernelRuntimeAheadOfTime(
+        const at::ArrayRef<c10::IValue>& inputs,
+        std::optional<int8_t> selected_device,
+        bool parallel_compile) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::compileFusionAheadOfTime");
+
+  // Permute tensor inputs as runFusionWithInputs does so that the cache id
+  // computed below matches the one of a real run.
+  // See Part_1 in Note [ Permutation support in nvfuser ]
+  std::vector<c10::IValue> perm_inputs = inputs.vec();
+  for (const auto& pair : fusion_->getPermutationInputMap()) {
+    auto& v = perm_inputs[pair.first];
+    NVF_CHECK(v.isTensor(), "input permutation can only be applied at tensor");
+    v = v.toTensor().permute(pair.second);
+  }
+
+  // Unlike prepareInputs, tensors are not required to live on a CUDA device
+  // and only their metadata is handed to the compiler. CPU scalar tensors are
+  // kept as they are since their values may be needed.
+  KernelArgumentHolder args;
+  args.setDeviceIndex(selected_device.value_or((int8_t)0));
+  args.reserve(perm_inputs.size());
+  for (const auto& input : perm_inputs) {
+    if (input.isTensor() && !input.toTensor().is_cpu()) {
+      const auto& tensor = input.toTensor();
+      args.pushTensorProxy(
+          tensor.sizes().vec(), tensor.strides().vec(), tensor.scalar_type());
+    } else {
+      args.push(at::ArrayRef<c10::IValue>(input));
+    }
+  }
+
+  auto id_lookup_ret = inputs_id_lookup_.lookupId(
+      perm_inputs,
+      initialInfo().scalarInputsAffectingConcretization(),
+      args.getDeviceIndex());
+  if (id_lookup_ret.eviction) {
+    evictCache(id_lookup_ret.evict_id);
+  }
+  args.setCacheId(id_lookup_ret.id);
+
+  auto kernel_runtime = getKernelRuntimeFor(args);
+  if (kernel_runtime->isCompiled()) {
+    return {kernel_runtime, false};
+  }
+  kernel_runtime->compileFusionParallel(args, parallel_compile);
+  return {kernel_runtime, true};
+}
+
 // Note [ Permutation support in nvfuser ]
 //
 // Background:
@@ -439,6 +533,27 @@ bool FusionExecutorCache::isCompiled(
 //
 // For details on Part_2, refer to the implementation note. [ Permutation
 // Bookkeeping and Propagation in Parser ]
+
+namespace {
+
+// Prints the profile of a compilation recorded with the compile_profile
+// option. If the option has an argument, it is a directory where the profile
+// is also written as a Chrome trace.
+void reportCompileProfile(const CompileProfile& profile, int64_t fusion_id) {
+  static std::atomic<int64_t> num_reported{0};
+  const int64_t compile_id = num_reported++;
+  debug() << "Fusion " << fusion_id << ", compilation " << compile_id << ":\n"
+          << profile;
+  const auto& args = getEnableOptionArguments(EnableOption::CompileProfile);
+  if (!args.empty()) {
+    profile.writeChromeTrace(
+        args.at(0) + "/fusion" + std::to_string(fusion_id) + "_compile" +
+        std::to_string(compile_id) + ".json");
+  }
+}
+
+} // namespace
+
 std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     const at::ArrayRef<c10::IValue>& inputs,
     std::optional<PrimDataType> forced_index_type,
@@ -466,6 +581,13 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     perm_inputs = inputs_vec;
   }
 
+  // Profiles segmentation, scheduling, lowering and compilation if a new
+  // kernel runtime is needed
+  std::optional<CompileProfileGuard> compile_profile_guard;
+  if (isOptionEnabled(EnableOption::CompileProfile)) {
+    compile_profile_guard.emplace();
+  }
+
   KernelArgumentHolder args = prepareInputs(perm_inputs, selected_device);
   auto kernel_runtime = getKernelRuntimeFor(args, forced_index_type);
 
@@ -473,10 +595,19 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     FusionProfiler::createSegments(kernel_runtime->executors().size());
   }
 
-  if (!kernel_runtime->isCompiled()) {
+  const bool compiles = !kernel_runtime->isCompiled();
+  if (compiles) {
     kernel_runtime->compileFusionParallel(args);
   }
 
+  if (compile_profile_guard.has_value() &&
+      compile_profile_guard->isRecording()) {
+    const CompileProfile profile = compile_profile_guard->stop();
+    if (compiles) {
+      reportCompileProfile(profile, fusion_id_);
+    }
+  }
+
   if (measure_kernel_time_) {
     kernel_runtime->enableKernelTimeMeasurement();
   }
@@ -645,6 +776,177 @@ DynamicTransformInitialInfo& FusionExecutorCache::initialInfo() {
   return initial_info_.value();
 }
 
+namespace {
+
+// Note [ Kernel runtime re-use buckets ]
+//
+// On an input id miss, getKernelRuntimeFor looks for an existing
+// FusionKernelRuntime whose heuristics also fit the new inputs, which costs
+// a full heuristics evaluation per candidate. To keep that from growing with
+// the number of runtimes, the inputs are first classified by properties that
+// the heuristics are very sensitive to: the index type and, for each tensor,
+// which dimensions are broadcast, which are contiguous and the alignment of
+// its data. The runtimes that served inputs of a class are checked first.
+// Other runtimes are checked only once per class: a runtime that fails is
+// remembered as rejected for the class and skipped from then on. This may
+// miss a re-use for other sizes of the same class, which only costs a
+// compilation, but bounds the heuristics evaluations of a miss by the number
+// of runtimes that served the class plus the ones never tried for it.
+InputsSignature computeShapeClass(
+    const KernelArgumentHolder& args,
+    std::optional<PrimDataType> forced_index_type,
+    int64_t conc_info_id) {
+  constexpr int64_t kScalarTag = -1;
+  constexpr int64_t kCpuScalarTag = -2;
+  constexpr int64_t kBroadcast = 1;
+  constexpr int64_t kContiguous = 2;
+
+  InputsSignature shape_class;
+  shape_class.append(args.getDeviceIndex());
+  shape_class.append(conc_info_id);
+  shape_class.append((int64_t)forced_index_type.value_or(
+      args.getSmallestIndexTypeOfArguments()));
+  for (auto i : c10::irange(args.size())) {
+    const PolymorphicValue* arg = args[i];
+    if (!arg->is<at::Tensor>()) {
+      shape_class.append(kScalarTag);
+      continue;
+    }
+    const auto& tensor = arg->as<at::Tensor>();
+    if (tensor.is_cpu()) {
+      shape_class.append(kCpuScalarTag);
+      continue;
+    }
+    shape_class.append(tensor.dim());
+    int64_t expected_stride = 1;
+    for (int64_t dim = tensor.dim() - 1; dim >= 0; dim--) {
+      auto size = tensor.size(dim);
+      if (size == 1) {
+        shape_class.append(kBroadcast);
+        continue;
+      }
+      shape_class.append(
+          tensor.stride(dim) == expected_stride ? kContiguous : 0);
+      expected_stride = tensor.stride(dim) * size;
+    }
+    shape_class.append((int64_t)SchedulerRuntimeInfo::computeAlignmentSize(
+        (size_t)tensor.data_ptr()));
+  }
+  return shape_class;
+}
+
+// Note [ Shape buckets ]
+//
+// With NVFUSER_ENABLE=shape_buckets, heuristics are not computed from the
+// sizes of the inputs but from the representative of the bucket of each size,
+// so that all sizes of a bucket get the same heuristics and hence share a
+// compiled kernel. A size n > 1 that is not a power of two falls into the
+// bucket of the next power of two P, and the representative of the bucket is
+// P - d, where d is the largest power of two dividing n, capped at 16. The
+// representative is at least n and has the same power-of-two divisors as n up
+// to 16, so vectorization chosen for the representative is also valid for n.
+// Only sizes of dense tensors are bucketed, since other tensors can't be
+// resized without changing their layout. Heuristics of persistent and matmul
+// schedulers depend on exact sizes for more than performance, and launch
+// parameters that fix the grid are only valid for the sizes they were
+// computed from, so runtimes that would use them are built from the exact
+// sizes instead.
+int64_t shapeBucketRepresentative(int64_t size) {
+  if (size <= 1 || (size & (size - 1)) == 0) {
+    return size;
+  }
+  int64_t next_pow2 = 1;
+  while (next_pow2 < size) {
+    next_pow2 <<= 1;
+  }
+  constexpr int64_t kMaxPreservedDivisor = 16;
+  return next_pow2 - std::min(size & -size, kMaxPreservedDivisor);
+}
+
+// Returns a copy of args in which the sizes of dense tensors are replaced by
+// the representatives of their buckets. The tensors keep the data pointers of
+// args so that the alignment seen by the heuristics is unchanged, but must
+// never be read. See Note [ Shape buckets ].
+KernelArgumentHolder bucketShapes(const KernelArgumentHolder& args) {
+  KernelArgumentHolder bucketed_args;
+  bucketed_args.setDeviceIndex(args.getDeviceIndex());
+  if (args.getCacheId().has_value()) {
+    bucketed_args.setCacheId(*args.getCacheId());
+  }
+  for (auto i : c10::irange(args.size())) {
+    const PolymorphicValue* arg = args[i];
+    if (!arg->is<at::Tensor>() || arg->as<at::Tensor>().is_cpu()) {
+      bucketed_args.push(*arg);
+      continue;
+    }
+    const auto& tensor = arg->as<at::Tensor>();
+    std::vector<int64_t> sizes(tensor.dim());
+    std::vector<int64_t> strides(tensor.dim());
+    bool dense = true;
+    int64_t expected_stride = 1;
+    int64_t bucketed_stride = 1;
+    for (int64_t dim = tensor.dim() - 1; dim >= 0; dim--) {
+      const auto size = tensor.size(dim);
+      sizes[dim] = shapeBucketRepresentative(size);
+      if (tensor.stride(dim) == 0) {
+        // Expanded broadcast
+        strides[dim] = 0;
+        continue;
+      }
+      if (size != 1 && tensor.stride(dim) != expected_stride) {
+        dense = false;
+        break;
+      }
+      strides[dim] = bucketed_stride;
+      expected_stride *= size;
+      bucketed_stride *= sizes[dim];
+    }
+    if (!dense) {
+      bucketed_args.push(*arg);
+      continue;
+    }
+    bucketed_args.push(at::from_blob(
+        tensor.data_ptr(), sizes, strides, [](void*) {}, tensor.options()));
+  }
+  return bucketed_args;
+}
+
+// Whether some launch parameters of heuristics fix the grid. Grids computed
+// for the representative of a bucket are too large for the other sizes of the
+// bucket, e.g. the reduction heuristics set gdimx and gdimy from the
+// iteration extent.
+bool hasGridDims(const FusionHeuristics& heuristics) {
+  const auto& list = heuristics.heuristicsList();
+  return std::any_of(list.begin(), list.end(), [](const auto& h) {
+    const auto& lparams = h->params()->lparams;
+    return lparams.hasDim(ParallelType::BIDx) ||
+        lparams.hasDim(ParallelType::BIDy) ||
+        lparams.hasDim(ParallelType::BIDz);
+  });
+}
+
+// Whether the heuristics of all segments of runtime are safe to share by all
+// sizes of a bucket. See Note [ Shape buckets ].
+bool canShareHeuristicsInBucket(FusionKernelRuntime* runtime) {
+  if (hasGridDims(*runtime->schedulerHeuristics())) {
+    return false;
+  }
+  const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+  return std::all_of(heuristics.begin(), heuristics.end(), [](const auto& h) {
+    switch (h->heuristic()) {
+      case ScheduleHeuristic::NoOp:
+      case ScheduleHeuristic::PointWise:
+      case ScheduleHeuristic::Reduction:
+      case ScheduleHeuristic::Transpose:
+        return true;
+      default:
+        return false;
+    }
+  });
+}
+
+} // namespace
+
 FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     const KernelArgumentHolder& args,
     std::optional<PrimDataType> forced_index_type) {
@@ -693,6 +995,13 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
   FusionKernelRuntime* kernel_runtime = nullptr;
 
   bool reusing = false;
+  ReuseBucket* bucket = nullptr;
+
+  // See Note [ Shape buckets ]
+  std::optional<KernelArgumentHolder> bucketed_args;
+  if (isOptionEnabled(EnableOption::ShapeBuckets)) {
+    bucketed_args = bucketShapes(args);
+  }
   // By default, we try to avoid recompiling whenever possible. However, this
   // can lead to suboptimal code if we only check that a compiled kernel is able
   // to run with some inputs, instead of whether it is optimal to do so. The
@@ -700,22 +1009,84 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
   // that whenever we encounter a new set of input shapes we segment and compile
   // a new FusionKernelRuntime.
   if (!isOptionDisabled(DisableOption::KernelReuse)) {
-    auto reuse_it = std::find_if(
-        kernel_runtimes.begin(),
-        kernel_runtimes.end(),
-        [&args, &new_heuristics, &forced_index_type](auto& kernel_runtime) {
-          auto maybe_heuristics =
-              kernel_runtime->getMaybeHeuristicsFor(args, forced_index_type);
-          if (!maybe_heuristics.has_value()) {
-            return false;
-          }
-          new_heuristics = std::move(maybe_heuristics.value());
-          return true;
-        });
-    if (reuse_it != kernel_runtimes.end()) {
-      kernel_runtime = reuse_it->get();
+    // See Note [ Kernel runtime re-use buckets ]
+    bucket = &reuse_buckets_[computeShapeClass(
+        args, forced_index_type, conc_info_id_map_.at(config))];
+
+    int64_t num_evaluations = 0;
+    bool bucket_hit = false;
+    auto can_reuse = [&](FusionKernelRuntime* candidate) {
+      num_evaluations++;
+      bucket_hit = bucketed_runtimes_.count(candidate) > 0;
+      auto maybe_heuristics = candidate->getMaybeHeuristicsFor(
+          bucket_hit ? *bucketed_args : args, forced_index_type);
+      if (!maybe_heuristics.has_value()) {
+        return false;
+      }
+      new_heuristics = std::move(maybe_heuristics.value());
+      return true;
+    };
+
+    auto bucket_it = std::find_if(
+        bucket->runtimes.begin(), bucket->runtimes.end(), can_reuse);
+    if (bucket_it != bucket->runtimes.end()) {
+      kernel_runtime = *bucket_it;
+    } else {
+      for (auto& candidate : kernel_runtimes) {
+        if (std::find(
+                bucket->runtimes.begin(),
+                bucket->runtimes.end(),
+                candidate.get()) != bucket->runtimes.end()) {
+          continue;
+        }
+        if (bucket->rejected.count(candidate.get())) {
+          reuse_stats_.negative_cache_hits++;
+          continue;
+        }
+        if (can_reuse(candidate.get())) {
+          kernel_runtime = candidate.get();
+          bucket->runtimes.push_back(kernel_runtime);
+          break;
+        }
+        bucket->rejected.insert(candidate.get());
+      }
+    }
+
+    reuse_stats_.searches++;
+    reuse_stats_.heuristics_evaluations += num_evaluations;
+    reuse_stats_.max_heuristics_evaluations =
+        std::max(reuse_stats_.max_heuristics_evaluations, num_evaluations);
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Kernel runtime re-use search: " << num_evaluations
+              << " heuristics evaluations for " << kernel_runtimes.size()
+              << " runtimes, "
+              << (kernel_runtime != nullptr ? "re-using" : "no match")
+              << std::endl;
+    }
+
+    if (kernel_runtime != nullptr && bucket_hit) {
+      // Prefer the launch parameters of the exact sizes if they are
+      // compatible with the kernels. Otherwise, the bucket saved a compilation
+      // and the launch parameters of the bucket are used.
+      auto exact_heuristics =
+          kernel_runtime->getMaybeHeuristicsFor(args, forced_index_type);
+      if (exact_heuristics.has_value()) {
+        new_heuristics = std::move(exact_heuristics.value());
+      } else if (hasGridDims(*new_heuristics)) {
+        // The grid of the bucket would be launched for the exact sizes
+        kernel_runtime = nullptr;
+      } else {
+        reuse_stats_.compiles_avoided++;
+      }
+      if (kernel_runtime != nullptr) {
+        reuse_stats_.bucket_hits++;
+      }
+    }
+
+    if (kernel_runtime != nullptr) {
       kernel_runtime->updateHeuristicsLaunchParams(new_heuristics.get());
       reusing = true;
+      reuse_stats_.reused++;
     }
   }
 
@@ -748,14 +1119,49 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
       }
     }
     FusionGuard fg(conc_fusion.get());
-    kernel_runtimes.emplace_back(std::make_unique<FusionKernelRuntime>(
-        std::move(conc_fusion),
-        args,
-        forced_index_type,
-        fusion_id_,
-        conc_info_id_map_.at(config),
-        kernel_runtimes.size()));
+    // Runtimes of a concretization segment copies of the same fusion, so the
+    // last one seeds the segmentation of the new one. A runtime that isn't
+    // segmented has nothing to re-use.
+    const SegmentedFusion* segmentation_seed = nullptr;
+    if (isOptionEnabled(EnableOption::IncrementalSegmentation) &&
+        !kernel_runtimes.empty() &&
+        kernel_runtimes.back()->fusionSegments()->groups().size() > 1) {
+      segmentation_seed = kernel_runtimes.back()->fusionSegments();
+    }
+    std::unique_ptr<FusionKernelRuntime> new_runtime;
+    if (bucketed_args.has_value()) {
+      // See Note [ Shape buckets ]. The copy is kept in case the runtime
+      // has to be built from the exact sizes.
+      auto bucketed_fusion = std::make_unique<Fusion>(*conc_fusion);
+      FusionGuard bucketed_fg(bucketed_fusion.get());
+      auto bucketed_runtime = std::make_unique<FusionKernelRuntime>(
+          std::move(bucketed_fusion),
+          *bucketed_args,
+          forced_index_type,
+          fusion_id_,
+          conc_info_id_map_.at(config),
+          kernel_runtimes.size(),
+          segmentation_seed);
+      if (canShareHeuristicsInBucket(bucketed_runtime.get())) {
+        bucketed_runtimes_.insert(bucketed_runtime.get());
+        new_runtime = std::move(bucketed_runtime);
+      }
+    }
+    if (new_runtime == nullptr) {
+      new_runtime = std::make_unique<FusionKernelRuntime>(
+          std::move(conc_fusion),
+          args,
+          forced_index_type,
+          fusion_id_,
+          conc_info_id_map_.at(config),
+          kernel_runtimes.size(),
+          segmentation_seed);
+    }
+    kernel_runtimes.emplace_back(std::move(new_runtime));
     kernel_runtime = kernel_runtimes.back().get();
+    if (bucket != nullptr) {
+      bucket->runtimes.push_back(kernel_runtime);
+    }
 
     if (profiling_) {
       kernel_runtime->profile(true);
@@ -930,7 +1336,8 @@ FusionKernelRuntime::FusionKernelRuntime(
     std::optional<PrimDataType> forced_index_type,
     int64_t fusion_id,
     int64_t concrete_id,
-    int64_t runtime_id)
+    int64_t runtime_id,
+    const SegmentedFusion* segmentation_seed)
     : fusion_id_{fusion_id},
       concrete_id_{concrete_id},
       runtime_id_{runtime_id} {
@@ -941,11 +1348,10 @@ FusionKernelRuntime::FusionKernelRuntime(
       "Fusion must be concretized before constructing FusionKernelRuntime");
 
   // Store metadata copy of arguments for serialization
-  std::transform(
-      args.cbegin(),
-      args.cend(),
-      args_metadata_.getBackInserter(),
-      convertMetadataArg);
+  args_metadata_.reserve(args.size());
+  for (const auto i : c10::irange(args.size())) {
+    args_metadata_.push(convertMetadataArg(args[i]));
+  }
 
   optimization::OptimizationPass<optimization::PreSegmenter>::runPass(
       fusion.get());
@@ -965,8 +1371,8 @@ FusionKernelRuntime::FusionKernelRuntime(
   // Initialize the evaluator simplifer
   precomputed_values_ = std::make_unique<PrecomputedValues>(fusion.get());
 
-  segmented_fusion_ =
-      SegmentCandidateFinder::segment(std::move(fusion), args, runtime_info);
+  segmented_fusion_ = SegmentCandidateFinder::segment(
+      std::move(fusion), args, runtime_info, segmentation_seed);
 
   heuristics_ = segmented_fusion_->makeInitialHeuristics(args, runtime_info);
 
@@ -1049,7 +1455,8 @@ void FusionKernelRuntime::deserialize(
 
 std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     KernelArgumentHolder& args,
-    SegmentedGroup* sg) {
+    SegmentedGroup* sg,
+    const FusionExecutor::WorkspacePlacement* placement) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runKernelWithInput");
   std::lock_guard<std::mutex> guard(mutex_);
   // This function will be called once on un-segmented fusion,
@@ -1079,7 +1486,8 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     sprof.inputBytesAccessed(executor.inputBytesProcessed(args));
     sprof.startKernel(args.getDeviceIndex());
   }
-  auto outputs = executor.runFusion(args, launch_params, compile_params);
+  auto outputs =
+      executor.runFusion(args, launch_params, compile_params, {}, placement);
   if (isProfilerEnabled()) {
     auto& sprof = FusionProfiler::segment(group_id);
     sprof.stopKernel();
@@ -1173,10 +1581,52 @@ void FusionKernelRuntime::prepareRuntimeOrder() {
         one_ran,
         "Couldn't run all groups, something must have gone wrong in segmentation.");
   }
+
+  // Map vals to the position in the run order of the group that lastly uses
+  // them. Never delete global fusion inputs and outputs, they may be used by
+  // other fusions or code.
+  auto isFusionInputOrOutput = [](Val* val) {
+    return val->isFusionInput() || val->isFusionOutput();
+  };
+  const auto& group_run_order = runtime_workspace_.group_run_order;
+  const int64_t num_groups = (int64_t)group_run_order.size();
+  std::unordered_map<Val*, int64_t> last_used_segment_map;
+  // only need to set lifetime of vals if there are more than 3 groups
+  if (num_groups >= 3) {
+    // start from the 2nd group, since the input of the first group is always
+    // the global input and its outputs are always used by at least one of the
+    // following groups
+    for (auto group_id : c10::irange(1l, num_groups)) {
+      auto group_to_run = group_run_order.at(group_id);
+      // set/update life of vals in inputs of this group
+      for (auto val : group_to_run->inputs()) {
+        if (!isFusionInputOrOutput(val)) {
+          last_used_segment_map[val] = group_id;
+        }
+      }
+      // set/update life of vals in outputs of this group
+      // skip the last group since its outputs are always the global outputs
+      if (group_id < num_groups - 1) {
+        for (auto val : group_to_run->outputs()) {
+          if (!isFusionInputOrOutput(val)) {
+            last_used_segment_map[val] = group_id;
+          }
+        }
+      }
+    }
+    // Group by segment, so we don't need to iterate over all vals when
+    // erasing
+    for (auto item : last_used_segment_map) {
+      runtime_workspace_.vals_last_used_at_segment[item.second].push_back(
+          item.first);
+    }
+  }
 }
 
 // passing args by value because we will be modify this
-void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
+void FusionKernelRuntime::compileFusionParallel(
+    KernelArgumentHolder args,
+    bool parallel_compile) {
   std::lock_guard<std::mutex> guard(mutex_);
 
   NVF_ERROR(
@@ -1193,6 +1643,8 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   auto group_cache_id = args.getCacheId();
 
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+  parallel_compile = parallel_compile && num_groups != 1 &&
+      !isOptionDisabled(DisableOption::ParallelCompile);
   num_live_args_after_segment_runs_.reserve(num_groups);
   if (isProfilerEnabled()) {
     FusionProfiler::startCompile();
@@ -1207,23 +1659,28 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
     if (group_cache_id.has_value()) {
       group_runtime_inputs.setCacheId(group_cache_id.value());
     }
+    group_runtime_inputs.reserve(group_to_run->inputs().size());
     for (auto input : group_to_run->inputs()) {
-      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
+      group_runtime_inputs.pushView(args_manager.checkTensorMap(input));
     }
 
-    if (num_groups == 1 || isOptionDisabled(DisableOption::ParallelCompile)) {
+    const auto device_index = args.getDeviceIndex();
+    if (!parallel_compile) {
       FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
-      c10::cuda::CUDAGuard dg(args.getDeviceIndex());
-      c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
+      c10::cuda::CUDAGuard dg(device_index);
+      c10::Device device(c10::DeviceType::CUDA, device_index);
       compileKernel(group_runtime_inputs, group_to_run);
     } else {
-      // launch compileKernel thread here
-      getThreadPool()->run([this, args, group_runtime_inputs, group_to_run]() {
-        FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
-        c10::cuda::CUDAGuard dg(args.getDeviceIndex());
-        c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
-        compileKernel(group_runtime_inputs, group_to_run);
-      });
+      // launch compileKernel thread here. The captured copy of
+      // group_runtime_inputs owns its arguments, so it stays valid after args
+      // is updated below.
+      getThreadPool()->run(
+          [this, device_index, group_runtime_inputs, group_to_run]() {
+            FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
+            c10::cuda::CUDAGuard dg(device_index);
+            c10::Device device(c10::DeviceType::CUDA, device_index);
+            compileKernel(group_runtime_inputs, group_to_run);
+          });
     }
 
     auto fusion_to_run = segmented_fusion_->makeFusion(group_to_run);
@@ -1237,7 +1694,7 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
     num_live_args_after_segment_runs_.push_back((int64_t)args.size());
   }
 
-  if (num_groups != 1 && !isOptionDisabled(DisableOption::ParallelCompile)) {
+  if (parallel_compile) {
     // wait until all segments finish compiling
     getThreadPool()->waitWorkComplete();
   }
@@ -1246,6 +1703,195 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   }
 }
 
+// passing args by value because we will be modify this
+SegmentWorkspacePlan FusionKernelRuntime::planWorkspace(
+    KernelArgumentHolder args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::planWorkspace");
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  NVF_ERROR(
+      args.size() == segmented_fusion_->inputs().size(),
+      "Inputs were not set up correctly, received ",
+      args.size(),
+      " inputs but expecting ",
+      segmented_fusion_->inputs().size());
+
+  ArgumentManager args_manager(
+      args, runtime_workspace_, segmented_fusion_->inputs());
+  auto group_cache_id = args.getCacheId();
+  const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+
+  SegmentWorkspacePlan plan;
+  plan.placements.resize(num_groups);
+
+  // Buffers to lay out and where their offsets go
+  struct BufferSlot {
+    int64_t group_id = 0;
+    bool is_output = true;
+    int64_t index = 0;
+    bool excluded = false;
+  };
+  std::vector<WorkspaceBuffer> buffers;
+  std::vector<BufferSlot> slots;
+  std::unordered_map<Val*, size_t> buffer_of_val;
+
+  for (auto group_id : c10::irange(num_groups)) {
+    auto group_to_run = runtime_workspace_.group_run_order.at(group_id);
+    auto& placement = plan.placements.at(group_id);
+
+    KernelArgumentHolder group_runtime_inputs;
+    group_runtime_inputs.setDeviceIndex(args.getDeviceIndex());
+    group_runtime_inputs.reserve(group_to_run->inputs().size());
+    for (auto input : group_to_run->inputs()) {
+      group_runtime_inputs.pushView(args_manager.checkTensorMap(input));
+      // Inputs produced by earlier segments live until this one has run
+      auto it = buffer_of_val.find(input);
+      if (it != buffer_of_val.end()) {
+        buffers.at(it->second).last_use = group_id;
+      }
+    }
+
+    auto fusion_to_run = segmented_fusion_->makeFusion(group_to_run);
+    auto group_runtime_outputs =
+        executors_.at(group_to_run->groupId())
+            .inferOutputSizes(fusion_to_run.get(), group_runtime_inputs);
+
+    const auto& group_outputs = group_to_run->outputs();
+    placement.output_offsets.assign(group_outputs.size(), -1);
+    placement.output_capacities.assign(group_outputs.size(), 0);
+    for (auto out_i : c10::irange(group_outputs.size())) {
+      Val* output = group_outputs.at(out_i);
+      // An output that aliases an input shares its memory, so neither can be
+      // given a slot that is reused once the input is dead
+      Val* aliased_in =
+          fusion_to_run->getOutputAlias(fusion_to_run->outputs().at(out_i))
+              .first;
+      if (aliased_in != nullptr) {
+        auto in_it = std::find(
+            fusion_to_run->inputs().begin(),
+            fusion_to_run->inputs().end(),
+            aliased_in);
+        NVF_ERROR(in_it != fusion_to_run->inputs().end());
+        auto buffer_it = buffer_of_val.find(group_to_run->inputs().at(
+            std::distance(fusion_to_run->inputs().begin(), in_it)));
+        if (buffer_it != buffer_of_val.end()) {
+          slots.at(buffer_it->second).excluded = true;
+        }
+        continue;
+      }
+      // Fusion inputs and outputs are owned by the caller, and forwarded
+      // inputs are already placed
+      if (output->isFusionInput() || output->isFusionOutput() ||
+          buffer_of_val.count(output) ||
+          std::find(
+              group_to_run->inputs().begin(),
+              group_to_run->inputs().end(),
+              output) != group_to_run->inputs().end()) {
+        continue;
+      }
+      const auto& proxy = group_runtime_outputs[out_i]->as<at::Tensor>();
+      buffer_of_val.emplace(output, buffers.size());
+      buffers.push_back(
+          {(int64_t)proxy.storage().nbytes(), group_id, group_id});
+      slots.push_back({group_id, true, (int64_t)out_i});
+    }
+
+    // Intermediates are only known once the kernel has been launched with
+    // these inputs
+    const std::vector<FusionExecutor::GlobalBufferInfo>* intermediates =
+        group_cache_id.has_value()
+        ? executors_.at(group_to_run->groupId())
+              .intermediateBufferInfo(group_cache_id.value())
+        : nullptr;
+    if (intermediates != nullptr) {
+      placement.intermediate_offsets.assign(intermediates->size(), -1);
+      placement.intermediate_capacities.assign(intermediates->size(), 0);
+      for (auto i : c10::irange(intermediates->size())) {
+        const auto& info = intermediates->at(i);
+        if (info.is_profile_buffer) {
+          continue;
+        }
+        int64_t num_bytes = (int64_t)c10::elementSize(info.type);
+        for (auto size : info.sizes) {
+          num_bytes *= size;
+        }
+        buffers.push_back({num_bytes, group_id, group_id});
+        slots.push_back({group_id, false, (int64_t)i});
+      }
+    }
+
+    args_manager.updateWithSegmentOutputs(
+        group_to_run->outputs(), group_runtime_outputs, group_id);
+  }
+
+  std::vector<WorkspaceBuffer> placed_buffers;
+  std::vector<size_t> placed_slots;
+  for (auto i : c10::irange(buffers.size())) {
+    if (!slots.at(i).excluded) {
+      placed_buffers.push_back(buffers.at(i));
+      placed_slots.push_back(i);
+    }
+  }
+  auto layout = layoutWorkspace(placed_buffers);
+  plan.workspace_size = layout.size;
+  plan.total_buffer_size = layout.total_buffer_size;
+  for (auto i : c10::irange(placed_slots.size())) {
+    const auto& slot = slots.at(placed_slots.at(i));
+    auto& placement = plan.placements.at(slot.group_id);
+    if (slot.is_output) {
+      placement.output_offsets.at(slot.index) = layout.offsets.at(i);
+      placement.output_capacities.at(slot.index) = placed_buffers.at(i).size;
+    } else {
+      placement.intermediate_offsets.at(slot.index) = layout.offsets.at(i);
+      placement.intermediate_capacities.at(slot.index) =
+          placed_buffers.at(i).size;
+    }
+  }
+  return plan;
+}
+
+const SegmentWorkspacePlan* FusionKernelRuntime::bindWorkspacePlan(
+    size_t input_id,
+    int64_t device_index) {
+  auto it = workspace_plans_.find(input_id);
+  if (it == workspace_plans_.end()) {
+    return nullptr;
+  }
+  auto& plan = it->second;
+
+  // A workspace still in use by kernels on another stream can't be reused
+  // without synchronization, so it is replaced, and released to the caching
+  // allocator on the stream it was used on.
+  c10::Stream stream =
+      c10::cuda::getCurrentCUDAStream((c10::DeviceIndex)device_index);
+  if (!workspace_.defined() || workspace_.numel() < plan.workspace_size ||
+      workspace_stream_ != stream) {
+    // Size the workspace for all plans, and unbind them so that none of them
+    // keeps the previous workspace alive. They are bound again when used.
+    int64_t workspace_size = 0;
+    for (auto& [id, other_plan] : workspace_plans_) {
+      workspace_size = std::max(workspace_size, other_plan.workspace_size);
+      for (auto& placement : other_plan.placements) {
+        placement.workspace = at::Tensor();
+      }
+    }
+    workspace_ = at::Tensor();
+    workspace_ = at::empty(
+        {workspace_size},
+        at::TensorOptions()
+            .dtype(at::kByte)
+            .device(c10::DeviceType::CUDA, (c10::DeviceIndex)device_index));
+    workspace_stream_ = stream;
+  }
+
+  for (auto& placement : plan.placements) {
+    if (!placement.workspace.is_same(workspace_)) {
+      placement.workspace = workspace_;
+    }
+  }
+  return &plan;
+}
+
 void FusionKernelRuntime::compileKernel(
     const KernelArgumentHolder& args,
     SegmentedGroup* sg) {
@@ -1344,11 +1990,30 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
 
   int64_t total_bytes_processed = 0;
 
+  // group should share cache id.
+  auto group_cache_id = args.getCacheId();
+
+  // Place the tensors passed between segments and the intermediates of the
+  // segments in the workspace planned for these inputs. The plan is made
+  // after the first run with them, when the intermediates are known. If
+  // another run holds the workspace, buffers are allocated as usual.
+  std::unique_lock<std::mutex> workspace_lock(
+      workspace_mutex_, std::defer_lock);
+  const SegmentWorkspacePlan* workspace_plan = nullptr;
+  std::optional<KernelArgumentHolder> args_to_plan;
+  if (group_cache_id.has_value() &&
+      isOptionEnabled(EnableOption::SegmentWorkspace) &&
+      workspace_lock.try_lock()) {
+    workspace_plan =
+        bindWorkspacePlan(group_cache_id.value(), args.getDeviceIndex());
+    if (workspace_plan == nullptr) {
+      args_to_plan = args;
+    }
+  }
+
   ArgumentManager args_manager(
       args, runtime_workspace_, segmented_fusion_->inputs());
 
-  // group should share cache id.
-  auto group_cache_id = args.getCacheId();
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
   num_live_args_after_segment_runs_.reserve(num_groups);
   kernel_time_ms_ = 0;
@@ -1361,16 +2026,19 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     if (group_cache_id.has_value()) {
       group_runtime_inputs.setCacheId(group_cache_id.value());
     }
+    group_runtime_inputs.reserve(group_to_run->inputs().size());
     for (auto input : group_to_run->inputs()) {
-      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
+      group_runtime_inputs.pushView(args_manager.checkTensorMap(input));
     }
 
     // TODO: currently we are still outputing PyTorch tensors, instead of
     // something abstract. This is quite unsatisfying.
 
     // Run graph segment
-    std::vector<at::Tensor> group_runtime_outputs =
-        runKernelWithInput(group_runtime_inputs, group_to_run);
+    std::vector<at::Tensor> group_runtime_outputs = runKernelWithInput(
+        group_runtime_inputs,
+        group_to_run,
+        workspace_plan ? &workspace_plan->placements.at(group_id) : nullptr);
     args_manager.updateWithSegmentOutputs(
         group_to_run->outputs(), group_runtime_outputs, group_id);
     num_live_args_after_segment_runs_.push_back((int64_t)args.size());
@@ -1386,6 +2054,16 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     }
   }
 
+  if (args_to_plan.has_value()) {
+    auto plan = planWorkspace(std::move(args_to_plan.value()));
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Segment workspace for input id " << group_cache_id.value()
+              << ": " << plan.workspace_size << " bytes, "
+              << plan.total_buffer_size << " bytes without reuse" << std::endl;
+    }
+    workspace_plans_.emplace(group_cache_id.value(), std::move(plan));
+  }
+
   if (isProfilerEnabled()) {
     int64_t input_bytes = 0;
     for (auto inp : fusionSegments()->inputs()) {
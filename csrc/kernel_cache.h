@@ -17,12 +17,19 @@
 #include <scheduler/registry.h>
 #include <serde/fusion_cache_generated.h>
 
+#include <c10/core/Stream.h>
 #include <c10/macros/Export.h>
 #include <c10/util/ArrayRef.h>
+#include <c10/util/SmallVector.h>
 
+#include <array>
+#include <atomic>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace nvfuser {
 
@@ -42,6 +49,27 @@ struct RuntimeWorkSpace {
 
   //! Pre-determined order to bind tensor input meta data
   std::vector<Val*> group_extent_binding_order;
+
+  //! Vals, other than fusion inputs and outputs, that are last used by the
+  //! group at each position of group_run_order, so their arguments can be
+  //! released once it has run
+  std::unordered_map<int64_t, std::vector<Val*>> vals_last_used_at_segment;
+};
+
+//! Static layout of the tensors passed between segments and of the global
+//! intermediates of each segment in a single workspace. Buffers that are not
+//! live while the same segment runs may share memory. See
+//! FusionKernelRuntime::planWorkspace.
+struct SegmentWorkspacePlan {
+  //! Peak workspace size in bytes
+  int64_t workspace_size = 0;
+
+  //! Bytes the planned buffers would take if no memory were reused
+  int64_t total_buffer_size = 0;
+
+  //! Placement of the buffers of each segment, indexed by position in the
+  //! run order. The workspace is bound when the plan is used.
+  std::vector<FusionExecutor::WorkspacePlacement> placements;
 };
 //! Simple hasher for pair<T, const U*>. There is no default hasher for pairs,
 //! since there are a lot of options how to combine hashes. In a case where one
@@ -95,7 +123,8 @@ class FusionKernelRuntime {
       std::optional<PrimDataType> forced_index_type = std::nullopt,
       int64_t fusion_id = 0,
       int64_t concrete_id = 0,
-      int64_t runtime_id = 0);
+      int64_t runtime_id = 0,
+      const SegmentedFusion* segmentation_seed = nullptr);
 
   //! Type notations within FusionKernelRuntime Context
   using HashType = size_t;
@@ -107,6 +136,8 @@ class FusionKernelRuntime {
     for (auto& fe : executors_) {
       fe.evictCache(input_id);
     }
+    std::lock_guard<std::mutex> guard(workspace_mutex_);
+    workspace_plans_.erase(input_id);
   }
 
   //! query if we already have a compiled kernel for execution
@@ -142,12 +173,36 @@ class FusionKernelRuntime {
 
   //! Compile a kernel executor for given inputs. Note: The compilation is
   //! multithreaded. The segments in the fusion are compiled independently.
-  void compileFusionParallel(KernelArgumentHolder args);
+  //! If parallel_compile is false, the segments are instead compiled one
+  //! after another on the calling thread.
+  void compileFusionParallel(
+      KernelArgumentHolder args,
+      bool parallel_compile = true);
 
   const std::vector<int64_t>& getArgsNumAfterSegmentRuns() {
     return num_live_args_after_segment_runs_;
   }
 
+  //! Lays out the tensors passed between segments, and the intermediates of
+  //! segments already run with the cache id of args, in one workspace from
+  //! their live ranges in the run order. Fusion inputs and outputs, and
+  //! tensors aliased by segment outputs, are left out. Only the metadata of
+  //! tensor arguments is used, so they may be proxies (see
+  //! KernelArgumentHolder::pushTensorProxy).
+  SegmentWorkspacePlan planWorkspace(KernelArgumentHolder args);
+
+  //! Returns the workspace plan used for runs with the given input cache id,
+  //! if any. Plans are made after the first run with a cache id when
+  //! EnableOption::SegmentWorkspace is set.
+  std::optional<SegmentWorkspacePlan> getWorkspacePlan(size_t input_id) {
+    std::lock_guard<std::mutex> guard(workspace_mutex_);
+    auto it = workspace_plans_.find(input_id);
+    if (it == workspace_plans_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
   //! Turn On/Off profiling
   void profile(bool to_profile = true) {
     profiling_ = to_profile;
@@ -234,10 +289,12 @@ class FusionKernelRuntime {
 
   //! Interface to run a single kernel, either one kernel for single-kernel
   //! fusions, or a kernel for a segmentedGrouup in a segmented fusion. Returns
-  //! the kernel outputs.
+  //! the kernel outputs. Buffers given a place in a workspace by placement
+  //! are created there.
   std::vector<at::Tensor> runKernelWithInput(
       KernelArgumentHolder& args,
-      SegmentedGroup* sg);
+      SegmentedGroup* sg,
+      const FusionExecutor::WorkspacePlacement* placement = nullptr);
 
   //! Interface to compile a single kernel. It is either a single kernel for a
   //! fusion or a kernel for a segmentedGrouup in a segmented fusion. Returns
@@ -253,6 +310,14 @@ class FusionKernelRuntime {
 
   void prepareRuntimeOrder();
 
+  //! Returns the workspace plan for the given input cache id with the
+  //! workspace bound, (re)allocating the workspace if it is too small or was
+  //! last used on another stream. Returns nullptr if there is no plan yet.
+  //! workspace_mutex_ must be held.
+  const SegmentWorkspacePlan* bindWorkspacePlan(
+      size_t input_id,
+      int64_t device_index);
+
  private:
   //! Entries indexed by groupID:
   //! Executors holding compiled kernels
@@ -300,6 +365,18 @@ class FusionKernelRuntime {
 
   std::mutex mutex_;
 
+  //! Workspace plans, keyed by input cache id
+  std::unordered_map<size_t, SegmentWorkspacePlan> workspace_plans_;
+
+  //! Workspace shared by the plans. It is kept between runs, which are
+  //! ordered on the stream it was last used on.
+  at::Tensor workspace_;
+  std::optional<c10::Stream> workspace_stream_;
+
+  //! Guards the workspace plans and the workspace. Runs that find it held
+  //! allocate their buffers as usual.
+  std::mutex workspace_mutex_;
+
   // ID of fusion in python frontend fusion cache, which maps to a single
   // FusionExecutorCache.
   int64_t fusion_id_ = -1;
@@ -314,6 +391,67 @@ class FusionKernelRuntime {
   ExecutorLog most_recent_executor_log_;
 };
 
+//! Fixed-width binary signature of a set of kernel inputs.
+//!
+//! The signature packs the device index, the sizes, strides and alignment of
+//! each tensor and the values of any recorded scalars as raw int64_t words.
+//! The words are kept in an inline small buffer, so computing the signature of
+//! a typical input set does not allocate, and they are used to verify equality
+//! after the 128-bit hash, which is accumulated as words are appended, matches.
+class InputsSignature {
+ public:
+  //! Number of words stored inline before spilling to the heap. This covers
+  //! e.g. six rank-4 tensors.
+  static constexpr size_t kInlineWords = 64;
+
+  InputsSignature() = default;
+
+  //! Rebuild a signature from raw bytes produced by bytes()
+  InputsSignature(const char* data, size_t num_bytes);
+
+  void append(int64_t word) {
+    words_.push_back(word);
+    mix(word);
+  }
+
+  //! Lower 64 bits of the 128-bit hash, used for bucketing
+  size_t hash() const {
+    return static_cast<size_t>(hash_[0]);
+  }
+
+  bool operator==(const InputsSignature& other) const {
+    return hash_ == other.hash_ && words_.size() == other.words_.size() &&
+        std::equal(words_.begin(), words_.end(), other.words_.begin());
+  }
+
+  //! Raw byte view of the packed key, used for serialization
+  const char* data() const {
+    return reinterpret_cast<const char*>(words_.data());
+  }
+
+  size_t numBytes() const {
+    return words_.size() * sizeof(int64_t);
+  }
+
+ private:
+  void mix(int64_t word);
+
+ private:
+  //! Two independently seeded 64-bit lanes
+  std::array<uint64_t, 2> hash_ = {
+      0x9e3779b97f4a7c15ULL,
+      0xc2b2ae3d27d4eb4fULL};
+
+  //! Packed key
+  c10::SmallVector<int64_t, kInlineWords> words_;
+};
+
+struct InputsSignatureHash {
+  size_t operator()(const InputsSignature& signature) const {
+    return signature.hash();
+  }
+};
+
 //! Encoding an input set to unique id, which is used to short-cut cache entry
 //! selection in our nested cache implementation to cut off overhead.
 //!
@@ -322,6 +460,11 @@ class FusionKernelRuntime {
 //! grow gigantic when we have input shapes that does not stabalize to a finite
 //! set.
 //!
+//! The lookup table is read-mostly: a hit only takes a shared lock and stamps
+//! the entry with a logical clock, and the exclusive lock is only taken to
+//! insert a new entry, at which point the entry with the oldest stamp is
+//! evicted if the cache is full.
+//!
 //! \note the uniqueness of the ide generated for a given input set is only
 //!   local to the instance of `InputsIdLookup`.
 //!
@@ -370,6 +513,13 @@ class InputsIdLookup : public NonCopyable {
       const std::unordered_set<size_t>& scalar_inputs_to_record = {},
       int8_t device = 0);
 
+  //! Compute the binary signature used as the lookup key for inputs. See
+  //! lookupId for the meaning of the arguments.
+  static InputsSignature computeSignature(
+      const at::ArrayRef<c10::IValue>& inputs,
+      const std::unordered_set<size_t>& scalar_inputs_to_record = {},
+      int8_t device = 0);
+
   //! debugging API that returns the size of lookup table
   size_t size() const {
     return encoding_lookup_.size();
@@ -383,36 +533,47 @@ class InputsIdLookup : public NonCopyable {
   void deserialize(const serde::InputsIdLookup* buffer);
 
  private:
-  // string to store encoded input meta information. Reuse the buffer instead of
-  // stringtream gives few us perf gain.
-  std::string encoding_; // Note: shared state, guarded by mutex_
-
-  // mutex_ used to guard reused encoding_
-  std::mutex mutex_;
-
   //! entry stored in `encoding_lookup_` to implement LRU
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
   struct EncodingEntry {
+    EncodingEntry(size_t id_, uint64_t last_used_)
+        : id(id_), last_used(last_used_) {}
+
     size_t id = 0;
-    std::list<std::string>::iterator lru_iter;
+    //! value of `clock_` at the most recent use of this entry. Updated under
+    //! the shared lock, hence atomic.
+    std::atomic<uint64_t> last_used;
   };
 
+  //! Stamp an entry as most recently used
+  void touch(EncodingEntry& entry) {
+    entry.last_used.store(
+        clock_.fetch_add(1, std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+  }
+
+  //! Entries ordered from the most recently used to the least recently used
+  std::vector<const std::pair<const InputsSignature, EncodingEntry>*>
+  entriesByRecency() const;
+
+ private:
+  //! guards the structure of `encoding_lookup_`. Lookup hits take it shared,
+  //! insertion and eviction take it exclusively.
+  mutable std::shared_mutex mutex_;
+
   //! maximum cache size for LRU
   size_t max_cache_size_ = 0;
 
   //! next available unique id, we monotonically increase `current_id_` avoid
-  //! conflicts
+  //! conflicts. Only modified under exclusive lock.
   size_t current_id_ = 1;
 
-  //! entry in the cache, This is used to implement LRU cache, where entries in
-  //! the list is ordered by their recent usage (freshly used entry is placed at
-  //! the beginning)
-  std::list<std::string> used_entry_;
+  //! logical clock used to order entries by their recent usage
+  std::atomic<uint64_t> clock_{0};
 
-  //! map from `std::string` to a unique id `size_t` (packaged in
-  //! `EncodingEntry`
-  //! ). We store an iterator to `used_entry_` to implement LRU
-  std::unordered_map<std::string, EncodingEntry> encoding_lookup_;
+  //! map from the input signature to a unique id `size_t` (packaged in
+  //! `EncodingEntry`).
+  std::unordered_map<InputsSignature, EncodingEntry, InputsSignatureHash>
+      encoding_lookup_;
 };
 
 //! [ Note -- Post-definition cache implementation ]
@@ -530,6 +691,26 @@ class FusionExecutorCache {
   //! query if there's a kernel ready to go for given inputs
   bool isCompiled(const at::ArrayRef<c10::IValue>& inputs, int8_t device = 0);
 
+  //! Segment, schedule, lower and compile the fusion for inputs like the
+  //! given ones without running it, so that a later runFusionWithInputs with
+  //! inputs of the same sizes, strides and dtypes does not stall on
+  //! compilation. Only the metadata of tensor inputs is used: they are passed
+  //! to the compiler as proxies (see KernelArgumentHolder::pushTensorProxy),
+  //! so meta tensors, e.g. from at::empty_strided(..., at::kMeta), can stand
+  //! in for real ones. Tensors without a data pointer are assumed to be
+  //! maximally aligned. Returns true if anything was compiled and false if
+  //! the inputs hit an already compiled runtime.
+  bool compileFusionAheadOfTime(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> selected_device = std::nullopt);
+  //! Same as compileFusionAheadOfTime, but also returns the kernel runtime
+  //! for the inputs, whether it was compiled by this call or before. See
+  //! FusionKernelRuntime::compileFusionParallel for parallel_compile.
+  std::pair<FusionKernelRuntime*, bool> compileKernelRuntimeAheadOfTime(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> selected_device = std::nullopt,
+      bool parallel_compile = true);
+
   Fusion* fusion() {
     return fusion_.get();
   }
@@ -653,6 +834,30 @@ class FusionExecutorCache {
     return rt->kernelTimeMs();
   }
 
+  //! Counters of the search for a re-usable FusionKernelRuntime that
+  //! getKernelRuntimeFor does on every input id miss
+  struct ReuseStats {
+    //! Searches, i.e. input id misses with kernel re-use enabled
+    int64_t searches = 0;
+    //! Searches that found a runtime to re-use
+    int64_t reused = 0;
+    //! Calls to FusionKernelRuntime::getMaybeHeuristicsFor
+    int64_t heuristics_evaluations = 0;
+    //! Most calls to getMaybeHeuristicsFor done by a single search
+    int64_t max_heuristics_evaluations = 0;
+    //! Candidates skipped because they already failed for the shape class
+    int64_t negative_cache_hits = 0;
+    //! Re-uses of a runtime whose heuristics were computed from shape
+    //! buckets. See Note [ Shape buckets ] in kernel_cache.cpp.
+    int64_t bucket_hits = 0;
+    //! Bucket hits whose exact sizes would not have re-used the runtime
+    int64_t compiles_avoided = 0;
+  };
+
+  const ReuseStats& reuseStats() const {
+    return reuse_stats_;
+  }
+
   //! Serialize Fusion Executor Cache using flatbuffers
   flatbuffers::Offset<serde::FusionExecutorCache> serialize(
       flatbuffers::FlatBufferBuilder& builder) const;
@@ -720,6 +925,25 @@ class FusionExecutorCache {
       PairPointerEquals>
       conc_info_id_map_;
 
+  //! Runtimes of one (device, concretization) pair that served inputs of a
+  //! shape class, and the runtimes that failed to. See
+  //! Note [ Kernel runtime re-use buckets ].
+  struct ReuseBucket {
+    std::vector<FusionKernelRuntime*> runtimes;
+    std::unordered_set<FusionKernelRuntime*> rejected;
+  };
+
+  //! Secondary index of kernel_runtimes_ keyed by the device, concretization
+  //! id and shape class of the inputs
+  std::unordered_map<InputsSignature, ReuseBucket, InputsSignatureHash>
+      reuse_buckets_;
+
+  //! Runtimes whose heuristics were computed from shape buckets. Their
+  //! heuristics are checked against the buckets of new inputs.
+  std::unordered_set<FusionKernelRuntime*> bucketed_runtimes_;
+
+  ReuseStats reuse_stats_;
+
   //! Logging state for most recent compilation
   bool profiling_ = false;
 
@@ -5,8 +5,22 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#ifdef NVFUSER_KERNEL_DB_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <limits>
 #include <mutex>
-#include <regex>
+#include <sstream>
+#include <thread>
 
 #include <instrumentation.h>
 #include <kernel_db/kernel_db.h>
@@ -18,28 +32,270 @@ namespace nvfuser {
 
 static std::mutex kernel_db_lock;
 
+namespace {
+
+const std::string kEntryExtension(".kdb");
+const std::string kTempExtension(".tmp");
+const std::string kLockFileName("lock");
+constexpr char kEntryMagic[] = "NVFKDB01";
+constexpr uint32_t kCompressedFlag = 1;
+constexpr uint64_t kDefaultMaxSizeMb = 1024;
+// Temporary files of writers that died before renaming them are removed
+// when they are older than this
+constexpr auto kStaleTempFileAge = std::chrono::hours(1);
+
+// 128-bit FNV-1a, which is stable across platforms and standard libraries
+// unlike std::hash
+using Hash128 = unsigned __int128;
+
+Hash128 fnv1a128(const std::string& str, Hash128 hash) {
+  // 2^88 + 2^8 + 0x3b
+  const Hash128 prime = ((Hash128)1 << 88) + 0x13b;
+  for (char c : str) {
+    hash ^= (uint8_t)c;
+    hash *= prime;
+  }
+  return hash;
+}
+
+Hash128 fnv1a128OffsetBasis() {
+  return ((Hash128)0x6c62272e07bb0142ULL << 64) | 0x62b821756295c58dULL;
+}
+
+// Parses the value of a numeric option, which must be a non-negative integer
+uint64_t parseSizeOption(const std::string& name, const std::string& value) {
+  size_t num_parsed = 0;
+  uint64_t parsed = 0;
+  try {
+    parsed = std::stoull(value, &num_parsed);
+  } catch (const std::exception&) {
+    num_parsed = 0;
+  }
+  NVF_CHECK(
+      !value.empty() && value[0] != '-' && num_parsed == value.size(),
+      "Kernel DB: Invalid value of ",
+      name,
+      ": ",
+      value);
+  return parsed;
+}
+
+// Reads the arguments of NVFUSER_ENABLE=kernel_db(...)
+void readKernelDbOptions(bool& compress, uint64_t& max_size) {
+  compress = false;
+  max_size = kDefaultMaxSizeMb << 20;
+  const std::string max_size_arg("max_size_mb=");
+  for (const auto& arg : getEnableOptionArguments(EnableOption::KernelDb)) {
+    if (arg == "compress") {
+      compress = true;
+    } else if (arg.rfind(max_size_arg, 0) == 0) {
+      const uint64_t max_size_mb =
+          parseSizeOption("max_size_mb", arg.substr(max_size_arg.size()));
+      NVF_CHECK(
+          max_size_mb <= (std::numeric_limits<uint64_t>::max() >> 20),
+          "Kernel DB: max_size_mb is too large: ",
+          max_size_mb);
+      max_size = max_size_mb << 20;
+    } else {
+      TORCH_WARN("Kernel DB: Ignoring unknown argument: ", arg);
+    }
+  }
+}
+
+bool hasCompressionSupport() {
+#ifdef NVFUSER_KERNEL_DB_WITH_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+// An entry file is laid out as
+//   magic | flags | signature | compile args | code | cubin
+// where each of the last four fields is a pair of uint64 sizes, the original
+// and the stored size, followed by the stored bytes. The stored bytes are
+// compressed if the compressed flag is set.
+template <typename T>
+void appendPod(std::vector<char>& buffer, T value) {
+  const auto* bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void appendField(
+    std::vector<char>& buffer,
+    const char* data,
+    size_t size,
+    bool compress) {
+  appendPod<uint64_t>(buffer, size);
+#ifdef NVFUSER_KERNEL_DB_WITH_ZLIB
+  if (compress) {
+    auto stored_size = compressBound((uLong)size);
+    std::vector<char> stored(stored_size);
+    NVF_ERROR(
+        compress2(
+            reinterpret_cast<Bytef*>(stored.data()),
+            &stored_size,
+            reinterpret_cast<const Bytef*>(data),
+            (uLong)size,
+            Z_DEFAULT_COMPRESSION) == Z_OK,
+        "Kernel DB: Failed to compress an entry");
+    appendPod<uint64_t>(buffer, stored_size);
+    buffer.insert(buffer.end(), stored.data(), stored.data() + stored_size);
+    return;
+  }
+#else
+  NVF_ERROR(!compress, "Kernel DB: nvFuser was built without zlib");
+#endif
+  appendPod<uint64_t>(buffer, size);
+  buffer.insert(buffer.end(), data, data + size);
+}
+
+class EntryReader {
+ public:
+  EntryReader(const std::vector<char>& buffer, size_t pos)
+      : buffer_(buffer), pos_(pos) {}
+
+  template <typename T>
+  bool readPod(T& value) {
+    if (pos_ + sizeof(T) > buffer_.size()) {
+      return false;
+    }
+    std::memcpy(&value, buffer_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  template <typename Container>
+  bool readField(Container& dst, bool compressed) {
+    uint64_t size = 0;
+    uint64_t stored_size = 0;
+    if (!readPod(size) || !readPod(stored_size) ||
+        pos_ + stored_size > buffer_.size()) {
+      return false;
+    }
+    const char* stored = buffer_.data() + pos_;
+    pos_ += stored_size;
+    dst.resize(size);
+    if (!compressed) {
+      if (stored_size != size) {
+        return false;
+      }
+      std::copy(stored, stored + size, dst.begin());
+      return true;
+    }
+#ifdef NVFUSER_KERNEL_DB_WITH_ZLIB
+    uLongf dst_size = (uLongf)size;
+    return uncompress(
+               reinterpret_cast<Bytef*>(&dst[0]),
+               &dst_size,
+               reinterpret_cast<const Bytef*>(stored),
+               (uLong)stored_size) == Z_OK &&
+        dst_size == size;
+#else
+    return false;
+#endif
+  }
+
+ private:
+  const std::vector<char>& buffer_;
+  size_t pos_ = 0;
+};
+
+std::vector<char> serializeEntry(const KernelDbEntry& entry, bool compress) {
+  std::vector<char> buffer(kEntryMagic, kEntryMagic + sizeof(kEntryMagic) - 1);
+  appendPod<uint32_t>(buffer, compress ? kCompressedFlag : 0);
+  appendField(
+      buffer,
+      entry.kernel_signature.data(),
+      entry.kernel_signature.size(),
+      false);
+  appendField(
+      buffer, entry.compile_args.data(), entry.compile_args.size(), false);
+  appendField(
+      buffer, entry.kernel_code.data(), entry.kernel_code.size(), compress);
+  appendField(buffer, entry.cubin.data(), entry.cubin.size(), compress);
+  return buffer;
+}
+
+bool deserializeEntry(const std::vector<char>& buffer, KernelDbEntry& entry) {
+  const size_t magic_size = sizeof(kEntryMagic) - 1;
+  if (buffer.size() < magic_size ||
+      std::memcmp(buffer.data(), kEntryMagic, magic_size) != 0) {
+    return false;
+  }
+  EntryReader reader(buffer, magic_size);
+  uint32_t flags = 0;
+  if (!reader.readPod(flags)) {
+    return false;
+  }
+  const bool compressed = (flags & kCompressedFlag) != 0;
+  return reader.readField(entry.kernel_signature, false) &&
+      reader.readField(entry.compile_args, false) &&
+      reader.readField(entry.kernel_code, compressed) &&
+      reader.readField(entry.cubin, compressed);
+}
+
+bool isEntryFile(const fs::path& path) {
+  return path.extension() == kEntryExtension;
+}
+
+// Files of the CSV based db that preceded the content addressed one
+bool isLegacyFile(const fs::path& path) {
+  return path.extension() == ".cubin" || path.extension() == ".cu" ||
+      path.extension() == ".csv";
+}
+
+// Refresh the modification time of an entry, which is its LRU timestamp.
+// Failures are ignored as the entry may have been evicted meanwhile.
+void touch(const fs::path& path) {
+  std::error_code ec;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+}
+
+// Holds an exclusive flock on a file, if it can be taken without waiting
+class FileLock {
+ public:
+  FileLock(const fs::path& path) {
+    fd_ = ::open(path.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd_ >= 0 && flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+  ~FileLock() {
+    if (fd_ >= 0) {
+      flock(fd_, LOCK_UN);
+      ::close(fd_);
+    }
+  }
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+
+  bool locked() const {
+    return fd_ >= 0;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+} // namespace
+
 KernelDb::KernelDb(bool _disabled)
-    : disabled_(_disabled),
-      initialized_(false),
-      kernel_map_(),
-      kernel_db_path_(),
-      kernel_db_txt_file_() {}
+    : disabled_(_disabled), initialized_(false), kernel_db_path_() {
+  readKernelDbOptions(compress_, max_size_);
+  compress_ = compress_ && hasCompressionSupport();
+}
 
 KernelDb& KernelDb::get() {
   const std::string kernel_db_dir = "nvfuser_kernel_db";
-  const std::string kernel_db_file = "db.csv";
 
   return get(
-      kernel_db_dir,
-      kernel_db_file,
-      true,
-      !isOptionEnabled(EnableOption::KernelDb),
-      false);
+      kernel_db_dir, true, !isOptionEnabled(EnableOption::KernelDb), false);
 }
 
 KernelDb& KernelDb::get(
     const std::string& kernel_db_dir,
-    const std::string& kernel_db_file,
     bool use_temp_dir,
     bool disabled,
     bool reset) {
@@ -52,19 +308,19 @@ KernelDb& KernelDb::get(
   if (reset) {
     singleton.disabled_ = true;
     singleton.initialized_ = false;
-    singleton.kernel_map_.clear();
     singleton.kernel_db_path_.clear();
-    singleton.kernel_db_txt_file_.clear();
+    readKernelDbOptions(singleton.compress_, singleton.max_size_);
+    singleton.compress_ = singleton.compress_ && hasCompressionSupport();
   }
 
   singleton.disabled_ = disabled;
 
   // Intialize the Db if it isn't already disabled
   if (!singleton.disabled_ && !singleton.initialized_) {
-    // If the appropriate files are not found or unable to be created, disable
+    // If the directory is unable to be created, disable
     auto success = false;
     try {
-      success = singleton.open(kernel_db_dir, kernel_db_file, use_temp_dir);
+      success = singleton.open(kernel_db_dir, use_temp_dir);
     } catch (const std::exception& e) {
       TORCH_WARN(
           "nvFuser's kernel_db had an unexpected exception while opening. Exception: ",
@@ -79,13 +335,8 @@ KernelDb& KernelDb::get(
   return singleton;
 }
 
-bool KernelDb::open(
-    const std::string& kernel_db_dir,
-    const std::string& kernel_db_file,
-    bool use_temp_dir) {
+bool KernelDb::open(const std::string& kernel_db_dir, bool use_temp_dir) {
   FUSER_PERF_SCOPE("KernelDb::open");
-  const std::string header(
-      "kernel_signature,compile_args,kernel_code_file,cubin_file");
 
   // The KernelDb directory is queried and created if it doesn't exist
   {
@@ -97,7 +348,7 @@ bool KernelDb::open(
     }
     if (!fs::is_directory(kernel_db_path_)) {
       try {
-        fs::create_directory(kernel_db_path_);
+        fs::create_directories(kernel_db_path_);
       } catch (const std::exception& e) {
         TORCH_WARN(
             "Unable to create nvFuser Kernel DB directory! ",
@@ -108,93 +359,80 @@ bool KernelDb::open(
     }
   }
 
-  // The CSV file that captures the db is read if it exists
+  // Entries need no restoring as they are looked up by file name. Only files
+  // of the legacy CSV based db and stale temporary files are cleaned up.
+  // Other processes may be doing the same, so failures are ignored.
   {
-    FUSER_PERF_SCOPE("KernelDb::open::read_db_txt_file");
-
-    kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
-    if (fs::is_regular_file(kernel_db_txt_file_)) {
-      std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
-      if (in_file) {
-        bool matched_header = false;
-        bool read_db_file = true;
-        // kernel_signature
-        //  --- Group 1: any word character and dash
-        // compile_args
-        //  --- Group 2: any word character, space, plus, dash and equals
-        // kernel_code_file
-        //  --- Group 3: [any word character, dash and slash].cu
-        // cubin_file
-        //  --- Group 4: [any word character, dash and slash].cubin
-        std::regex db_line_regex(
-            R"(^([\w-]+),([\w \+\-\=]+),([\w\-\/]+\.cu),([\w\-\/]+\.cubin)$)");
-        for (std::string line; std::getline(in_file, line);) {
-          if (!matched_header) {
-            if (line.compare(header) == 0) {
-              matched_header = true;
-            } else {
-              // Header is corrupted or badly formed
-              TORCH_WARN(
-                  "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
-                  line);
-              read_db_file = false;
-              break;
-            }
-          } else {
-            std::smatch db_line_match;
-            if (std::regex_match(line, db_line_match, db_line_regex)) {
-              if (db_line_match.size() == 5) {
-                KernelDbEntry temp{
-                    db_line_match[1],
-                    db_line_match[2],
-                    db_line_match[3],
-                    db_line_match[4]};
-
-                fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
-                std::string code;
-                if (copy_from_text_file(code_path.string(), code)) {
-                  kernel_map_[code] = temp;
-                } else {
-                  TORCH_WARN(
-                      "Kernel DB: Unable to copy cuda file: ",
-                      code_path.string());
-                }
-              }
-            } else {
-              TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
-            }
-          }
-        }
-        if (read_db_file) {
-          return true;
+    FUSER_PERF_SCOPE("KernelDb::open::cleanup");
+    const auto now = fs::file_time_type::clock::now();
+    for (const auto& dir_entry : fs::directory_iterator(kernel_db_path_)) {
+      const fs::path& path = dir_entry.path();
+      std::error_code ec;
+      if (!fs::is_regular_file(path, ec)) {
+        continue;
+      }
+      if (isLegacyFile(path)) {
+        fs::remove(path, ec);
+      } else if (path.extension() == kTempExtension) {
+        auto mtime = fs::last_write_time(path, ec);
+        if (!ec && now - mtime > kStaleTempFileAge) {
+          fs::remove(path, ec);
         }
       }
     }
   }
+  return true;
+}
 
-  // If reading of the CSV file was successful, the rest of this method
-  // is skipped
+size_t KernelDb::size() const {
+  size_t num_entries = 0;
+  for (const auto& dir_entry : fs::directory_iterator(kernel_db_path_)) {
+    if (isEntryFile(dir_entry.path())) {
+      num_entries++;
+    }
+  }
+  return num_entries;
+}
 
-  // Remove all files from directory if valid db txt file was not found
+uint64_t KernelDb::sizeInBytes() const {
+  uint64_t num_bytes = 0;
   for (const auto& dir_entry : fs::directory_iterator(kernel_db_path_)) {
-    const fs::path& path = dir_entry.path();
-    if (fs::is_regular_file(path)) {
-      if (path.extension() == ".cubin" || path.extension() == ".cu" ||
-          path.extension() == ".csv") {
-        fs::remove(path);
-      }
+    std::error_code ec;
+    if (isEntryFile(dir_entry.path())) {
+      auto file_size = fs::file_size(dir_entry.path(), ec);
+      num_bytes += ec ? 0 : file_size;
     }
   }
+  return num_bytes;
+}
 
-  // Create an empty db csv file
-  {
-    FUSER_PERF_SCOPE("KernelDb::open::create_db_txt_file");
+void KernelDb::setMaxSizeInBytes(uint64_t max_size) {
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+  max_size_ = max_size;
+}
 
-    if (copy_to_text_file(kernel_db_txt_file_, header + "\n")) {
-      return true;
-    }
+void KernelDb::setCompressionEnabled(bool compress) {
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+  if (compress && !hasCompressionSupport()) {
+    TORCH_WARN(
+        "Kernel DB: Compression is unavailable as nvFuser was built without zlib");
   }
-  return false;
+  compress_ = compress && hasCompressionSupport();
+}
+
+std::string KernelDb::entryFileName(
+    const std::string& kernel_code,
+    const std::string& compile_args) {
+  // The compile args include the target architecture. The size of the kernel
+  // code separates it from the compile args.
+  Hash128 hash = fnv1a128OffsetBasis();
+  hash = fnv1a128(std::to_string(kernel_code.size()) + ":", hash);
+  hash = fnv1a128(kernel_code, hash);
+  hash = fnv1a128(compile_args, hash);
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16)
+     << (uint64_t)(hash >> 64) << std::setw(16) << (uint64_t)hash;
+  return ss.str() + kEntryExtension;
 }
 
 bool KernelDb::query(
@@ -203,27 +441,36 @@ bool KernelDb::query(
     std::string& kernel_signature,
     std::vector<char>& cubin) const {
   FUSER_PERF_SCOPE("KernelDb::query");
-  bool status = false;
-  auto db_entry = kernel_map_.find(kernel_code);
-
-  // Kernel Match is found
-  if (db_entry != kernel_map_.end()) {
-    // Make sure the compilation args also match
-    if (db_entry->second.compile_args == compile_args) {
-      // Copy the cubin to a data buffer and record the kernel name for module
-      // loading
-      fs::path cubin_file_path = kernel_db_path_ / db_entry->second.cubin_file;
-      if (copy_from_binary_file(cubin_file_path.string(), cubin)) {
-        kernel_signature = db_entry->second.kernel_signature;
-        status = true;
-      }
-    }
+  fs::path entry_path =
+      kernel_db_path_ / entryFileName(kernel_code, compile_args);
+
+  // Entries are published by renaming, so a file that exists is complete
+  std::vector<char> buffer;
+  if (!fs::is_regular_file(entry_path) ||
+      !copy_from_binary_file(entry_path.string(), buffer)) {
+    return false;
+  }
+
+  KernelDbEntry entry;
+  if (!deserializeEntry(buffer, entry)) {
+    TORCH_WARN("Kernel DB: Unable to read entry: ", entry_path.string());
+    return false;
+  }
+  // Guards against digest collisions, which would load another kernel
+  if (entry.compile_args != compile_args || entry.kernel_code != kernel_code) {
+    TORCH_WARN(
+        "Kernel DB: Entry of another kernel found in ", entry_path.string());
+    return false;
   }
-  return status;
+
+  touch(entry_path);
+  kernel_signature = entry.kernel_signature;
+  cubin = std::move(entry.cubin);
+  return true;
 }
 
-// This method will write a cubin and the kernel code to files as well as add
-// an entry to the db csv file.
+// This method writes an entry file to a temporary file and then publishes it
+// by renaming it to its content addressed name.
 bool KernelDb::write(
     const std::string& kernel_code,
     const std::string& compile_args,
@@ -232,51 +479,89 @@ bool KernelDb::write(
   FUSER_PERF_SCOPE("KernelDb::write");
   std::lock_guard<std::mutex> guard(kernel_db_lock);
 
-  // Short-circuit path if kernel already exist in database.
-  // Only return false if it does not already exist in the database and we fail
-  // to add kernel to database.
-  if (kernel_map_.count(kernel_code) > 0) {
+  const auto entry_file_name = entryFileName(kernel_code, compile_args);
+  fs::path entry_path = kernel_db_path_ / entry_file_name;
+
+  // Short-circuit path if kernel already exist in database, possibly written
+  // by another process.
+  if (fs::is_regular_file(entry_path)) {
+    touch(entry_path);
     return true;
   }
 
-  // If the kernel doesn't already exist in the hash map, add it.
-  // The cubin and kernel code files are given a unique number based on the
-  // size of the hash map.
-  std::string kernel_num =
-      std::to_string(static_cast<unsigned long>(kernel_map_.size()));
+  // The temporary file name is unique across processes and threads
+  std::stringstream temp_file_name;
+  temp_file_name << entry_file_name << "." << getpid() << "."
+                 << std::hash<std::thread::id>()(std::this_thread::get_id())
+                 << kTempExtension;
+  fs::path temp_path = kernel_db_path_ / temp_file_name.str();
+
+  auto buffer = serializeEntry(
+      {kernel_signature, compile_args, kernel_code, cubin}, compress_);
+  if (!copy_to_binary_file(temp_path.string(), buffer)) {
+    return false;
+  }
 
-  // Kernel Code File path
-  std::string code_file_name("kernel_" + kernel_num + ".cu");
-  fs::path code_file_path = kernel_db_path_ / code_file_name;
+  // rename atomically replaces an entry that another process published
+  // meanwhile, which has the same content
+  std::error_code ec;
+  fs::rename(temp_path, entry_path, ec);
+  if (ec) {
+    fs::remove(temp_path, ec);
+    return false;
+  }
 
-  // Cubin File path
-  std::string cubin_file_name("kernel_" + kernel_num + ".cubin");
-  fs::path cubin_file_path = kernel_db_path_ / cubin_file_name;
+  evict();
+  return true;
+}
 
-  // Copy kernel code to file
-  bool status = copy_to_text_file(code_file_path.string(), kernel_code);
+void KernelDb::evict() const {
+  FUSER_PERF_SCOPE("KernelDb::evict");
 
-  // If the kernel code copy was successful, copy the cubin to file
-  if (status) {
-    status = copy_to_binary_file(cubin_file_path.string(), cubin);
+  // Only one process evicts at a time. If another process holds the lock it
+  // is already evicting, which this process doesn't need to wait for.
+  FileLock lock(kernel_db_path_ / kLockFileName);
+  if (!lock.locked()) {
+    return;
   }
 
-  // If both files were created successfully, add an entry to the CSV file
-  if (status) {
-    std::string entry(kernel_signature);
-    entry += "," + compile_args + "," + code_file_name + "," + cubin_file_name +
-        "\n";
-    status = append_to_text_file(kernel_db_txt_file_.string(), entry);
+  struct EntryFile {
+    fs::file_time_type mtime;
+    uint64_t size;
+    fs::path path;
+  };
+  std::vector<EntryFile> entry_files;
+  uint64_t total_size = 0;
+  for (const auto& dir_entry : fs::directory_iterator(kernel_db_path_)) {
+    const fs::path& path = dir_entry.path();
+    if (!isEntryFile(path)) {
+      continue;
+    }
+    std::error_code ec;
+    auto mtime = fs::last_write_time(path, ec);
+    auto size = ec ? 0 : fs::file_size(path, ec);
+    if (ec) {
+      continue;
+    }
+    entry_files.push_back({mtime, size, path});
+    total_size += size;
+  }
+  if (total_size <= max_size_) {
+    return;
   }
 
-  // If writing both files and adding an entry the CSV file was successful,
-  // finally add an entry to the Kernel DB
-  if (status) {
-    KernelDbEntry tmp{
-        kernel_signature, compile_args, code_file_name, cubin_file_name};
-    kernel_map_[kernel_code] = tmp;
+  std::sort(
+      entry_files.begin(),
+      entry_files.end(),
+      [](const EntryFile& a, const EntryFile& b) { return a.mtime < b.mtime; });
+  for (const auto& entry_file : entry_files) {
+    if (total_size <= max_size_) {
+      break;
+    }
+    std::error_code ec;
+    fs::remove(entry_file.path, ec);
+    total_size -= entry_file.size;
   }
-  return status;
 }
 
 } // namespace nvfuser
@@ -17,39 +17,54 @@ namespace fs = std::experimental::filesystem;
 #error "C++14 or Higher is required for filesystem library!"
 #endif
 
-#include <unordered_map>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include <c10/macros/Export.h>
 
 namespace nvfuser {
 
-//! KernelDbEntry captures information to be printed per fusion in a csv file
-//! that is used to restore a hash map
+//! KernelDbEntry is the content of an entry file of the db
 struct KernelDbEntry {
   //! Cuda kernel function signature that is required to load the Cubin
   std::string kernel_signature;
   //! Compilation args supplied to NVRTC -- register usage and compute
   //! capability can be specific to a kernel instance
   std::string compile_args;
-  //! Full file path to Cuda Kernel
-  std::string kernel_code_file;
-  //! Full file path to cubin
-  std::string cubin_file;
+  //! Cuda kernel code. Compared with the queried one, as entries are looked
+  //! up by a digest of it.
+  std::string kernel_code;
+  //! Cubin or PTX
+  std::vector<char> cubin;
 };
 
 //! KernelDb class is a singleton structure that is used to open, query, and
-//! write to the the database that is held in a hash map.  The kernel code is
-//! used as string key to the hash map.
+//! write to the database of compiled kernels in a directory.
+//!
+//! The db is content addressed. Every entry is a single file named by a
+//! digest of the kernel code and the compile args, which include the target
+//! architecture. Entries are published by writing them to a temporary file
+//! and renaming it, so any number of processes, e.g. the ranks of a training
+//! job on one node, can share a directory without locking: a reader sees
+//! either a complete entry or no entry at all.
+//!
+//! The total size of the entries is capped. When a write exceeds the cap the
+//! least recently used entries are evicted, where the modification time of
+//! an entry file is refreshed on every hit. Eviction is serialized across
+//! processes with a lock file.
+//!
+//! The db is enabled by NVFUSER_ENABLE=kernel_db, which takes the optional
+//! arguments:
+//!   compress -- Compress the kernel code and cubin of new entries. Only
+//!               available when built with zlib.
+//!   max_size_mb=<n> -- The size cap, defaults to 1024 MiB.
 class KernelDb {
   KernelDb(bool _disabled);
 
   //! Open is private because this method should only be called once by the
   //! singleton upon creation to create a new db or restore an existing one.
-  bool open(
-      const std::string& kernel_db_dir,
-      const std::string& kernel_db_file,
-      bool use_temp_dir);
+  bool open(const std::string& kernel_db_dir, bool use_temp_dir);
 
  public:
   // clang-tidy - deleted member function should be public
@@ -61,7 +76,6 @@ class KernelDb {
   //! Thread-Safe method to get the Meyer's singleton -- For testing
   static KernelDb& get(
       const std::string& kernel_db_dir,
-      const std::string& kernel_db_file,
       bool use_temp_dir = true,
       bool disabled = false,
       bool reset = false);
@@ -70,40 +84,65 @@ class KernelDb {
   bool enabled() const {
     return !disabled_ && initialized_;
   }
-  //! Returns the number entries in the db
-  size_t size() const {
-    return kernel_map_.size();
+  //! Returns the number of entries in the db, including those written by
+  //! other processes
+  size_t size() const;
+  //! Returns the total size in bytes of the entries in the db
+  uint64_t sizeInBytes() const;
+
+  //! Size cap in bytes, see the class comment
+  uint64_t maxSizeInBytes() const {
+    return max_size_;
+  }
+  void setMaxSizeInBytes(uint64_t max_size);
+
+  //! Whether new entries are compressed, see the class comment. Returns false
+  //! if compression was requested but nvFuser was built without zlib.
+  bool compressionEnabled() const {
+    return compress_;
   }
+  void setCompressionEnabled(bool compress);
 
-  //! Query uses the string of the kernel code to lookup whether a cubin already
-  //! exists for the given kernel.  Additionally, the compile args are also
-  //! matched.
+  //! Name of the entry file of a kernel, i.e. its digest with the entry file
+  //! extension
+  static std::string entryFileName(
+      const std::string& kernel_code,
+      const std::string& compile_args);
+
+  //! Query looks up the entry of the kernel code and compile args.  If it
+  //! exists, the cubin and the kernel signature are copied out and the entry
+  //! is marked as recently used.
   bool query(
       const std::string& kernel_code,
       const std::string& compile_args,
       std::string& kernel_signature,
       std::vector<char>& cubin) const;
   //! Write is used to write a new entry to the db upon compilation of a
-  //! new fusion
+  //! new fusion. Evicts least recently used entries if the db grows beyond
+  //! its size cap.
   bool write(
       const std::string& kernel_code,
       const std::string& compile_args,
       const std::string& kernel_signature,
       const std::vector<char>& cubin);
 
+ private:
+  //! Remove least recently used entries until the db fits in its size cap
+  void evict() const;
+
  private:
   //! Disablement is specified by the user and can also be set by a
   //! failure to open the db
   bool disabled_ = true;
   //! Db is only initialized after it is successfully open
   bool initialized_ = false;
-  //! Hash Map of kernel_string -> db_entry
-  std::unordered_map<std::string, KernelDbEntry> kernel_map_;
+  //! Compress new entries
+  bool compress_ = false;
+  //! Size cap in bytes
+  uint64_t max_size_ = 0;
 
   //! Full path to the db directory
   fs::path kernel_db_path_;
-  //! Full path to csv file used to record and restore the db
-  fs::path kernel_db_txt_file_;
 };
 
 } // namespace nvfuser
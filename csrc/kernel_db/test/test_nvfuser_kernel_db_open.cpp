@@ -20,15 +20,13 @@
 namespace nvfuser {
 
 TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
-  // Check a corrupted DB and reset the DB
-  // 1.) Test writes a bad db.csv file and open fails to match header
-  // 2.) Should delete cubins because of bad db.csv file.
-  // 3.) Creates a new empty db.csv file with proper header
+  // Check the cleanup of an existing DB directory
+  // 1.) Files of the legacy CSV based db are removed
+  // 2.) Stale temporary files of writers that died are removed
+  // 3.) Entries and fresh temporary files are kept
   try {
     const std::string kernel_db_dir("nvfuser_kernel_db_open_test");
-    const std::string bad_text("blahblahblah\n");
-    const std::string header(
-        "kernel_signature,compile_args,kernel_code_file,cubin_file");
+    const std::string test_text("blahblahblah\n");
     fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
     if (fs::is_directory(test_db_path)) {
       fs::remove_all(test_db_path);
@@ -36,25 +34,38 @@ TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
     ASSERT_TRUE(fs::create_directory(test_db_path));
 
     // Setup 1
-    const std::string kernel_db_file("db.csv");
-    fs::path test_db_file = test_db_path / kernel_db_file;
-    ASSERT_FALSE(fs::is_regular_file(test_db_file));
-    ASSERT_TRUE(copy_to_text_file(test_db_file.string(), bad_text));
-    ASSERT_TRUE(fs::is_regular_file(test_db_file));
+    fs::path test_db_file = test_db_path / "db.csv";
+    fs::path test_cubin_file = test_db_path / "kernel_0.cubin";
+    fs::path test_kernel_file = test_db_path / "kernel_0.cu";
+    ASSERT_TRUE(copy_to_text_file(test_db_file.string(), test_text));
+    ASSERT_TRUE(copy_to_text_file(test_cubin_file.string(), test_text));
+    ASSERT_TRUE(copy_to_text_file(test_kernel_file.string(), test_text));
     // Setup 2
-    fs::path test_cubin_file = test_db_path / "test1.cubin";
-    ASSERT_TRUE(copy_to_text_file(test_cubin_file.string(), bad_text));
+    fs::path stale_temp_file = test_db_path / "stale.kdb.1.2.tmp";
+    ASSERT_TRUE(copy_to_text_file(stale_temp_file.string(), test_text));
+    fs::last_write_time(
+        stale_temp_file,
+        fs::file_time_type::clock::now() - std::chrono::hours(2));
+    // Setup 3
+    const auto entry_file_name = KernelDb::entryFileName(test_text, test_text);
+    fs::path entry_file = test_db_path / entry_file_name;
+    fs::path fresh_temp_file = test_db_path / (entry_file_name + ".1.2.tmp");
+    ASSERT_TRUE(copy_to_text_file(entry_file.string(), test_text));
+    ASSERT_TRUE(copy_to_text_file(fresh_temp_file.string(), test_text));
+
     // Execute 1, 2, 3
-    KernelDb::get(kernel_db_dir, kernel_db_file, true, false, true);
+    auto& kernel_db = KernelDb::get(kernel_db_dir, true, false, true);
+    ASSERT_TRUE(kernel_db.enabled());
     // Check 1
-    ASSERT_TRUE(fs::is_regular_file(test_db_file));
-    // Check 2
+    ASSERT_FALSE(fs::is_regular_file(test_db_file));
     ASSERT_FALSE(fs::is_regular_file(test_cubin_file));
+    ASSERT_FALSE(fs::is_regular_file(test_kernel_file));
+    // Check 2
+    ASSERT_FALSE(fs::is_regular_file(stale_temp_file));
     // Check 3
-    std::ifstream db_file(test_db_file.c_str(), std::ios::in);
-    std::string line;
-    std::getline(db_file, line);
-    ASSERT_TRUE(header == line);
+    ASSERT_TRUE(fs::is_regular_file(entry_file));
+    ASSERT_TRUE(fs::is_regular_file(fresh_temp_file));
+    ASSERT_TRUE(kernel_db.size() == 1);
 
     // Cleanup DB Directory
     if (fs::is_directory(test_db_path)) {
@@ -62,42 +73,24 @@ TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
     }
     SUCCEED();
   } catch (const std::exception& e) {
-    FAIL() << "Failed replacing a bad db.csv file and removing cubins!"
+    FAIL() << "Failed cleaning up an existing Kernel DB directory!"
            << e.what();
   }
 
-  // Check a successful opening of an existing DB
+  // Check that a missing DB directory is created
   try {
-    // Setup DB Directory
     const std::string kernel_db_dir("nvfuser_kernel_db_test");
     fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
     if (fs::is_directory(test_db_path)) {
       fs::remove_all(test_db_path);
     }
-    ASSERT_TRUE(fs::create_directory(test_db_path));
-
-    // Setup DB File and corresponding fake cubins and cuda files
-    const std::string header(
-        "kernel_signature,compile_args,kernel_code_file,cubin_file\n");
-    const std::string test_text("blahblahblah\n");
-    const std::string kernel_db_file("db.csv");
-    const std::string kernel_db_cubin("test1.cubin");
-    const std::string kernel_db_kernel("test1.cu");
-    fs::path test_db_file_path = test_db_path / kernel_db_file;
-    fs::path test_cubin_path = test_db_path / kernel_db_cubin;
-    fs::path test_kernel_path = test_db_path / kernel_db_kernel;
-
-    copy_to_text_file(test_db_file_path, header);
-    const std::string db_line = test_text + "," + test_text + "," +
-        kernel_db_kernel + "," + kernel_db_cubin;
-    ASSERT_TRUE(append_to_text_file(test_db_file_path, db_line));
-    ASSERT_TRUE(copy_to_text_file(test_cubin_path, test_text));
-    ASSERT_TRUE(copy_to_text_file(test_kernel_path, test_text));
 
     // Open Db
-    auto& kernel_db = KernelDb::get(kernel_db_dir, kernel_db_file, true, false);
+    auto& kernel_db = KernelDb::get(kernel_db_dir, true, false, true);
 
     ASSERT_TRUE(kernel_db.enabled());
+    ASSERT_TRUE(fs::is_directory(test_db_path));
+    ASSERT_TRUE(kernel_db.size() == 0);
 
     // Cleanup DB Directory
     if (fs::is_directory(test_db_path)) {
@@ -106,7 +99,7 @@ TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
 
     SUCCEED();
   } catch (const std::exception& e) {
-    FAIL() << "Failed to successfully read existing Kernel DB!" << e.what();
+    FAIL() << "Failed to successfully create a new Kernel DB!" << e.what();
   }
 }
 
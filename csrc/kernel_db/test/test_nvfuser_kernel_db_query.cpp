@@ -20,17 +20,33 @@
 namespace nvfuser {
 
 TEST_F(NVFuserTest, KernelDb_Query_CUDA) {
-  // Setup the test db
-  fs::path test_db =
+  // Setup the test db with the kernel from the test data
+  fs::path test_data =
       fs::path(__FILE__).parent_path() / "test_data/kernel_db_for_query_test";
-  ASSERT_TRUE(fs::is_directory(test_db));
-  const std::string test_db_file_name("db.csv");
-  fs::path test_db_file = test_db / test_db_file_name;
-  ASSERT_TRUE(fs::is_regular_file(test_db_file));
+  ASSERT_TRUE(fs::is_directory(test_data));
+  fs::path test_data_cubin = test_data / "kernel_0.cubin";
+  fs::path test_data_kernel = test_data / "kernel_0.cu";
+  ASSERT_TRUE(fs::is_regular_file(test_data_cubin));
+  ASSERT_TRUE(fs::is_regular_file(test_data_kernel));
 
-  auto& kernel_db =
-      KernelDb::get(test_db.string(), test_db_file_name, false, false, true);
+  const std::string kernel_db_dir("nvfuser_kernel_db_query_test");
+  fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
+  if (fs::is_directory(test_db_path)) {
+    fs::remove_all(test_db_path);
+  }
+
+  auto& kernel_db = KernelDb::get(kernel_db_dir, true, false, true);
   ASSERT_TRUE(kernel_db.enabled());
+
+  const std::string compiler_args(
+      "--std=c++14 --gpu-architecture=sm_80 -default-device --fmad=true -DNDEBUG --ptxas-options --maxrregcount=255");
+  const std::string kernel_signature(
+      "_ZN76_GLOBAL__N__00000000_37___tmp_kernel_pointwise_f0_c1_r0_g0_cu_8995cef2_3255329nvfuser_pointwise_f0_c1_r0_g0ENS_6TensorIfLi2ELi2EEES1_S1_");
+  std::string code;
+  std::vector<char> cubin;
+  ASSERT_TRUE(copy_from_text_file(test_data_kernel, code));
+  ASSERT_TRUE(copy_from_binary_file(test_data_cubin, cubin));
+  ASSERT_TRUE(kernel_db.write(code, compiler_args, kernel_signature, cubin));
   ASSERT_TRUE(kernel_db.size() == 1);
 
   // Check a query with a bad code string
@@ -48,9 +64,6 @@ TEST_F(NVFuserTest, KernelDb_Query_CUDA) {
 
   // Check a query with a good code string and bad compiler args
   try {
-    fs::path code_path = test_db / "kernel_0.cu";
-    std::string code;
-    ASSERT_TRUE(copy_from_text_file(code_path, code));
     const std::string bad_text("blahblahblah");
     std::string dummy_name;
     std::vector<char> dummy_cubin(0);
@@ -64,20 +77,23 @@ TEST_F(NVFuserTest, KernelDb_Query_CUDA) {
 
   // Check a successful query
   try {
-    fs::path code_path = test_db / "kernel_0.cu";
-    std::string code;
-    ASSERT_TRUE(copy_from_text_file(code_path, code));
-    const std::string compiler_args(
-        "--std=c++14 --gpu-architecture=sm_80 -default-device --fmad=true -DNDEBUG --ptxas-options --maxrregcount=255");
-    std::string dummy_name;
-    std::vector<char> dummy_cubin(0);
+    std::string queried_name;
+    std::vector<char> queried_cubin(0);
 
-    ASSERT_TRUE(kernel_db.query(code, compiler_args, dummy_name, dummy_cubin));
+    ASSERT_TRUE(
+        kernel_db.query(code, compiler_args, queried_name, queried_cubin));
+    ASSERT_TRUE(queried_name == kernel_signature);
+    ASSERT_TRUE(queried_cubin == cubin);
     SUCCEED();
   } catch (const std::exception& e) {
     FAIL() << "Unexpected failure while querying db for existing entry!"
            << e.what();
   }
+
+  // Cleanup DB Directory
+  if (fs::is_directory(test_db_path)) {
+    fs::remove_all(test_db_path);
+  }
 }
 
 } // namespace nvfuser
@@ -29,14 +29,12 @@ TEST_F(NVFuserTest, KernelDb_Write_CUDA) {
   ASSERT_TRUE(fs::is_regular_file(test_data_kernel));
 
   const std::string kernel_db_dir("nvfuser_kernel_db_write_test");
-  const std::string kernel_db_file("db.csv");
   fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
   if (fs::is_directory(test_db_path)) {
     fs::remove_all(test_db_path);
   }
 
-  auto& kernel_db =
-      KernelDb::get(kernel_db_dir, kernel_db_file, true, false, true);
+  auto& kernel_db = KernelDb::get(kernel_db_dir, true, false, true);
   ASSERT_TRUE(kernel_db.enabled());
   ASSERT_TRUE(kernel_db.size() == 0);
 
@@ -68,6 +66,54 @@ TEST_F(NVFuserTest, KernelDb_Write_CUDA) {
     FAIL() << "Unexpected failure while writing existing db entry!" << e.what();
   }
 
+  // Test a compressed entry, if nvFuser was built with zlib
+  try {
+    kernel_db.setCompressionEnabled(true);
+    const std::string other_args(compile_args + " -lineinfo");
+    const auto uncompressed_size = kernel_db.sizeInBytes();
+    ASSERT_TRUE(kernel_db.write(code, other_args, kernel_signature, cubin));
+    ASSERT_TRUE(kernel_db.size() == 2);
+    if (kernel_db.compressionEnabled()) {
+      ASSERT_TRUE(kernel_db.sizeInBytes() < 2 * uncompressed_size);
+    }
+
+    std::string queried_name;
+    std::vector<char> queried_cubin;
+    ASSERT_TRUE(
+        kernel_db.query(code, other_args, queried_name, queried_cubin));
+    ASSERT_TRUE(queried_name == kernel_signature);
+    ASSERT_TRUE(queried_cubin == cubin);
+    SUCCEED();
+  } catch (const std::exception& e) {
+    FAIL() << "Unexpected failure while writing compressed db entry!"
+           << e.what();
+  }
+
+  // Test eviction of the least recently used entries. The first entry is
+  // queried so that the second one is the least recently used. The new entry
+  // is written with the same compression as the second one and is no larger,
+  // so evicting the second one is enough.
+  try {
+    std::string queried_name;
+    std::vector<char> queried_cubin;
+    ASSERT_TRUE(
+        kernel_db.query(code, compile_args, queried_name, queried_cubin));
+    kernel_db.setMaxSizeInBytes(kernel_db.sizeInBytes());
+
+    const std::string new_args(compile_args + " -G");
+    ASSERT_TRUE(kernel_db.write(code, new_args, kernel_signature, cubin));
+    ASSERT_TRUE(kernel_db.sizeInBytes() <= kernel_db.maxSizeInBytes());
+    ASSERT_TRUE(
+        kernel_db.query(code, compile_args, queried_name, queried_cubin));
+    ASSERT_TRUE(kernel_db.query(code, new_args, queried_name, queried_cubin));
+    ASSERT_FALSE(kernel_db.query(
+        code, compile_args + " -lineinfo", queried_name, queried_cubin));
+    SUCCEED();
+  } catch (const std::exception& e) {
+    FAIL() << "Unexpected failure while evicting db entries!" << e.what();
+  }
+  kernel_db.setCompressionEnabled(false);
+
   // Cleanup DB Directory
   if (fs::is_directory(test_db_path)) {
     fs::remove_all(test_db_path);
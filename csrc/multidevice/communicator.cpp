@@ -101,9 +101,20 @@ bool parseEnv(
   return true;
 }
 
+inline std::string getBackendName(CommunicatorBackend backend) {
+  switch (backend) {
+    case CommunicatorBackend::nccl:
+      return "nccl";
+    case CommunicatorBackend::ucc:
+      return "ucc";
+    case CommunicatorBackend::gloo:
+      return "gloo";
+  }
+  NVF_ERROR(false, "unknown backend");
+}
+
 inline std::string getTeamKey(const Team& team, CommunicatorBackend backend) {
-  std::string backend_str =
-      (backend == CommunicatorBackend::ucc) ? "ucc" : "nccl";
+  std::string backend_str = getBackendName(backend);
   return std::accumulate(
       std::begin(team),
       std::end(team),
@@ -156,7 +167,8 @@ Communicator::Communicator(
       local_size_(0),
       master_port_(0),
       ucc_available_(false),
-      nccl_available_(false) {
+      nccl_available_(false),
+      gloo_available_(false) {
   // retrieves rank and communicator size
   is_available_ = parseEnv(
       rank_, size_, local_rank_, local_size_, master_addr_, master_port_);
@@ -186,6 +198,10 @@ Communicator::Communicator(
 #ifdef USE_C10D_NCCL
   nccl_available_ = true;
 #endif
+
+#ifdef USE_C10D_GLOO
+  gloo_available_ = true;
+#endif
 }
 
 c10::intrusive_ptr<c10d::Backend> Communicator::getBackendForTeam(
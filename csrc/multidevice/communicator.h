@@ -31,7 +31,7 @@ namespace nvfuser {
 
 using RankType = DeviceIdxType;
 
-// Supported backends. TODO: gloo untested
+// Supported backends. Gloo is meant for CPU tensors.
 enum class CommunicatorBackend { nccl, ucc, gloo };
 
 #ifdef USE_C10D_NCCL
@@ -111,6 +111,8 @@ class Communicator {
       return ucc_available_;
     } else if (backend == CommunicatorBackend::nccl) {
       return nccl_available_;
+    } else if (backend == CommunicatorBackend::gloo) {
+      return gloo_available_;
     }
     return false;
   }
@@ -140,6 +142,7 @@ class Communicator {
   int master_port_;
   bool ucc_available_;
   bool nccl_available_;
+  bool gloo_available_;
   // stores the world's store used for the backend init
   c10::intrusive_ptr<c10d::TCPStore> store_;
   // cache for the created backends. The keys are strings generated from Teams
@@ -11,6 +11,10 @@
 #include <multidevice/lower_communication.h>
 #include <multidevice/pipeline.h>
 
+#include <c10/cuda/CUDAFunctions.h>
+
+#include <list>
+
 namespace nvfuser {
 
 bool PipelineExecutor::shouldRun(PipelineStage* stage) {
@@ -21,15 +25,125 @@ bool PipelineExecutor::shouldRun(PipelineStage* stage) {
   return should_run_[stage];
 }
 
+void PendingWorks::add(
+    const std::vector<Val*>& vals,
+    c10::intrusive_ptr<c10d::Work> work) {
+  for (auto val : vals) {
+    works_[val].push_back(work);
+  }
+}
+
+void PendingWorks::waitFor(Val* val) {
+  auto it = works_.find(val);
+  if (it == works_.end()) {
+    return;
+  }
+  for (auto& work : it->second) {
+    work->wait();
+  }
+  works_.erase(it);
+}
+
+std::vector<c10::intrusive_ptr<c10d::Work>> PendingWorks::release() {
+  // A work registered under several Vals appears several times
+  std::vector<c10::intrusive_ptr<c10d::Work>> works;
+  std::unordered_set<c10d::Work*> seen;
+  for (auto& item : works_) {
+    for (auto& work : item.second) {
+      if (seen.insert(work.get()).second) {
+        works.push_back(work);
+      }
+    }
+  }
+  works_.clear();
+  return works;
+}
+
+std::vector<Expr*> PipelineExecutor::schedule(Pipeline* pipeline) {
+  auto exprs = StmtSort::getExprsTo(pipeline, pipeline->outputs());
+  std::list<Expr*> remaining(exprs.begin(), exprs.end());
+
+  std::unordered_set<Val*> computed(
+      pipeline->inputs().begin(), pipeline->inputs().end());
+  // Outputs of the communications scheduled so far that no stage consumed
+  std::unordered_set<Val*> in_flight;
+  auto is_ready = [&computed](Expr* expr) {
+    return std::all_of(
+        expr->inputs().begin(), expr->inputs().end(), [&computed](Val* val) {
+          return computed.count(val) > 0;
+        });
+  };
+  auto waits = [&in_flight](Expr* expr) {
+    return std::any_of(
+        expr->inputs().begin(), expr->inputs().end(), [&in_flight](Val* val) {
+          return in_flight.count(val) > 0;
+        });
+  };
+
+  std::vector<Expr*> order;
+  order.reserve(exprs.size());
+  while (!remaining.empty()) {
+    auto it = std::find_if(remaining.begin(), remaining.end(), [&](Expr* e) {
+      return e->isA<PipelineCommunication>() && is_ready(e);
+    });
+    if (it == remaining.end()) {
+      it = std::find_if(remaining.begin(), remaining.end(), [&](Expr* e) {
+        return is_ready(e) && !waits(e);
+      });
+    }
+    if (it == remaining.end()) {
+      it = std::find_if(remaining.begin(), remaining.end(), is_ready);
+    }
+    NVF_ERROR(it != remaining.end(), "The Pipeline has a cycle");
+
+    Expr* expr = *it;
+    remaining.erase(it);
+    order.push_back(expr);
+    for (auto input : expr->inputs()) {
+      in_flight.erase(input);
+    }
+    for (auto output : expr->outputs()) {
+      computed.insert(output);
+      if (expr->isA<PipelineCommunication>()) {
+        in_flight.insert(output);
+      }
+    }
+  }
+  return order;
+}
+
+void PipelineExecutor::synchronize() const {
+  if (runtime_.comm_.device().is_cuda()) {
+    c10::cuda::device_synchronize();
+  }
+}
+
 void PipelineExecutor::handle(PipelineStage* stage) {
-  // get the IValues corresponding to the stage's input
+  // get the IValues corresponding to the stage's input. Only their metadata
+  // is needed to allocate the outputs of a stage that doesn't run here.
   std::vector<c10::IValue> stage_input_IValues;
   for (auto& input_val : stage->inputs()) {
+    if (shouldRun(stage)) {
+      pending_works_.waitFor(input_val);
+    }
     stage_input_IValues.push_back(val_to_IValue_[input_val]);
   }
 
   std::vector<at::Tensor> outputs;
 
+  // Time the stage once the kernels it depends on completed
+  const bool measure = timings_ != nullptr && shouldRun(stage);
+  double start_ms = 0;
+  auto elapsed_ms = [this]() {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start_time_)
+        .count();
+  };
+  if (measure) {
+    synchronize();
+    start_ms = elapsed_ms();
+  }
+
   // Compile the stage and either execute it or allocate output buffers
   // if the stage is configured to be autoscheduled, use FusionExecutorCache,
   // otherwise use FusionExecutor
@@ -61,6 +175,12 @@ void PipelineExecutor::handle(PipelineStage* stage) {
         : fe_[stage]->allocOutputSpace(stage_input_IValues);
   }
 
+  if (measure) {
+    synchronize();
+    timings_->intervals.push_back(
+        {stage, micro_batch_, start_ms, elapsed_ms()});
+  }
+
   // Store the outputs or placeholders in the context
   for (auto output_idx : c10::irange(stage->outputs().size())) {
     val_to_IValue_[stage->outputs().at(output_idx)] = outputs.at(output_idx);
@@ -68,47 +188,71 @@ void PipelineExecutor::handle(PipelineStage* stage) {
 }
 
 void PipelineExecutor::handle(PipelineCommunication* c) {
+  // The input may be the buffer of a communication still in flight
+  pending_works_.waitFor(c->in());
   at::Tensor input_tensor = val_to_IValue_.at(c->in()).toTensor();
 
-  /* Allocation of output buffer.
-    TODO: revise to avoid garbage allocation. Indeed, for now we use the same
-    buffer for the input and output of the Communication. The input has always
-    been allocated previously since we systematically allocate the output of
-    every PipelineStage. This is valid but induces a lot of garbage allocation:
-    1) some PipelineStage's outputs could be ignore on certain devices
-    2) some buffers are overallocated, e.g., if the communication pattern is
-       the one of a "Scatter", the destination buffer's size only need to be a
-    fraction of the source buffer.
-  */
-  val_to_IValue_[c->out()] = val_to_IValue_.at(c->in());
-  at::Tensor output_tensor =
-      val_to_IValue_.at(c->out()).toTensor(); // shallow copy
+  // Allocation of output buffer. Only the receiving devices get a buffer,
+  // drawn from the runtime's pool. The other devices alias the input, whose
+  // metadata is enough to allocate the outputs of the stages they don't run.
+  at::Tensor output_tensor = allocateCommunicationOutput(
+      runtime_.comm_.deviceId(), c, input_tensor, runtime_.buffer_pool_);
+  val_to_IValue_[c->out()] = output_tensor;
 
   // Lower the Communication into a vector of Communications
   if (communications_.find(c) == communications_.end()) { // check if cached
     communications_.emplace(
         c,
         lowerCommunication(
-            runtime_.comm_.deviceId(), c, input_tensor, output_tensor));
+            runtime_.comm_.deviceId(),
+            c,
+            input_tensor,
+            output_tensor,
+            &runtime_.buffer_pool_));
   }
   auto& communications = communications_[c];
 
-  // post and wait communications
+  // post communications. They are waited on by the exprs using their input
+  // or output buffer.
   for (auto& communication : communications) {
     auto work = communication->post(runtime_.comm_);
     if (work) {
-      work->wait();
+      pending_works_.add({c->in(), c->out()}, work);
     }
   }
 }
 
 std::vector<at::Tensor> PipelineExecutor::runWithInput(
     const std::vector<c10::IValue>& inputs) {
+  auto outputs = runMicroBatch(inputs);
+  waitForMicroBatches(0);
+  return outputs;
+}
+
+void PipelineExecutor::waitForMicroBatches(size_t max_in_flight) {
+  while (in_flight_micro_batches_.size() > max_in_flight) {
+    for (auto& work : in_flight_micro_batches_.front().works) {
+      work->wait();
+    }
+    in_flight_micro_batches_.pop_front();
+  }
+}
+
+std::vector<at::Tensor> PipelineExecutor::runMicroBatch(
+    const std::vector<c10::IValue>& inputs,
+    int64_t micro_batch) {
   // Make sure inputs align at global boundary.
   NVF_ERROR(
       inputs.size() == runtime_.pipeline_->inputs().size(),
       "Wrong number of inputs");
 
+  if (timings_ != nullptr && micro_batch == 0) {
+    start_time_ = std::chrono::steady_clock::now();
+  }
+  micro_batch_ = micro_batch;
+  // The lowered communications are bound to the buffers of a micro-batch
+  communications_.clear();
+
   // process input values input values:
   for (auto input_idx : c10::irange(inputs.size())) {
     val_to_IValue_[runtime_.pipeline_->inputs().at(input_idx)] =
@@ -116,7 +260,20 @@ std::vector<at::Tensor> PipelineExecutor::runWithInput(
   }
 
   // Run through the stages to launch kernel
-  traverseTo(runtime_.pipeline_, runtime_.pipeline_->outputs());
+  for (auto expr : schedule(runtime_.pipeline_)) {
+    dispatch(expr);
+  }
+
+  // Keep track of the communications whose outputs were not consumed
+  InFlightMicroBatch in_flight;
+  in_flight.works = pending_works_.release();
+  for (auto& item : communications_) {
+    in_flight.communications.insert(
+        in_flight.communications.end(), item.second.begin(), item.second.end());
+  }
+  if (!in_flight.works.empty()) {
+    in_flight_micro_batches_.push_back(std::move(in_flight));
+  }
 
   // Collect global outputs from context
   std::vector<at::Tensor> outputs;
@@ -15,11 +15,49 @@
 #include <multidevice/pipeline_ir.h>
 #include <multidevice/runtime.h>
 
+#include <chrono>
+#include <deque>
+
 namespace nvfuser {
 
+// Works of the posted communications that were not waited on yet, by the Vals
+// whose buffers they use
+class PendingWorks {
+ public:
+  // Registers the work of a communication reading or writing the buffers of
+  // vals
+  void add(const std::vector<Val*>& vals, c10::intrusive_ptr<c10d::Work> work);
+
+  // Returns whether a communication reading or writing the buffer of val was
+  // not waited on yet
+  bool isPending(Val* val) const {
+    return works_.count(val) > 0;
+  }
+
+  // Waits for the communications reading or writing the buffer of val
+  void waitFor(Val* val);
+
+  // Returns the works that were not waited on yet, each once, and forgets
+  // about them
+  std::vector<c10::intrusive_ptr<c10d::Work>> release();
+
+ private:
+  std::unordered_map<Val*, std::vector<c10::intrusive_ptr<c10d::Work>>> works_;
+};
+
 // Runtime Executor for Pipelines
-// This class inherits from IterVisitor because the execution
-// is ordered by the traversal of the Pipeline seen as a DAG
+// This class inherits from IterVisitor to dispatch the exprs of the Pipeline
+// seen as a DAG. The exprs are run in the order given by schedule().
+//
+// Communications are posted without blocking. The c10d::Work of each
+// communication is only waited on before a stage that runs on this device
+// consumes its buffers, or before another communication uses them, so
+// transfers overlap with the stages that don't depend on them.
+//
+// The Pipeline can also be run on successive micro-batches with
+// runMicroBatch. The communications of a micro-batch that are still in flight
+// when it returns are only waited on by waitForMicroBatches, so they overlap
+// with the stages of the next micro-batches.
 class PipelineExecutor : public IterVisitor {
  public:
   explicit PipelineExecutor(MultiDeviceRuntime& runtime)
@@ -28,6 +66,31 @@ class PipelineExecutor : public IterVisitor {
   // Run the Pipelined Fusion with the given global inputs
   std::vector<at::Tensor> runWithInput(const std::vector<c10::IValue>& inputs);
 
+  // Run the Pipelined Fusion on the inputs of a micro-batch. The returned
+  // outputs are only complete after waitForMicroBatches(0).
+  std::vector<at::Tensor> runMicroBatch(
+      const std::vector<c10::IValue>& inputs,
+      int64_t micro_batch = 0);
+
+  // Waits for the communications of the oldest micro-batches until at most
+  // max_in_flight of them have communications in flight
+  void waitForMicroBatches(size_t max_in_flight);
+
+  // Record the host time of the stages run on this device in timings
+  void measureStageTime(PipelineTimings* timings) {
+    timings_ = timings;
+  }
+
+  // Waits for the kernels launched on the device of this process
+  void synchronize() const;
+
+  // Returns a topological order of the exprs of the Pipeline in which each
+  // communication is posted as soon as its input is computed, and stages
+  // whose inputs are not being communicated run before the ones that would
+  // have to wait. It only depends on the Pipeline, so all devices post the
+  // communications in the same order.
+  static std::vector<Expr*> schedule(Pipeline* pipeline);
+
  private:
   // Implement the execution of exprs of the Pipeline
   // Each PipelineStage will be compiled and executed on a GPU
@@ -40,6 +103,17 @@ class PipelineExecutor : public IterVisitor {
   // Returns whether the current process should run the stage
   bool shouldRun(PipelineStage* stage);
 
+  // Works of the posted communications that were not waited on yet
+  PendingWorks pending_works_;
+
+  // Communications and works of the micro-batches that were not waited on
+  // yet, oldest first. The communications keep their buffers alive.
+  struct InFlightMicroBatch {
+    std::vector<std::shared_ptr<Communication>> communications;
+    std::vector<c10::intrusive_ptr<c10d::Work>> works;
+  };
+  std::deque<InFlightMicroBatch> in_flight_micro_batches_;
+
   // Stores concrete computed values,
   std::unordered_map<Val*, c10::IValue> val_to_IValue_;
 
@@ -56,6 +130,12 @@ class PipelineExecutor : public IterVisitor {
   // Cache results of shouldRun method
   std::unordered_map<PipelineStage*, bool> should_run_;
 
+  // Where to record the stage intervals, if measured, and the index of the
+  // micro-batch being run
+  PipelineTimings* timings_ = nullptr;
+  int64_t micro_batch_ = 0;
+  std::chrono::steady_clock::time_point start_time_;
+
   // MultiDeviceRuntime to be executed
   MultiDeviceRuntime& runtime_;
 };
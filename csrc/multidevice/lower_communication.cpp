@@ -32,7 +32,12 @@ inline bool isDeviceInvolved(
 
 // Creates a dummy tensor for scatter/gather communications,
 // see 'createParamsForGatherScatter'
-inline at::Tensor createDummyTensor(at::Tensor reference) {
+inline at::Tensor createDummyTensor(
+    at::Tensor reference,
+    CommunicationBufferPool* pool) {
+  if (pool != nullptr) {
+    return pool->get(reference.sizes(), reference.options());
+  }
   return at::empty_like(reference, reference.options());
 }
 
@@ -46,7 +51,8 @@ CommParams createParamsForGatherScatter(
     const DeviceMesh& mesh, // is_scatter? receivers : senders
     at::Tensor root_buf, // is_scatter? input buf : output buf
     at::Tensor buf, // is_scatter? output buf : input buf
-    bool is_scatter) {
+    bool is_scatter,
+    CommunicationBufferPool* pool) {
   CommParams params;
   params.root = root;
   params.team = mesh.vector();
@@ -70,7 +76,7 @@ CommParams createParamsForGatherScatter(
     // have to artificially make it send and receive a dummy buffer
     // Since it is an "inplace" operation, this should not cause any overhead
     if (!is_root_in_mesh) {
-      at::Tensor dummy = createDummyTensor(root_buf.index({0, "..."}));
+      at::Tensor dummy = createDummyTensor(root_buf.index({0, "..."}), pool);
       params.src_bufs.push_back(dummy);
       params.dst_bufs.push_back(dummy);
     }
@@ -85,6 +91,7 @@ void lowerToScatter(
     const DeviceMesh& receiver_mesh,
     at::Tensor input_tensor,
     at::Tensor output_tensor,
+    CommunicationBufferPool* pool,
     std::vector<std::shared_ptr<Communication>>& comms) {
   // we arbitrarily choose the first device of the sender mesh to be the root
   auto root = sender_mesh.vector().at(0);
@@ -92,7 +99,13 @@ void lowerToScatter(
     return;
   }
   auto params = createParamsForGatherScatter(
-      my_device_index, root, receiver_mesh, input_tensor, output_tensor, true);
+      my_device_index,
+      root,
+      receiver_mesh,
+      input_tensor,
+      output_tensor,
+      true,
+      pool);
   comms.push_back(std::make_shared<Scatter>(std::move(params)));
 }
 
@@ -108,6 +121,7 @@ void lowerToGather(
     const DeviceMesh& receiver_mesh,
     at::Tensor input_tensor,
     at::Tensor output_tensor,
+    CommunicationBufferPool* pool,
     std::vector<std::shared_ptr<Communication>>& comms) {
   // we create as many 'Gathers' as there are devices in the receiver mesh
   for (auto root : receiver_mesh.vector()) {
@@ -115,7 +129,13 @@ void lowerToGather(
       continue;
     }
     auto params = createParamsForGatherScatter(
-        my_device_index, root, sender_mesh, output_tensor, input_tensor, false);
+        my_device_index,
+        root,
+        sender_mesh,
+        output_tensor,
+        input_tensor,
+        false,
+        pool);
     comms.push_back(std::make_shared<Gather>(std::move(params)));
   }
 }
@@ -229,6 +249,59 @@ void lowerToBroadcastOrP2P(
 
 } // namespace
 
+at::Tensor CommunicationBufferPool::get(
+    at::IntArrayRef sizes,
+    const at::TensorOptions& options) {
+  auto it = std::find_if(
+      available_.begin(), available_.end(), [&](const at::Tensor& buf) {
+        return buf.sizes() == sizes && buf.dtype() == options.dtype() &&
+            buf.device() == options.device();
+      });
+  at::Tensor buf;
+  if (it != available_.end()) {
+    buf = std::move(*it);
+    available_.erase(it);
+  } else {
+    buf = at::empty(sizes, options);
+    const auto nbytes = (int64_t)buf.nbytes();
+    bytes_allocated_ += nbytes;
+    bytes_reserved_ += nbytes;
+  }
+  in_use_.push_back(buf);
+  return buf;
+}
+
+void CommunicationBufferPool::releaseAll(
+    const std::vector<at::Tensor>& escaping) {
+  for (auto& buf : in_use_) {
+    const bool escapes = std::any_of(
+        escaping.begin(), escaping.end(), [&buf](const at::Tensor& t) {
+          return t.defined() && t.is_alias_of(buf);
+        });
+    if (escapes) {
+      bytes_reserved_ -= (int64_t)buf.nbytes();
+    } else {
+      available_.push_back(std::move(buf));
+    }
+  }
+  in_use_.clear();
+}
+
+at::Tensor allocateCommunicationOutput(
+    DeviceIdxType my_device_index,
+    PipelineCommunication* c,
+    at::Tensor input_tensor,
+    CommunicationBufferPool& pool) {
+  const auto& receiver_mesh =
+      c->out()->as<PipelineVal>()->getStage()->descriptor()->mesh;
+  if (!receiver_mesh.has(my_device_index)) {
+    return input_tensor;
+  }
+  // The input and output are the same logical tensor, and sharded tensors
+  // keep the extent of their mesh on their first axis
+  return pool.get(input_tensor.sizes(), input_tensor.options());
+}
+
 /*
 TODO:
 *) Propose several lowering paths for each given communication
@@ -242,7 +315,8 @@ std::vector<std::shared_ptr<Communication>> lowerCommunication(
     DeviceIdxType my_device_index,
     PipelineCommunication* c,
     at::Tensor input_tensor,
-    at::Tensor output_tensor) {
+    at::Tensor output_tensor,
+    CommunicationBufferPool* pool) {
   std::vector<std::shared_ptr<Communication>> comms;
   TensorView* input_tv =
       c->in()->as<PipelineVal>()->getOriginalVal()->as<TensorView>();
@@ -291,6 +365,7 @@ std::vector<std::shared_ptr<Communication>> lowerCommunication(
         receiver_mesh,
         input_tensor,
         output_tensor,
+        pool,
         comms);
   } else if (is_input_sharded && !is_output_sharded) {
     if (receiver_mesh.vector() == sender_mesh.vector()) {
@@ -303,6 +378,7 @@ std::vector<std::shared_ptr<Communication>> lowerCommunication(
           receiver_mesh,
           input_tensor,
           output_tensor,
+          pool,
           comms);
     }
   } else {
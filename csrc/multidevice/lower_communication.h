@@ -12,15 +12,60 @@
 #include <multidevice/multidevice.h>
 #include <multidevice/pipeline_ir.h>
 
+#include <vector>
+
 namespace nvfuser {
 
+// Pool of the buffers allocated for communications. A buffer handed out by
+// get() is only reused after releaseAll(), which a runtime calls at the end of
+// each run, so the buffers of a run are recycled by the next one instead of
+// being reallocated.
+class CommunicationBufferPool {
+ public:
+  // Returns a contiguous buffer of the given sizes and options
+  at::Tensor get(at::IntArrayRef sizes, const at::TensorOptions& options);
+
+  // Makes all the buffers available again, except the ones sharing their
+  // storage with one of the escaping tensors, e.g. the outputs of the last run
+  // that the caller may still hold
+  void releaseAll(const std::vector<at::Tensor>& escaping = {});
+
+  // Bytes allocated since the creation of the pool
+  int64_t bytesAllocated() const {
+    return bytes_allocated_;
+  }
+
+  // Bytes held by the pool
+  int64_t bytesReserved() const {
+    return bytes_reserved_;
+  }
+
+ private:
+  std::vector<at::Tensor> available_;
+  std::vector<at::Tensor> in_use_;
+  int64_t bytes_allocated_ = 0;
+  int64_t bytes_reserved_ = 0;
+};
+
+// Returns the buffer receiving the output of the communication c on
+// device_index. Only the devices of the receiver mesh get a buffer, drawn
+// from pool. The input tensor is returned on the other devices, which only
+// need the metadata of the output.
+at::Tensor allocateCommunicationOutput(
+    DeviceIdxType device_index,
+    PipelineCommunication* c,
+    at::Tensor input_tensor,
+    CommunicationBufferPool& pool);
+
 // Lower a PipelineCommunication into a series of Communication, given a
-// device_index.
+// device_index. The buffers needed by the lowering are drawn from pool if
+// given.
 std::vector<std::shared_ptr<Communication>> lowerCommunication(
     DeviceIdxType device_index,
     PipelineCommunication* c,
     at::Tensor input_tensor,
-    at::Tensor output_tensor);
+    at::Tensor output_tensor,
+    CommunicationBufferPool* pool = nullptr);
 
 } // namespace nvfuser
 
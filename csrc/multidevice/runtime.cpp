@@ -13,14 +13,126 @@
 #include <multidevice/executor.h>
 #include <multidevice/runtime.h>
 
+#include <algorithm>
+#include <chrono>
+
 namespace nvfuser {
 
+double PipelineTimings::bubbleFraction() const {
+  if (wall_ms <= 0) {
+    return 0;
+  }
+  double busy_ms = 0;
+  for (const auto& interval : intervals) {
+    busy_ms += interval.end_ms - interval.start_ms;
+  }
+  return std::clamp(1 - busy_ms / wall_ms, 0.0, 1.0);
+}
+
+double PipelineTimings::idealBubbleFraction(
+    int64_t num_stages,
+    int64_t num_micro_batches) {
+  NVF_ERROR(num_stages > 0 && num_micro_batches > 0);
+  return (double)(num_stages - 1) /
+      (double)(num_micro_batches + num_stages - 1);
+}
+
 std::vector<at::Tensor> MultiDeviceRuntime::runWithInput(
     std::vector<c10::IValue> inputs) {
   auto error_msg = validate();
   NVF_ERROR(error_msg.empty(), error_msg);
-  PipelineExecutor executor(*this);
-  return executor.runWithInput(inputs);
+
+  const int64_t bytes_before = buffer_pool_.bytesAllocated();
+  std::vector<at::Tensor> outputs;
+  {
+    PipelineExecutor executor(*this);
+    outputs = runMicroBatches(executor, inputs);
+  }
+  // The communications of the run are complete, so their buffers can be
+  // reused by the next run unless they are returned to the caller
+  buffer_pool_.releaseAll(outputs);
+  last_run_communication_bytes_ = buffer_pool_.bytesAllocated() - bytes_before;
+  return outputs;
+}
+
+std::vector<at::Tensor> MultiDeviceRuntime::runMicroBatches(
+    PipelineExecutor& executor,
+    const std::vector<c10::IValue>& inputs) {
+  const auto& params = micro_batch_params_;
+  const int64_t num_micro_batches = params.num_micro_batches;
+  if (num_micro_batches == 1 && !params.measure_stage_time) {
+    return executor.runWithInput(inputs);
+  }
+
+  // Split the tensor inputs along the batch dimension. Other inputs are
+  // given to every micro-batch.
+  std::vector<std::vector<c10::IValue>> micro_batch_inputs(num_micro_batches);
+  for (const auto& input : inputs) {
+    std::vector<at::Tensor> chunks;
+    if (input.isTensor() && num_micro_batches > 1) {
+      const auto& tensor = input.toTensor();
+      NVF_CHECK(
+          tensor.dim() > params.batch_dim &&
+              tensor.size(params.batch_dim) % num_micro_batches == 0,
+          "the batch dimension ",
+          params.batch_dim,
+          " of input of shape ",
+          tensor.sizes(),
+          " can't be split into ",
+          num_micro_batches,
+          " micro-batches");
+      chunks = tensor.chunk(num_micro_batches, params.batch_dim);
+    }
+    for (auto micro_batch : c10::irange(num_micro_batches)) {
+      micro_batch_inputs.at(micro_batch)
+          .push_back(
+              chunks.empty() ? input : c10::IValue(chunks.at(micro_batch)));
+    }
+  }
+
+  // Number of micro-batches whose communications may be in flight when a
+  // micro-batch starts
+  const auto num_stages =
+      (int64_t)pipeline_->descriptor().stage_descriptors.size();
+  const int64_t max_in_flight =
+      params.schedule == MicroBatchSchedule::OneForwardOneBackward
+      ? num_stages - 1
+      : num_micro_batches;
+
+  if (params.measure_stage_time) {
+    last_run_timings_ = PipelineTimings();
+    executor.measureStageTime(&last_run_timings_);
+  }
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::vector<at::Tensor>> micro_batch_outputs;
+  micro_batch_outputs.reserve(num_micro_batches);
+  for (auto micro_batch : c10::irange(num_micro_batches)) {
+    executor.waitForMicroBatches(max_in_flight);
+    micro_batch_outputs.push_back(executor.runMicroBatch(
+        micro_batch_inputs.at(micro_batch), micro_batch));
+  }
+  executor.waitForMicroBatches(0);
+
+  if (params.measure_stage_time) {
+    executor.synchronize();
+    last_run_timings_.wall_ms = std::chrono::duration<double, std::milli>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count();
+  }
+
+  if (num_micro_batches == 1) {
+    return micro_batch_outputs.front();
+  }
+  std::vector<at::Tensor> outputs;
+  for (auto output_idx : c10::irange(micro_batch_outputs.front().size())) {
+    std::vector<at::Tensor> chunks;
+    for (const auto& micro_batch_output : micro_batch_outputs) {
+      chunks.push_back(micro_batch_output.at(output_idx));
+    }
+    outputs.push_back(at::cat(chunks, params.batch_dim));
+  }
+  return outputs;
 }
 
 std::string MultiDeviceRuntime::validate() const {
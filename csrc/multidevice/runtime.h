@@ -11,11 +11,62 @@
 #include <c10/core/DeviceType.h>
 #include <exceptions.h>
 #include <multidevice/communicator.h>
+#include <multidevice/lower_communication.h>
 #include <multidevice/pipeline.h>
 #include <multidevice/pipeline_ir.h>
 
+#include <vector>
+
 namespace nvfuser {
 
+class PipelineExecutor;
+
+/*
+  Schedules of the micro-batches of a pipelined run. Pipelines only run
+  forward, so both schedules run the micro-batches in order on each device and
+  differ in how many of them may be in flight. GPipe posts the communications
+  of all the micro-batches before waiting on any of them. 1F1B, as in its
+  steady state, waits for the communications of micro-batch m - S before
+  starting micro-batch m, S being the number of stages, which bounds the
+  number of micro-batches whose buffers are alive.
+*/
+enum class MicroBatchSchedule { GPipe, OneForwardOneBackward };
+
+struct MicroBatchParams {
+  // Number of micro-batches the global inputs are split into
+  int64_t num_micro_batches = 1;
+  MicroBatchSchedule schedule = MicroBatchSchedule::GPipe;
+  // Dimension of the global tensor inputs and outputs that is split. Its
+  // size must be divisible by num_micro_batches, and each sample must be
+  // computed independently of the others.
+  int64_t batch_dim = 0;
+  // Whether to time the stages run on this device. The device is
+  // synchronized around each stage when set.
+  bool measure_stage_time = false;
+};
+
+// Host time of the stages run by this device during a run, in ms since the
+// start of the run
+struct PipelineTimings {
+  struct Interval {
+    PipelineStage* stage = nullptr;
+    int64_t micro_batch = 0;
+    double start_ms = 0;
+    double end_ms = 0;
+  };
+  std::vector<Interval> intervals;
+  double wall_ms = 0;
+
+  // Fraction of the run during which this device ran no stage
+  double bubbleFraction() const;
+
+  // Bubble fraction of a pipeline of num_stages stages of the same duration,
+  // run on different devices, i.e. (S - 1) / (M + S - 1)
+  static double idealBubbleFraction(
+      int64_t num_stages,
+      int64_t num_micro_batches);
+};
+
 /*
   The MultiDeviceRuntime class gather all what is needed for executing a
   Pipeline on a multi-device setting. It is instantiated from a Pipeline and a
@@ -27,9 +78,38 @@ class MultiDeviceRuntime {
   explicit MultiDeviceRuntime(Pipeline* pipeline, Communicator& comm)
       : pipeline_(pipeline), comm_(comm) {}
 
-  // Run the multidevice fusion with the given global inputs
+  // Run the multidevice fusion with the given global inputs, split into
+  // micro-batches as set by setMicroBatchParams
   std::vector<at::Tensor> runWithInput(std::vector<c10::IValue> inputs);
 
+  void setMicroBatchParams(MicroBatchParams params) {
+    NVF_CHECK(
+        params.num_micro_batches > 0,
+        "the number of micro-batches must be positive");
+    micro_batch_params_ = params;
+  }
+
+  const auto& microBatchParams() const {
+    return micro_batch_params_;
+  }
+
+  // Returns the timings of the last run with
+  // MicroBatchParams::measure_stage_time set
+  const auto& lastRunTimings() const {
+    return last_run_timings_;
+  }
+
+  // Returns the bytes allocated for the communication buffers of the last
+  // run. The buffers are reused across runs, so this is zero once the input
+  // shapes are stable.
+  int64_t lastRunCommunicationBytes() const {
+    return last_run_communication_bytes_;
+  }
+
+  const auto& communicationBufferPool() const {
+    return buffer_pool_;
+  }
+
   // Returns the Communicator
   auto& comm() {
     return comm_;
@@ -49,8 +129,17 @@ class MultiDeviceRuntime {
                                  // and comm_ to PipelineExecutor
   // test if the runtime is valid and satisfies our assumptions
 
+  // Runs the global inputs through executor, split into micro-batches
+  std::vector<at::Tensor> runMicroBatches(
+      PipelineExecutor& executor,
+      const std::vector<c10::IValue>& inputs);
+
   Pipeline* pipeline_;
   Communicator& comm_;
+  MicroBatchParams micro_batch_params_;
+  PipelineTimings last_run_timings_;
+  CommunicationBufferPool buffer_pool_;
+  int64_t last_run_communication_bytes_ = 0;
 };
 
 } // namespace nvfuser
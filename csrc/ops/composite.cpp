@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <ATen/cuda/CUDAContext.h>
+#include <device_descriptor.h>
 #include <ir/builder.h>
 #include <ops/all_ops.h>
 #include <transform_view.h>
@@ -56,9 +57,8 @@ TensorView* dropout_backward(TensorView* dy, TensorView* mask, Val* scale) {
 TensorView* _matmul_nn(TensorView* a, TensorView* b) {
   NVF_CHECK(
       a->nDims() == 2 && b->nDims() == 2, "Only 2-D Tensors are supported!");
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
   NVF_CHECK(
-      device_prop->major == 8,
+      getTargetDevice()->major == 8,
       "Only the Ampere MMA Op is currently supported!");
   auto tv0t = transpose(a, 0, 1);
   auto tv0b = broadcast(tv0t, {false, true, false});
@@ -69,9 +69,8 @@ TensorView* _matmul_nn(TensorView* a, TensorView* b) {
 TensorView* _matmul_nt(TensorView* a, TensorView* b) {
   NVF_CHECK(
       a->nDims() == 2 && b->nDims() == 2, "Only 2-D Tensors are supported!");
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
   NVF_CHECK(
-      device_prop->major == 8,
+      getTargetDevice()->major == 8,
       "Only the Ampere MMA Op is currently supported!");
   auto tv0t = transpose(a, 0, 1);
   auto tv1t = transpose(b, 0, 1);
@@ -83,9 +82,8 @@ TensorView* _matmul_nt(TensorView* a, TensorView* b) {
 TensorView* _matmul_tn(TensorView* a, TensorView* b) {
   NVF_CHECK(
       a->nDims() == 2 && b->nDims() == 2, "Only 2-D Tensors are supported!");
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
   NVF_CHECK(
-      device_prop->major == 8,
+      getTargetDevice()->major == 8,
       "Only the Ampere MMA Op is currently supported!");
   auto tv0b = broadcast(a, {false, true, false});
   auto tv1b = broadcast(b, {true, false, false});
@@ -95,9 +93,8 @@ TensorView* _matmul_tn(TensorView* a, TensorView* b) {
 TensorView* _matmul_tt(TensorView* a, TensorView* b) {
   NVF_CHECK(
       a->nDims() == 2 && b->nDims() == 2, "Only 2-D Tensors are supported!");
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
   NVF_CHECK(
-      device_prop->major == 8,
+      getTargetDevice()->major == 8,
       "Only the Ampere MMA Op is currently supported!");
   auto tv1t = transpose(b, 0, 1);
   auto tv0b = broadcast(a, {false, true, false});
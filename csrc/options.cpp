@@ -150,10 +150,16 @@ template <>
 std::unordered_map<EnableOption, std::vector<std::string>> Options<
     EnableOption>::getOptionsFromEnv() {
   const std::unordered_map<std::string, EnableOption> available_options = {
+      {"autotune", EnableOption::Autotune},
+      {"compile_profile", EnableOption::CompileProfile},
       {"id_model", EnableOption::IdModel},
+      {"incremental_segmentation", EnableOption::IncrementalSegmentation},
       {"kernel_db", EnableOption::KernelDb},
       {"kernel_profile", EnableOption::KernelProfile},
       {"memory_promotion", EnableOption::MemoryPromotion},
+      {"parallel_lower_analysis", EnableOption::ParallelLowerAnalysis},
+      {"segment_workspace", EnableOption::SegmentWorkspace},
+      {"shape_buckets", EnableOption::ShapeBuckets},
       {"static_fusion_count", EnableOption::StaticFusionCount},
       {"warn_register_spill", EnableOption::WarnRegisterSpill}};
 
@@ -177,10 +183,12 @@ std::unordered_map<DisableOption, std::vector<std::string>> Options<
       {"parallel_serde", DisableOption::ParallelSerde},
       {"predicate_elimination", DisableOption::PredicateElimination},
       {"kernel_reuse", DisableOption::KernelReuse},
+      {"lazy_serde", DisableOption::LazySerde},
       {"var_name_remapping", DisableOption::VarNameRemapping},
       {"welford_vectorization", DisableOption::WelfordVectorization},
       {"reuse_mismatched_type_registers",
-       DisableOption::ReuseMismatchedTypeRegisters}};
+       DisableOption::ReuseMismatchedTypeRegisters},
+      {"typed_value_machine", DisableOption::TypedValueMachine}};
 
   auto options = parseEnvOptions("DISABLE", available_options);
 
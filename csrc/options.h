@@ -75,10 +75,23 @@ enum class DebugDumpOption {
 //! These can be set through the `NVFUSER_ENABLE` environment variable
 //!
 enum class EnableOption {
+  Autotune, //! Enable tuning heuristics and looking them up in a tuning
+            //! database, see autotuneHeuristicParams
+  CompileProfile, //! Enable recording a host time profile of each
+                  //! compilation, see CompileProfiler
   IdModel, //! Enable IdModel
+  IncrementalSegmentation, //! Enable seeding the segmentation of a new kernel
+                           //! runtime with the segmentation of the previous
+                           //! one, see SegmentCandidateFinder::segment
   KernelDb, //! Enable Kernel Database
   KernelProfile, //! Enable intra-kernel performance profiling
   MemoryPromotion, //! Enable promotion of memory types for non-pointwise ops
+  ParallelLowerAnalysis, //! Enable running read-only lowering analyses
+                         //! concurrently on the thread pool
+  SegmentWorkspace, //! Enable placing segment intermediates in a workspace
+                    //! planned from their live ranges
+  ShapeBuckets, //! Enable computing heuristics from bucketed input sizes so
+                //! that a kernel is re-used for all sizes of a bucket
   StaticFusionCount, //! Enable using single static count in kernel name
   WarnRegisterSpill, //! Enable warnings of register spill
   EndOfOption //! Placeholder for counting the number of elements
@@ -104,10 +117,14 @@ enum class DisableOption {
   PredicateElimination, //! Disable predicate elimination
   KernelReuse, //! Disable re-using cached FusionKernelRuntimes with different
                //! input shapes
+  LazySerde, //! Disable deferring the deserialization of each fusion of a
+             //! serialized FusionCache until it is first used
   VarNameRemapping, //! Disable variable name remapping
   WelfordVectorization, //! Disable vectorizaton of Welford ops
   ReuseMismatchedTypeRegisters, //! Disable explicitly re-using registers unless
                                 //! types match
+  TypedValueMachine, //! Disable the int64/bool fast path used to evaluate
+                     //! PrecomputedValues
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -0,0 +1,207 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <instrumentation.h>
+#include <kernel_cache.h>
+#include <python_frontend/batch_compile.h>
+#include <python_frontend/fusion_cache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <unordered_map>
+
+namespace nvfuser::python_frontend {
+
+namespace {
+
+c10::IValue toIValue(const PolymorphicValue& value) {
+  if (value.is<at::Tensor>()) {
+    return value.as<at::Tensor>();
+  } else if (value.is<double>()) {
+    return value.as<double>();
+  } else if (value.is<int64_t>()) {
+    return value.as<int64_t>();
+  } else if (value.is<bool>()) {
+    return value.as<bool>();
+  } else if (value.is<std::complex<double>>()) {
+    return c10::complex<double>(value.as<std::complex<double>>());
+  }
+  NVF_ERROR(false, "Unsupported kernel argument: ", value);
+  return {};
+}
+
+template <typename Data>
+std::string writeFile(const std::string& path, const Data& data) {
+  std::ofstream file(path, std::ios::binary);
+  NVF_CHECK(file.good(), "Can't open ", path);
+  file.write(data.data(), (std::streamsize)data.size());
+  return path;
+}
+
+// Writes the CUDA source and the PTX or cubin of each kernel of a runtime
+void writeKernels(
+    const FusionKernelRuntime* kernel_runtime,
+    const std::string& output_dir,
+    std::vector<std::string>& files) {
+  for (const auto& executor : kernel_runtime->executors()) {
+    if (!executor.isCompiled()) {
+      continue;
+    }
+    const std::string path = output_dir + "/" + executor.kernelName();
+    files.push_back(writeFile(path + ".cu", executor.getStructuredCode()));
+    const auto& compiled_kernel = executor.compiledKernel();
+    if (!compiled_kernel.ptx.empty()) {
+      files.push_back(writeFile(path + ".ptx", compiled_kernel.ptx));
+    }
+    if (!compiled_kernel.cubin.empty()) {
+      files.push_back(writeFile(path + ".cubin", compiled_kernel.cubin));
+    }
+  }
+}
+
+void compileJob(
+    const BatchCompileJob& job,
+    const BatchCompileOptions& options,
+    BatchCompileResult& result) {
+  FUSER_PERF_SCOPE("batchCompile::compileJob");
+  result.fusion_id = job.fusion_id;
+  for (const auto& inputs : job.inputs) {
+    try {
+      auto fec = FusionCache::get()
+                     ->queryFusionSchedules(job.fusion_id)
+                     ->auto_gen_schedules.get();
+      const auto start = std::chrono::steady_clock::now();
+      // Compile the segments on this worker. Otherwise, every worker would
+      // wait for the whole thread pool to be idle after submitting its
+      // segments, see FusionKernelRuntime::compileFusionParallel.
+      auto [kernel_runtime, compiled] = fec->compileKernelRuntimeAheadOfTime(
+          inputs, options.device, /*parallel_compile=*/false);
+      result.compile_time_ms += std::chrono::duration<double, std::milli>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count();
+      if (!compiled) {
+        continue;
+      }
+      result.num_compiled++;
+      result.num_kernels += (int64_t)kernel_runtime->executors().size();
+      if (!options.output_dir.empty()) {
+        writeKernels(kernel_runtime, options.output_dir, result.files);
+      }
+    } catch (const std::exception& e) {
+      if (!result.error.has_value()) {
+        result.error = e.what();
+      }
+    }
+  }
+}
+
+} // namespace
+
+std::vector<BatchCompileResult> batchCompile(
+    const std::vector<BatchCompileJob>& jobs,
+    const BatchCompileOptions& options) {
+  FUSER_PERF_SCOPE("batchCompile");
+  std::vector<BatchCompileResult> results(jobs.size());
+  if (jobs.empty()) {
+    return results;
+  }
+
+  if (!options.output_dir.empty()) {
+    std::filesystem::create_directories(options.output_dir);
+  }
+
+  int64_t num_workers = options.num_workers > 0
+      ? options.num_workers
+      : (int64_t)std::thread::hardware_concurrency();
+  num_workers = std::clamp(num_workers, (int64_t)1, (int64_t)jobs.size());
+
+  std::atomic<size_t> next_job{0};
+  auto work = [&]() {
+    for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+      compileJob(jobs[i], options, results[i]);
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers);
+  for (int64_t i = 0; i < num_workers; i++) {
+    workers.emplace_back(work);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return results;
+}
+
+std::vector<BatchCompileJob> loadBatchCompileJobs(
+    const std::string& filename) {
+  FUSER_PERF_SCOPE("loadBatchCompileJobs");
+  auto runtime_args = FusionCache::get()->deserializeDefinitions(filename);
+
+  std::vector<BatchCompileJob> jobs;
+  std::unordered_map<size_t, size_t> job_of_fusion;
+  for (const auto& [fusion_id, args] : runtime_args) {
+    auto it = job_of_fusion.find(fusion_id);
+    if (it == job_of_fusion.end()) {
+      it = job_of_fusion.emplace(fusion_id, jobs.size()).first;
+      jobs.emplace_back();
+      jobs.back().fusion_id = fusion_id;
+    }
+    std::vector<c10::IValue> inputs;
+    inputs.reserve(args.size());
+    for (auto i : c10::irange(args.size())) {
+      inputs.push_back(toIValue(*args[i]));
+    }
+    jobs.at(it->second).inputs.push_back(std::move(inputs));
+  }
+  return jobs;
+}
+
+void printBatchCompileReport(
+    std::ostream& os,
+    const std::vector<BatchCompileResult>& results) {
+  std::vector<const BatchCompileResult*> sorted;
+  double total_ms = 0.0;
+  int64_t num_kernels = 0;
+  int64_t num_failed = 0;
+  for (const auto& result : results) {
+    sorted.push_back(&result);
+    total_ms += result.compile_time_ms;
+    num_kernels += result.num_kernels;
+    num_failed += result.error.has_value() ? 1 : 0;
+  }
+  std::stable_sort(
+      sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+        return a->compile_time_ms > b->compile_time_ms;
+      });
+
+  os << "Compiled " << num_kernels << " kernels of " << results.size()
+     << " fusions in " << std::fixed << std::setprecision(3) << total_ms
+     << " ms of compile time, " << num_failed << " failed\n";
+  os << std::setw(10) << "Fusion" << std::setw(12) << "Runtimes"
+     << std::setw(10) << "Kernels" << std::setw(14) << "Time (ms)"
+     << "  Status\n";
+  for (const auto* result : sorted) {
+    os << std::setw(10) << result->fusion_id << std::setw(12)
+       << result->num_compiled << std::setw(10) << result->num_kernels
+       << std::setw(14) << result->compile_time_ms << "  "
+       << (result->error.has_value() ? "FAILED" : "ok") << "\n";
+  }
+  for (const auto* result : sorted) {
+    if (result->error.has_value()) {
+      os << "\nFusion " << result->fusion_id
+         << " failed: " << result->error.value() << "\n";
+    }
+  }
+}
+
+} // namespace nvfuser::python_frontend
@@ -0,0 +1,82 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+#include <exceptions.h>
+
+#include <ATen/core/ivalue.h>
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nvfuser::python_frontend {
+
+//! \struct BatchCompileJob
+//! \brief A fusion of the FusionCache and the sets of inputs to compile it
+//! for, as taken by FusionExecutorCache::compileFusionAheadOfTime
+struct BatchCompileJob {
+  size_t fusion_id = 0;
+  std::vector<std::vector<c10::IValue>> inputs;
+};
+
+//! \struct BatchCompileResult
+//! \brief Outcome of the compilation of a BatchCompileJob
+struct BatchCompileResult {
+  size_t fusion_id = 0;
+  //! Number of input sets that needed a new kernel runtime
+  int64_t num_compiled = 0;
+  int64_t num_kernels = 0;
+  //! Wall time of the segmentation, scheduling, lowering, code generation
+  //! and NVRTC compilation of all input sets
+  double compile_time_ms = 0.0;
+  //! Files written to BatchCompileOptions::output_dir
+  std::vector<std::string> files;
+  //! Error message of the first input set that failed, if any
+  std::optional<std::string> error;
+};
+
+struct BatchCompileOptions {
+  //! Number of worker threads. Non-positive means one per hardware thread.
+  int64_t num_workers = 0;
+  std::optional<int8_t> device = std::nullopt;
+  //! Directory where the CUDA source and the PTX or cubin of every kernel
+  //! compiled are written. Nothing is written if it is empty.
+  std::string output_dir;
+};
+
+//! Compiles the fusions of FusionCache::get() for the inputs of each job
+//! without running them. Segmentation, scheduling, GpuLower, code generation
+//! and NVRTC run for one fusion at a time on each worker thread. FusionGuard
+//! and the active GpuLower are thread-local, so the workers don't interfere,
+//! and the segments of a fusion are compiled serially on its worker instead
+//! of on the shared thread pool.
+//!
+//! Compiled kernels are written to the kernel database when it is enabled
+//! with NVFUSER_ENABLE=kernel_db, so that other processes don't compile them
+//! again, and stay in the FusionCache, which serialize() persists.
+//!
+//! A job that fails doesn't stop the others. Results are in the order of
+//! the jobs.
+std::vector<BatchCompileResult> batchCompile(
+    const std::vector<BatchCompileJob>& jobs,
+    const BatchCompileOptions& options);
+
+//! Loads the fusion definitions of a serialized FusionCache into
+//! FusionCache::get(), which must be empty, and returns a job for each
+//! fusion with the inputs of the kernel runtimes it had. See
+//! FusionCache::deserializeDefinitions.
+std::vector<BatchCompileJob> loadBatchCompileJobs(const std::string& filename);
+
+//! Prints the compile time of every job, slowest first, and the failures
+void printBatchCompileReport(
+    std::ostream& os,
+    const std::vector<BatchCompileResult>& results);
+
+} // namespace nvfuser::python_frontend
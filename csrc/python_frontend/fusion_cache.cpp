@@ -21,7 +21,9 @@ namespace fs = std::filesystem;
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
 #else
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -70,28 +72,13 @@ fs::path getSerdeFilePath(const std::string& file_name) {
   return kernel_db_path / file_name;
 }
 
-using BinaryBuffer = std::vector<uint8_t>;
-BinaryBuffer openFusionCache(std::string filename) {
-  FUSER_PERF_SCOPE("Flatbuffers::openFusionCache");
-  auto file_handle = std::fopen(filename.c_str(), "rb");
-  NVF_CHECK(file_handle != nullptr, "Failed to open FusionCache buffer.");
-
-  auto file_path = fs::path(filename.c_str());
-  auto file_size = fs::file_size(file_path);
-  NVF_CHECK(file_size > 0, "FusionCache buffer is empty.");
-
-  BinaryBuffer buffer(file_size);
-  size_t read_status =
-      std::fread(buffer.data(), sizeof(uint8_t), file_size, file_handle);
-  NVF_CHECK(
-      read_status == file_size, "Failed to read entire FusionCache buffer.\n");
-  return buffer;
-}
-
-// This check function only throws errors if strict flag is enabled.
+// This check function only throws errors if strict flag is enabled. The
+// device and CUDA versions are only checked if check_versions is set, since
+// they only matter for the compiled kernels.
 const serde::FusionCache* verifyFusionCache(
     const BinaryBuffer& buffer,
-    bool strict) {
+    bool strict,
+    bool check_versions = true) {
   FUSER_PERF_SCOPE("Flatbuffers::verifyFusionCache");
   auto fusion_cache_buffer = serde::GetFusionCache(buffer.data());
 
@@ -110,6 +97,10 @@ const serde::FusionCache* verifyFusionCache(
     return nullptr;
   }
 
+  if (!check_versions) {
+    return fusion_cache_buffer;
+  }
+
   // Check device major and minor versions
   auto device_prop = at::cuda::getCurrentDeviceProperties();
   if (device_prop->major != fusion_cache_buffer->device_major() ||
@@ -151,6 +142,45 @@ const serde::FusionCache* verifyFusionCache(
 
 } // namespace
 
+BinaryBuffer::BinaryBuffer(const std::string& filename) {
+  FUSER_PERF_SCOPE("Flatbuffers::openFusionCache");
+  auto file_path = fs::path(filename.c_str());
+  NVF_CHECK(fs::exists(file_path), "Failed to open FusionCache buffer.");
+  size_ = fs::file_size(file_path);
+  NVF_CHECK(size_ > 0, "FusionCache buffer is empty.");
+
+#ifndef _WIN32
+  int fd = open(filename.c_str(), O_RDONLY);
+  NVF_CHECK(fd >= 0, "Failed to open FusionCache buffer.");
+  void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file is closed
+  close(fd);
+  if (mapping != MAP_FAILED) {
+    data_ = static_cast<const uint8_t*>(mapping);
+    mapped_ = true;
+    return;
+  }
+#endif // _WIN32
+
+  auto file_handle = std::fopen(filename.c_str(), "rb");
+  NVF_CHECK(file_handle != nullptr, "Failed to open FusionCache buffer.");
+  contents_.resize(size_);
+  size_t read_status =
+      std::fread(contents_.data(), sizeof(uint8_t), size_, file_handle);
+  std::fclose(file_handle);
+  NVF_CHECK(
+      read_status == size_, "Failed to read entire FusionCache buffer.\n");
+  data_ = contents_.data();
+}
+
+BinaryBuffer::~BinaryBuffer() {
+#ifndef _WIN32
+  if (mapped_) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+#endif // _WIN32
+}
+
 void serialize() {
   auto tmp_file_path = getSerdeFilePath(getSerdeTmpFile());
   FusionCache::get()->serialize(tmp_file_path);
@@ -205,18 +235,107 @@ Fusion* FusionSchedules::preschedFusion() {
   return fusion;
 }
 
+void FusionSchedules::buildPreschedFusion() {
+  if (serde_terminal_node == nullptr) {
+    return;
+  }
+  FUSER_PERF_SCOPE("FusionSchedules::buildPreschedFusion");
+  // Replay the records from the root, the StartRecord, to the EndRecord
+  std::vector<TrieNode*> path;
+  for (auto node = serde_terminal_node; node != nullptr; node = node->parent) {
+    path.push_back(node);
+  }
+  FusionState state;
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    state.addRecord((*it)->record->clone());
+  }
+  state.buildFusionIr(preschedFusion());
+  serde_terminal_node = nullptr;
+}
+
+void FusionSchedules::materialize() {
+  std::call_once(materialize_flag, [this]() {
+    FUSER_PERF_SCOPE("FusionSchedules::materialize");
+    buildPreschedFusion();
+    if (serde_buffer != nullptr) {
+      auto_gen_schedules->deserialize(serde_buffer, fusion_id_);
+      serde_buffer = nullptr;
+    }
+  });
+}
+
 TrieNode::TrieNode(RecordFunctor* rec, TrieNode* _parent, size_t _fusion_id)
     : record(rec),
       children(),
       fusion_id(_fusion_id),
       visits(0),
       parent(_parent),
-      trie_node_lock() {}
+      trie_node_lock(),
+      record_hash_(rec != nullptr ? rec->hash() : 0) {}
 
 bool TrieNode::isTerminal() const {
   return (record.get()->recordType() == serde::RecordType::End);
 }
 
+TrieNode::ChildTable::ChildTable(size_t capacity) : slots(capacity) {
+  for (auto& slot : slots) {
+    slot.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+void TrieNode::insertChild(ChildTable& table, TrieNode* child) {
+  const size_t mask = table.slots.size() - 1;
+  size_t idx = child->record_hash_ & mask;
+  while (table.slots[idx].load(std::memory_order_relaxed) != nullptr) {
+    idx = (idx + 1) & mask;
+  }
+  // Release so that a reader that finds the child sees it fully constructed
+  table.slots[idx].store(child, std::memory_order_release);
+}
+
+TrieNode* TrieNode::findChild(RecordFunctor* rec) const {
+  const ChildTable* table = child_table_.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    return nullptr;
+  }
+  const size_t hash = rec->hash();
+  const size_t mask = table->slots.size() - 1;
+  for (size_t idx = hash & mask;; idx = (idx + 1) & mask) {
+    TrieNode* child = table->slots[idx].load(std::memory_order_acquire);
+    if (child == nullptr) {
+      return nullptr;
+    }
+    if (child->record_hash_ == hash && *child->record == *rec) {
+      return child;
+    }
+  }
+}
+
+TrieNode* TrieNode::addChild(std::unique_ptr<TrieNode> child) {
+  TrieNode* child_ptr = child.get();
+  auto status = children.emplace(child_ptr->record.get(), std::move(child));
+  NVF_CHECK(status.second, "Failed to add child to the current TrieNode.");
+
+  // Keep the table at most a quarter full so that probe sequences stay short
+  // and always end at an empty slot.
+  ChildTable* table = child_table_.load(std::memory_order_relaxed);
+  if (table != nullptr && 4 * children.size() <= table->slots.size()) {
+    insertChild(*table, child_ptr);
+    return child_ptr;
+  }
+  size_t capacity = 8;
+  while (capacity < 4 * children.size()) {
+    capacity *= 2;
+  }
+  auto new_table = std::make_unique<ChildTable>(capacity);
+  for (auto& it : children) {
+    insertChild(*new_table, it.second.get());
+  }
+  child_table_.store(new_table.get(), std::memory_order_release);
+  child_tables_.push_back(std::move(new_table));
+  return child_ptr;
+}
+
 flatbuffers::Offset<serde::TrieNode> TrieNode::serialize(
     flatbuffers::FlatBufferBuilder& builder,
     const std::map<RecordFunctor*, size_t>&
@@ -254,6 +373,7 @@ FusionCache* FusionCache::get(
 }
 
 size_t FusionCache::numFusions() const {
+  std::shared_lock<std::shared_mutex> guard(fusions_lock_);
   return fusions_.size();
 }
 
@@ -336,14 +456,16 @@ FusionCache::FusionCache(size_t max_fusions, bool load_from_default_workspace)
   // Deserialize cache hierarchy from common workspace automatically
   auto file_path = getSerdeFilePath(getSerdeFile()).native();
   if (load_from_default_workspace && fs::exists(file_path)) {
-    const BinaryBuffer& buffer = openFusionCache(file_path);
+    auto buffer = std::make_unique<BinaryBuffer>(file_path);
     const serde::FusionCache* fc =
-        verifyFusionCache(buffer, false /* strict */);
+        verifyFusionCache(*buffer, false /* strict */);
     // The saved workspace can become out-of-date between nvfuser updates.
     if (fc != nullptr) {
       // Only deserialize if the current binary is valid.
-      deserialize(buffer, fc);
+      serde_buffer_ = std::move(buffer);
+      deserialize(*serde_buffer_, fc);
     } else {
+      buffer.reset();
       try {
         fs::remove(file_path);
         std::cout << "Delete incompatible workspace." << std::endl;
@@ -365,22 +487,24 @@ std::optional<TrieNode*> FusionCache::queryChildren(
   NVF_CHECK(
       !node->isTerminal(), "There should be no children from a Terminal Node!");
   NVF_CHECK(rec, "Record is null!");
-  auto trie_node = node->children.find(rec);
-  if (trie_node == std::end(node->children)) {
+  TrieNode* child = node->findChild(rec);
+  if (child == nullptr) {
     return std::nullopt;
   } else {
-    ++(trie_node->second.get()->visits);
-    return std::optional<TrieNode*>(trie_node->second.get());
+    ++(child->visits);
+    return std::optional<TrieNode*>(child);
   }
 }
 
 FusionSchedules* FusionCache::queryFusionSchedules(size_t fusion_id) const {
+  std::shared_lock<std::shared_mutex> guard(fusions_lock_);
   NVF_CHECK(
       fusion_id < fusions_.size(),
       "Invalid scheduler query for id:",
       fusion_id);
   FusionSchedules* ptr = fusions_.at(fusion_id).get();
   NVF_CHECK(ptr != nullptr, "Unexpected null FusionSchedules object.");
+  ptr->materialize();
   return ptr;
 }
 std::optional<size_t> FusionCache::queryUserScheduleId(
@@ -429,6 +553,7 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
   } else {
     size_t fusion_id = 0;
     if (rec->recordType() == serde::RecordType::End) {
+      std::unique_lock<std::shared_mutex> fusions_guard(fusions_lock_);
       NVF_CHECK(
           (fusions_.size() + 1) <= max_fusions_,
           "The number of fusions in nvfuser has exceeded ",
@@ -444,13 +569,13 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
     // than managing a shared pointer that would only share with
     // FusionDefinition that creates a trie node but not cache lookups
     RecordFunctor* new_rec = rec->clone();
-    node->children[new_rec] =
-        std::make_unique<TrieNode>(new_rec, node, fusion_id);
-    child = node->children[new_rec].get();
+    child =
+        node->addChild(std::make_unique<TrieNode>(new_rec, node, fusion_id));
     NVF_CHECK(child, "Created child of TrieNode should not be null!");
     ++(child->visits);
     if (rec->recordType() == serde::RecordType::End) {
-      terminal_nodes_.push_back(node->children[new_rec].get());
+      std::unique_lock<std::shared_mutex> fusions_guard(fusions_lock_);
+      terminal_nodes_.push_back(child);
     }
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
       std::stringstream ss;
@@ -547,9 +672,20 @@ void FusionCache::serialize(std::string filename) const {
     terminal_node_idx.push_back(
         map_record_functor_to_trie_node_id.at(node->record.get()));
 
-    auto schedule = queryFusionSchedules(node->fusion_id);
-    fb_auto_gen_schedules.emplace_back(
-        schedule->auto_gen_schedules->serialize(builder));
+    // Fusions that were deserialized lazily and never used are copied from
+    // serde_buffer_ as they are, without deserializing them. Their table is
+    // unpacked with the flatbuffers object API and packed in builder.
+    FusionSchedules* schedule = fusions_.at(node->fusion_id).get();
+    NVF_CHECK(schedule != nullptr, "Unexpected null FusionSchedules object.");
+    if (schedule->serde_buffer != nullptr) {
+      std::unique_ptr<serde::FusionExecutorCacheT> fec_table(
+          schedule->serde_buffer->UnPack());
+      fb_auto_gen_schedules.emplace_back(
+          serde::FusionExecutorCache::Pack(builder, fec_table.get()));
+    } else {
+      fb_auto_gen_schedules.emplace_back(
+          schedule->auto_gen_schedules->serialize(builder));
+    }
   }
 
   auto device_prop = at::cuda::getCurrentDeviceProperties();
@@ -570,7 +706,7 @@ void FusionCache::serialize(std::string filename) const {
       device_prop->minor,
       cuda_major,
       cuda_minor);
-  builder.Finish(fusion_cache, "NV00" /* file_identifier */);
+  builder.Finish(fusion_cache, "NV01" /* file_identifier */);
 
   // 6. Write flatbuffer binary to file
   auto fb = builder.GetBufferSpan();
@@ -590,15 +726,40 @@ void FusionCache::deserialize(std::string filename) {
   NVF_CHECK(
       fusions_.empty(),
       "Deserialization is prohibited if FusionCache is already populated.");
-  const BinaryBuffer& buffer = openFusionCache(filename);
+  serde_buffer_ = std::make_unique<BinaryBuffer>(filename);
   const serde::FusionCache* fusion_cache_buffer =
-      verifyFusionCache(buffer, true /* strict */);
-  deserialize(buffer, fusion_cache_buffer);
+      verifyFusionCache(*serde_buffer_, true /* strict */);
+  deserialize(*serde_buffer_, fusion_cache_buffer);
+}
+
+std::vector<std::pair<size_t, KernelArgumentHolder>> FusionCache::
+    deserializeDefinitions(std::string filename) {
+  FUSER_PERF_SCOPE("FusionCache::deserializeDefinitions");
+  NVF_CHECK(
+      fusions_.empty(),
+      "Deserialization is prohibited if FusionCache is already populated.");
+  serde_buffer_ = std::make_unique<BinaryBuffer>(filename);
+  const serde::FusionCache* fusion_cache_buffer = verifyFusionCache(
+      *serde_buffer_, true /* strict */, false /* check_versions */);
+  deserialize(*serde_buffer_, fusion_cache_buffer, false /* load_kernels */);
+
+  std::vector<std::pair<size_t, KernelArgumentHolder>> runtime_args;
+  for (auto fb_fec : *fusion_cache_buffer->auto_gen_schedules()) {
+    for (auto fb_device_runtimes : *fb_fec->kernel_runtimes_map()) {
+      for (auto fb_runtime : *fb_device_runtimes->runtimes()) {
+        KernelArgumentHolder args;
+        args.deserialize(fb_runtime->args());
+        runtime_args.emplace_back((size_t)fb_fec->fusion_id(), args);
+      }
+    }
+  }
+  return runtime_args;
 }
 
 void FusionCache::deserialize(
     const BinaryBuffer& buffer,
-    const serde::FusionCache* fusion_cache_buffer) {
+    const serde::FusionCache* fusion_cache_buffer,
+    bool load_kernels) {
   // See table definition for FusionCache in serde/fusion_cache.fbs
   FUSER_PERF_SCOPE("FusionCache::deserialize");
   NVF_CHECK(fusion_cache_buffer != nullptr, "Fusion Cache buffer is invalid.");
@@ -611,10 +772,10 @@ void FusionCache::deserialize(
   max_fusions_ = fusion_cache_buffer->max_fusions();
 
   // 2. Deserialize fusions: (Fusion) and structure: (TrieNode) fields
-  std::generate_n(
-      std::back_inserter(fusions_),
-      fusion_cache_buffer->terminal_nodes()->size(),
-      [] { return std::make_unique<FusionSchedules>(); });
+  for (auto fusion_id :
+       c10::irange(fusion_cache_buffer->terminal_nodes()->size())) {
+    fusions_.emplace_back(std::make_unique<FusionSchedules>(fusion_id));
+  }
 
   serde::RecordFunctorFactory record_functor_factory;
 
@@ -622,12 +783,6 @@ void FusionCache::deserialize(
   std::deque<BfsState> queue = {
       {root_.get() /* TrieNode pointer */, 0 /* structure_idx */}};
 
-  // state_queue holds the FusionState for each BfsState in the queue.
-  std::deque<std::unique_ptr<FusionState>> state_queue;
-
-  // Create empty fusion container for root node
-  state_queue.emplace_back(std::make_unique<FusionState>());
-
   // bfs_order is used to map indices in the structure field to their
   // corresponding TrieNode pointers. It is used to reconstruct the
   // terminal_nodes vector.
@@ -644,15 +799,11 @@ void FusionCache::deserialize(
     // Get corresponding flatbuffer object for current TrieNode
     auto fb_trie_node = fusion_cache_buffer->structure()->Get(structure_idx);
 
-    // While traversing the Trie Structure, build the Fusion Container by
-    // adding the TrieNode's RecordFunctor
-    auto state = state_queue.front().get();
-    state->addRecord(trie_ptr->record.get()->clone());
-
     // Deserialize Table TrieNode => Field: visits (ulong)
     trie_ptr->visits = fb_trie_node->visits();
 
-    // Build fusion container if current node is a terminal node
+    // The fusion container of a terminal node is built from the records of
+    // its path when the fusion is first queried
     if (fb_trie_node->is_terminal()) {
       NVF_CHECK(
           fb_trie_node->children()->size() == 0,
@@ -663,9 +814,7 @@ void FusionCache::deserialize(
       NVF_CHECK(
           trie_ptr->fusion_id == fb_trie_node->fusion_id(),
           "The fusion id for this TrieNode should already be set.")
-      Fusion* fusion =
-          queryFusionSchedules(fb_trie_node->fusion_id())->preschedFusion();
-      state->buildFusionIr(fusion);
+      fusions_.at(trie_ptr->fusion_id)->serde_terminal_node = trie_ptr;
     }
 
     // Table TrieNode => Field: children: [ulong]
@@ -680,23 +829,14 @@ void FusionCache::deserialize(
           record_functor_factory.parse(serde_buffer->type(), serde_buffer);
 
       // Deserialize the record and fusion id fields in the TrieNode table
-      auto status = trie_ptr->children.emplace(
-          rec,
-          std::make_unique<TrieNode>(
-              rec, trie_ptr, fb_child_trie_node->fusion_id()));
-      NVF_CHECK(
-          status.second,
-          "Fusion-Cache Deserialization: Failed to add child to the current TrieNode.");
+      auto child = trie_ptr->addChild(std::make_unique<TrieNode>(
+          rec, trie_ptr, fb_child_trie_node->fusion_id()));
 
       // Add child TrieNode to BFS queue
-      queue.emplace_back(
-          status.first->second.get() /* TrieNode pointer */, child_bfs_idx);
-      state_queue.emplace_back(state->clone());
+      queue.emplace_back(child /* TrieNode pointer */, child_bfs_idx);
     }
 
-    // Destroy current fusion state
     queue.pop_front();
-    state_queue.pop_front();
   }
 
   // Deserialize terminal_nodes field in the FusionCache table
@@ -705,20 +845,32 @@ void FusionCache::deserialize(
     auto trie_node = bfs_order.at(node_idx);
     terminal_nodes_.push_back(trie_node);
 
-    auto fb_fec_node = fusion_cache_buffer->auto_gen_schedules()->Get(idx);
-    auto fusion_schedule = queryFusionSchedules(trie_node->fusion_id);
+    auto fusion_schedule = fusions_.at(trie_node->fusion_id).get();
+    if (load_kernels) {
+      fusion_schedule->serde_buffer =
+          fusion_cache_buffer->auto_gen_schedules()->Get(idx);
+    }
+  }
+
+  if (!isOptionDisabled(DisableOption::LazySerde)) {
+    return;
+  }
 
+  // Deserialize every fusion now. The fusion containers are built first, as
+  // only the FusionExecutorCaches are deserialized in parallel.
+  for (auto& fusion_schedule : fusions_) {
+    fusion_schedule->buildPreschedFusion();
+  }
+  for (auto& fusion_schedule : fusions_) {
     if (!isOptionDisabled(DisableOption::ParallelSerde)) {
       // Parallelize the deserialization of each FusionExecutorCache.
-      getThreadPool()->run([=]() {
+      getThreadPool()->run([fusion_schedule = fusion_schedule.get()]() {
         FUSER_PERF_SCOPE("FusionCache::deserializeFusionParallel");
-        fusion_schedule->auto_gen_schedules->deserialize(
-            fb_fec_node, (int64_t)trie_node->fusion_id);
+        fusion_schedule->materialize();
       });
     } else {
       FUSER_PERF_SCOPE("FusionCache::deserializeFusionSerial");
-      fusion_schedule->auto_gen_schedules->deserialize(
-          fb_fec_node, (int64_t)trie_node->fusion_id);
+      fusion_schedule->materialize();
     }
   }
 
@@ -12,11 +12,48 @@
 #include <kernel_cache.h>
 #include <python_frontend/fusion_record.h>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
 
 namespace nvfuser::python_frontend {
 
+struct TrieNode;
+
+//! \class BinaryBuffer
+//! \brief A read-only view of a serialized FusionCache file.
+//!
+//! The file is memory-mapped where supported, so that only the pages of the
+//! fusions that are used get read from disk. Elsewhere, or if mapping fails,
+//! the file is read into memory.
+class BinaryBuffer {
+ public:
+  explicit BinaryBuffer(const std::string& filename);
+  ~BinaryBuffer();
+
+  BinaryBuffer(const BinaryBuffer&) = delete;
+  BinaryBuffer& operator=(const BinaryBuffer&) = delete;
+
+  const uint8_t* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  //! Whether data_ is a mapping of the file
+  bool mapped_ = false;
+  //! The contents of the file if it is not mapped
+  std::vector<uint8_t> contents_;
+};
+
 //! \struct UserSchedule
 //! \brief A container to hold a scheduled Fusion IR as well as an executor
 //! to contain the corresponding generated kernel.
@@ -39,6 +76,12 @@ struct UserSchedule {
 struct FusionSchedules {
   FusionSchedules(int64_t fusion_id = 0);
   Fusion* preschedFusion();
+  //! Thread-Safe: Finishes the deserialization of schedules that the
+  //! FusionCache loaded lazily, see serde_terminal_node and serde_buffer.
+  //! Does nothing for other schedules.
+  void materialize();
+  //! Builds the prescheduled Fusion from serde_terminal_node, if set
+  void buildPreschedFusion();
 
   //! Schedules Automatically generated by nvFuser for dynamic inputs. (default)
   //! NOTE: The FusionExecutorCache also holds the Unscheduled Fusion IR
@@ -57,6 +100,14 @@ struct FusionSchedules {
   std::mutex scheds_lock;
   //! ID of fusion in python frontend fusion cache
   int64_t fusion_id_ = -1;
+  //! Terminal node of a deserialized fusion whose prescheduled Fusion is not
+  //! built yet. Its records are replayed from the root to build it.
+  TrieNode* serde_terminal_node = nullptr;
+  //! Serialized auto_gen_schedules that are not deserialized yet. Points
+  //! into the BinaryBuffer owned by the FusionCache.
+  const serde::FusionExecutorCache* serde_buffer = nullptr;
+  //! Guards materialize
+  std::once_flag materialize_flag;
 };
 
 //! \struct TrieNode
@@ -73,6 +124,13 @@ struct TrieNode {
   // Queries whether the entry denotes a leaf node which also represents
   // a the end of Fusion entry in the cache.
   bool isTerminal() const;
+  //! Thread-Safe: Lock-free lookup of the child whose record equals rec.
+  //! Returns nullptr if there is none. A child that is being added by
+  //! another thread at the same time may be missed.
+  TrieNode* findChild(RecordFunctor* rec) const;
+  //! Adds a child and publishes it to findChild. Callers other than
+  //! deserialization must hold trie_node_lock.
+  TrieNode* addChild(std::unique_ptr<TrieNode> child);
   //! Serialize TrieNode using flatbuffers
   flatbuffers::Offset<serde::TrieNode> serialize(
       flatbuffers::FlatBufferBuilder& builder,
@@ -84,16 +142,38 @@ struct TrieNode {
   //! A hash map of the children for the current node.
   //! The hash map hashes a pointer to a RecordFunctor because
   //! the hash function is virtual.
+  //! NOTE: This map owns the children but is not safe to read while children
+  //! are being added. Use findChild for lookups.
   std::unordered_map<RecordFunctor*, std::unique_ptr<TrieNode>> children;
   //! An index into FusionCache's vector of nvFuser object that holds an
   //! unscheduled Fusion.  The id is only valid if the entry is terminal.
   size_t fusion_id;
   //! Count of times the Entry is traversed
-  size_t visits;
+  std::atomic<size_t> visits;
   //! Parent node for printing
   TrieNode* parent;
   //! For thread-Safe locking of a node
   std::mutex trie_node_lock;
+
+ private:
+  //! An open addressing hash table of the children for findChild. Slots are
+  //! only ever filled, never cleared, so a reader that sees an empty slot
+  //! can stop probing.
+  struct ChildTable {
+    explicit ChildTable(size_t capacity);
+    std::vector<std::atomic<TrieNode*>> slots;
+  };
+
+  //! Insert a child into a table with at least one free slot
+  static void insertChild(ChildTable& table, TrieNode* child);
+
+  //! Hash of record, cached to keep probing cheap
+  size_t record_hash_ = 0;
+  //! The table that findChild reads. When it fills up, a larger copy is
+  //! published in its place. Replaced tables are kept in child_tables_
+  //! until the node is destroyed, since readers may still be probing them.
+  std::atomic<ChildTable*> child_table_{nullptr};
+  std::vector<std::unique_ptr<ChildTable>> child_tables_;
 };
 
 //! \class FusionCache
@@ -109,11 +189,18 @@ struct TrieNode {
 //! of fusions that is checked to prevent a runaway case.
 //!
 //! \note
-//! Thread-Safety is assured by the Python GIL.  If a no-GIL python is used
-//! then further scrutiny needs to be applied to the mutexes used to limit
-//! acccess to the singleton pointer, node creation, and user schedule
-//! creation.  Otherwise, the Python GIL provides a natural thread based mutex
-//! that does not allow for multiple threads to interact.
+//! Lookups in the trie are lock-free and creating a child only locks its
+//! parent node, so fusions can be defined and looked up from multiple
+//! threads. The vector of fusions is guarded by a reader-writer lock. The
+//! methods for printing, stats, serialization and reset are not thread-safe
+//! and are expected to be called while no other thread uses the cache.
+//!
+//! \note
+//! A deserialized cache only builds its trie up front. The prescheduled
+//! Fusion and the FusionExecutorCache of each fusion, whose kernel runtimes
+//! are segmented and lowered again, are deserialized the first time the
+//! fusion is queried, unless DisableOption::LazySerde is set. The file stays
+//! mapped for the lifetime of the cache.
 
 class FusionCache {
   //! The constructor is private given the FusionCache is only constructed
@@ -141,18 +228,29 @@ class FusionCache {
   //! Reset Cache to an empty state
   static void reset(bool load_from_default_workspace = false);
 
-  //! Serialize Fusion Cache using flatbuffers
+  //! Serialize Fusion Cache using flatbuffers. The fusions of a deserialized
+  //! cache that were never used are copied from its file as they are.
   void serialize(std::string filename) const;
   //! Deserialize Fusion Cache using flatbuffers
   void deserialize(std::string filename);
+  //! Deserialize only the fusion definitions of a Fusion Cache, without its
+  //! compiled kernels. Unlike deserialize, the file may come from another
+  //! CUDA version or device. Returns the fusion id and the arguments of every
+  //! kernel runtime of the file, as metadata tensors, so that the kernels
+  //! can be compiled again, e.g. with FusionExecutorCache::
+  //! compileFusionAheadOfTime.
+  std::vector<std::pair<size_t, KernelArgumentHolder>> deserializeDefinitions(
+      std::string filename);
 
   //! The rest of the public methods are only used in C++
 
-  //! Thread-Unsafe: Queries the current trie node to see if a record matches
-  //! one of its children
+  //! Thread-Safe: Queries the current trie node to see if a record matches
+  //! one of its children. A child that is being created by another thread may
+  //! be missed, in which case createChild returns that child.
   std::optional<TrieNode*> queryChildren(TrieNode* node, RecordFunctor* rec)
       const;
-  //! Query a Fusion's Schedules based on fusion id or cache id
+  //! Query a Fusion's Schedules based on fusion id or cache id. Finishes
+  //! their deserialization if they were loaded lazily.
   FusionSchedules* queryFusionSchedules(size_t fusion_id) const;
   //! Lookup the User Schedule Id and return null if one does not exist.
   //! NOTE: this method cannot be const because the InputsIdLookup can
@@ -177,17 +275,21 @@ class FusionCache {
   TrieNode* rootTriePtr();
 
  private:
-  using BinaryBuffer = std::vector<uint8_t>;
-  //! Deserialize Fusion Cache
+  //! Deserialize Fusion Cache. The FusionExecutorCaches, with their kernels,
+  //! are only deserialized if load_kernels is set.
   void deserialize(
       const BinaryBuffer& buffer,
-      const serde::FusionCache* fusion_cache_buffer);
+      const serde::FusionCache* fusion_cache_buffer,
+      bool load_kernels = true);
 
   //! The static pointer to the FusionCache
   static FusionCache* singleton_;
   //! Lock for accessing the singleton by multiple threads
   static std::mutex singleton_lock_;
 
+  //! The serialized cache this cache was deserialized from, which lazily
+  //! loaded FusionSchedules point into. Declared first to be destroyed last.
+  std::unique_ptr<BinaryBuffer> serde_buffer_;
   //! The max allowed number of fusions in the cache
   size_t max_fusions_;
   //! The root (start) of the prefix tree to start a cache look up of a given
@@ -197,6 +299,9 @@ class FusionCache {
   std::vector<std::unique_ptr<FusionSchedules>> fusions_;
   //! A vector of Terminal trie nodes for Stats collection
   std::vector<TrieNode*> terminal_nodes_;
+  //! Guards fusions_ and terminal_nodes_, which grow when terminal nodes are
+  //! created under different parent nodes
+  mutable std::shared_mutex fusions_lock_;
 
   //! Items specifically to aid user defined schedules these data members
   //! are for the mechanics of user schedule usage and don't make sense as
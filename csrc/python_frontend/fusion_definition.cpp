@@ -10,6 +10,7 @@
 #include <options.h>
 #include <python_frontend/fusion_cache.h>
 #include <python_frontend/fusion_definition.h>
+#include <python_frontend/warmup_trace.h>
 #include <scheduler/heuristic_types.h>
 #include <utils.h>
 #include <validator_utils.h>
@@ -157,11 +158,21 @@ std::vector<at::Tensor> FusionDefinition::execute(
     const at::ArrayRef<c10::IValue>& inputs,
     bool override_user_schedule,
     bool capture_debug_output,
-    std::optional<int8_t> selected_device) const {
+    std::optional<int8_t> selected_device,
+    bool capture_compile_profile) const {
   debug_output_ = std::nullopt;
   std::stringstream debug_ss;
   DebugStreamGuard dsg(capture_debug_output ? debug_ss : std::cout);
 
+  compile_profile_ = std::nullopt;
+  std::optional<CompileProfileGuard> compile_profile_guard;
+  if (capture_compile_profile) {
+    compile_profile_guard.emplace();
+    NVF_CHECK(
+        compile_profile_guard->isRecording(),
+        "A compile profile is already being recorded");
+  }
+
   NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
 
   auto scheds = fusionCache()->queryFusionSchedules(id().value());
@@ -183,12 +194,21 @@ std::vector<at::Tensor> FusionDefinition::execute(
     }
   }
 
+  // Only executions that compiled a new kernel runtime are recorded in the
+  // warmup trace, see WarmupTraceEntry.
+  auto num_runtimes = scheds->auto_gen_schedules->countRuntimes();
   outputs = scheds->auto_gen_schedules->runFusionWithInputs(
       inputs, std::nullopt, selected_device);
+  if (scheds->auto_gen_schedules->countRuntimes() > num_runtimes) {
+    recordWarmupTrace(id().value(), inputs);
+  }
 
   if (capture_debug_output) {
     debug_output_ = debug_ss.str();
   }
+  if (capture_compile_profile) {
+    compile_profile_ = compile_profile_guard->stop();
+  }
 
   return outputs;
 }
@@ -10,6 +10,7 @@
 #include <iostream>
 
 #include <c10/macros/Export.h>
+#include <compile_profiler.h>
 #include <kernel_cache.h>
 #include <python_frontend/fusion_state.h>
 
@@ -129,12 +130,18 @@ class FusionDefinition : public FusionState {
       const at::ArrayRef<c10::IValue>& inputs,
       bool override_user_schedule,
       bool capture_debug_output,
-      std::optional<int8_t> device) const;
+      std::optional<int8_t> device,
+      bool capture_compile_profile = false) const;
   //! Return debugging output captured through exeuction with
   //! capture_debug_output=true
   std::optional<std::string> getDebugOutput() const {
     return debug_output_;
   }
+  //! Return the host time profile recorded during execution with
+  //! capture_compile_profile=true
+  const std::optional<CompileProfile>& getCompileProfile() const {
+    return compile_profile_;
+  }
   // Returns the tolerances values based on reduction sizes.
   std::vector<std::pair<double, double>> getValTolerances(
       const at::ArrayRef<c10::IValue>& inputs);
@@ -239,6 +246,8 @@ class FusionDefinition : public FusionState {
 
  private:
   mutable std::optional<std::string> debug_output_ = std::nullopt;
+  //! Host time profile of the previous execution, if captured
+  mutable std::optional<CompileProfile> compile_profile_ = std::nullopt;
 };
 
 } // namespace nvfuser::python_frontend
@@ -13,10 +13,12 @@
 #include <ir/all_nodes.h>
 #include <ir/builder.h>
 #include <ops/all_ops.h>
+#include <python_frontend/batch_compile.h>
 #include <python_frontend/fusion_cache.h>
 #include <python_frontend/fusion_definition.h>
 #include <python_frontend/fusion_record.h>
 #include <python_frontend/python_bindings.h>
+#include <python_frontend/warmup_trace.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <complex>
 #include <iostream>
@@ -372,6 +374,69 @@ void initNvFuserPythonBindings(PyObject* module) {
   nvfuser.def("compute_contiguity", computeContiguity);
   nvfuser.def("compute_tensor_descriptor", computeTensorDescriptor);
   nvfuser.def("serialize", serialize);
+  nvfuser.def(
+      "warmup",
+      [](const std::string& trace_file, std::optional<int64_t> device) {
+        FUSER_PERF_SCOPE("warmup (string)");
+        std::optional<int8_t> selected_device = std::nullopt;
+        if (device.has_value()) {
+          NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+          selected_device = (int8_t)device.value();
+        }
+        return warmupFusionCache(readWarmupTrace(trace_file), selected_device);
+      },
+      py::arg("trace_file"),
+      py::arg("device") = py::none());
+  nvfuser.def(
+      "batch_compile",
+      [](const py::iterable& jobs,
+         int64_t num_workers,
+         std::optional<int64_t> device,
+         const std::string& output_dir) {
+        FUSER_PERF_SCOPE("batch_compile (python)");
+        std::vector<BatchCompileJob> batch_jobs;
+        for (py::handle job : jobs) {
+          auto [fusion_id, input_sets] =
+              job.cast<std::pair<size_t, py::list>>();
+          BatchCompileJob& batch_job = batch_jobs.emplace_back();
+          batch_job.fusion_id = fusion_id;
+          for (py::handle input_set : input_sets) {
+            auto& inputs = batch_job.inputs.emplace_back();
+            for (py::handle obj : input_set) {
+              inputs.push_back(torch::jit::toIValue(obj, c10::AnyType::get()));
+            }
+          }
+        }
+        BatchCompileOptions options;
+        options.num_workers = num_workers;
+        if (device.has_value()) {
+          NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+          options.device = (int8_t)device.value();
+        }
+        options.output_dir = output_dir;
+
+        std::vector<BatchCompileResult> results;
+        {
+          py::gil_scoped_release release;
+          results = batchCompile(batch_jobs, options);
+        }
+        py::list py_results;
+        for (const auto& result : results) {
+          py::dict py_result;
+          py_result["fusion_id"] = result.fusion_id;
+          py_result["num_compiled"] = result.num_compiled;
+          py_result["num_kernels"] = result.num_kernels;
+          py_result["compile_time_ms"] = result.compile_time_ms;
+          py_result["files"] = result.files;
+          py_result["error"] = result.error;
+          py_results.append(py_result);
+        }
+        return py_results;
+      },
+      py::arg("jobs"),
+      py::arg("num_workers") = 0,
+      py::arg("device") = py::none(),
+      py::arg("output_dir") = "");
 
   //! Binding the FusionCache that holds a cache of Fusions
   //! This is only bound to provide an interface to get the number of fusions
@@ -507,7 +572,8 @@ void initNvFuserPythonBindings(PyObject* module) {
              const py::iterable& iter,
              bool override_user_schedule,
              std::optional<int64_t> device,
-             bool capture_debug_output) {
+             bool capture_debug_output,
+             bool capture_compile_profile) {
             std::vector<c10::IValue> inputs;
             for (py::handle obj : iter) {
               // Allows for a Vector of Sizes to be inputed as a list
@@ -530,18 +596,40 @@ void initNvFuserPythonBindings(PyObject* module) {
                 inputs,
                 override_user_schedule,
                 capture_debug_output,
-                int8_device);
+                int8_device,
+                capture_compile_profile);
           },
           py::arg("inputs"),
           py::arg("override_user_schedule") = false,
           py::kw_only(),
           py::arg("device") = py::none(),
           py::arg("capture_debug_output") = false,
+          py::arg("capture_compile_profile") = false,
           py::return_value_policy::reference)
       .def(
           "_debug_output",
           [](FusionDefinition& self) { return self.getDebugOutput(); },
           py::return_value_policy::reference)
+      .def(
+          "_compile_profile",
+          [](FusionDefinition& self) -> std::optional<std::string> {
+            const auto& profile = self.getCompileProfile();
+            if (!profile.has_value()) {
+              return std::nullopt;
+            }
+            std::stringstream ss;
+            ss << profile.value();
+            return ss.str();
+          })
+      .def(
+          "_compile_profile_trace",
+          [](FusionDefinition& self) -> std::optional<std::string> {
+            const auto& profile = self.getCompileProfile();
+            if (!profile.has_value()) {
+              return std::nullopt;
+            }
+            return profile->toChromeTrace();
+          })
       .def(
           "_fusion_ir",
           [](FusionDefinition& self) { return self.fusionIr(); },
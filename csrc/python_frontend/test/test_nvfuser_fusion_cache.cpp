@@ -10,10 +10,16 @@
 
 #include <torch/torch.h>
 
+#include <c10/util/irange.h>
+
 #include <python_frontend/fusion_cache.h>
+#include <python_frontend/warmup_trace.h>
 #include <test/utils.h>
 #include <test/validator.h>
 
+#include <thread>
+#include <unordered_set>
+
 namespace nvfuser {
 using namespace nvfuser::python_frontend;
 
@@ -183,4 +189,93 @@ TEST_F(NVFuserTest, PyFusionCache_CUDA) {
   }
 }
 
+// Define and look up the same fusions from several threads at once. Every
+// thread must end up at the same terminal node for each definition.
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*PyFusionCacheConcurrent*"
+TEST_F(NVFuserTest, PyFusionCacheConcurrentDefinitions_CUDA) {
+  FusionCache::reset();
+  FusionCache* fc = FusionCache::get();
+
+  // Each definition is two tensor records followed by an end record, so the
+  // root gets kWidth children and each of them kWidth children.
+  constexpr int64_t kNumThreads = 8;
+  constexpr int64_t kWidth = 16;
+  constexpr int64_t kNumDefinitions = kWidth * kWidth;
+
+  auto make_record = [](int64_t size) {
+    return std::make_unique<TensorRecord>(
+        std::vector<State>{State(0, serde::StateType::Tensor)},
+        std::vector<int64_t>{size},
+        std::vector<std::optional<bool>>{true},
+        DataType::Float);
+  };
+  auto query_or_create = [fc](TrieNode* node, RecordFunctor* rec) {
+    auto child = fc->queryChildren(node, rec);
+    return child.has_value() ? child.value() : fc->createChild(node, rec);
+  };
+
+  std::vector<std::vector<size_t>> fusion_ids(
+      kNumThreads, std::vector<size_t>(kNumDefinitions));
+  std::vector<std::thread> threads;
+  for (auto tid : c10::irange(kNumThreads)) {
+    threads.emplace_back([&, tid]() {
+      EndRecord end_record;
+      for (auto i : c10::irange(kNumDefinitions)) {
+        // Start at different definitions so that inserts interleave
+        auto def = (i + tid * 7) % kNumDefinitions;
+        auto first = make_record(def / kWidth + 2);
+        auto second = make_record(def % kWidth + 2);
+        TrieNode* node = query_or_create(fc->rootTriePtr(), first.get());
+        node = query_or_create(node, second.get());
+        node = query_or_create(node, &end_record);
+        fusion_ids[tid][def] = node->fusion_id;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(fc->numFusions(), (size_t)kNumDefinitions);
+  for (auto tid : c10::irange(1, kNumThreads)) {
+    EXPECT_EQ(fusion_ids[tid], fusion_ids[0]);
+  }
+  std::unordered_set<size_t> unique_ids(
+      fusion_ids[0].begin(), fusion_ids[0].end());
+  EXPECT_EQ(unique_ids.size(), (size_t)kNumDefinitions);
+}
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*PyFusionCacheWarmupTrace*"
+TEST_F(NVFuserTest, PyFusionCacheWarmupTrace_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 8}, options).t();
+  at::Tensor t1 =
+      at::scalar_tensor(2.0, at::TensorOptions().dtype(at::kDouble));
+  std::vector<c10::IValue> inputs = {t0, t1, 0.5, (int64_t)3, true};
+
+  auto entry = WarmupTraceEntry::fromInputs(7, inputs);
+  const std::string expected =
+      "7 Float[8,4]{1,8} cpu:Double[]{} Double=0.5 Long=3 Bool=1";
+  EXPECT_EQ(entry.toString(), expected);
+
+  auto parsed = WarmupTraceEntry::parse(expected);
+  EXPECT_EQ(parsed.fusion_id, (size_t)7);
+  EXPECT_EQ(parsed.toString(), expected);
+
+  auto proxies = parsed.proxyInputs();
+  ASSERT_EQ(proxies.size(), inputs.size());
+  EXPECT_TRUE(proxies[0].toTensor().is_meta());
+  EXPECT_EQ(proxies[0].toTensor().sizes(), t0.sizes());
+  EXPECT_EQ(proxies[0].toTensor().strides(), t0.strides());
+  EXPECT_TRUE(proxies[1].toTensor().is_cpu());
+  EXPECT_EQ(proxies[2].toDouble(), 0.5);
+  EXPECT_EQ(proxies[3].toInt(), 3);
+  EXPECT_TRUE(proxies[4].toBool());
+
+  EXPECT_THAT(
+      [&]() { WarmupTraceEntry::parse("7 Float[8,4]{1}"); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("differ in rank")));
+}
+
 } // namespace nvfuser
@@ -0,0 +1,271 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <c10/util/irange.h>
+
+#include <instrumentation.h>
+#include <python_frontend/fusion_cache.h>
+#include <python_frontend/warmup_trace.h>
+#include <utils.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+namespace nvfuser::python_frontend {
+
+namespace {
+
+constexpr const char* kCpuPrefix = "cpu:";
+
+at::ScalarType parseScalarType(const std::string& name) {
+  for (auto i : c10::irange((int)at::ScalarType::NumOptions)) {
+    auto dtype = (at::ScalarType)i;
+    if (name == c10::toString(dtype)) {
+      return dtype;
+    }
+  }
+  NVF_CHECK(false, "Unknown dtype in warmup trace: ", name);
+}
+
+std::vector<int64_t> parseInts(const std::string& list) {
+  std::vector<int64_t> ints;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    ints.push_back(std::stoll(item));
+  }
+  return ints;
+}
+
+void printInts(std::ostream& os, const std::vector<int64_t>& ints) {
+  for (auto i : c10::irange(ints.size())) {
+    os << (i > 0 ? "," : "") << ints[i];
+  }
+}
+
+WarmupTraceEntry::Input parseScalarInput(
+    const std::string& field,
+    size_t eq_pos) {
+  WarmupTraceEntry::Input input;
+  input.is_tensor = false;
+  input.dtype = parseScalarType(field.substr(0, eq_pos));
+  const std::string value = field.substr(eq_pos + 1);
+  switch (input.dtype) {
+    case at::ScalarType::Bool:
+      input.value = std::stoll(value) != 0;
+      break;
+    case at::ScalarType::Long:
+      input.value = (int64_t)std::stoll(value);
+      break;
+    case at::ScalarType::Double:
+      input.value = std::stod(value);
+      break;
+    case at::ScalarType::ComplexDouble: {
+      auto comma = value.find(',');
+      NVF_CHECK(
+          value.size() > 2 && value.front() == '(' && value.back() == ')' &&
+              comma != std::string::npos,
+          "Malformed complex scalar in warmup trace: ",
+          field);
+      input.value = c10::complex<double>(
+          std::stod(value.substr(1, comma - 1)),
+          std::stod(value.substr(comma + 1, value.size() - comma - 2)));
+      break;
+    }
+    default:
+      NVF_CHECK(false, "Unsupported scalar in warmup trace: ", field);
+  }
+  return input;
+}
+
+WarmupTraceEntry::Input parseTensorInput(const std::string& field) {
+  WarmupTraceEntry::Input input;
+  std::string desc = field;
+  if (desc.rfind(kCpuPrefix, 0) == 0) {
+    input.is_cpu = true;
+    desc = desc.substr(std::strlen(kCpuPrefix));
+  }
+  auto lbracket = desc.find('[');
+  auto rbracket = desc.find(']', lbracket);
+  auto lbrace = desc.find('{', rbracket);
+  auto rbrace = desc.find('}', lbrace);
+  NVF_CHECK(
+      lbracket != std::string::npos && rbracket != std::string::npos &&
+          lbrace == rbracket + 1 && rbrace == desc.size() - 1,
+      "Malformed tensor in warmup trace: ",
+      field);
+  input.dtype = parseScalarType(desc.substr(0, lbracket));
+  input.sizes = parseInts(desc.substr(lbracket + 1, rbracket - lbracket - 1));
+  input.strides = parseInts(desc.substr(lbrace + 1, rbrace - lbrace - 1));
+  NVF_CHECK(
+      input.sizes.size() == input.strides.size(),
+      "Sizes and strides of a tensor in warmup trace differ in rank: ",
+      field);
+  return input;
+}
+
+} // namespace
+
+WarmupTraceEntry WarmupTraceEntry::fromInputs(
+    size_t fusion_id,
+    const at::ArrayRef<c10::IValue>& inputs) {
+  WarmupTraceEntry entry;
+  entry.fusion_id = fusion_id;
+  entry.inputs.reserve(inputs.size());
+  for (const auto& ivalue : inputs) {
+    Input input;
+    if (ivalue.isTensor()) {
+      const auto& tensor = ivalue.toTensor();
+      input.dtype = tensor.scalar_type();
+      input.is_cpu = tensor.is_cpu();
+      input.sizes = tensor.sizes().vec();
+      input.strides = tensor.strides().vec();
+    } else {
+      NVF_CHECK(
+          ivalue.isScalar(),
+          "Unsupported input in warmup trace: ",
+          ivalue.tagKind());
+      input.is_tensor = false;
+      input.value = ivalue.toScalar();
+      input.dtype = input.value.type();
+    }
+    entry.inputs.push_back(std::move(input));
+  }
+  return entry;
+}
+
+WarmupTraceEntry WarmupTraceEntry::parse(const std::string& line) {
+  std::stringstream ss(line);
+  WarmupTraceEntry entry;
+  NVF_CHECK(
+      ss >> entry.fusion_id, "Expected a fusion id in warmup trace: ", line);
+  std::string field;
+  while (ss >> field) {
+    auto eq_pos = field.find('=');
+    entry.inputs.push_back(
+        eq_pos == std::string::npos ? parseTensorInput(field)
+                                    : parseScalarInput(field, eq_pos));
+  }
+  return entry;
+}
+
+std::string WarmupTraceEntry::toString() const {
+  std::stringstream ss;
+  ss << std::setprecision(std::numeric_limits<double>::max_digits10);
+  ss << fusion_id;
+  for (const auto& input : inputs) {
+    ss << " ";
+    if (input.is_tensor) {
+      ss << (input.is_cpu ? kCpuPrefix : "") << c10::toString(input.dtype)
+         << "[";
+      printInts(ss, input.sizes);
+      ss << "]{";
+      printInts(ss, input.strides);
+      ss << "}";
+      continue;
+    }
+    ss << c10::toString(input.dtype) << "=";
+    switch (input.dtype) {
+      case at::ScalarType::Bool:
+        ss << (input.value.toBool() ? 1 : 0);
+        break;
+      case at::ScalarType::Long:
+        ss << input.value.toLong();
+        break;
+      case at::ScalarType::Double:
+        ss << input.value.toDouble();
+        break;
+      case at::ScalarType::ComplexDouble: {
+        auto value = input.value.toComplexDouble();
+        ss << "(" << value.real() << "," << value.imag() << ")";
+        break;
+      }
+      default:
+        NVF_CHECK(
+            false,
+            "Unsupported scalar in warmup trace: ",
+            c10::toString(input.dtype));
+    }
+  }
+  return ss.str();
+}
+
+std::vector<c10::IValue> WarmupTraceEntry::proxyInputs() const {
+  std::vector<c10::IValue> ivalues;
+  ivalues.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    if (!input.is_tensor) {
+      ivalues.emplace_back(input.value);
+    } else if (input.is_cpu) {
+      ivalues.emplace_back(at::empty_strided(
+                               input.sizes,
+                               input.strides,
+                               at::TensorOptions().dtype(input.dtype))
+                               .zero_());
+    } else {
+      ivalues.emplace_back(at::empty_strided(
+          input.sizes,
+          input.strides,
+          at::TensorOptions().dtype(input.dtype).device(at::kMeta)));
+    }
+  }
+  return ivalues;
+}
+
+std::vector<WarmupTraceEntry> readWarmupTrace(const std::string& filename) {
+  std::ifstream is(filename);
+  NVF_CHECK(is, "Failed to open warmup trace ", filename);
+  std::vector<WarmupTraceEntry> trace;
+  std::string line;
+  while (std::getline(is, line)) {
+    auto first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') {
+      continue;
+    }
+    trace.push_back(WarmupTraceEntry::parse(line));
+  }
+  return trace;
+}
+
+void recordWarmupTrace(
+    size_t fusion_id,
+    const at::ArrayRef<c10::IValue>& inputs) {
+  static const char* trace_file = getNvFuserEnv("WARMUP_TRACE");
+  if (trace_file == nullptr) {
+    return;
+  }
+  auto line = WarmupTraceEntry::fromInputs(fusion_id, inputs).toString();
+
+  // Each entry is appended right away so that the trace survives a crash
+  static std::mutex trace_lock;
+  std::lock_guard<std::mutex> guard(trace_lock);
+  std::ofstream os(trace_file, std::ios::app);
+  NVF_CHECK(os, "Failed to open warmup trace ", trace_file);
+  os << line << std::endl;
+}
+
+int64_t warmupFusionCache(
+    const std::vector<WarmupTraceEntry>& trace,
+    std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("warmupFusionCache");
+  auto fusion_cache = FusionCache::get();
+  int64_t num_compiled = 0;
+  for (const auto& entry : trace) {
+    auto scheds = fusion_cache->queryFusionSchedules(entry.fusion_id);
+    if (scheds->auto_gen_schedules->compileFusionAheadOfTime(
+            entry.proxyInputs(), selected_device)) {
+      num_compiled++;
+    }
+  }
+  return num_compiled;
+}
+
+} // namespace nvfuser::python_frontend
@@ -0,0 +1,82 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+#include <exceptions.h>
+
+#include <ATen/core/ivalue.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nvfuser::python_frontend {
+
+//! \struct WarmupTraceEntry
+//! \brief A fusion of the FusionCache and the inputs it was compiled for.
+//!
+//! A warmup trace is recorded by a process running with
+//! NVFUSER_WARMUP_TRACE=<file>, which appends one entry to <file> every time
+//! a FusionDefinition::execute compiles a new kernel runtime. Replaying the
+//! trace with warmupFusionCache compiles the same kernels ahead of time.
+//!
+//! An entry is a line of whitespace separated fields: the fusion id followed
+//! by one field per input. Tensors are written as dtype[sizes]{strides},
+//! prefixed with "cpu:" for CPU scalar tensors, and scalars as dtype=value,
+//! with dtype as printed by c10::toString(at::ScalarType). For example:
+//!
+//!   3 Float[128,1024]{1024,1} Half[1024]{1} Double=1e-05
+struct WarmupTraceEntry {
+  //! Only the metadata of tensor inputs is stored
+  struct Input {
+    at::ScalarType dtype = at::ScalarType::Float;
+    bool is_tensor = true;
+    bool is_cpu = false;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    //! Value of a scalar input
+    c10::Scalar value;
+  };
+
+  size_t fusion_id = 0;
+  std::vector<Input> inputs;
+
+  static WarmupTraceEntry fromInputs(
+      size_t fusion_id,
+      const at::ArrayRef<c10::IValue>& inputs);
+
+  //! Parse a line of a trace file. See the struct comment for the format.
+  static WarmupTraceEntry parse(const std::string& line);
+
+  std::string toString() const;
+
+  //! Inputs for FusionExecutorCache::compileFusionAheadOfTime. Tensors are
+  //! meta tensors, except for CPU scalar tensors which are zero-filled.
+  std::vector<c10::IValue> proxyInputs() const;
+};
+
+//! Read a trace file. Empty lines and lines starting with '#' are skipped.
+std::vector<WarmupTraceEntry> readWarmupTrace(const std::string& filename);
+
+//! Append an entry to the file named by NVFUSER_WARMUP_TRACE. Does nothing if
+//! it is not set.
+void recordWarmupTrace(
+    size_t fusion_id,
+    const at::ArrayRef<c10::IValue>& inputs);
+
+//! Compile the kernels of each trace entry ahead of time through
+//! FusionExecutorCache::compileFusionAheadOfTime. The fusions are looked up
+//! in FusionCache::get(), so they must have been deserialized from the cache
+//! of the process that recorded the trace. Call serialize() afterwards to
+//! persist the compiled kernels. Returns the number of entries that needed
+//! compilation.
+int64_t warmupFusionCache(
+    const std::vector<WarmupTraceEntry>& trace,
+    std::optional<int8_t> selected_device = std::nullopt);
+
+} // namespace nvfuser::python_frontend
@@ -0,0 +1,762 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/autotune.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/util/irange.h>
+#include <debug.h>
+#include <executor.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <iter_visitor.h>
+#include <kernel_db/utils.h>
+#include <options.h>
+#include <scheduler/pointwise_heuristic.h>
+#include <scheduler/reduction_heuristic.h>
+#include <scheduler/registry.h>
+#include <scheduler/transpose_heuristic.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace nvfuser {
+
+namespace {
+
+// Largest unroll factor the autotuner tries
+constexpr int64_t kMaxUnrollFactor = 8;
+
+struct AutotuneOptions {
+  bool lookup_only = false;
+  bool cost_model = false;
+  std::string db_path;
+};
+
+// Reads the arguments of NVFUSER_ENABLE=autotune(...)
+AutotuneOptions readAutotuneOptions() {
+  AutotuneOptions options;
+  options.db_path =
+      (std::filesystem::temp_directory_path() / "nvfuser_tuning_db.tsv")
+          .string();
+  if (!isOptionEnabled(EnableOption::Autotune)) {
+    return options;
+  }
+  const std::string db_arg("db=");
+  for (const auto& arg : getEnableOptionArguments(EnableOption::Autotune)) {
+    if (arg == "lookup") {
+      options.lookup_only = true;
+    } else if (arg == "cost_model") {
+      options.cost_model = true;
+    } else if (arg.rfind(db_arg, 0) == 0) {
+      options.db_path = arg.substr(db_arg.size());
+    } else {
+      TORCH_WARN_ONCE("Autotune: Ignoring unknown argument: ", arg);
+    }
+  }
+  return options;
+}
+
+bool isPowerOfTwo(int64_t value) {
+  return value > 0 && (value & (value - 1)) == 0;
+}
+
+// A vectorization factor can only be reduced to a divisor, since a wider one
+// may not be legal for the alignment or the extents of the inputs
+bool isNarrowerVectorization(int64_t value, int64_t analytic) {
+  return value <= analytic && analytic % value == 0;
+}
+
+// Returns the launch params with new block dimensions. The grid dimensions
+// are cleared if they were derived from the block dimensions, so that they
+// are inferred from the scheduled extents at launch.
+LaunchParams withBlockDims(
+    const LaunchParams& lparams,
+    int64_t bdimx,
+    int64_t bdimy,
+    bool clear_grid) {
+  auto grid_dim = [&](ParallelType ptype) {
+    return clear_grid ? LaunchParams::UNINITIALIZED_VAL
+                      : lparams.getRawVal(ptype);
+  };
+  LaunchParams new_lparams(
+      grid_dim(ParallelType::BIDx),
+      grid_dim(ParallelType::BIDy),
+      lparams.getRawVal(ParallelType::BIDz),
+      bdimx,
+      bdimy,
+      lparams.getRawVal(ParallelType::TIDz));
+  new_lparams.setSmem(lparams.smem());
+  return new_lparams;
+}
+
+// Sets a knob of params, which are a copy of analytic. Returns false if the
+// knob doesn't apply or the value isn't legal for the analytic params.
+bool setPointwiseKnob(
+    const PointwiseParams& analytic,
+    PointwiseParams& params,
+    const std::string& knob,
+    int64_t value) {
+  if (knob == "unroll") {
+    const auto analytic_factor = (int64_t)analytic.unroll_factor;
+    if (analytic.vectorize) {
+      if (!isNarrowerVectorization(value, analytic_factor)) {
+        return false;
+      }
+      params.vectorize = value > 1;
+    } else if (value > kMaxUnrollFactor) {
+      return false;
+    }
+    params.unroll_factor = (size_t)value;
+    return true;
+  }
+  if (knob == "bdimx") {
+    // The 1D schedule splits by a constant block size, while the 2D schedule
+    // binds both block dimensions symbolically
+    if (!analytic.split_block || !analytic.lparams.hasDim(ParallelType::TIDx) ||
+        !analytic.lparams.hasDim(ParallelType::TIDy)) {
+      return false;
+    }
+    const int64_t num_threads =
+        analytic.lparams.bdimx() * analytic.lparams.bdimy();
+    if (value > num_threads || num_threads % value != 0) {
+      return false;
+    }
+    params.lparams = withBlockDims(
+        analytic.lparams, value, num_threads / value, /*clear_grid=*/false);
+    return true;
+  }
+  return false;
+}
+
+bool setReductionKnob(
+    ScheduleHeuristic heuristic,
+    const ReductionParams& analytic,
+    ReductionParams& params,
+    const std::string& knob,
+    int64_t value) {
+  if (knob == "unroll_iter") {
+    if (analytic.vectorize_iter_dom) {
+      if (!isNarrowerVectorization(value, analytic.unroll_factor_iter_dom)) {
+        return false;
+      }
+      params.vectorize_iter_dom = value > 1;
+    } else if (value > kMaxUnrollFactor) {
+      return false;
+    }
+    params.unroll_factor_iter_dom = value;
+    return true;
+  }
+
+  // The other knobs determine the persistent buffer layout of persistent
+  // kernels, so they are only tuned for plain reductions
+  if (heuristic != ScheduleHeuristic::Reduction || analytic.persistent_kernel) {
+    return false;
+  }
+  if (knob == "unroll_inner") {
+    if (analytic.vectorize_inner_reduction) {
+      if (!isNarrowerVectorization(
+              value, analytic.unroll_factor_inner_reduction)) {
+        return false;
+      }
+      params.vectorize_inner_reduction = value > 1;
+    } else if (value > kMaxUnrollFactor) {
+      return false;
+    }
+    params.unroll_factor_inner_reduction = value;
+    return true;
+  }
+  if (knob == "bdimx") {
+    // Grid reductions and static block dimensions depend on the exact
+    // launch configuration of the analytic heuristic
+    if (analytic.static_bdimx || analytic.static_bdimy ||
+        analytic.schedule_3D || analytic.cross_grid_inner_reduction ||
+        analytic.cross_grid_outer_reduction ||
+        !analytic.lparams.hasDim(ParallelType::TIDx) ||
+        !analytic.lparams.hasDim(ParallelType::TIDy)) {
+      return false;
+    }
+    const int64_t num_threads =
+        analytic.lparams.bdimx() * analytic.lparams.bdimy();
+    if (value > num_threads || num_threads % value != 0 ||
+        (analytic.pad_inner_reduction_to_warp && value % 32 != 0)) {
+      return false;
+    }
+    params.lparams = withBlockDims(
+        analytic.lparams, value, num_threads / value, /*clear_grid=*/true);
+    return true;
+  }
+  return false;
+}
+
+bool setTransposeKnob(
+    const TransposeParams& analytic,
+    TransposeParams& params,
+    const std::string& knob,
+    int64_t value) {
+  if (knob == "vectorize1") {
+    if (!isNarrowerVectorization(value, (int64_t)analytic.vectorize_factor1)) {
+      return false;
+    }
+    params.vectorize_factor1 = (size_t)value;
+  } else if (knob == "vectorize2") {
+    if (!isNarrowerVectorization(value, (int64_t)analytic.vectorize_factor2)) {
+      return false;
+    }
+    params.vectorize_factor2 = (size_t)value;
+  } else {
+    return false;
+  }
+  // The block size of the transpose scheduler follows from the tiles and the
+  // vectorization factors
+  params.lparams = withBlockDims(
+      analytic.lparams,
+      params.getThreadsPerBlock(),
+      analytic.lparams.getRawVal(ParallelType::TIDy),
+      /*clear_grid=*/false);
+  return true;
+}
+
+// Knobs of a heuristic and their analytic values
+std::vector<std::pair<std::string, int64_t>> tuningKnobs(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& analytic) {
+  switch (heuristic) {
+    case ScheduleHeuristic::PointWise: {
+      const auto& params = *analytic.as<PointwiseParams>();
+      return {
+          {"unroll", (int64_t)params.unroll_factor},
+          {"bdimx", params.lparams.bdimx()}};
+    }
+    case ScheduleHeuristic::Reduction:
+    case ScheduleHeuristic::InnerPersistent:
+    case ScheduleHeuristic::OuterPersistent: {
+      const auto& params = *analytic.as<ReductionParams>();
+      return {
+          {"unroll_iter", params.unroll_factor_iter_dom},
+          {"unroll_inner", params.unroll_factor_inner_reduction},
+          {"bdimx", params.lparams.bdimx()}};
+    }
+    case ScheduleHeuristic::Transpose: {
+      const auto& params = *analytic.as<TransposeParams>();
+      return {
+          {"vectorize1", (int64_t)params.vectorize_factor1},
+          {"vectorize2", (int64_t)params.vectorize_factor2}};
+    }
+    default:
+      return {};
+  }
+}
+
+// FNV-1a, which is stable across processes unlike std::hash
+uint64_t fnv1a(const std::string& str, uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (char c : str) {
+    hash ^= (uint8_t)c;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Sizes of a tensor, or nullopt if they can't be evaluated
+std::optional<std::vector<int64_t>> evaluateSizes(
+    TensorView* tv,
+    ExpressionEvaluator& ee,
+    bool expanded) {
+  std::vector<int64_t> sizes;
+  for (IterDomain* id :
+       TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    Val* extent = expanded ? id->getMaybeExpandedExtent() : id->extent();
+    if (!expanded && id->hasExpandedExtent()) {
+      sizes.push_back(1);
+      continue;
+    }
+    auto size = ee.evaluate(extent);
+    if (!size.hasValue()) {
+      return std::nullopt;
+    }
+    sizes.push_back(size.as<int64_t>());
+  }
+  return sizes;
+}
+
+int64_t bucketSize(int64_t size) {
+  int64_t bucket = 1;
+  while (bucket < size) {
+    bucket <<= 1;
+  }
+  return size <= 1 ? size : bucket;
+}
+
+// Largest number of elements of a tensor of the fusion
+int64_t numElements(Fusion* fusion, ExpressionEvaluator& ee) {
+  int64_t num_elements = 1;
+  for (auto vals : {fusion->inputs(), fusion->outputs()}) {
+    for (auto tv : ir_utils::filterByType<TensorView>(vals)) {
+      auto sizes = evaluateSizes(tv, ee, /*expanded=*/true);
+      if (!sizes.has_value()) {
+        continue;
+      }
+      int64_t numel = 1;
+      for (auto size : *sizes) {
+        numel *= size;
+      }
+      num_elements = std::max(num_elements, numel);
+    }
+  }
+  return num_elements;
+}
+
+// Random inputs of the sizes of the runtime info for the segment
+KernelArgumentHolder makeTuningInputs(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  auto& ee = runtime_info.expressionEvaluator();
+  const auto device = at::cuda::current_device();
+  KernelArgumentHolder args;
+  args.setDeviceIndex((int8_t)device);
+  for (Val* input : fusion->inputs()) {
+    auto tv = dynamic_cast<TensorView*>(input);
+    if (tv == nullptr) {
+      args.push(ee.evaluate(input));
+      continue;
+    }
+    auto sizes = evaluateSizes(tv, ee, /*expanded=*/false);
+    auto expanded_sizes = evaluateSizes(tv, ee, /*expanded=*/true);
+    NVF_ERROR(
+        sizes.has_value() && expanded_sizes.has_value(),
+        "Can't evaluate the sizes of ",
+        tv->toString());
+    auto options = at::TensorOptions().dtype(data_type_to_aten(tv->dtype()));
+    options = tv->isCpuScalar() ? options.device(at::kCPU)
+                                : options.device(at::kCUDA, device);
+    // Zeros are valid indices for gathers and selects
+    at::Tensor tensor =
+        isFloatingPointType(tv->dtype()) || isComplexType(tv->dtype())
+        ? at::randn(*sizes, options)
+        : at::zeros(*sizes, options);
+    args.push(tensor.expand(*expanded_sizes));
+  }
+  return args;
+}
+
+} // namespace
+
+std::string toString(const TuningConfig& config) {
+  if (config.empty()) {
+    return "-";
+  }
+  std::stringstream ss;
+  bool first = true;
+  for (const auto& [knob, value] : config) {
+    ss << (first ? "" : ",") << knob << "=" << value;
+    first = false;
+  }
+  return ss.str();
+}
+
+TuningConfig parseTuningConfig(const std::string& str) {
+  TuningConfig config;
+  if (str == "-") {
+    return config;
+  }
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    const auto pos = item.find('=');
+    NVF_CHECK(pos != std::string::npos, "Invalid tuning config: ", str, ".");
+    config[item.substr(0, pos)] = std::stoll(item.substr(pos + 1));
+  }
+  return config;
+}
+
+bool isTunable(ScheduleHeuristic heuristic) {
+  switch (heuristic) {
+    case ScheduleHeuristic::PointWise:
+    case ScheduleHeuristic::Reduction:
+    case ScheduleHeuristic::InnerPersistent:
+    case ScheduleHeuristic::OuterPersistent:
+    case ScheduleHeuristic::Transpose:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::shared_ptr<HeuristicParams> applyTuningConfig(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& analytic,
+    const TuningConfig& config) {
+  NVF_ERROR(
+      isTunable(heuristic), "Heuristic is not tunable: ", toString(heuristic));
+  auto params = analytic.clone();
+  for (const auto& [knob, value] : config) {
+    if (!isPowerOfTwo(value)) {
+      return nullptr;
+    }
+    bool applied = false;
+    switch (heuristic) {
+      case ScheduleHeuristic::PointWise:
+        applied = setPointwiseKnob(
+            *analytic.as<PointwiseParams>(),
+            *params->as<PointwiseParams>(),
+            knob,
+            value);
+        break;
+      case ScheduleHeuristic::Transpose:
+        applied = setTransposeKnob(
+            *analytic.as<TransposeParams>(),
+            *params->as<TransposeParams>(),
+            knob,
+            value);
+        break;
+      default:
+        applied = setReductionKnob(
+            heuristic,
+            *analytic.as<ReductionParams>(),
+            *params->as<ReductionParams>(),
+            knob,
+            value);
+    }
+    if (!applied) {
+      return nullptr;
+    }
+  }
+  return params;
+}
+
+std::vector<TuningConfig> tuningCandidates(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& analytic) {
+  std::vector<TuningConfig> candidates = {TuningConfig()};
+  for (const auto& [knob, analytic_value] : tuningKnobs(heuristic, analytic)) {
+    std::vector<int64_t> values;
+    for (auto value : {analytic_value / 2, analytic_value * 2}) {
+      if (applyTuningConfig(heuristic, analytic, {{knob, value}}) != nullptr) {
+        values.push_back(value);
+      }
+    }
+    // Every combination with the neighboring values of this knob
+    const auto num_candidates = candidates.size();
+    for (auto value : values) {
+      for (auto i : c10::irange(num_candidates)) {
+        TuningConfig config = candidates.at(i);
+        config[knob] = value;
+        if (applyTuningConfig(heuristic, analytic, config) != nullptr) {
+          candidates.push_back(std::move(config));
+        }
+      }
+    }
+  }
+  return candidates;
+}
+
+std::string tuningKey(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info) {
+  FUSER_PERF_SCOPE("tuningKey");
+  // The statement names are deterministic for a given definition, so the
+  // printed math identifies the fusion across processes
+  std::stringstream math;
+  for (auto input : fusion->inputs()) {
+    math << input->toString() << " " << input->dtype() << "\n";
+  }
+  for (auto expr : StmtSort::getExprsBetween(
+           fusion, fusion->inputs(), fusion->outputs())) {
+    math << expr->toString();
+  }
+  for (auto output : fusion->outputs()) {
+    math << output->toString() << "\n";
+  }
+
+  std::stringstream key;
+  key << "sm" << runtime_info.targetDevice().computeCapability() << "/"
+      << toString(heuristic) << "/" << std::hex << std::setw(16)
+      << std::setfill('0') << fnv1a(math.str()) << std::dec << "/";
+  auto& ee = runtime_info.expressionEvaluator();
+  bool first = true;
+  for (auto vals : {fusion->inputs(), fusion->outputs()}) {
+    for (auto val : vals) {
+      key << (first ? "" : ";");
+      first = false;
+      auto tv = dynamic_cast<TensorView*>(val);
+      if (tv == nullptr) {
+        key << "s";
+        continue;
+      }
+      auto sizes = evaluateSizes(tv, ee, /*expanded=*/true);
+      if (!sizes.has_value()) {
+        key << "?";
+        continue;
+      }
+      for (auto i : c10::irange(sizes->size())) {
+        key << (i == 0 ? "" : "x") << bucketSize(sizes->at(i));
+      }
+    }
+  }
+  return key.str();
+}
+
+std::optional<double> KernelTimingBackend::measure(
+    const TuningCandidate& candidate) {
+  FUSER_PERF_SCOPE("KernelTimingBackend::measure");
+  try {
+    // Only the segment is cloned, since the fusion may be a complete fusion
+    // narrowed by a FusionSegmentGuard
+    Fusion fusion;
+    Fusion::copySubgraph(
+        candidate.fusion,
+        &fusion,
+        candidate.fusion->inputs(),
+        candidate.fusion->outputs());
+    KernelArgumentHolder args =
+        makeTuningInputs(candidate.fusion, *candidate.runtime_info);
+    candidate.schedule(&fusion);
+
+    const auto& params = *candidate.params;
+    FusionExecutor fe;
+    fe.compileFusion(
+        &fusion, args, params.lparams, params.cparams, candidate.heuristic);
+    fe.setMeasureKernelTimeFlag(true);
+    // The first run is a warmup
+    double best_ms = std::numeric_limits<double>::max();
+    for (auto i : c10::irange(num_runs_ + 1)) {
+      fe.runFusion(args, params.lparams, params.cparams);
+      if (i > 0) {
+        best_ms = std::min(best_ms, (double)fe.kernelTimeMs());
+      }
+    }
+    return best_ms;
+  } catch (const std::exception& e) {
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << "Autotune: Discarding a candidate that failed: " << e.what()
+              << std::endl;
+    }
+    return std::nullopt;
+  }
+}
+
+std::optional<double> CostModelBackend::measure(
+    const TuningCandidate& candidate) {
+  const auto& device = candidate.runtime_info->targetDevice();
+  const auto& params = *candidate.params;
+
+  // Elements processed by a thread per iteration, and the width of its
+  // memory accesses
+  int64_t work_per_thread = 1;
+  double vector_width = 1.0;
+  switch (candidate.heuristic) {
+    case ScheduleHeuristic::PointWise: {
+      const auto& pparams = *params.as<PointwiseParams>();
+      work_per_thread = (int64_t)pparams.unroll_factor;
+      vector_width = pparams.vectorize ? (double)pparams.unroll_factor : 1.0;
+      break;
+    }
+    case ScheduleHeuristic::Transpose: {
+      const auto& tparams = *params.as<TransposeParams>();
+      work_per_thread = std::max(
+          (int64_t)(tparams.tile_size1 * tparams.tile_size2) /
+              tparams.getThreadsPerBlock(),
+          (int64_t)1);
+      vector_width =
+          (double)(tparams.vectorize_factor1 + tparams.vectorize_factor2) / 2;
+      break;
+    }
+    default: {
+      const auto& rparams = *params.as<ReductionParams>();
+      work_per_thread = rparams.unroll_factor_iter_dom *
+          rparams.unroll_factor_inner_reduction *
+          rparams.unroll_factor_outer_reduction;
+      vector_width = (rparams.vectorize_iter_dom
+                          ? (double)rparams.unroll_factor_iter_dom
+                          : 1.0) *
+          (rparams.vectorize_inner_reduction
+               ? (double)rparams.unroll_factor_inner_reduction
+               : 1.0);
+    }
+  }
+
+  const int64_t num_threads = params.lparams.bdimx() *
+      params.lparams.bdimy() * params.lparams.bdimz();
+  const int64_t num_elements = numElements(
+      candidate.fusion, candidate.runtime_info->expressionEvaluator());
+  const int64_t num_blocks =
+      ceilDiv(num_elements, num_threads * work_per_thread);
+  const int64_t blocks_per_sm = std::clamp(
+      device.max_threads_per_multi_processor / num_threads,
+      (int64_t)1,
+      std::max(device.max_blocks_per_multi_processor, (int64_t)1));
+  const int64_t num_waves = ceilDiv(
+      num_blocks,
+      std::max(device.multi_processor_count, (int64_t)1) * blocks_per_sm);
+
+  // Every wave pays a memory latency, which unrolling amortizes until the
+  // registers run out
+  constexpr double kWaveLatency = 8.0;
+  constexpr int64_t kMaxWorkInRegisters = 16;
+  const double register_penalty = work_per_thread > kMaxWorkInRegisters
+      ? (double)work_per_thread / kMaxWorkInRegisters
+      : 1.0;
+  return (double)num_waves *
+      ((double)work_per_thread / vector_width + kWaveLatency) *
+      register_penalty;
+}
+
+namespace {
+
+std::mutex tuning_backend_mutex;
+std::shared_ptr<TuningBackend> tuning_backend_override;
+
+} // namespace
+
+void setTuningBackend(std::shared_ptr<TuningBackend> backend) {
+  std::lock_guard<std::mutex> lock(tuning_backend_mutex);
+  tuning_backend_override = std::move(backend);
+}
+
+std::shared_ptr<TuningBackend> getTuningBackend() {
+  {
+    std::lock_guard<std::mutex> lock(tuning_backend_mutex);
+    if (tuning_backend_override != nullptr) {
+      return tuning_backend_override;
+    }
+  }
+  if (readAutotuneOptions().cost_model) {
+    return std::make_shared<CostModelBackend>();
+  }
+  return std::make_shared<KernelTimingBackend>();
+}
+
+TuningDb::TuningDb(std::string path) : path_(std::move(path)) {
+  FUSER_PERF_SCOPE("TuningDb::open");
+  std::ifstream file(path_);
+  std::string line;
+  while (std::getline(file, line)) {
+    const auto key_end = line.find('\t');
+    const auto config_end = line.find('\t', key_end + 1);
+    if (key_end == std::string::npos || config_end == std::string::npos) {
+      continue;
+    }
+    try {
+      entries_[line.substr(0, key_end)] = parseTuningConfig(
+          line.substr(key_end + 1, config_end - key_end - 1));
+    } catch (const std::exception&) {
+      // Skip lines of a partial write
+    }
+  }
+}
+
+std::shared_ptr<TuningDb> TuningDb::get() {
+  static std::mutex mutex;
+  static std::shared_ptr<TuningDb> db;
+  const std::string path = readAutotuneOptions().db_path;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (db == nullptr || db->path() != path) {
+    db = std::make_shared<TuningDb>(path);
+  }
+  return db;
+}
+
+size_t TuningDb::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+std::optional<TuningConfig> TuningDb::query(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void TuningDb::write(
+    const std::string& key,
+    const TuningConfig& config,
+    double time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[key] = config;
+  std::stringstream line;
+  line << key << "\t" << toString(config) << "\t" << time << "\n";
+  if (!append_to_text_file(path_, line.str())) {
+    TORCH_WARN("Autotune: Unable to write to the tuning db ", path_);
+  }
+}
+
+std::shared_ptr<HeuristicParams> autotuneHeuristicParams(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const std::shared_ptr<HeuristicParams>& analytic,
+    const std::function<void(Fusion*, const std::shared_ptr<HeuristicParams>&)>&
+        schedule) {
+  FUSER_PERF_SCOPE("autotuneHeuristicParams");
+  const std::string key = tuningKey(heuristic, fusion, runtime_info);
+  auto db = TuningDb::get();
+
+  // A stored config may not apply to the analytic params of other sizes of
+  // the same bucket, e.g. if it narrows a vectorization they don't have
+  auto apply_stored = [&](const TuningConfig& config) {
+    auto params = applyTuningConfig(heuristic, *analytic, config);
+    return params != nullptr ? params : analytic;
+  };
+  if (auto config = db->query(key)) {
+    return apply_stored(*config);
+  }
+  if (readAutotuneOptions().lookup_only) {
+    return analytic;
+  }
+
+  static std::mutex tuning_mutex;
+  std::lock_guard<std::mutex> lock(tuning_mutex);
+  // Another thread may have tuned the same key meanwhile
+  if (auto config = db->query(key)) {
+    return apply_stored(*config);
+  }
+
+  FUSER_PERF_SCOPE("autotune");
+  auto backend = getTuningBackend();
+  std::optional<TuningConfig> best_config;
+  std::shared_ptr<HeuristicParams> best_params;
+  double best_time = 0.0;
+  for (const auto& config : tuningCandidates(heuristic, *analytic)) {
+    auto params = applyTuningConfig(heuristic, *analytic, config);
+    TuningCandidate candidate;
+    candidate.heuristic = heuristic;
+    candidate.fusion = fusion;
+    candidate.runtime_info = &runtime_info;
+    candidate.params = params;
+    candidate.schedule = [&schedule, &params](Fusion* fusion_copy) {
+      schedule(fusion_copy, params);
+    };
+    const auto time = backend->measure(candidate);
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << "Autotune " << key << " with " << backend->name() << ": "
+              << toString(config) << " -> "
+              << (time.has_value() ? std::to_string(*time) : "failed")
+              << std::endl;
+    }
+    // Ties keep the earlier candidate, which is the analytic one first
+    if (time.has_value() && (!best_config.has_value() || *time < best_time)) {
+      best_config = config;
+      best_params = params;
+      best_time = *time;
+    }
+  }
+  if (!best_config.has_value()) {
+    return analytic;
+  }
+  db->write(key, *best_config, best_time);
+  return best_params;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,187 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <fusion.h>
+#include <scheduler/heuristic.h>
+#include <scheduler/heuristic_types.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+class SchedulerRuntimeInfo;
+
+//! Values of the tunable parameters of a heuristic that differ from the
+//! analytic heuristic, by knob name. The knobs are:
+//!   PointWise:      unroll (unroll or vectorization factor), bdimx (2D only)
+//!   Reduction:      unroll_iter, unroll_inner, bdimx
+//!   InnerPersistent, OuterPersistent: unroll_iter
+//!   Transpose:      vectorize1, vectorize2
+//! An empty config is the analytic heuristic itself.
+using TuningConfig = std::map<std::string, int64_t>;
+
+//! Formats a config as "name=value,name=value", or "-" if it is empty
+std::string toString(const TuningConfig& config);
+TuningConfig parseTuningConfig(const std::string& str);
+
+//! Whether the autotuner handles the heuristics of the given scheduler
+bool isTunable(ScheduleHeuristic heuristic);
+
+//! Returns a copy of the analytic params with the config applied, or nullptr
+//! if the config doesn't apply to them, e.g. because it asks for a wider
+//! vectorization than the analytic heuristic found legal. Knobs are only
+//! changed in ways that keep the schedule valid for the inputs the analytic
+//! params were computed for.
+std::shared_ptr<HeuristicParams> applyTuningConfig(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& analytic,
+    const TuningConfig& config);
+
+//! Returns the configs whose knobs are each the analytic value, half or
+//! double of it, that apply to the analytic params. The first is the empty
+//! config.
+std::vector<TuningConfig> tuningCandidates(
+    ScheduleHeuristic heuristic,
+    const HeuristicParams& analytic);
+
+//! Key of a fusion in the TuningDb. It combines the target architecture, the
+//! heuristic, a digest of the fusion math, and the shape bucket of the
+//! inputs and outputs, where every extent is rounded up to a power of two.
+//! The fusion is the segment being scheduled, so it may be narrowed by a
+//! FusionSegmentGuard.
+std::string tuningKey(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info);
+
+//! \struct TuningCandidate
+//! \brief A candidate heuristic given to a TuningBackend to be measured
+struct TuningCandidate {
+  ScheduleHeuristic heuristic = ScheduleHeuristic::None;
+  //! Unscheduled fusion of the segment, which must not be modified
+  Fusion* fusion = nullptr;
+  SchedulerRuntimeInfo* runtime_info = nullptr;
+  std::shared_ptr<HeuristicParams> params;
+  //! Schedules a copy of fusion with params
+  std::function<void(Fusion*)> schedule;
+};
+
+//! \class TuningBackend
+//! \brief Measures candidates for the autotuner. Only relative times matter,
+//! so a backend can be a cost model instead of a timer.
+class TuningBackend {
+ public:
+  virtual ~TuningBackend() = default;
+
+  virtual std::string name() const = 0;
+
+  //! Returns the time of the candidate, or nullopt if it can't be compiled
+  //! or run, in which case it is discarded
+  virtual std::optional<double> measure(const TuningCandidate& candidate) = 0;
+};
+
+//! Compiles each candidate and times its kernel on the current device, with
+//! inputs of the sizes of the runtime info
+class KernelTimingBackend : public TuningBackend {
+ public:
+  explicit KernelTimingBackend(int64_t num_runs = 5) : num_runs_(num_runs) {}
+
+  std::string name() const override {
+    return "kernel_timing";
+  }
+
+  std::optional<double> measure(const TuningCandidate& candidate) override;
+
+ private:
+  int64_t num_runs_ = 5;
+};
+
+//! Deterministic stand-in that estimates the time of a candidate from its
+//! launch configuration and the target device, without a GPU. It favors full
+//! waves, wide vectorization and moderate unrolling. It is meant for tests
+//! and for tuning on machines without the target GPU, not as a predictor.
+class CostModelBackend : public TuningBackend {
+ public:
+  std::string name() const override {
+    return "cost_model";
+  }
+
+  std::optional<double> measure(const TuningCandidate& candidate) override;
+};
+
+//! Overrides the backend used by the autotuner. nullptr restores the
+//! default, which is the CostModelBackend if NVFUSER_ENABLE=autotune has the
+//! cost_model argument, and the KernelTimingBackend otherwise.
+void setTuningBackend(std::shared_ptr<TuningBackend> backend);
+std::shared_ptr<TuningBackend> getTuningBackend();
+
+//! \class TuningDb
+//! \brief On-disk database of the best TuningConfig of each tuning key.
+//!
+//! The db is a text file with a line "key<TAB>config<TAB>time" per entry,
+//! which is appended to when a key is tuned, so that processes sharing the
+//! file don't overwrite each other's entries. The file is read when the db
+//! is opened, and the last line of a key wins. Entries written by other
+//! processes later are not seen until the db is opened again.
+class TuningDb {
+ public:
+  explicit TuningDb(std::string path);
+
+  TuningDb(const TuningDb&) = delete;
+  TuningDb& operator=(const TuningDb&) = delete;
+
+  //! Returns the db of the path given by the db=<path> argument of
+  //! NVFUSER_ENABLE=autotune, which defaults to nvfuser_tuning_db.tsv in the
+  //! temporary directory. The db is opened again if the path changes.
+  static std::shared_ptr<TuningDb> get();
+
+  const std::string& path() const {
+    return path_;
+  }
+
+  size_t size() const;
+
+  std::optional<TuningConfig> query(const std::string& key) const;
+
+  //! Records the best config of a key and appends it to the file
+  void write(const std::string& key, const TuningConfig& config, double time);
+
+ private:
+  const std::string path_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, TuningConfig> entries_;
+};
+
+//! Returns the heuristic params to use for a segment, given the params of the
+//! analytic heuristic. Used by SchedulerEntry::makeEntry when
+//! NVFUSER_ENABLE=autotune is set.
+//!
+//! On a TuningDb hit, the stored config is applied to the analytic params.
+//! On a miss, the candidates are measured with the TuningBackend and the best
+//! config is stored, unless the option has the lookup argument, in which
+//! case the analytic params are used. Tuning is serialized across threads so
+//! that measurements don't disturb each other.
+std::shared_ptr<HeuristicParams> autotuneHeuristicParams(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const std::shared_ptr<HeuristicParams>& analytic,
+    const std::function<void(Fusion*, const std::shared_ptr<HeuristicParams>&)>&
+        schedule);
+
+} // namespace nvfuser
@@ -360,9 +360,8 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
   const auto problem_shape =
       getProblemShape(fusion, mma_exprs.front()->as<MmaOp>(), runtime_info);
 
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
-  const auto mma_op =
-      getMmaOp(device_prop->major * 10 + device_prop->minor, problem_shape);
+  const auto mma_op = getMmaOp(
+      (int)runtime_info.targetDevice().computeCapability(), problem_shape);
   NVF_ERROR(
       mma_op.has_value(), "Failed to determine a MMA op for given problem.");
 
@@ -7,6 +7,7 @@
 // clang-format on
 
 #include <ATen/cuda/CUDAContext.h>
+#include <device_descriptor.h>
 #include <device_lower/utils.h>
 #include <expr_evaluator.h>
 #include <ir/printer.h>
@@ -43,20 +44,21 @@ std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
     bool smem_a_reuse_guaranteed,
     bool smem_b_reuse_guaranteed,
     bool ignore_occupancy_drop) {
-  const auto properties = at::cuda::getCurrentDeviceProperties();
-  const size_t device_smem_limit = properties->sharedMemPerBlockOptin;
-  const size_t shared_memory_overhead = properties->reservedSharedMemPerBlock;
+  const auto target_device = getTargetDevice();
+  const size_t device_smem_limit = target_device->shared_mem_per_block_optin;
+  const size_t shared_memory_overhead =
+      target_device->reserved_shared_mem_per_block;
   const size_t shared_memory_available =
       device_smem_limit - shared_memory_overhead;
 
   auto warp_dims = gemm_tile.cta_tile / gemm_tile.warp_tile;
   const auto threads_per_block =
-      warp_dims.m * warp_dims.n * warp_dims.k * properties->warpSize;
+      warp_dims.m * warp_dims.n * warp_dims.k * target_device->warp_size;
 
   // see scheduleContiguousVectorLoad
   const int vector_word = 8;
   const int round_to_factor = warp_dims.m * warp_dims.n * warp_dims.k *
-      properties->warpSize * vector_word;
+      (int)target_device->warp_size * vector_word;
   const int mk = gemm_tile.cta_tile.m * gemm_tile.cta_tile.k;
   const int nk = gemm_tile.cta_tile.n * gemm_tile.cta_tile.k;
   const size_t smem_a = (size_t)(ceilDiv(mk, round_to_factor) *
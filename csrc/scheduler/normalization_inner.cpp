@@ -67,15 +67,15 @@ std::pair<int64_t, int64_t> getPersistentBufferSize(
       scheduler_utils::register_file_size;
 
   // Check available shared memory
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& target_device = runtime_info.targetDevice();
   const int64_t max_shared_memory_size =
-      (int64_t)dev_prop->sharedMemPerBlockOptin;
+      target_device.shared_mem_per_block_optin;
   // Some shared memories are reserved for kernel launch overhead and
   // reduction_broadcast_workspace. Estimation is conservative, but should
   // be good enough. The actual threads per block is set in the heuristics
   // and it may be smaller than maxThreadsPerBlock.
   // TODO: More accurate estimation of available shared memory size.
-  const int64_t kernel_overhead = (int64_t)dev_prop->reservedSharedMemPerBlock;
+  const int64_t kernel_overhead = target_device.reserved_shared_mem_per_block;
   int64_t max_buffer_dtype_size = 1;
   for (auto tv : persistent_buffer_info.persistent_buffers) {
     max_buffer_dtype_size = std::max(
@@ -83,7 +83,7 @@ std::pair<int64_t, int64_t> getPersistentBufferSize(
         dataTypeSize(tv->getDataType().value(), runtime_info.getIndexType()));
   }
   const int64_t reduction_broadcast_workspace =
-      (int64_t)(dev_prop->maxThreadsPerBlock) * max_buffer_dtype_size;
+      target_device.max_threads_per_block * max_buffer_dtype_size;
   const int64_t available_shared_memory_size =
       max_shared_memory_size - kernel_overhead - reduction_broadcast_workspace;
   available_persistent_buffer_size =
@@ -114,7 +114,8 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
   auto properties = scheduler_utils::getReductionProperties(
       fusion, runtime_info, reference_tv);
 
-  const int64_t warp_size = at::cuda::getCurrentDeviceProperties()->warpSize;
+  const auto& target_device = runtime_info.targetDevice();
+  const int64_t warp_size = target_device.warp_size;
 
   // pair of persistent_buffer_size and available_persistent_buffer_size
   const std::pair<int64_t, int64_t> buffer_size =
@@ -123,7 +124,7 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
   const int64_t available_persistent_buffer_size = buffer_size.second;
 
   const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+      target_device.multi_processor_count;
 
   if (persistent_buffer_size > available_persistent_buffer_size) {
     scheduler_debug_utils::canScheduleRejectReason(
@@ -133,8 +134,7 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
   }
 
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      target_device.max_threads_per_multi_processor;
 
   const int64_t required_sm_per_norm =
       ceilDiv(persistent_buffer_size, scheduler_utils::register_file_size);
@@ -178,6 +178,7 @@ void InnerPersistentKernelScheduler::computeHeuristics(
 namespace {
 
 std::shared_ptr<ReductionParams> innerPersistentHeuristicSharedMemory(
+    const TargetDeviceDescriptor& target_device,
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
     const int64_t inner_most_dimension_numel,
@@ -185,7 +186,6 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristicSharedMemory(
     const int64_t max_input_dtype_size,
     const int64_t max_persistent_buffer_size,
     const size_t max_vectorize_factor) {
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
   auto rparams = std::make_shared<ReductionParams>();
   rparams->shared_mem_persistent_buffer = true;
   rparams->persistent_kernel = true;
@@ -195,7 +195,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristicSharedMemory(
   // e.g. layer_norm with hidden size larger than 64K for fp16 or 32K for fp32.
   // fully vectorized, use maxThreadsPerBlock to reduce workload per threads
   int64_t vectorize_factor = (int64_t)max_vectorize_factor;
-  int64_t bdimx = dev_prop->maxThreadsPerBlock;
+  int64_t bdimx = target_device.max_threads_per_block;
   NVF_ERROR(
       total_reduction_numel >= vectorize_factor * bdimx,
       "total_reduction_numel should be larger than or equal to vectorize_factor * bdimx.\n",
@@ -245,6 +245,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristicSharedMemory(
   return rparams;
 }
 std::shared_ptr<ReductionParams> innerPersistentHeuristic(
+    const TargetDeviceDescriptor& target_device,
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
     const int64_t inner_most_dimension_numel,
@@ -255,6 +256,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   if (max_persistent_buffer_size > scheduler_utils::register_file_size) {
     // use shared memory for persistent buffer
     return innerPersistentHeuristicSharedMemory(
+        target_device,
         total_reduction_numel,
         total_iteration_numel,
         inner_most_dimension_numel,
@@ -270,14 +272,11 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   const int64_t outer_reduction_numel =
       total_reduction_numel / inner_most_dimension_numel;
 
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
-  // WARNING: At some point we may want to generate heuristics for another
-  // device that is not the current device.
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)dev_prop->maxThreadsPerMultiProcessor;
+      target_device.max_threads_per_multi_processor;
 
   const int64_t device_multiprocessor_count =
-      (int64_t)dev_prop->multiProcessorCount;
+      target_device.multi_processor_count;
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -294,8 +293,8 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   // if data fits in l2 and we need more parallelization in the reduction dim,
   // we can use a smaller warp size. While thread local data fits in l1, and
   // reduction dim is really small, we can use <32 threads per warp.
-  const bool fits_in_l2 =
-      n_elems * max_input_dtype_size * n_tensor_inputs < dev_prop->l2CacheSize;
+  const bool fits_in_l2 = n_elems * max_input_dtype_size * n_tensor_inputs <
+      target_device.l2_cache_size;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
@@ -383,7 +382,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
       // reductions
       max_threads_in_block = std::min(
           ceilDiv(n_elems, target_blocks * target_unroll),
-          (int64_t)dev_prop->maxThreadsPerBlock);
+          target_device.max_threads_per_block);
     } else {
       // targetting 4 waves, so try to use a quarter of available threads
       max_threads_in_block = std::min(
@@ -396,7 +395,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   if (max_threads_in_block % warp_size != 0) {
     max_threads_in_block += warp_size - max_threads_in_block % warp_size;
     max_threads_in_block =
-        std::min(max_threads_in_block, (int64_t)dev_prop->maxThreadsPerBlock);
+        std::min(max_threads_in_block, target_device.max_threads_per_block);
   }
   // Compute maximum number of reductions we could do in the same kernel based
   // on persistent buffer size. Bounded by the wave count for utilization of
@@ -483,7 +482,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
   // (2) Two warps, so we can achieve 100% occupancy since most GPUs allow 32
   //     blocks per SM.
   // (3) Four warps, number recommended by the cuda-c-best-practices-guide.
-  const int64_t min_threads_per_block = 4l * dev_prop->warpSize;
+  const int64_t min_threads_per_block = 4l * target_device.warp_size;
 
   // start bdimx with min_threads_per_block then increase if we have too many
   // persistent buffer batches per block
@@ -609,13 +608,13 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
     batches_per_block_outer_reduction /= 2l;
   }
 
-  auto device_warp_size = (int64_t)at::cuda::warp_size();
+  auto device_warp_size = target_device.warp_size;
   auto padded_bdimx = bdimx % device_warp_size == 0
       ? bdimx
       : bdimx + (device_warp_size - bdimx % device_warp_size);
 
   bool pad_bdimx = bdimx > 16 &&
-      padded_bdimx * bdimy * bdimz < (int64_t)dev_prop->maxThreadsPerBlock;
+      padded_bdimx * bdimy * bdimz < target_device.max_threads_per_block;
 
   // estimate register usage and occupancy raito.
   // If occupancy raito is less than a preset occupancy_ratio, reduce register
@@ -679,7 +678,7 @@ std::shared_ptr<ReductionParams> innerPersistentHeuristic(
     constexpr double occupancy_ratio = 0.4;
     const int64_t blocks_per_sm_wanted = ceilDiv(
         static_cast<int64_t>(
-            dev_prop->maxThreadsPerMultiProcessor * occupancy_ratio),
+            target_device.max_threads_per_multi_processor * occupancy_ratio),
         threads_per_block);
 
     // if estimated blocks is smaller than wanted and decrease register usage
@@ -799,6 +798,7 @@ std::shared_ptr<ReductionParams> getInnerPersistentHeuristics(
           InnerPersistentKernelScheduler::heuristicType());
 
   std::shared_ptr<ReductionParams> rparams = innerPersistentHeuristic(
+      runtime_info.targetDevice(),
       prop.total_reduction_numel,
       prop.total_iteration_numel,
       prop.inner_most_dimension_numel,
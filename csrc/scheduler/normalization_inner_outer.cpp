@@ -253,7 +253,8 @@ bool InnerOuterPersistentKernelScheduler::canScheduleRunTime(
   auto properties = scheduler_utils::getReductionProperties(
       fusion, runtime_info, reference_tv);
 
-  const int64_t warp_size = at::cuda::getCurrentDeviceProperties()->warpSize;
+  const auto& target_device = runtime_info.targetDevice();
+  const int64_t warp_size = target_device.warp_size;
 
   // pair of persistent_buffer_size and available_persistent_buffer_size
   const std::pair<int64_t, int64_t> buffer_size =
@@ -262,7 +263,7 @@ bool InnerOuterPersistentKernelScheduler::canScheduleRunTime(
   const int64_t available_persistent_buffer_size = buffer_size.second;
 
   const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+      target_device.multi_processor_count;
 
   if (persistent_buffer_size > available_persistent_buffer_size) {
     scheduler_debug_utils::canScheduleRejectReason(
@@ -297,8 +298,7 @@ bool InnerOuterPersistentKernelScheduler::canScheduleRunTime(
   }
 
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      target_device.max_threads_per_multi_processor;
 
   const int64_t required_sm_per_norm =
       ceilDiv(persistent_buffer_size, scheduler_utils::register_file_size);
@@ -361,6 +361,7 @@ namespace {
 // (b) TIDx*BIDy is usually much larger than hidden_size, e.g. 128*216 =
 // 1024*27 this means without switch only 1/27 of the threads is used.
 std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
+    const TargetDeviceDescriptor& target_device,
     const int64_t outer_dim_numel,
     const int64_t inner_dim_numel,
     const int64_t max_persistent_buffer_size,
@@ -425,9 +426,8 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
         threads_per_sm / warp_size, allocated_warps_per_block);
   };
 
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
   const int64_t device_multiprocessor_count =
-      (int64_t)dev_prop->multiProcessorCount;
+      target_device.multi_processor_count;
 
   // Step-1, set InnerParams reduction dim: inner_vect, inner_batch,
   // threads_per_block (bdimx * bdimy). Start threads_per_block from a quarter
@@ -454,7 +454,7 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
           outer_dim_numel,
           max_persistent_buffer_size,
           iop.inner_vect,
-          dev_prop->warpSize,
+          target_device.warp_size,
           ignore_register_size_limit);
   auto opt_inner_batch = batch_and_block_size.first;
   NVF_ERROR(opt_inner_batch.has_value());
@@ -472,8 +472,8 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
   int64_t reg_per_thread =
       getEstimatedRegisterUsage(iop.inner_vect * iop.inner_batch);
   int64_t threads_per_sm = getThreadsPerSMGivenRegPerThread(reg_per_thread);
-  int64_t blocks_per_sm =
-      getBlocksPerSM(threads_per_sm, threads_per_block, dev_prop->warpSize);
+  int64_t blocks_per_sm = getBlocksPerSM(
+      threads_per_sm, threads_per_block, target_device.warp_size);
   iop.gdimy = blocks_per_sm * device_multiprocessor_count;
   const int64_t outer_iter_min = 8;
   const int64_t gdimy_max = scheduler_utils::roundUpToN(
@@ -531,7 +531,7 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
         getEstimatedRegisterUsage(iop.inner_vect * iop.inner_batch);
     threads_per_sm = getThreadsPerSMGivenRegPerThread(reg_per_thread);
     blocks_per_sm = getBlocksPerSM(
-        threads_per_sm, threads_per_block_mrpb, dev_prop->warpSize);
+        threads_per_sm, threads_per_block_mrpb, target_device.warp_size);
     iop.gdimy = blocks_per_sm * device_multiprocessor_count;
 
     // Step-3, OuterParams, Iteration dim: vectorization_factor_outer(reuse),
@@ -545,7 +545,7 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
 
     // Step-4, OuterParams, Reduction dim: bdimx (already done)
 
-    if (iop.bdimx % dev_prop->warpSize == 0) {
+    if (iop.bdimx % target_device.warp_size == 0) {
       rparams->pad_inner_reduction_to_warp = true;
       rparams->pad_outer_reduction_to_warp = true;
     }
@@ -604,6 +604,7 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
 }
 
 std::shared_ptr<ReductionParams> persistentHeuristic(
+    const TargetDeviceDescriptor& target_device,
     const int64_t total_iteration_numel,
     const int64_t inner_most_dimension_numel,
     const size_t tmp_gmem_dtype_size,
@@ -614,6 +615,7 @@ std::shared_ptr<ReductionParams> persistentHeuristic(
   const int64_t outer_dim_numel = total_iteration_numel;
   const int64_t inner_dim_numel = inner_most_dimension_numel;
   rparams = innerOuterPersistentHeuristic(
+      target_device,
       outer_dim_numel,
       inner_dim_numel,
       max_persistent_buffer_size,
@@ -761,6 +763,7 @@ std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
       dataTypeSize(outer_reduction_tvs[0]->getDataType().value());
 
   auto heuristic = persistentHeuristic(
+      runtime_info.targetDevice(),
       properties.total_iteration_numel,
       properties.inner_most_dimension_numel,
       tmp_gmem_dtype_size,
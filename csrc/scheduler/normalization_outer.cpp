@@ -53,10 +53,10 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
   auto properties = scheduler_utils::getReductionProperties(
       fusion, runtime_info, reduction_tvs[0]);
 
-  const auto device_prop = at::cuda::getCurrentDeviceProperties();
+  const auto& target_device = runtime_info.targetDevice();
 
   const int64_t sm_register_file_size =
-      static_cast<int64_t>(device_prop->regsPerBlock * sizeof(int));
+      static_cast<int64_t>(target_device.regs_per_block * sizeof(int));
 
   auto persistent_buffer_info_entry =
       HeuristicSummaryEntry<HeuristicCompileTime::PersistentBufferInfo>(
@@ -79,7 +79,7 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
             persistent_buffer_size_info.projected_persistent_buffer_size);
 
   const int64_t device_multiprocessor_count =
-      (int64_t)device_prop->multiProcessorCount;
+      target_device.multi_processor_count;
 
   const auto available_persistent_buffer_size =
       sm_register_file_size * device_multiprocessor_count;
@@ -192,7 +192,7 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
   }
 
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)device_prop->maxThreadsPerMultiProcessor;
+      target_device.max_threads_per_multi_processor;
   const int64_t min_fraction_of_sms =
       scheduler_utils::safeDiv(device_multiprocessor_count, 8);
   if (properties.total_reduction_numel >=
@@ -231,7 +231,7 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
            (vectorization_factor * cross_grid_params->launch_params.bdimx() *
             cross_grid_params->launch_params.gdimx()) !=
        0) &&
-      device_prop->major == 7) {
+      target_device.major == 7) {
     scheduler_debug_utils::canScheduleRejectReason(
         heuristicType(), "iteration not evenly divided");
     return false;
@@ -362,6 +362,7 @@ std::shared_ptr<ReductionParams> gridOuterPersistentHeuristic(
 // grid reductions.
 // TODO: Check adding iteration domain unrolling
 std::shared_ptr<ReductionParams> outerPersistentHeuristic(
+    const TargetDeviceDescriptor& target_device,
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
     const int64_t n_tensor_inputs,
@@ -370,22 +371,21 @@ std::shared_ptr<ReductionParams> outerPersistentHeuristic(
     const size_t vectorize_factor) {
   // Set some targets for parallelization
   const int64_t n_elems = total_reduction_numel * total_iteration_numel;
-  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
 
   const int64_t device_multiprocessor_count =
-      (int64_t)dev_prop->multiProcessorCount;
+      target_device.multi_processor_count;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
   // dim going a bit smaller than 32 usually helps.
-  const int64_t warp_size =
-      n_elems * max_input_dtype_size * n_tensor_inputs < dev_prop->l2CacheSize
+  const int64_t warp_size = n_elems * max_input_dtype_size * n_tensor_inputs <
+          target_device.l2_cache_size
       ? (int64_t)32 / max_input_dtype_size
       : 16;
 
   const auto register_file_size =
-      dev_prop->regsPerBlock * scheduler_utils::bytes_per_register;
-  const int64_t device_warp_size = (int64_t)dev_prop->warpSize;
+      target_device.regs_per_block * scheduler_utils::bytes_per_register;
+  const int64_t device_warp_size = target_device.warp_size;
 
   // Each block runs N reductions, where N is defined as:
   // vectorize_factor * blockDim.x. The minimum number of SMs to run
@@ -640,6 +640,7 @@ std::shared_ptr<ReductionParams> getOuterPersistentHeuristics(
           OuterPersistentKernelScheduler::heuristicType());
 
   std::shared_ptr<ReductionParams> rparams = outerPersistentHeuristic(
+      runtime_info.targetDevice(),
       prop.total_reduction_numel,
       prop.total_iteration_numel,
       prop.n_tensor_inputs,
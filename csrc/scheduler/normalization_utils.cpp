@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <device_descriptor.h>
 #include <expr_evaluator.h>
 #include <grouped_reduction.h>
 #include <instrumentation.h>
@@ -64,8 +65,7 @@ bool PreferredLaunchConfig::setBdimx(int bdimx, bool dry_run) {
 // 36), (2, 54)].
 void PreferredLaunchConfig::initValidGdims() {
   std::vector<std::pair<int, int>> grid_dims;
-  const int num_sms =
-      at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int num_sms = (int)getTargetDevice()->multi_processor_count;
   const int max_first_half =
       static_cast<int>(std::sqrt(static_cast<float>(num_sms)));
   for (int gdimy = 2; gdimy <= max_first_half; ++gdimy) {
@@ -458,9 +458,8 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
     int64_t adjusted_gdimy = -1;
     int64_t adjusted_buffer_size = -1;
     bool last_block_work_reduced = false;
-    const auto major_ver = at::cuda::getCurrentDeviceProperties()->major;
-    const auto minor_ver = at::cuda::getCurrentDeviceProperties()->minor;
-    if (major_ver == 7 && minor_ver == 5) {
+    const auto target_device = getTargetDevice();
+    if (target_device->major == 7 && target_device->minor == 5) {
       adjusted_gdimy = launch_cfg.gdimy();
       adjusted_buffer_size = getMinPersistentBufferSize(
           total_reduction_numel, launch_cfg.bdimy(), launch_cfg.gdimy());
@@ -184,8 +184,9 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
 
   NVF_ERROR(largest_out != nullptr);
 
+  const auto& target_device = runtime_info.targetDevice();
   const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+      target_device.multi_processor_count;
 
   // TODO: Set to 1?
   int64_t max_input_dtype_size = 2;
@@ -388,15 +389,14 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
         // Need to be able to parallelize, don't use break if there's not
         // at least an unrolled warp.
         if (ceilDiv(cur_right_elem_count, max_unroll_factor) <=
-            at::cuda::getCurrentDeviceProperties()->warpSize) {
+            target_device.warp_size) {
           continue;
         }
 
         // If outer broadcast, or balanced broadcast:
         if (lhs_byte_multiple <= rhs_byte_multiple &&
             // If right transfer size is bigger than half of L2
-            at::cuda::getCurrentDeviceProperties()->l2CacheSize <
-                right_transfer_size * 2) {
+            target_device.l2_cache_size < right_transfer_size * 2) {
           // flip BIDx and BIDy bindings
           flip_grid_binding = true;
         } else {
@@ -61,6 +61,7 @@ void reduceProductTo(int64_t& z, int64_t& y, int64_t& x, const int64_t max) {
 }
 
 std::shared_ptr<ReductionParams> innerReductionHeuristic(
+    const TargetDeviceDescriptor& target_device,
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
     const int64_t inner_most_dimension_numel,
@@ -71,14 +72,11 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
 
   const int64_t n_elems = total_reduction_numel * total_iteration_numel;
 
-  // WARNING: At some point we may want to generate heuristics for another
-  // device that is not the current device.
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      target_device.max_threads_per_multi_processor;
 
   const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+      target_device.multi_processor_count;
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -97,7 +95,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
   // we can use a smaller warp size. While thread local data fits in l1, and
   // reduction dim is really small, we can use <32 threads per warp.
   const bool fits_in_l2 = n_elems * max_input_dtype_size * n_tensor_inputs <
-      at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+      target_device.l2_cache_size;
 
   // If it fits in l2, we just want to make sure each warp uses 32Bytes. Set
   // minimum warp as 16 threads instead of 32 as if we have a small reduction
@@ -382,9 +380,8 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
   rparams->block_dim_inner_reduction = ParallelType::TIDx;
   rparams->cross_grid_inner_reduction = gridim > 1;
   rparams->multiple_reds_per_blk = bdimy > 1;
-  bool pad_bdimx = bdimx > 16 &&
-      bdimx * bdimy <
-          (int64_t)at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock;
+  bool pad_bdimx =
+      bdimx > 16 && bdimx * bdimy < target_device.max_threads_per_block;
   // If barely just covering reduction dim, don't pad to the next warp
   pad_bdimx = pad_bdimx &&
       bdimx * inner_reduction_unroll_factor != inner_most_dimension_numel;
@@ -392,8 +389,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
 
   if (rparams->pad_inner_reduction_to_warp) {
     // Adjust bdimx based on padding
-    auto min_warp_size =
-        (int64_t)at::cuda::getCurrentDeviceProperties()->warpSize;
+    auto min_warp_size = target_device.warp_size;
     bdimx = bdimx % min_warp_size == 0
         ? bdimx
         : bdimx + min_warp_size - bdimx % min_warp_size;
@@ -493,6 +489,7 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
                 << rparams->cross_grid_inner_reduction << std::endl;
       }
       return innerReductionHeuristic(
+          target_device,
           total_reduction_numel,
           total_iteration_numel,
           total_reduction_numel,
@@ -506,18 +503,17 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
 }
 
 std::shared_ptr<ReductionParams> outerReductionHeuristic(
+    const TargetDeviceDescriptor& target_device,
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
     const int64_t n_tensor_inputs,
     const int64_t max_input_dtype_size,
     const size_t vectorize_factor) {
-  // WARNING: Current device for codegen may not be the target device
   const int64_t device_max_threads_per_multiprocessor =
-      (int64_t)at::cuda::getCurrentDeviceProperties()
-          ->maxThreadsPerMultiProcessor;
+      target_device.max_threads_per_multi_processor;
 
   const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+      target_device.multi_processor_count;
 
   auto const max_unroll = ceilDiv(
       // Available unrolling based on size of data type
@@ -535,7 +531,7 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
   // TODO: Could get a much more accurate estimation of it the problem fits in
   // L2
   const bool fits_in_l2 = n_elems * max_input_dtype_size * n_tensor_inputs <
-      at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+      target_device.l2_cache_size;
 
   const int64_t min_warp_size = fits_in_l2 ? 16 : 32;
 
@@ -1016,6 +1012,7 @@ bool ReductionScheduler::canScheduleRunTime(
 }
 
 std::shared_ptr<ReductionParams> reductionHeuristic(
+    const TargetDeviceDescriptor& target_device,
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
     const int64_t inner_most_dimension_numel,
@@ -1025,6 +1022,7 @@ std::shared_ptr<ReductionParams> reductionHeuristic(
     const size_t vectorize_factor) {
   if (fastest_dim_reduction) {
     return innerReductionHeuristic(
+        target_device,
         total_reduction_numel,
         total_iteration_numel,
         inner_most_dimension_numel,
@@ -1034,6 +1032,7 @@ std::shared_ptr<ReductionParams> reductionHeuristic(
   } else {
     // 3D schedules not enabled for outer reductions
     return outerReductionHeuristic(
+        target_device,
         total_reduction_numel,
         total_iteration_numel,
         (int64_t)n_tensor_inputs,
@@ -1133,6 +1132,7 @@ std::shared_ptr<ReductionParams> getReductionHeuristics(
   n_tensor_inputs = std::max(n_tensor_inputs, 1l);
 
   auto heuristic = reductionHeuristic(
+      runtime_info.targetDevice(),
       properties.total_reduction_numel,
       properties.total_iteration_numel,
       properties.inner_most_dimension_numel,
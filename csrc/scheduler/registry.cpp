@@ -7,7 +7,10 @@
 // clang-format on
 #include <ATen/cuda/CUDAContext.h>
 #include <executor_utils.h>
+#include <instrumentation.h>
+#include <options.h>
 #include <scheduler/all_schedulers.h>
+#include <scheduler/autotune.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/matmul_utils.h>
 #include <scheduler/registry.h>
@@ -22,8 +25,12 @@ SchedulerRuntimeInfo::SchedulerRuntimeInfo(
     KernelArgumentHolder args,
     PrecomputedValues* precomputed_values,
     const std::vector<TensorView*>& all_tvs,
-    std::optional<PrimDataType> forced_index_type)
-    : complete_fusion_(complete_fusion) {
+    std::optional<PrimDataType> forced_index_type,
+    std::shared_ptr<const TargetDeviceDescriptor> target_device)
+    : complete_fusion_(complete_fusion),
+      target_device_(
+          target_device != nullptr ? std::move(target_device)
+                                   : getTargetDevice()) {
   NVF_ERROR(
       complete_fusion_->inputs().size() == args.size(),
       "The provided fusion group expects ",
@@ -149,6 +156,9 @@ bool checkCanSchedule(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
     HeuristicSummary* data_cache = nullptr) {
+  static const std::string scope_name =
+      "canSchedule " + toString(SchedulerType::heuristicType());
+  FUSER_PERF_SCOPE(scope_name.c_str());
   FusionGuard fg(fusion);
   // If a data cache is given, the compile time part doesn't need to be checked,
   // since for all current use cases
@@ -218,6 +228,7 @@ std::unique_ptr<SchedulerEntry> SchedulerEntry::makeEntry(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
     HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("SchedulerEntry::makeEntry");
   std::unique_ptr<SchedulerEntry> scheduler_entry = nullptr;
   switch (sh) {
     case ScheduleHeuristic::NoOp:
@@ -256,6 +267,24 @@ std::unique_ptr<SchedulerEntry> SchedulerEntry::makeEntry(
       NVF_ERROR(false, "unreachable");
   }
 
+  if (isOptionEnabled(EnableOption::Autotune) && isTunable(sh)) {
+    SchedulerEntry* entry = scheduler_entry.get();
+    const auto analytic = entry->params_;
+    entry->params_ = autotuneHeuristicParams(
+        sh,
+        fusion,
+        runtime_info,
+        analytic,
+        [entry, &analytic](
+            Fusion* fusion_copy,
+            const std::shared_ptr<HeuristicParams>& params) {
+          // Candidates are scheduled by this entry with its params swapped
+          entry->params_ = params;
+          entry->schedule(fusion_copy);
+          entry->params_ = analytic;
+        });
+  }
+
   return scheduler_entry;
 }
 
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #pragma once
+#include <device_descriptor.h>
 #include <exceptions.h>
 #include <executor_kernel_arg.h>
 #include <expr_evaluator.h>
@@ -50,12 +51,18 @@ class SchedulerRuntimeInfo : public NonCopyable {
   //! The index type of forced_index_type is used if given, no matter
   //! how large the actual arguments and fusion tensors
   //! are. CORRECTNESS IS NOT GUARANTEED.
+  //!
+  //! Heuristics are computed for target_device, which defaults to
+  //! getTargetDevice(). Scheduler utilities that are not given a
+  //! SchedulerRuntimeInfo use getTargetDevice(), so use TargetDeviceGuard
+  //! to compile a whole fusion for another device.
   SchedulerRuntimeInfo(
       Fusion* complete_fusion,
       KernelArgumentHolder args,
       PrecomputedValues* precomputed_values = nullptr,
       const std::vector<TensorView*>& all_tvs = {},
-      std::optional<PrimDataType> forced_index_type = std::nullopt);
+      std::optional<PrimDataType> forced_index_type = std::nullopt,
+      std::shared_ptr<const TargetDeviceDescriptor> target_device = nullptr);
 
   SchedulerRuntimeInfo(
       Fusion* complete_fusion,
@@ -81,6 +88,11 @@ class SchedulerRuntimeInfo : public NonCopyable {
     return complete_fusion_;
   }
 
+  //! The device heuristics are computed for
+  const TargetDeviceDescriptor& targetDevice() const {
+    return *target_device_;
+  }
+
   ExpressionEvaluator& expressionEvaluator() {
     NVF_ERROR(expression_evaluator_ != nullptr);
     return *expression_evaluator_;
@@ -123,6 +135,8 @@ class SchedulerRuntimeInfo : public NonCopyable {
   // Found index mode kernel needs to be run in
   PrimDataType index_type_ = PrimDataType::Int;
 
+  std::shared_ptr<const TargetDeviceDescriptor> target_device_;
+
   // TODO: Remove
   std::unordered_map<TensorView*, size_t> vectorword_map_;
 };
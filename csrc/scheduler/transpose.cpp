@@ -698,7 +698,7 @@ std::string getTransposeRuntimeRejectReason(
 
   // don't schedule with transpose scheduler if less than a full wave
   const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+      runtime_info.targetDevice().multi_processor_count;
   auto elements_per_wave = device_multiprocessor_count * default_tile_elements;
   if ((int64_t)elements_per_wave > n_elems) {
     return "Transpose scheduler does not perform well on small problem sizes.";
@@ -834,7 +834,7 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
   auto& n_elems = pair.second;
 
   const int64_t device_multiprocessor_count =
-      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+      runtime_info.targetDevice().multi_processor_count;
 
   auto innermost_info_entry = getInnerMostDimInfoInReference(
       data_cache, reference_tensors, reference1, domain_map);
@@ -37,7 +37,7 @@ nvfuser::PolymorphicValue deserializePolymorphicValue(const Scalar* c);
 
 flatbuffers::Offset<PolymorphicValue> serializePolymorphicValue(
     flatbuffers::FlatBufferBuilder& builder,
-    std::shared_ptr<nvfuser::PolymorphicValue> v);
+    const nvfuser::PolymorphicValue& v);
 
 flatbuffers::Offset<Scalar> serializeScalarCpu(
     flatbuffers::FlatBufferBuilder& builder,
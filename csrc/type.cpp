@@ -13,6 +13,7 @@
 #include <stdexcept>
 #include <unordered_map>
 
+#include <device_descriptor.h>
 #include <ir/all_nodes.h>
 #include <tensor_metadata.h>
 
@@ -159,8 +160,7 @@ DataType getComplexTypeFromType(DataType dtype) {
 }
 
 bool isSupportedTypeByDevice(DataType dtype) {
-  auto prop = at::cuda::getCurrentDeviceProperties();
-  auto major_ver = prop->major;
+  auto major_ver = getTargetDevice()->major;
   if (dtype == DataType::BFloat16) {
     return major_ver >= 8;
   }
@@ -9,6 +9,7 @@
 #include <c10/util/string_view.h>
 #include <cuda_occupancy.h>
 #include <debug.h>
+#include <device_descriptor.h>
 #include <options.h>
 #include <utils.h>
 
@@ -170,11 +171,11 @@ std::vector<int64_t> getTensorSizes(at::TensorTypePtr const& tensor_type) {
 int64_t getRegPerThreadGivenThreadsPerSM(int64_t threads_per_sm) {
   int num_partition = 0;
   int reg_allocation_granularity = 0;
-  const auto prop = at::cuda::getCurrentDeviceProperties();
-  cudaOccDeviceProp occ_prop(*prop);
+  const cudaDeviceProp prop = getTargetDevice()->toDeviceProperties();
+  cudaOccDeviceProp occ_prop(prop);
   cudaOccSubPartitionsPerMultiprocessor(&num_partition, &occ_prop);
   cudaOccRegAllocationGranularity(&reg_allocation_granularity, &occ_prop);
-  int warp_size = prop->warpSize;
+  int warp_size = prop.warpSize;
   int num_warps = (int)ceilDiv(threads_per_sm, warp_size);
 
   // warps could be distributed unevenly across partition
@@ -182,7 +183,7 @@ int64_t getRegPerThreadGivenThreadsPerSM(int64_t threads_per_sm) {
   // registers are evenly distributed across partitions, partition with most
   // wraps determins the maximum register available per warp
   int max_reg_per_warp =
-      prop->regsPerBlock / num_partition / max_warps_per_sm_partition;
+      prop.regsPerBlock / num_partition / max_warps_per_sm_partition;
   // clamp down to register allocation granularity at warp level
   int effective_max_reg_per_warp = max_reg_per_warp /
       reg_allocation_granularity * reg_allocation_granularity;
@@ -192,17 +193,17 @@ int64_t getRegPerThreadGivenThreadsPerSM(int64_t threads_per_sm) {
 int64_t getThreadsPerSMGivenRegPerThread(int64_t reg_per_thread) {
   int num_partition = 0;
   int reg_allocation_granularity = 0;
-  const auto prop = at::cuda::getCurrentDeviceProperties();
-  cudaOccDeviceProp occ_prop(*prop);
+  const cudaDeviceProp prop = getTargetDevice()->toDeviceProperties();
+  cudaOccDeviceProp occ_prop(prop);
   cudaOccSubPartitionsPerMultiprocessor(&num_partition, &occ_prop);
   cudaOccRegAllocationGranularity(&reg_allocation_granularity, &occ_prop);
-  int warp_size = prop->warpSize;
+  int warp_size = prop.warpSize;
 
   int reg_per_warp =
       (int)ceilDiv(reg_per_thread * warp_size, reg_allocation_granularity) *
       reg_allocation_granularity;
   int warps_per_sm_partition =
-      prop->regsPerBlock / reg_per_warp / num_partition;
+      prop.regsPerBlock / reg_per_warp / num_partition;
   int num_warps = warps_per_sm_partition * num_partition;
   return num_warps * static_cast<int64_t>(warp_size);
 }
@@ -65,22 +65,20 @@ bool ValGraph::hasGroup(Val* val) const {
 }
 
 const ExprGroup& ValGraph::toGroup(Expr* expr) const {
-  auto disjoint_set_it = disjoint_exprs_.disjointSetMap().find(expr);
   NVF_ERROR(
-      disjoint_set_it != disjoint_exprs_.disjointSetMap().end(),
+      disjoint_exprs_.mappingExists(expr),
       "\nExpr group could not be found in graph associated with: ",
       expr->toString());
-  return disjoint_set_it->second;
+  return disjoint_exprs_.disjointSetOf(expr);
 }
 
 const ValGroup& ValGraph::toGroup(Val* val) const {
-  auto disjoint_set_it = disjoint_vals_.disjointSetMap().find(val);
   NVF_ERROR(
-      disjoint_set_it != disjoint_vals_.disjointSetMap().end(),
+      disjoint_vals_.mappingExists(val),
       "\nId group could not be found in graph associated with: ",
       val->toString(),
       "\n");
-  return disjoint_set_it->second;
+  return disjoint_vals_.disjointSetOf(val);
 }
 
 std::vector<ValGroup> ValGraph::outputGroups(const ExprGroup& expr) const {
@@ -183,8 +181,8 @@ void ValGraph::initializeVal(
     Val* val,
     const VectorOfUniqueEntries<Expr*>& definitions,
     const VectorOfUniqueEntries<Expr*>& uses) {
-  const ValGroup& val_disjoint_set =
-      disjointValSets().initializeSet(val).first->second;
+  disjointValSets().initializeSet(val);
+  ValGroup val_disjoint_set = toGroup(val);
 
   // For now, the definition of a val should be unique. Remove this
   // assertion as necessary
@@ -192,9 +190,8 @@ void ValGraph::initializeVal(
 
   ExprGroups def_groups;
   for (auto def : definitions) {
-    const ExprGroup& expr_set =
-        disjointExprSets().initializeSet(def).first->second;
-    def_groups.pushBack(expr_set);
+    disjointExprSets().initializeSet(def);
+    def_groups.pushBack(toGroup(def));
   }
   // TODO-NM: def_groups can be empty. Should it be still mapped?
   NVF_ERROR(
@@ -204,9 +201,8 @@ void ValGraph::initializeVal(
 
   ExprGroups use_groups;
   for (auto use : uses) {
-    const ExprGroup& expr_set =
-        disjointExprSets().initializeSet(use).first->second;
-    use_groups.pushBack(expr_set);
+    disjointExprSets().initializeSet(use);
+    use_groups.pushBack(toGroup(use));
   }
   // TODO-NM: use_groups can be empty. Should it be still mapped?
   NVF_ERROR(
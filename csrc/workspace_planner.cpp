@@ -0,0 +1,95 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <exceptions.h>
+#include <workspace_planner.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace nvfuser {
+
+WorkspaceLayout layoutWorkspace(
+    const std::vector<WorkspaceBuffer>& buffers,
+    int64_t alignment) {
+  NVF_ERROR(
+      alignment > 0 && (alignment & (alignment - 1)) == 0,
+      "Workspace alignment must be a power of two: ",
+      alignment);
+  auto align = [alignment](int64_t size) {
+    return (size + alignment - 1) & ~(alignment - 1);
+  };
+
+  WorkspaceLayout layout;
+  layout.offsets.resize(buffers.size(), 0);
+
+  // Place large buffers first: they are the hardest to fit in a gap. Ties
+  // are broken by the order the buffers were given to keep the result
+  // deterministic.
+  std::vector<size_t> order(buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return buffers[a].size > buffers[b].size;
+  });
+
+  // (offset, aligned size) of placed buffers live at the same time as the
+  // buffer being placed
+  std::vector<std::pair<int64_t, int64_t>> conflicts;
+  std::vector<size_t> placed;
+  placed.reserve(buffers.size());
+  for (auto i : order) {
+    const auto& buffer = buffers[i];
+    NVF_ERROR(
+        buffer.size >= 0 && buffer.first_use <= buffer.last_use,
+        "Invalid workspace buffer: size ",
+        buffer.size,
+        ", live range [",
+        buffer.first_use,
+        ", ",
+        buffer.last_use,
+        "]");
+    const int64_t size = align(buffer.size);
+    layout.total_buffer_size += size;
+
+    conflicts.clear();
+    for (auto j : placed) {
+      const auto& other = buffers[j];
+      if (other.first_use <= buffer.last_use &&
+          buffer.first_use <= other.last_use) {
+        conflicts.emplace_back(layout.offsets[j], align(other.size));
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+
+    // Best fit: the smallest gap between conflicting buffers that can hold
+    // this one. Falls back to the end of the conflicting buffers.
+    int64_t best_offset = -1;
+    int64_t best_gap = std::numeric_limits<int64_t>::max();
+    int64_t end = 0;
+    for (const auto& [offset, other_size] : conflicts) {
+      const int64_t gap = offset - end;
+      if (gap >= size && gap < best_gap) {
+        best_offset = end;
+        best_gap = gap;
+      }
+      end = std::max(end, offset + other_size);
+    }
+    if (best_offset < 0) {
+      best_offset = end;
+    }
+
+    layout.offsets[i] = best_offset;
+    layout.size = std::max(layout.size, best_offset + size);
+    placed.push_back(i);
+  }
+  return layout;
+}
+
+} // namespace nvfuser
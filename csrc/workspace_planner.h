@@ -0,0 +1,48 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace nvfuser {
+
+//! A buffer to be placed in a workspace. The buffer is live from step
+//! first_use to step last_use, both inclusive. A step is typically the index
+//! of a segment in the run order of a segmented fusion.
+struct WorkspaceBuffer {
+  int64_t size = 0;
+  int64_t first_use = 0;
+  int64_t last_use = 0;
+};
+
+//! Result of layoutWorkspace.
+struct WorkspaceLayout {
+  //! Byte offset of each buffer in the workspace, in the order the buffers
+  //! were given
+  std::vector<int64_t> offsets;
+  //! Size of the workspace, i.e. the peak memory needed by the buffers
+  int64_t size = 0;
+  //! Sum of the aligned sizes of all buffers, i.e. the memory needed if no
+  //! memory were reused
+  int64_t total_buffer_size = 0;
+};
+
+//! Statically assigns offsets to buffers with known sizes and live ranges so
+//! that buffers that are live at the same step never overlap, while buffers
+//! with disjoint live ranges may share memory. Offsets are multiples of
+//! alignment, which must be a power of two.
+//!
+//! Buffers are placed largest first. Each buffer goes into the smallest gap
+//! left between the already placed buffers it is live together with, or
+//! after all of them if no gap fits.
+WorkspaceLayout layoutWorkspace(
+    const std::vector<WorkspaceBuffer>& buffers,
+    int64_t alignment = 256);
+
+} // namespace nvfuser
@@ -0,0 +1,135 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+#include <benchmark/benchmark.h>
+
+#include <dynamic_type/dynamic_type.h>
+
+#include <complex>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace dynamic_type;
+
+// Evaluates a chain of arithmetic on values of mixed types, like the
+// expression evaluator of nvFuser does on PolymorphicValue. Binary operators
+// on two DynamicTypes look up the pair of types in a jump table. This is
+// compared with resolving the pair of types with two nested for_all_types
+// loops, which is a chain of type checks whose length grows with the square of
+// the number of types.
+
+// Reference dispatch of a binary operator with nested for_all_types loops
+template <typename DT, typename Op>
+DT applyByTypeChecks(const DT& x, const DT& y, Op op) {
+  DT ret(std::monostate{});
+  DT::for_all_types([&ret, &x, &y, &op](auto lhs) {
+    DT::for_all_types([&ret, &x, &y, &op, lhs](auto rhs) {
+      using LHS = typename decltype(lhs)::type;
+      using RHS = typename decltype(rhs)::type;
+      if constexpr (std::is_invocable_v<Op, LHS, RHS>) {
+        if constexpr (std::is_constructible_v<
+                          typename DT::VariantType,
+                          std::invoke_result_t<Op, LHS, RHS>>) {
+          if (x.template is<LHS>() && y.template is<RHS>()) {
+            ret = DT(op(x.template as<LHS>(), y.template as<RHS>()));
+          }
+        }
+      }
+    });
+  });
+  DYNAMIC_TYPE_CHECK(!ret.template is<std::monostate>(), "Cannot compute");
+  return ret;
+}
+
+constexpr auto add_fn = [](auto x, auto y) -> decltype(x + y) { return x + y; };
+constexpr auto mul_fn = [](auto x, auto y) -> decltype(x * y) { return x * y; };
+
+// Alternating int64_t and double values, so that every pair of types that is
+// added is mixed
+template <typename DT>
+std::vector<DT> getMixedValues(int64_t size) {
+  std::vector<DT> result;
+  result.reserve(size);
+  for (int64_t i = 0; i < size; ++i) {
+    if (i % 2 == 0) {
+      result.emplace_back((int64_t)(rand() % 100));
+    } else {
+      result.emplace_back((double)(rand() % 100) / 100.0);
+    }
+  }
+  return result;
+}
+
+static constexpr int64_t kNumValues = 4096;
+
+static void Arith_Native(benchmark::State& state) {
+  std::vector<double> values;
+  for (int64_t i = 0; i < kNumValues; ++i) {
+    values.push_back((double)(rand() % 100));
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (const auto& v : values) {
+      sum = sum + v * v;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues * 2);
+}
+
+template <bool use_type_checks, typename... Ts>
+void BenchmarkArith(benchmark::State& state) {
+  using DT = DynamicType<NoContainers, Ts...>;
+  const auto values = getMixedValues<DT>(kNumValues);
+  for (auto _ : state) {
+    DT sum = 0.0;
+    for (const auto& v : values) {
+      if constexpr (use_type_checks) {
+        sum = applyByTypeChecks(sum, applyByTypeChecks(v, v, mul_fn), add_fn);
+      } else {
+        sum = sum + v * v;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues * 2);
+}
+
+#define DEFINE_ARITH_BENCHMARK(name, ...)                         \
+  static void Arith_JumpTable_##name(benchmark::State& state) {   \
+    BenchmarkArith<false, __VA_ARGS__>(state);                    \
+  }                                                               \
+  static void Arith_TypeChecks_##name(benchmark::State& state) {  \
+    BenchmarkArith<true, __VA_ARGS__>(state);                     \
+  }                                                               \
+  BENCHMARK(Arith_JumpTable_##name);                              \
+  BENCHMARK(Arith_TypeChecks_##name)
+
+BENCHMARK(Arith_Native);
+DEFINE_ARITH_BENCHMARK(DynamicType2, int64_t, double);
+DEFINE_ARITH_BENCHMARK(DynamicType4, int64_t, double, bool, float);
+DEFINE_ARITH_BENCHMARK(
+    DynamicType6,
+    int64_t,
+    double,
+    bool,
+    float,
+    std::complex<double>,
+    int32_t);
+DEFINE_ARITH_BENCHMARK(
+    DynamicType8,
+    int64_t,
+    double,
+    bool,
+    float,
+    std::complex<double>,
+    int32_t,
+    float*,
+    std::string);
@@ -4,9 +4,19 @@
 # All rights reserved.
 # SPDX-License-Identifier: BSD-3-Clause
 
+# Results are also written to a CSV file, one line per compilation, so that
+# the compilation time can be tracked across changes to dynamic_type.h
+RESULTS=${RESULTS:-compilation-time.csv}
+echo "compiler,output,time_s,memory_kb" > $RESULTS
+
 timeit() {
     echo $@
-    /usr/bin/time --format="Time: %e s\nMemory: %M KB" $@
+    /usr/bin/time --output=time.txt --format="%e %M" $@
+    read seconds memory < time.txt
+    rm -f time.txt
+    echo "Time: $seconds s"
+    echo "Memory: $memory KB"
+    echo "$1,${@: -1},$seconds,$memory" >> $RESULTS
     echo ""
 }
 
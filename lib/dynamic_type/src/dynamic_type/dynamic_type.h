@@ -8,10 +8,13 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <optional>
 #include <ostream>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 #include <variant>
 
 #include "C++20/type_traits"
@@ -424,6 +427,54 @@ struct is_dynamic_type<DynamicType<Ts...>> : std::true_type {};
 template <typename T>
 constexpr bool is_dynamic_type_v = is_dynamic_type<T>::value;
 
+// A 2-D jump table, generated at compile time, to dispatch a binary operator
+// on two DynamicTypes. The entry at (i, j) computes the operator for the i-th
+// and j-th alternatives of the variant, or is nullptr if the operator is not
+// defined for them. Looking up the entry with the variant indices replaces a
+// chain of type checks over all pairs of types. Op must provide:
+//   template <typename DT, typename LHS, typename RHS>
+//   static constexpr bool defined();
+//   template <typename DT, typename LHS, typename RHS>
+//   static constexpr Ret apply(const DT& x, const DT& y);
+template <typename DT, typename Ret, typename Op>
+struct BinaryOpTable {
+  using VariantType = typename DT::VariantType;
+  using Entry = Ret (*)(const DT&, const DT&);
+  static constexpr std::size_t num_types = std::variant_size_v<VariantType>;
+
+  template <std::size_t I, std::size_t J>
+  static constexpr Entry entry() {
+    using LHS = std::variant_alternative_t<I, VariantType>;
+    using RHS = std::variant_alternative_t<J, VariantType>;
+    if constexpr (Op::template defined<DT, LHS, RHS>()) {
+      return &Op::template apply<DT, LHS, RHS>;
+    } else {
+      return nullptr;
+    }
+  }
+
+  template <std::size_t... Ks>
+  static constexpr std::array<Entry, sizeof...(Ks)> make(
+      std::index_sequence<Ks...>) {
+    return {{entry<Ks / num_types, Ks % num_types>()...}};
+  }
+
+  // Row-major: the entry for (i, j) is at i * num_types + j
+  static constexpr std::array<Entry, num_types * num_types> table =
+      make(std::make_index_sequence<num_types * num_types>{});
+
+  // Returns the entry for the types held by x and y
+  static constexpr Entry lookup(const DT& x, const DT& y) {
+    const std::size_t i = x.value.index();
+    const std::size_t j = y.value.index();
+    // The index is variant_npos if the variant is valueless by exception
+    if (i >= num_types || j >= num_types) {
+      return nullptr;
+    }
+    return table[i * num_types + j];
+  }
+};
+
 #define DEFINE_BINARY_OP(opname, op)                                       \
   /*TODO: we should inline the definition of lambdas into enable_if,*/     \
   /*but I can only do this in C++20 */                                     \
@@ -438,6 +489,17 @@ constexpr bool is_dynamic_type_v = is_dynamic_type<T>::value;
     }                                                                      \
     return false;                                                          \
   };                                                                       \
+  struct opname##_binary_op {                                              \
+    template <typename DT, typename LHS, typename RHS>                     \
+    static constexpr bool defined() {                                      \
+      return opname##_defined_checker<typename DT::VariantType>(           \
+          std::type_identity<LHS>{}, std::type_identity<RHS>{});           \
+    }                                                                      \
+    template <typename DT, typename LHS, typename RHS>                     \
+    static constexpr DT apply(const DT& x, const DT& y) {                  \
+      return DT(x.template as<LHS>() op y.template as<RHS>());             \
+    }                                                                      \
+  };                                                                       \
   template <typename DT>                                                   \
   inline constexpr std::enable_if_t<                                       \
       is_dynamic_type_v<DT> &&                                             \
@@ -447,23 +509,9 @@ constexpr bool is_dynamic_type_v = is_dynamic_type<T>::value;
               DT::type_identities_as_tuple),                               \
       DT>                                                                  \
   operator op(const DT& x, const std::type_identity_t<DT>& y) {            \
-    DT ret(std::monostate{});                                              \
-    DT::for_all_types([&ret, &x, &y](auto lhs) {                           \
-      using LHS = typename decltype(lhs)::type;                            \
-      DT::for_all_types([&ret, &x, &y](auto rhs) {                         \
-        using RHS = typename decltype(rhs)::type;                          \
-        if constexpr ((opcheck<LHS> op opcheck<RHS>)) {                    \
-          if constexpr (std::is_constructible_v<                           \
-                            typename DT::VariantType,                      \
-                            decltype(std::declval<LHS>()                   \
-                                         op std::declval<RHS>())>) {       \
-            if (x.template is<LHS>() && y.template is<RHS>()) {            \
-              ret = DT(x.template as<LHS>() op y.template as<RHS>());      \
-            }                                                              \
-          }                                                                \
-        }                                                                  \
-      });                                                                  \
-    });                                                                    \
+    const auto entry =                                                     \
+        BinaryOpTable<DT, DT, opname##_binary_op>::lookup(x, y);           \
+    DT ret = entry == nullptr ? DT(std::monostate{}) : entry(x, y);        \
     DYNAMIC_TYPE_CHECK(                                                    \
         !ret.template is<std::monostate>(),                                \
         "Cannot compute ",                                                 \
@@ -53,6 +53,7 @@ class FusionDefinition(_C._FusionDefinition):
         device=None,
         override_user_schedule=False,
         capture_debug_output=False,
+        capture_compile_profile=False,
     ):
         """
         Executes an nvFuser set of kernels for a given Fusion
@@ -91,6 +92,12 @@ class FusionDefinition(_C._FusionDefinition):
                 debugging information as a string. If True, the string can be
                 retrieved after execution using :meth:`get_debug_output`. If False,
                 then that method will return None when called.
+            capture_compile_profile (bool): Whether to record a host time
+                profile of segmentation, scheduling, lowering and compilation
+                during execution. If True, the profile can be retrieved after
+                execution using :meth:`compile_profile` and
+                :meth:`compile_profile_trace`. It is nearly empty if the
+                fusion was already compiled for these inputs.
 
         Returns:
             List[Tensor]
@@ -125,6 +132,7 @@ class FusionDefinition(_C._FusionDefinition):
                 override_user_schedule,
                 device=device,
                 capture_debug_output=capture_debug_output,
+                capture_compile_profile=capture_compile_profile,
             )
         except Exception as err:
             msg = (
@@ -198,6 +206,37 @@ class FusionDefinition(_C._FusionDefinition):
         """
         return self._debug_output()
 
+    def compile_profile(self):
+        """
+        Retrieve the summary table of the host time profile recorded during the
+        previous execution.
+
+        Note that `capture_compile_profile=True` must be passed to `execute()`
+        in order to record the profile. Otherwise, this method will return
+        `None`.
+
+        Returns:
+            Optional[String] : the time, number of calls, IR statements created
+            and heap memory change of each profiled scope, aggregated by name
+            and sorted by decreasing total time.
+        """
+        return self._compile_profile()
+
+    def compile_profile_trace(self):
+        """
+        Retrieve the host time profile recorded during the previous execution
+        in the Chrome Tracing JSON format, which can be loaded in
+        `about://tracing` or Perfetto.
+
+        Note that `capture_compile_profile=True` must be passed to `execute()`
+        in order to record the profile. Otherwise, this method will return
+        `None`.
+
+        Returns:
+            Optional[String] : the profile as a JSON string
+        """
+        return self._compile_profile_trace()
+
     def from_pytorch(self, tensor, static_sizes=False):
         """
         Defines an nvfuser input tensor from a pytorch tensor and defaults
@@ -6,7 +6,9 @@
 from copy import deepcopy
 from functools import partial
 import itertools
+import json
 import math
+import os
 import random
 import re
 from typing import List, Callable
@@ -28,6 +30,7 @@ from nvfuser import (
     version,
     compute_contiguity,
     compute_tensor_descriptor,
+    batch_compile,
     serialize as nv_serialize,
 )
 from nvfuser.pytorch_utils import torch_dtype_to_nvfuser_dtype
@@ -1769,6 +1772,46 @@ class TestNvFuserFrontend(TestCase):
         # Erroneous cache hit based on fill value would use kernel1
         self.assertEqual(F.pad(inputs[0], [1, 1], "constant", 2.0), nvf_out3[0])
 
+    def test_serde_unused_fusions(self):
+        """Test that a deserialized FusionCache keeps the fusions it never ran.
+
+        Fusions of a deserialized FusionCache are only deserialized when they
+        are first used, so serializing it again must copy the serialized
+        tables of the others.
+        """
+        inputs = [
+            torch.randn(4, 4, device="cuda"),
+        ]
+
+        def fusion_func(fd: FusionDefinition):
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.ops.relu(t0)
+            fd.add_output(t1)
+
+        with FusionDefinition() as fd:
+            fusion_func(fd)
+        fd.execute(inputs)
+
+        fc = FusionCache.get()
+        num_fusions = fc.num_fusions()
+        with tempfile.NamedTemporaryFile() as tmp1:
+            fc.serialize(tmp1.name)
+            FusionCache.reset()
+            fc = FusionCache.get()
+            fc.deserialize(tmp1.name)
+        with tempfile.NamedTemporaryFile() as tmp2:
+            fc.serialize(tmp2.name)
+            FusionCache.reset()
+            fc = FusionCache.get()
+            fc.deserialize(tmp2.name)
+        self.assertEqual(fc.num_fusions(), num_fusions)
+
+        with FusionDefinition() as fd:
+            fusion_func(fd)
+        nvf_out = fd.execute(inputs)
+        self.assertEqual(fc.num_fusions(), num_fusions)
+        self.assertEqual(torch.relu(inputs[0]), nvf_out[0])
+
     def test_cat(self):
         inputs = [
             torch.randn(2, 4, device="cuda"),
@@ -2461,6 +2504,66 @@ class TestNvFuserFrontend(TestCase):
         out2 = fd.execute(inputs, capture_debug_output=True)
         self.assertIsNotNone(fd.debug_output())
 
+    def test_compile_profile(self):
+        inputs = [
+            torch.randn((5, 7), dtype=torch.float32, device="cuda:0"),
+        ]
+
+        with FusionDefinition() as fd:
+            T0 = fd.from_pytorch(inputs[0])
+            T1 = fd.ops.sum(T0, axes=[1])
+            fd.add_output(T1)
+
+        fd.execute(inputs)
+        self.assertIsNone(fd.compile_profile())
+        self.assertIsNone(fd.compile_profile_trace())
+
+        # The profile is nearly empty when nothing is compiled, but is still
+        # valid
+        fd.execute(inputs, capture_compile_profile=True)
+        self.assertIn("Compile profile", fd.compile_profile())
+        trace = json.loads(fd.compile_profile_trace())
+        self.assertIn("traceEvents", trace)
+
+    def test_batch_compile(self):
+        inputs = [
+            torch.randn((4, 6), dtype=torch.float32, device="cuda:0"),
+            2.0,
+        ]
+
+        with FusionDefinition() as fd:
+            T0 = fd.from_pytorch(inputs[0])
+            S1 = fd.define_scalar()
+            T2 = fd.ops.mul(T0, S1)
+            T3 = fd.ops.sum(T2, axes=[0])
+            fd.add_output(T3)
+
+        # Large enough for the reduction heuristics to differ from the ones of
+        # the first input set, so that the runtime can't be reused
+        other_inputs = [
+            torch.randn((16384, 1024), dtype=torch.float32, device="cuda:0"),
+            3.0,
+        ]
+        with tempfile.TemporaryDirectory() as output_dir:
+            results = batch_compile(
+                [(fd.id(), [inputs, other_inputs])], output_dir=output_dir
+            )
+            self.assertEqual(len(results), 1)
+            self.assertEqual(results[0]["fusion_id"], fd.id())
+            self.assertIsNone(results[0]["error"])
+            self.assertEqual(results[0]["num_compiled"], 2)
+            self.assertGreater(results[0]["num_kernels"], 0)
+            self.assertGreater(len(results[0]["files"]), 0)
+            for path in results[0]["files"]:
+                self.assertTrue(os.path.isfile(path))
+
+        # Both input sets are now compiled
+        results = batch_compile([(fd.id(), [inputs, other_inputs])])
+        self.assertEqual(results[0]["num_compiled"], 0)
+
+        nvf_out = fd.execute(inputs)
+        self.assertEqual(nvf_out[0], (inputs[0] * inputs[1]).sum(0))
+
     # Test that deterministic random ops (uniform, normal) give same results as
     # their stochastic versions
     def test_deterministic_random(self):
@@ -41,12 +41,14 @@ void MultiDeviceEnvironment::TearDown() {
 void MultiDeviceTest::SetUp() {
   NVFuserTest::SetUp();
   communicator = multidevice_env->communicator();
-  if (!communicator->is_available() || communicator->size() < 2 ||
-      torch::cuda::device_count() < 2) {
+  if (!communicator->is_available() || communicator->size() < 2) {
+    GTEST_SKIP() << "This test needs at least 2 ranks";
+  }
+  if (usesGpus() && torch::cuda::device_count() < 2) {
     GTEST_SKIP() << "This test needs at least 2 GPUs and 2 ranks";
   }
-  tensor_options =
-      at::TensorOptions().dtype(at::kFloat).device(communicator->device());
+  tensor_options = at::TensorOptions().dtype(at::kFloat).device(
+      usesGpus() ? communicator->device() : at::Device(at::kCPU));
   debug_print = multidevice_env->debugPrint();
   do_barrier_at_test = multidevice_env->doBarrierAtTest();
 }
@@ -269,7 +271,9 @@ void executeAndValidatePipeline(
     Pipeline& pipeline,
     std::vector<c10::IValue>& inputs,
     Communicator* communicator,
-    bool print) {
+    bool print,
+    const MicroBatchParams& micro_batch_params = {},
+    PipelineTimings* timings = nullptr) {
   if (print && !communicator->deviceId()) {
     fusion_ptr->printKernel();
     std::cout << pipeline.toString() << std::endl;
@@ -281,7 +285,11 @@ void executeAndValidatePipeline(
     GTEST_SKIP() << error_msg;
   }
 
+  runtime.setMicroBatchParams(micro_batch_params);
   auto outputs = runtime.runWithInput(inputs);
+  if (timings != nullptr) {
+    *timings = runtime.lastRunTimings();
+  }
 
   if (print) {
     std::stringstream ss;
@@ -308,7 +316,13 @@ void PipelineTest::SetUp() {
 
 void PipelineTest::validate() {
   executeAndValidatePipeline(
-      std::move(fusion), *pipeline, inputs, communicator, debug_print);
+      std::move(fusion),
+      *pipeline,
+      inputs,
+      communicator,
+      debug_print,
+      micro_batch_params,
+      &timings);
 }
 
 void PipelineTestTwoStages::SetUp() {
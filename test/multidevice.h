@@ -43,6 +43,10 @@ class MultiDeviceTest : public NVFuserTest {
  protected:
   void SetUp() override;
   void TearDown() override;
+  // Whether the test runs on GPUs. Otherwise, tensor_options is on CPU.
+  virtual bool usesGpus() const {
+    return true;
+  }
   Communicator* communicator;
   c10::TensorOptions tensor_options;
   bool debug_print;
@@ -54,6 +58,10 @@ class CommunicationTest
       public ::testing::WithParamInterface<CommunicatorBackend> {
  protected:
   void SetUp() override;
+  // Gloo is tested on CPU tensors
+  bool usesGpus() const override {
+    return GetParam() != CommunicatorBackend::gloo;
+  }
   void validate(at::Tensor obtained, at::Tensor expected);
   void resetDstBuffers();
   static constexpr DeviceIdxType root = 0;
@@ -72,6 +80,9 @@ class PipelineTest : public MultiDeviceTest {
   std::unique_ptr<Pipeline> pipeline;
   std::unique_ptr<Fusion> fusion;
   std::vector<c10::IValue> inputs;
+  // Micro-batching of the run, and its timings if measured
+  MicroBatchParams micro_batch_params;
+  PipelineTimings timings;
 };
 
 //(first stage's mesh, second stage's mesh, is first stage sharded, is second
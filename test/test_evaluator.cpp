@@ -12,9 +12,12 @@
 
 #include <test/utils.h>
 
+#include <evaluator_common.h>
+#include <executor_kernel_arg.h>
 #include <expr_evaluator.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
+#include <options.h>
 
 namespace nvfuser {
 
@@ -656,4 +659,116 @@ TEST_F(ExprEvalTest, Reshape_MergeBroadcast) {
   EXPECT_THAT(out_tensor.strides(), ElementsAre(1));
 }
 
+// Evaluate the same extents with the typed and the generic value machine and
+// check both against ExpressionEvaluator, re-binding the inputs in between.
+TEST_F(ExprEvalTest, ValueMachine_TypedVsGeneric) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto* a = IrBuilder::create<Val>(DataType::Int);
+  auto* b = IrBuilder::create<Val>(DataType::Int);
+  auto* c = IrBuilder::create<Val>(DataType::Double);
+  fusion.addInput(a);
+  fusion.addInput(b);
+  fusion.addInput(c);
+
+  // e4 is computed by a generic instruction reading typed registers
+  std::vector<Val*> shape = {
+      add(ceilDiv(a, b), mod(a, b)),
+      where(lt(a, b), a, b),
+      max(mul(a, b), IrBuilder::create<Val>(3L)),
+      castOp(DataType::Int, mul(c, a))};
+  auto* tv = full(shape, IrBuilder::create<Val>(0.0), DataType::Float);
+  fusion.addOutput(tv);
+
+  PrecomputedValues typed_pv(&fusion);
+  std::unique_ptr<PrecomputedValues> generic_pv;
+  {
+    DisableOptionsGuard options_guard;
+    DisableOptionsGuard::getCurOptions().set(DisableOption::TypedValueMachine);
+    generic_pv = std::make_unique<PrecomputedValues>(&fusion);
+  }
+
+  auto check = [&](int64_t a_val, int64_t b_val, double c_val) {
+    auto args = KernelArgumentHolder::createKernelArgumentHolder(
+        {a_val, b_val, c_val});
+    typed_pv.bindInputs(args);
+    typed_pv.evaluate();
+    generic_pv->bindInputs(args);
+    generic_pv->evaluate();
+
+    ExpressionEvaluator evaluator;
+    evaluator.bind(a, a_val);
+    evaluator.bind(b, b_val);
+    evaluator.bind(c, c_val);
+
+    for (auto id : tv->getLeafDomain()) {
+      auto extent = id->extent();
+      auto expected = evaluator.evaluate(extent);
+      ASSERT_TRUE(expected.hasValue());
+      EXPECT_EQ(typed_pv.getMaybeValueFor(extent), expected)
+          << extent->toInlineString();
+      EXPECT_EQ(generic_pv->getMaybeValueFor(extent), expected)
+          << extent->toInlineString();
+    }
+  };
+
+  check(7, 3, 1.5);
+  check(2, 5, 2.0);
+  check(-9, 4, 0.5);
+}
+
+// An input whose runtime dtype does not match the one the typed program was
+// compiled for must fall back to the generic path instead of producing
+// garbage.
+TEST_F(ExprEvalTest, ValueMachine_InputDtypeMismatch) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto* a = IrBuilder::create<Val>(DataType::Int);
+  auto* b = IrBuilder::create<Val>(DataType::Int);
+  fusion.addInput(a);
+  fusion.addInput(b);
+
+  auto* tv = full(
+      {add(a, b), mul(a, b), max(a, b)},
+      IrBuilder::create<Val>(0.0),
+      DataType::Float);
+  fusion.addOutput(tv);
+
+  PrecomputedValues typed_pv(&fusion);
+  std::unique_ptr<PrecomputedValues> generic_pv;
+  {
+    DisableOptionsGuard options_guard;
+    DisableOptionsGuard::getCurOptions().set(DisableOption::TypedValueMachine);
+    generic_pv = std::make_unique<PrecomputedValues>(&fusion);
+  }
+
+  // Bind a double to the Int input a
+  auto args = KernelArgumentHolder::createKernelArgumentHolder({7.0, 3L});
+  typed_pv.bindInputs(args);
+  typed_pv.evaluate();
+  generic_pv->bindInputs(args);
+  generic_pv->evaluate();
+
+  const std::vector<int64_t> expected = {10, 21, 7};
+  const auto& leaf = tv->getLeafDomain();
+  ASSERT_EQ(leaf.size(), expected.size());
+  for (const auto i : c10::irange(leaf.size())) {
+    auto extent = leaf[i]->extent();
+    EXPECT_EQ(typed_pv.getMaybeValueFor(extent), expected[i]);
+    EXPECT_EQ(
+        typed_pv.getMaybeValueFor(extent),
+        generic_pv->getMaybeValueFor(extent));
+  }
+
+  // Re-binding well-typed inputs goes back to the typed path
+  args = KernelArgumentHolder::createKernelArgumentHolder({4L, 5L});
+  typed_pv.bindInputs(args);
+  typed_pv.evaluate();
+  EXPECT_EQ(typed_pv.getMaybeValueFor(leaf[0]->extent()), 9);
+  EXPECT_EQ(typed_pv.getMaybeValueFor(leaf[1]->extent()), 20);
+  EXPECT_EQ(typed_pv.getMaybeValueFor(leaf[2]->extent()), 5);
+}
+
 } // namespace nvfuser
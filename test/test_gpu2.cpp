@@ -1035,6 +1035,47 @@ TEST_F(NVFuserTest, FusionInputsIdLookup_CUDA) {
   NVF_CHECK(id_3_norecord.id == id_3_lookup_norecord.id);
 }
 
+TEST_F(NVFuserTest, FusionInputsIdLookupConcurrent_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<std::vector<c10::IValue>> input_sets;
+  for (auto i : c10::irange(4)) {
+    input_sets.push_back({at::randn({4 + i, 8}, options), (int64_t)i});
+  }
+
+  nvfuser::InputsIdLookup inputs_id_lookup;
+
+  // Hits and misses from several threads must agree on one id per input set
+  constexpr int64_t num_threads = 8;
+  std::vector<std::vector<size_t>> ids(
+      num_threads, std::vector<size_t>(input_sets.size()));
+  std::vector<std::thread> threads;
+  for (auto tid : c10::irange(num_threads)) {
+    threads.emplace_back([&, tid]() {
+      for (auto repeat : c10::irange(100)) {
+        (void)repeat;
+        for (auto i : c10::irange(input_sets.size())) {
+          auto ret = inputs_id_lookup.lookupId(input_sets[i], {1});
+          NVF_CHECK(!ret.eviction);
+          ids[tid][i] = ret.id;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  NVF_CHECK(inputs_id_lookup.size() == input_sets.size());
+  for (auto tid : c10::irange(num_threads)) {
+    NVF_CHECK(ids[tid] == ids[0]);
+  }
+
+  // A recorded int and bool with the same bits must not collide
+  auto id_int = inputs_id_lookup.lookupId({(int64_t)1}, {0});
+  auto id_bool = inputs_id_lookup.lookupId({true}, {0});
+  NVF_CHECK(id_int.id != id_bool.id);
+}
+
 TEST_F(NVFuserTest, FusionDisjointSet_CUDA) {
   DisjointSets<int> set;
 
@@ -1147,6 +1188,52 @@ TEST_F(NVFuserTest, FusionDisjointSet_CUDA) {
   }
 }
 
+// Sets are listed in the order they were created or last merged, and members
+// in the order they joined the set
+TEST_F(NVFuserTest, FusionDisjointSetOrder_CUDA) {
+  DisjointSets<int> sets;
+  for (auto i : c10::irange(6)) {
+    sets.initializeSet(i);
+  }
+  sets.mapEntries(4, 1);
+  sets.mapEntries(0, 5);
+  sets.mapEntries(3, 4);
+  sets.mapEntries(6, 6);
+
+  auto to_vectors = [](const DisjointSets<int>& sets) {
+    std::vector<std::vector<int>> vectors;
+    for (const auto& set : sets.disjointSets()) {
+      vectors.push_back(set->vector());
+    }
+    return vectors;
+  };
+  using Sets = std::vector<std::vector<int>>;
+  EXPECT_EQ(to_vectors(sets), Sets({{2}, {0, 5}, {3, 4, 1}, {6}}));
+  EXPECT_EQ(sets.size(), 4u);
+
+  // Unchanged sets keep their identity, merged ones get a new one
+  auto set_of_2 = sets.disjointSets().at(0);
+  auto set_of_0 = sets.disjointSets().at(1);
+  sets.mapEntries(5, 1);
+  EXPECT_EQ(sets.disjointSets().at(0), set_of_2);
+  EXPECT_NE(sets.disjointSets().at(1), set_of_0);
+  EXPECT_EQ(to_vectors(sets), Sets({{2}, {6}, {0, 5, 3, 4, 1}}));
+
+  // Erasing keeps the order of the remaining members
+  EXPECT_TRUE(sets.erase(5));
+  EXPECT_TRUE(sets.erase(2));
+  EXPECT_FALSE(sets.erase(2));
+  EXPECT_EQ(to_vectors(sets), Sets({{6}, {0, 3, 4, 1}}));
+  EXPECT_TRUE(sets.permissiveAreMapped(0, 1));
+  EXPECT_FALSE(sets.permissiveAreMapped(0, 5));
+
+  // Copies are independent of the original
+  DisjointSets<int> copy = sets;
+  copy.mapEntries(6, 0);
+  EXPECT_EQ(to_vectors(copy), Sets({{6, 0, 3, 4, 1}}));
+  EXPECT_EQ(to_vectors(sets), Sets({{6}, {0, 3, 4, 1}}));
+}
+
 TEST_F(NVFuserTest, FusionNonUniqueBroadcastSize_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
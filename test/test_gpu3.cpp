@@ -10,7 +10,9 @@
 #include <gtest/gtest.h>
 
 #include <codegen.h>
+#include <compile_profiler.h>
 #include <debug.h>
+#include <device_lower/analysis_scheduler.h>
 #include <device_lower/lower2device.h>
 #include <device_lower/pass/magic_zero.h>
 #include <disjoint_set.h>
@@ -39,6 +41,8 @@
 #include <test/validator.h>
 #include <transform_replay.h>
 #include <transform_rfactor.h>
+#include <utils.h>
+#include <workspace_planner.h>
 
 #include <torch/csrc/jit/api/function_impl.h>
 #include <torch/csrc/jit/codegen/cuda/interface.h>
@@ -51,6 +55,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <thread>
 #include <typeinfo>
@@ -8207,6 +8212,53 @@ TEST_F(NVFuserTest, FusionTestSegmenterHint_CUDA) {
       executor_cache.fusion(), outputs, {at_x}, {ref_out}, __LINE__, __FILE__);
 }
 
+// Segment fusions should only contain the statements of their group
+TEST_F(NVFuserTest, FusionSegmentLocalFusion_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = relu(tv0);
+  auto tv2 = sin(tv1);
+  auto tv3 = segment_set(tv2);
+  auto tv4 = neg(tv3);
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({32, 64}, options);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_TRUE(runtime->isSegmented());
+  auto segmented_fusion = runtime->fusionSegments();
+  for (auto group : segmented_fusion->groups()) {
+    auto segment = segmented_fusion->makeFusion(group);
+    auto segment_tvs = ir_utils::filterByType<TensorView>(segment->vals());
+    auto num_group_tvs = std::count_if(
+        segment_tvs.begin(),
+        segment_tvs.end(),
+        [](TensorView* tv) { return tv->definition() != nullptr; });
+    EXPECT_EQ(num_group_tvs, (int64_t)group->exprs().size());
+    EXPECT_LT(
+        segment->vals().size(),
+        segmented_fusion->completeFusion()->vals().size());
+
+    // Repeated calls hand out independent copies of the cached segment
+    auto segment_copy = segmented_fusion->makeFusion(group);
+    EXPECT_NE(segment.get(), segment_copy.get());
+    EXPECT_EQ(segment->vals().size(), segment_copy->vals().size());
+  }
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0},
+      {t0.relu().sin().neg()},
+      __LINE__,
+      __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionTestWarnRegisterSpill_CUDA) {
   const int hidden_size = 1024 * 10;
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
@@ -9564,6 +9616,351 @@ TEST_F(NVFuserTest, LoweringHook) {
   EXPECT_TRUE(executed);
 }
 
+// Compile for meta tensors ahead of time and check that a run with real
+// inputs of the same shape reuses the compiled runtime
+TEST_F(NVFuserTest, CompileFusionAheadOfTime) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto proxy = at::empty_strided(
+      {128, 1024},
+      {1024, 1},
+      at::TensorOptions().dtype(at::kFloat).device(at::kMeta));
+  EXPECT_TRUE(fec.compileFusionAheadOfTime({proxy}));
+  EXPECT_FALSE(fec.compileFusionAheadOfTime({proxy}));
+  EXPECT_EQ(fec.countRuntimes(), 1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  EXPECT_TRUE(fec.isCompiled({t0}));
+
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+  EXPECT_EQ(fec.countRuntimes(), 1);
+  testValidate(fusion, cg_outputs, {t0}, {t0.sum({1})}, __LINE__, __FILE__);
+}
+
+// Inputs of a new shape class check the runtimes of other classes only once
+TEST_F(NVFuserTest, KernelRuntimeReuseBuckets) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion_ptr->addInput(tv0);
+  auto tv1 = add(tv0, tv0);
+  fusion_ptr->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto a5 = at::zeros({5}, options);
+  auto a6 = at::zeros({6}, options);
+  auto a7 = at::zeros({7}, options);
+  auto a8 = at::zeros({8}, options);
+
+  fec.runFusionWithInputs({a5});
+  fec.runFusionWithInputs({a6});
+  EXPECT_EQ(fec.countRuntimes(), 1);
+  auto stats = fec.reuseStats();
+  EXPECT_EQ(stats.searches, 2);
+  EXPECT_EQ(stats.reused, 1);
+  EXPECT_EQ(stats.heuristics_evaluations, 1);
+
+  // Forcing 64-bit indexing changes the shape class. The 32-bit runtime is
+  // evaluated for it only once.
+  fec.runFusionWithInputs({a7}, PrimDataType::Int);
+  EXPECT_EQ(fec.countRuntimes(), 2);
+  fec.runFusionWithInputs({a8}, PrimDataType::Int);
+  EXPECT_EQ(fec.countRuntimes(), 2);
+  stats = fec.reuseStats();
+  EXPECT_EQ(stats.searches, 4);
+  EXPECT_EQ(stats.reused, 2);
+  EXPECT_EQ(stats.heuristics_evaluations, 3);
+}
+
+// Fusion::exprs() only sorts the graph again after a mutation that may
+// change the order
+TEST_F(NVFuserTest, FusionExprsCache) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = sin(tv0);
+  auto tv2 = cos(tv1);
+  fusion.addOutput(tv2);
+
+  auto num_traversals = []() { return Fusion::exprsStats().traversals; };
+
+  const auto exprs = fusion.exprs();
+  EXPECT_EQ(exprs, std::vector<Expr*>({tv1->definition(), tv2->definition()}));
+  auto last = num_traversals();
+  EXPECT_EQ(fusion.exprs(), exprs);
+  EXPECT_EQ(num_traversals(), last);
+
+  // Exprs that can't reach an output don't change the order
+  add(tv0->axis(0)->extent(), IrBuilder::create<Val>(1L));
+  auto tv3 = exp(tv1);
+  EXPECT_EQ(fusion.exprs(), exprs);
+  EXPECT_EQ(num_traversals(), last);
+
+  // Mutating a live expr does
+  auto tv2_def = ir_utils::replaceValInExprInputs(tv2->definition(), tv1, tv3);
+  EXPECT_EQ(
+      fusion.exprs(),
+      std::vector<Expr*>({tv1->definition(), tv3->definition(), tv2_def}));
+  EXPECT_GT(num_traversals(), last);
+  last = num_traversals();
+
+  // So does changing the outputs
+  fusion.replaceOutput(tv2, tv3);
+  EXPECT_EQ(
+      fusion.exprs(),
+      std::vector<Expr*>({tv1->definition(), tv3->definition()}));
+  EXPECT_GT(num_traversals(), last);
+}
+
+// Buffers live at the same time never overlap in a workspace layout, while
+// the others share memory
+TEST_F(NVFuserTest, FusionWorkspaceLayout) {
+  std::vector<WorkspaceBuffer> buffers = {
+      {1000, 0, 1}, {500, 1, 2}, {800, 2, 3}, {100, 3, 3}, {0, 0, 3}};
+  auto layout = layoutWorkspace(buffers, 256);
+  ASSERT_EQ(layout.offsets.size(), buffers.size());
+  EXPECT_EQ(layout.total_buffer_size, 1024 + 512 + 1024 + 256);
+  EXPECT_LT(layout.size, layout.total_buffer_size);
+
+  auto aligned = [](int64_t size) { return (size + 255) / 256 * 256; };
+  for (auto i : c10::irange(buffers.size())) {
+    EXPECT_EQ(layout.offsets[i] % 256, 0);
+    EXPECT_LE(layout.offsets[i] + aligned(buffers[i].size), layout.size);
+    for (auto j : c10::irange(i)) {
+      const bool live_together = buffers[i].first_use <= buffers[j].last_use &&
+          buffers[j].first_use <= buffers[i].last_use;
+      const bool overlap =
+          layout.offsets[i] < layout.offsets[j] + aligned(buffers[j].size) &&
+          layout.offsets[j] < layout.offsets[i] + aligned(buffers[i].size);
+      EXPECT_FALSE(live_together && overlap)
+          << "Buffers " << i << " and " << j << " overlap";
+    }
+  }
+  // The first and the third buffer are never live together, nor are the
+  // second and the fourth
+  EXPECT_EQ(layout.size, 1024 + 512);
+
+  EXPECT_THAT(
+      [&]() { layoutWorkspace(buffers, 100); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("alignment must be a power of two")));
+}
+
+// Tensors passed between segments are placed in a workspace planned from
+// their live ranges
+TEST_F(NVFuserTest, FusionSegmentWorkspace) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = segment_set(sin(tv0));
+  auto tv2 = segment_set(cos(tv1));
+  auto tv3 = segment_set(exp(tv2));
+  auto tv4 = neg(tv3);
+  fusion->addOutput(tv4);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SegmentWorkspace);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 128}, options);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_EQ(runtime->fusionSegments()->groups().size(), 4);
+
+  // tv1 and tv3 are never live together, so they share memory. Only the
+  // metadata of the inputs is needed to plan.
+  KernelArgumentHolder args;
+  args.pushTensorProxy({1024, 128}, {128, 1}, at::kFloat);
+  auto plan = runtime->planWorkspace(args);
+  const int64_t buffer_size = 1024 * 128 * 4;
+  EXPECT_EQ(plan.total_buffer_size, 3 * buffer_size);
+  EXPECT_EQ(plan.workspace_size, 2 * buffer_size);
+  ASSERT_EQ(plan.placements.size(), 4);
+  EXPECT_EQ(
+      plan.placements.at(0).output_offsets.at(0),
+      plan.placements.at(2).output_offsets.at(0));
+  EXPECT_NE(
+      plan.placements.at(0).output_offsets.at(0),
+      plan.placements.at(1).output_offsets.at(0));
+  // The fusion output is left to the caller
+  EXPECT_EQ(plan.placements.at(3).output_offsets.at(0), -1);
+
+  // The plan made after the first run is used by the following ones
+  auto cache_id = executor_cache.prepareInputs({t0}).getCacheId();
+  ASSERT_TRUE(cache_id.has_value());
+  auto used_plan = runtime->getWorkspacePlan(cache_id.value());
+  ASSERT_TRUE(used_plan.has_value());
+  EXPECT_EQ(used_plan->workspace_size, plan.workspace_size);
+
+  auto ref = t0.sin().cos().exp().neg();
+  for (int64_t run = 0; run < 2; run++) {
+    outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, {ref}, __LINE__, __FILE__);
+  }
+}
+
+// Read-only analyses run concurrently between barriers, respecting their
+// dependencies
+TEST_F(NVFuserTest, LowerAnalysisScheduler) {
+  std::mutex mutex;
+  std::vector<std::string> order;
+  auto record = [&](const std::string& name) {
+    return [&, name]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(name);
+    };
+  };
+
+  std::vector<LowerAnalysis> analyses;
+  analyses.push_back({"a", record("a")});
+  analyses.push_back({"b", record("b"), {"a"}, /*read_only=*/true});
+  analyses.push_back({"c", record("c"), {}, /*read_only=*/true});
+  analyses.push_back({"d", record("d"), {"b"}, /*read_only=*/true});
+  analyses.push_back({"e", record("e"), {"d"}});
+
+  int64_t num_prepares = 0;
+  std::vector<std::string> finished;
+  auto times = runAnalyses(
+      analyses,
+      getThreadPool(),
+      [](const std::function<void()>& run) { run(); },
+      [&]() { num_prepares++; },
+      [&](const LowerAnalysis& analysis) {
+        finished.push_back(analysis.name);
+      });
+
+  EXPECT_EQ(num_prepares, 1);
+  EXPECT_EQ(finished, std::vector<std::string>({"a", "b", "c", "d", "e"}));
+  ASSERT_EQ(order.size(), 5);
+  EXPECT_EQ(order.front(), "a");
+  EXPECT_EQ(order.back(), "e");
+  auto position = [&](const std::string& name) {
+    return std::find(order.begin(), order.end(), name) - order.begin();
+  };
+  EXPECT_LT(position("b"), position("d"));
+
+  ASSERT_EQ(times.size(), 5);
+  for (auto i : c10::irange(times.size())) {
+    EXPECT_EQ(times[i].name, analyses[i].name);
+    EXPECT_EQ(times[i].concurrent, analyses[i].read_only);
+  }
+
+  // The first error is rethrown and nothing after the batch runs
+  order.clear();
+  analyses[2].run = []() { NVF_ERROR(false, "analysis c failed"); };
+  EXPECT_THAT(
+      [&]() {
+        runAnalyses(
+            analyses,
+            getThreadPool(),
+            [](const std::function<void()>& run) { run(); },
+            []() {},
+            [](const LowerAnalysis&) {});
+      },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("analysis c failed")));
+  EXPECT_EQ(std::count(order.begin(), order.end(), "e"), 0);
+}
+
+// Running the lowering analyses concurrently generates the same kernel
+TEST_F(NVFuserTest, FusionParallelLowerAnalysis) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = add(tv0, tv2);
+  fusion.addOutput(tv3);
+
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv3);
+  inlineMost();
+
+  const auto serial_kernel =
+      codegen::generateCudaKernel(GpuLower(&fusion).run());
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ParallelLowerAnalysis);
+  GpuLower lower(&fusion);
+  const auto& times = lower.analysisTimes();
+  EXPECT_TRUE(std::any_of(times.begin(), times.end(), [](const auto& time) {
+    return time.concurrent;
+  }));
+  EXPECT_EQ(codegen::generateCudaKernel(lower.run()), serial_kernel);
+}
+
+// The compile profiler records the lowering passes nested in GpuLower::run
+TEST_F(NVFuserTest, FusionCompileProfiler) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  CompileProfileGuard guard;
+  ASSERT_TRUE(guard.isRecording());
+  {
+    CompileProfileGuard nested_guard;
+    EXPECT_FALSE(nested_guard.isRecording());
+  }
+  GpuLower lower(&fusion);
+  codegen::generateCudaKernel(lower.run());
+  const CompileProfile profile = guard.stop();
+  EXPECT_FALSE(CompileProfiler::isRecording());
+
+  const auto& events = profile.events;
+  auto find_event = [&events](const std::string& name) {
+    return std::find_if(events.begin(), events.end(), [&name](const auto& e) {
+      return e.name == name;
+    });
+  };
+
+  auto run_it = find_event("GpuLower::run");
+  ASSERT_NE(run_it, events.end());
+  EXPECT_GT(run_it->statements, 0);
+  for (const auto& [name, pass] : lower.passes()) {
+    auto it = find_event(name);
+    ASSERT_NE(it, events.end()) << name;
+    EXPECT_EQ(it->parent, std::distance(events.begin(), run_it)) << name;
+  }
+  EXPECT_NE(find_event("build ComputeAtMap"), events.end());
+  EXPECT_NE(find_event("generateCudaKernel"), events.end());
+
+  std::stringstream ss;
+  ss << profile;
+  EXPECT_THAT(ss.str(), ::testing::HasSubstr("GpuLower::run"));
+  EXPECT_THAT(
+      profile.toChromeTrace(),
+      ::testing::HasSubstr("\"name\": \"IndexLowering\""));
+}
+
 // Test file size should be up to 10K LoC. Create a new file for more tests.
 
 } // namespace nvfuser
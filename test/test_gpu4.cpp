@@ -0,0 +1,447 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <executor.h>
+#include <fusion.h>
+#include <fusion_segmenter.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <scheduler/all_schedulers.h>
+#include <scheduler/autotune.h>
+#include <test/utils.h>
+#include <test/validator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+namespace nvfuser {
+
+// With shape buckets, all sizes of a bucket re-use the kernel compiled for
+// the first one
+TEST_F(NVFuserTest, KernelRuntimeShapeBuckets) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ShapeBuckets);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  // All of these sizes are in the bucket of 1024 with 8 as the largest
+  // power-of-two divisor, i.e. share the representative 1016
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t size : {1000, 984, 1016}) {
+    at::Tensor t0 = at::randn({128, size}, options);
+    auto cg_outputs = fec.runFusionWithInputs({t0});
+    testValidate(fusion, cg_outputs, {t0}, {t0.sum({1})}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.countRuntimes(), 1);
+  auto stats = fec.reuseStats();
+  EXPECT_EQ(stats.reused, 2);
+  EXPECT_EQ(stats.bucket_hits, 2);
+  EXPECT_LE(stats.compiles_avoided, stats.bucket_hits);
+
+  // Non-power-of-two extents, whose bucket representative is larger. The
+  // grid of the reduction must still be sized for the exact extents, also
+  // when the heuristics fix it, as for cross-grid reductions.
+  const std::vector<std::vector<int64_t>> shapes{
+      {100, 1000}, {92, 1000}, {5, 300000}, {7, 300000}};
+  for (const auto& shape : shapes) {
+    at::Tensor t0 = at::randn(shape, options);
+    auto cg_outputs = fec.runFusionWithInputs({t0});
+    testValidate(fusion, cg_outputs, {t0}, {t0.sum({1})}, __LINE__, __FILE__);
+
+    Fusion fusion_copy(*fusion);
+    auto exact_rparams = getReductionHeuristics(&fusion_copy, {t0});
+    ASSERT_NE(exact_rparams, nullptr);
+    const auto& lparams = fec.getMostRecentKernelRuntime()
+                              ->schedulerHeuristics()
+                              ->heuristicsList()
+                              .at(0)
+                              ->params()
+                              ->lparams;
+    EXPECT_EQ(lparams.gdimx(), exact_rparams->lparams.gdimx());
+    EXPECT_EQ(lparams.gdimy(), exact_rparams->lparams.gdimy());
+  }
+}
+
+TEST_F(NVFuserTest, FusionAutotunePointwise) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigTensor(2);
+    auto tv1 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    fusion->addInput(tv1);
+    auto tv2 = add(tv0, tv1);
+    fusion->addOutput(tv2);
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  at::Tensor t1 = at::randn({1024, 1024}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1});
+
+  // Prefers a vectorization factor of 2 over the analytic factor of 4
+  struct PreferVectorize2Backend : public TuningBackend {
+    int64_t num_measured = 0;
+    std::string name() const override {
+      return "prefer_vectorize2";
+    }
+    std::optional<double> measure(const TuningCandidate& candidate) override {
+      num_measured++;
+      const auto pparams = candidate.params->as<PointwiseParams>();
+      return pparams->vectorize && pparams->unroll_factor == 2 ? 1.0 : 2.0;
+    }
+  };
+
+  const std::string db_path =
+      (std::filesystem::temp_directory_path() / "nvfuser_autotune_test.tsv")
+          .string();
+  std::filesystem::remove(db_path);
+  auto pointwise_params = [](FusionExecutorCache& executor_cache) {
+    return executor_cache.getMostRecentKernelRuntime()
+        ->schedulerHeuristics()
+        ->heuristicsList()
+        .at(0)
+        ->pointwiseParams();
+  };
+
+  EnableOptionsGuard opt_guard;
+  auto backend = std::make_shared<PreferVectorize2Backend>();
+  setTuningBackend(backend);
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::Autotune, {"db=" + db_path});
+  {
+    FusionExecutorCache executor_cache(make_fusion());
+    auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        aten_inputs,
+        {t0 + t1},
+        __LINE__,
+        __FILE__);
+    const auto pparams = pointwise_params(executor_cache);
+    EXPECT_TRUE(pparams.vectorize);
+    EXPECT_EQ(pparams.unroll_factor, 2);
+  }
+  EXPECT_GT(backend->num_measured, 1);
+
+  // The winner is persisted, and only looked up by later compilations
+  TuningDb db(db_path);
+  ASSERT_EQ(db.size(), 1);
+  auto backend_after = std::make_shared<PreferVectorize2Backend>();
+  setTuningBackend(backend_after);
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::Autotune, {"lookup", "db=" + db_path});
+  {
+    FusionExecutorCache executor_cache(make_fusion());
+    executor_cache.runFusionWithInputs(aten_inputs);
+    EXPECT_EQ(pointwise_params(executor_cache).unroll_factor, 2);
+  }
+  EXPECT_EQ(backend_after->num_measured, 0);
+
+  setTuningBackend(nullptr);
+  std::filesystem::remove(db_path);
+}
+
+TEST_F(NVFuserTest, FusionAutotuneCostModel) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = sum(tv0, {1});
+    fusion->addOutput(tv1);
+    return fusion;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000, 3000}, options);
+  std::vector<c10::IValue> aten_inputs({t0});
+
+  const std::string db_path =
+      (std::filesystem::temp_directory_path() / "nvfuser_autotune_cm_test.tsv")
+          .string();
+  std::filesystem::remove(db_path);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::Autotune, {"cost_model", "db=" + db_path});
+  FusionExecutorCache executor_cache(make_fusion());
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t0.sum({1})},
+      __LINE__,
+      __FILE__);
+
+  // Sizes of the same bucket share the tuned config
+  TuningDb db(db_path);
+  ASSERT_EQ(db.size(), 1);
+  at::Tensor t1 = at::randn({1024, 2900}, options);
+  std::vector<c10::IValue> other_inputs({t1});
+  FusionExecutorCache other_cache(make_fusion());
+  cg_outputs = other_cache.runFusionWithInputs(other_inputs);
+  testValidate(
+      other_cache.fusion(),
+      cg_outputs,
+      other_inputs,
+      {t1.sum({1})},
+      __LINE__,
+      __FILE__);
+  EXPECT_EQ(TuningDb(db_path).size(), 1);
+
+  std::filesystem::remove(db_path);
+}
+
+// Kernel runtimes created for new sizes are segmented from the
+// segmentation of the previous runtime
+TEST_F(NVFuserTest, FusionIncrementalSegmentation) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Val>(2.0));
+  auto tv2 = segment_set(tv1);
+  auto tv3 = sum(tv2, {1});
+  auto tv4 = add(tv2, broadcast(tv3, {false, true}));
+  fusion->addOutput(tv4);
+
+  DisableOptionsGuard disable_guard;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::KernelReuse);
+  EnableOptionsGuard enable_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::IncrementalSegmentation);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const std::vector<std::vector<int64_t>> shapes{
+      {128, 1024}, {256, 2048}, {7, 333}};
+  for (const auto i : c10::irange(shapes.size())) {
+    at::Tensor t0 = at::randn(shapes.at(i), options);
+    auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+    auto t1 = t0 * 2;
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        {t0},
+        {t1 + t1.sum({1}).unsqueeze(-1)},
+        __LINE__,
+        __FILE__);
+
+    auto segmented_fusion =
+        executor_cache.getMostRecentKernelRuntime()->fusionSegments();
+    ASSERT_EQ(segmented_fusion->groups().size(), 2);
+    EXPECT_EQ(segmented_fusion->numSeededGroups(), i == 0 ? 0 : 2);
+  }
+  EXPECT_EQ(executor_cache.countRuntimes(), shapes.size());
+}
+
+// The seed casts the tensors passed between its segments to half precision,
+// which adds expressions to its groups. They must not prevent seeding.
+TEST_F(NVFuserTest, FusionIncrementalSegmentationHalfEdges) {
+  if (!deviceMajorMinorCheck(8)) {
+    GTEST_SKIP() << "skipping tests on pre-AMPERE GPUs";
+  }
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeSymbolicTensor(2, DataType::BFloat16);
+  fusion->addInput(tv0);
+  auto tv1 = mul(castOp(DataType::Float, tv0), IrBuilder::create<Val>(2.0));
+  auto tv2 = segment_set(tv1);
+  auto tv3 = sum(tv2, {1});
+  auto tv4 = add(tv2, broadcast(tv3, {false, true}));
+  fusion->addOutput(castOp(DataType::BFloat16, tv4));
+
+  DisableOptionsGuard disable_guard;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::KernelReuse);
+  EnableOptionsGuard enable_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::IncrementalSegmentation);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto options =
+      at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA, 0);
+  const std::vector<std::vector<int64_t>> shapes{
+      {128, 1024}, {256, 2048}, {7, 333}};
+  for (const auto i : c10::irange(shapes.size())) {
+    at::Tensor t0 = at::randn(shapes.at(i), options);
+    auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+    // The segment edge is rounded to bfloat16
+    auto t2 = (t0.to(at::kFloat) * 2).to(at::kBFloat16).to(at::kFloat);
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        {t0},
+        {(t2 + t2.sum({1}).unsqueeze(-1)).to(at::kBFloat16)},
+        __LINE__,
+        __FILE__);
+
+    auto segmented_fusion =
+        executor_cache.getMostRecentKernelRuntime()->fusionSegments();
+    ASSERT_EQ(segmented_fusion->groups().size(), 2);
+    EXPECT_EQ(segmented_fusion->numSeededGroups(), i == 0 ? 0 : 2);
+  }
+}
+
+// An un-segmented seed is not used, so a fusion that has to be segmented for
+// new sizes is segmented as from scratch
+TEST_F(NVFuserTest, FusionIncrementalSegmentationUnsegmentedSeed) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = sum(mul(tv0, tv0), {1});
+  auto tv3 = broadcast(add(tv1, tv2), {false, true});
+  auto tv4 = div(tv0, tv3);
+  fusion.addOutput(tv4);
+
+  auto segment = [&fusion](const at::Tensor& t0, const SegmentedFusion* seed) {
+    auto fusion_copy = std::make_unique<Fusion>(fusion);
+    auto args = KernelArgumentHolder::createKernelArgumentHolder({t0});
+    SchedulerRuntimeInfo runtime_info(fusion_copy.get(), args);
+    return SegmentCandidateFinder::segment(
+        std::move(fusion_copy), args, runtime_info, seed);
+  };
+  auto heuristics = [](const SegmentedFusion* segmented_fusion) {
+    std::vector<ScheduleHeuristic> heuristics;
+    for (auto group : segmented_fusion->cgroups()) {
+      heuristics.push_back(group->heuristic());
+    }
+    std::sort(heuristics.begin(), heuristics.end());
+    return heuristics;
+  };
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // Small enough to be a single persistent kernel
+  auto seed = segment(at::randn({128, 1024}, options), nullptr);
+  ASSERT_EQ(seed->groups().size(), 1);
+
+  // Too large to be persistent. Both reductions are combined into one group
+  // when segmenting from scratch.
+  at::Tensor t0 = at::randn({8, 1 << 22}, options);
+  auto from_scratch = segment(t0, nullptr);
+  auto seeded = segment(t0, seed.get());
+  ASSERT_GT(from_scratch->groups().size(), 1);
+  EXPECT_EQ(seeded->numSeededGroups(), 0);
+  EXPECT_EQ(seeded->groups().size(), from_scratch->groups().size());
+  EXPECT_EQ(heuristics(seeded.get()), heuristics(from_scratch.get()));
+}
+
+// Structural hashing and interning of scalars in IrContainer
+TEST_F(NVFuserTest, FusionScalarHashCons) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto a = IrBuilder::create<Val>(DataType::Int);
+  auto b = IrBuilder::create<Val>(DataType::Int);
+  auto ab = add(a, b);
+  auto ab2 = add(a, b);
+  auto ba = add(b, a);
+  auto two = IrBuilder::create<Val>(2L);
+  auto two2 = IrBuilder::create<Val>(2L);
+
+  auto& table = fusion.scalarHashConsTable();
+  EXPECT_EQ(table.hash(ab), table.hash(ab2));
+  EXPECT_EQ(table.hash(two), table.hash(two2));
+  // Hashes don't depend on the order of inputs, sameAs does
+  EXPECT_EQ(table.hash(ab), table.hash(ba));
+  EXPECT_TRUE(table.sameAs(ab, ab2));
+  EXPECT_FALSE(table.sameAs(ab, ba));
+  EXPECT_FALSE(table.sameAs(ab, mul(a, b)));
+
+  EXPECT_EQ(table.find(ab2), nullptr);
+  EXPECT_EQ(table.intern(ab), ab);
+  EXPECT_EQ(table.intern(ab2), ab);
+  EXPECT_EQ(table.find(ab2), ab);
+  EXPECT_EQ(table.find(ba), nullptr);
+  EXPECT_EQ(table.intern(two2), two2);
+  EXPECT_EQ(table.find(two), two2);
+
+  // ab2 is now a free variable, which must not be sameAs ab
+  fusion.removeExpr(ab2->definition());
+  EXPECT_FALSE(table.sameAs(ab, ab2));
+  EXPECT_EQ(table.find(ab2), nullptr);
+  EXPECT_EQ(table.intern(ab2), ab2);
+}
+
+// Launches of one cache id from several threads must each use their own
+// kernel parameters
+TEST_F(NVFuserTest, FusionExecutorConcurrentLaunch_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(1);
+  auto s1 = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(tv0);
+  fusion->addInput(s1);
+  auto tv1 = mul(tv0, s1);
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  constexpr int64_t num_threads = 8;
+  std::vector<at::Tensor> inputs;
+  for ([[maybe_unused]] auto i : c10::irange(num_threads)) {
+    inputs.push_back(at::randn({1024}, options));
+  }
+
+  FusionExecutor fe;
+  fe.compileFusion(fusion.get(), {inputs[0], 1.0});
+  // Lays out the kernel parameters of the cache id
+  constexpr size_t cache_id = 0;
+  fe.runFusion({inputs[0], 1.0}, LaunchParams(), CompileParams(), cache_id);
+
+  std::atomic<int64_t> num_mismatches = 0;
+  std::vector<std::thread> threads;
+  for (auto i : c10::irange(num_threads)) {
+    threads.emplace_back([&, i]() {
+      const double factor = (double)(i + 1);
+      for ([[maybe_unused]] auto iteration : c10::irange(50)) {
+        auto outputs = fe.runFusion(
+            {inputs[i], factor}, LaunchParams(), CompileParams(), cache_id);
+        if (!at::allclose(outputs[0], inputs[i] * factor)) {
+          num_mismatches++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_mismatches, 0);
+}
+
+// Test file size should be up to 10K LoC. Create a new file for more tests.
+
+} // namespace nvfuser
@@ -9,10 +9,16 @@
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
+#include <codegen.h>
+#include <device_descriptor.h>
+#include <device_lower/lower2device.h>
 #include <device_lower/utils.h>
 #include <executor_utils.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
+#include <scheduler/normalization_inner.h>
+#include <scheduler/reduction.h>
+#include <scheduler/registry.h>
 #include <scheduler/utils.h>
 #include <scheduler/vectorize_helper.h>
 #include <test/utils.h>
@@ -1080,4 +1086,180 @@ TEST_F(NVFuserTest, FusionSASSDumpError_CUDA) {
   testValidate(fe.kernel(), cg_outputs, {t0}, __LINE__, __FILE__);
 }
 
+// Pointers into a KernelArgumentHolder must stay valid as arguments are
+// pushed, views must alias, and copies must own their arguments
+TEST_F(NVFuserTest, KernelArgumentHolderStorage_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 8}, options);
+
+  KernelArgumentHolder args;
+  args.push(t0);
+  const PolymorphicValue* first = args[0];
+  // Push enough arguments to spill into several storage blocks
+  for (auto i : c10::irange(100)) {
+    args.push(PolymorphicValue((int64_t)i));
+  }
+  EXPECT_EQ(args.size(), 101);
+  EXPECT_EQ(args[0], first);
+  EXPECT_TRUE(args[0]->as<at::Tensor>().is_same(t0));
+  EXPECT_EQ(args[100]->as<int64_t>(), 99);
+
+  KernelArgumentHolder view;
+  view.pushView(args[0]);
+  view.pushView(args[1]);
+  EXPECT_EQ(view[0], args[0]);
+
+  KernelArgumentHolder copy(view);
+  EXPECT_NE(copy[0], args[0]);
+  EXPECT_TRUE(copy[0]->as<at::Tensor>().is_same(t0));
+  EXPECT_EQ(copy[1]->as<int64_t>(), 0);
+
+  // Erasing the original does not affect the copy
+  args.erase(first);
+  EXPECT_EQ(args.size(), 100);
+  EXPECT_EQ(args[0]->as<int64_t>(), 0);
+  EXPECT_TRUE(copy[0]->as<at::Tensor>().is_same(t0));
+}
+
+TEST_F(NVFuserTest, TargetDeviceDescriptorJson_CUDA) {
+  auto a100 = TargetDeviceDescriptor::builtin("A100");
+  ASSERT_NE(a100, nullptr);
+  EXPECT_EQ(a100->computeCapability(), 80);
+  EXPECT_EQ(a100->multi_processor_count, 108);
+  EXPECT_EQ(TargetDeviceDescriptor::builtin("no_such_gpu"), nullptr);
+
+  // A profile written by toJson reads back to the same descriptor
+  EXPECT_EQ(TargetDeviceDescriptor::fromJson(a100->toJson()), *a100);
+  auto current = getTargetDevice();
+  EXPECT_EQ(TargetDeviceDescriptor::fromJson(current->toJson()), *current);
+
+  // Missing keys keep their defaults
+  auto partial = TargetDeviceDescriptor::fromJson(
+      R"({"name": "partial", "major": 7, "minor": 5})");
+  EXPECT_EQ(partial.name, "partial");
+  EXPECT_EQ(partial.computeCapability(), 75);
+  EXPECT_EQ(partial.warp_size, 32);
+
+  EXPECT_THAT(
+      [&]() { TargetDeviceDescriptor::fromJson(R"({"num_sms": 1})"); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("Unknown key in device profile: num_sms")));
+  EXPECT_THAT(
+      [&]() { TargetDeviceDescriptor::fromJson(R"({"major": 8)"); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("Malformed device profile")));
+
+  {
+    TargetDeviceGuard guard(*a100);
+    EXPECT_EQ(*getTargetDevice(), *a100);
+  }
+  EXPECT_EQ(*getTargetDevice(), *current);
+}
+
+// Schedule and generate code for a device other than the current one
+TEST_F(NVFuserTest, TargetDeviceHeuristics_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8192, 1024}, options);
+
+  auto h100 = TargetDeviceDescriptor::builtin("h100");
+  ASSERT_NE(h100, nullptr);
+
+  // Heuristics for a device given to SchedulerRuntimeInfo match the ones
+  // computed while that device is the process-wide target
+  SchedulerRuntimeInfo runtime_info(
+      fusion.get(),
+      KernelArgumentHolder::createKernelArgumentHolder({t0}),
+      nullptr,
+      {},
+      std::nullopt,
+      std::make_shared<const TargetDeviceDescriptor>(*h100));
+  EXPECT_EQ(runtime_info.targetDevice(), *h100);
+  auto rparams = getReductionHeuristics(fusion.get(), runtime_info);
+  ASSERT_NE(rparams, nullptr);
+
+  TargetDeviceGuard guard(*h100);
+  auto guarded_rparams = getReductionHeuristics(fusion.get(), {t0});
+  EXPECT_TRUE(rparams->sameAs(guarded_rparams));
+
+  scheduleReduction(fusion.get(), *rparams);
+  GpuLower gpulw(fusion.get());
+  EXPECT_EQ(gpulw.targetDevice(), *h100);
+  EXPECT_FALSE(codegen::generateCudaKernel(gpulw.run()).empty());
+}
+
+// Schedule and lower for a target whose warp size differs from the one of the
+// physical devices. The inputs are meta tensors and the target is also set
+// process-wide, so nothing queries the GPU.
+TEST_F(NVFuserTest, TargetDeviceWarpSize_CUDA) {
+  auto target = std::make_shared<const TargetDeviceDescriptor>(
+      TargetDeviceDescriptor::fromJson(
+          R"({"name": "wide_warp", "major": 8, "minor": 0,
+              "multi_processor_count": 108, "warp_size": 64,
+              "shared_mem_per_block_optin": 166912,
+              "shared_mem_per_multiprocessor": 167936,
+              "clock_rate": 1410000})"));
+  TargetDeviceGuard guard(*target);
+
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = sum(tv0, {1});
+    auto tv2 = broadcast(tv1, {false, true});
+    auto tv3 = div(tv0, tv2);
+    fusion.addOutput(tv3);
+
+    at::Tensor t0 = at::empty(
+        {1024, 1000}, at::TensorOptions().dtype(at::kFloat).device(at::kMeta));
+    SchedulerRuntimeInfo runtime_info(
+        &fusion,
+        KernelArgumentHolder::createKernelArgumentHolder({t0}),
+        nullptr,
+        {},
+        std::nullopt,
+        target);
+    auto rparams = getInnerPersistentHeuristics(&fusion, runtime_info);
+    ASSERT_NE(rparams, nullptr);
+    scheduleInnerPersistentKernel(&fusion, *rparams);
+    GpuLower gpulw(&fusion, CompileParams(), target);
+    EXPECT_FALSE(codegen::generateCudaKernel(gpulw.run()).empty());
+  }
+
+  // A TIDx extent of 64 is a single warp of the target, but not of a device
+  // with the default warp size
+  auto lower_warp_reduction =
+      [](std::shared_ptr<const TargetDeviceDescriptor> target_device) {
+        Fusion fusion;
+        FusionGuard fg(&fusion);
+        auto tv0 = makeContigConcreteTensor({4, 64});
+        fusion.addInput(tv0);
+        auto tv1 = sum(tv0, {1});
+        fusion.addOutput(tv1);
+        tv1->axis(0)->parallelize(ParallelType::BIDx);
+        tv1->axis(1)->parallelize(ParallelType::TIDx);
+        GpuLower gpulw(&fusion, CompileParams(), std::move(target_device));
+        gpulw.run();
+        return gpulw.getWarpPaddedParallelInfo();
+      };
+  auto wide_warp_info = lower_warp_reduction(target);
+  EXPECT_TRUE(wide_warp_info.has_warp_reduction);
+  EXPECT_TRUE(wide_warp_info.is_tidx_single_warp);
+
+  auto a100 = TargetDeviceDescriptor::builtin("a100");
+  ASSERT_NE(a100, nullptr);
+  auto a100_info = lower_warp_reduction(
+      std::make_shared<const TargetDeviceDescriptor>(*a100));
+  EXPECT_TRUE(a100_info.has_warp_reduction);
+  EXPECT_FALSE(a100_info.is_tidx_single_warp);
+}
+
 } // namespace nvfuser
@@ -239,6 +239,9 @@ TEST_P(CommunicationTest, Communication_Allreduce) {
 }
 
 TEST_P(CommunicationTest, Communication_ReduceScatter) {
+  if (GetParam() == CommunicatorBackend::gloo) {
+    GTEST_SKIP() << "Gloo does not support reduce_scatter";
+  }
   params.redOp = red_op;
   params.root = root;
   params.team = all_ranks;
@@ -267,10 +270,45 @@ TEST_P(CommunicationTest, Communication_ReduceScatter) {
   }
 }
 
+// Posts all the communications before waiting on any of them, as
+// PipelineExecutor does to overlap them with computation
+TEST_P(CommunicationTest, Communication_OverlappedPosts) {
+  std::vector<std::unique_ptr<Communication>> communications;
+  for (int j : c10::irange(number_of_repetitions)) {
+    CommParams allreduce_params;
+    allreduce_params.redOp = red_op;
+    allreduce_params.team = all_ranks;
+    allreduce_params.src_bufs = {
+        at::arange(tensor_size, tensor_options) +
+        (communicator->deviceId() + 1) * j};
+    allreduce_params.dst_bufs = {at::empty(tensor_size, tensor_options)};
+    communications.push_back(std::make_unique<Allreduce>(allreduce_params));
+  }
+
+  std::vector<c10::intrusive_ptr<c10d::Work>> works;
+  for (auto& communication : communications) {
+    works.push_back(communication->post(*communicator, GetParam()));
+  }
+  for (auto& work : works) {
+    work->wait();
+  }
+
+  int S = communicator->size();
+  for (int j : c10::irange(number_of_repetitions)) {
+    auto obtained = communications.at(j)->params().dst_bufs.at(0);
+    auto ref =
+        at::arange(tensor_size, tensor_options) * S + S * (S + 1) / 2 * j;
+    validate(obtained, ref);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     CommunicatorBackend,
     CommunicationTest,
-    ::testing::Values(CommunicatorBackend::nccl, CommunicatorBackend::ucc)
+    ::testing::Values(
+        CommunicatorBackend::nccl,
+        CommunicatorBackend::ucc,
+        CommunicatorBackend::gloo)
 
 );
 
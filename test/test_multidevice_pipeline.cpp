@@ -25,6 +25,8 @@
 #include <kernel_cache.h>
 #include <kernel_ir.h>
 #include <mma_type.h>
+#include <multidevice/executor.h>
+#include <multidevice/lower_communication.h>
 #include <ops/all_ops.h>
 #include <root_domain_map.h>
 #include <scheduler/all_schedulers.h>
@@ -36,7 +38,10 @@
 #include <transform_rfactor.h>
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <numeric>
+#include <thread>
 
 namespace nvfuser {
 
@@ -136,6 +141,293 @@ TEST_F(PipelineTest, Pipeline) {
   validate();
 }
 
+class PipelineTestMicroBatches
+    : public PipelineTest,
+      public ::testing::WithParamInterface<MicroBatchSchedule> {};
+
+TEST_P(PipelineTestMicroBatches, MicroBatches) {
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sum(tv0, {1});
+  TensorView* tv2 = set(tv1);
+  TensorView* tv3 = add(tv2, tv2);
+  fusion->addOutput(tv3);
+
+  PipelineStageDescriptor stage0, stage1;
+  stage0.addVal({tv0, tv1});
+  stage1.addVal({tv2, tv3});
+  stage0.mesh = {0};
+  stage1.mesh = {1};
+  PipelineDescriptor descriptor{
+      .stage_descriptors{std::move(stage0), std::move(stage1)}};
+  pipeline = std::make_unique<Pipeline>(fusion.get(), std::move(descriptor));
+
+  constexpr int64_t num_micro_batches = 4;
+  micro_batch_params.num_micro_batches = num_micro_batches;
+  micro_batch_params.schedule = GetParam();
+  micro_batch_params.measure_stage_time = true;
+  inputs = {at::randn({64, 1024}, tensor_options)};
+
+  validate();
+
+  // Each of the first two devices runs one stage per micro-batch
+  const DeviceIdxType device_id = communicator->deviceId();
+  EXPECT_EQ(
+      (int64_t)timings.intervals.size(),
+      device_id < 2 ? num_micro_batches : 0);
+  for (const auto& interval : timings.intervals) {
+    EXPECT_LE(interval.start_ms, interval.end_ms);
+    EXPECT_LE(interval.end_ms, timings.wall_ms);
+  }
+  EXPECT_GE(timings.bubbleFraction(), 0);
+  EXPECT_LE(timings.bubbleFraction(), 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Schedules,
+    PipelineTestMicroBatches,
+    ::testing::Values(
+        MicroBatchSchedule::GPipe,
+        MicroBatchSchedule::OneForwardOneBackward));
+
+TEST(PipelineTimingsTest, BubbleFraction) {
+  EXPECT_DOUBLE_EQ(PipelineTimings::idealBubbleFraction(1, 8), 0);
+  EXPECT_DOUBLE_EQ(PipelineTimings::idealBubbleFraction(4, 1), 0.75);
+  EXPECT_DOUBLE_EQ(PipelineTimings::idealBubbleFraction(4, 13), 0.1875);
+
+  PipelineTimings timings;
+  EXPECT_DOUBLE_EQ(timings.bubbleFraction(), 0);
+  timings.wall_ms = 10;
+  timings.intervals.push_back({nullptr, 0, 1, 4});
+  timings.intervals.push_back({nullptr, 1, 5, 9});
+  EXPECT_DOUBLE_EQ(timings.bubbleFraction(), 0.3);
+}
+
+// Lowers the communications of a pipeline on CPU buffers, without running its
+// stages
+class PipelineCommunicationTest : public MultiDeviceTest {
+ protected:
+  bool usesGpus() const override {
+    return false;
+  }
+
+  // Builds a Pipeline scattering a tensor from device 0 to all the devices
+  // and returns its communication
+  PipelineCommunication* makeScatter() {
+    const auto num_devices = communicator->size();
+    FusionGuard fg(&fusion);
+    TensorView* tv0 = makeContigTensor(2);
+    fusion.addInput(tv0);
+    TensorView* tv1 = set(tv0);
+    TensorView* tv2 = set(tv1);
+    TensorView* tv3 = set(tv2);
+    fusion.addOutput(tv3);
+    tv2->axis(0)->parallelize(ParallelType::DIDx);
+    tv3->axis(0)->parallelize(ParallelType::DIDx);
+
+    std::vector<DeviceIdxType> all_devices(num_devices);
+    std::iota(all_devices.begin(), all_devices.end(), 0);
+    PipelineStageDescriptor stage0(false), stage1(false);
+    stage0.addVal({tv0, tv1});
+    stage1.addVal({tv2, tv3});
+    stage0.mesh = {0};
+    stage1.mesh = DeviceMesh(all_devices);
+    PipelineDescriptor descriptor{
+        .stage_descriptors{std::move(stage0), std::move(stage1)}};
+    pipeline = std::make_unique<Pipeline>(&fusion, std::move(descriptor));
+
+    auto exprs = pipeline->exprs();
+    auto it = std::find_if(exprs.begin(), exprs.end(), [](Expr* expr) {
+      return expr->isA<PipelineCommunication>();
+    });
+    NVF_ERROR(it != exprs.end());
+    return (*it)->as<PipelineCommunication>();
+  }
+
+  Fusion fusion;
+  std::unique_ptr<Pipeline> pipeline;
+};
+
+TEST_F(PipelineCommunicationTest, ScatterWithBufferPool) {
+  constexpr auto backend = CommunicatorBackend::gloo;
+  if (!communicator->isBackendAvailable(backend)) {
+    GTEST_SKIP() << "Backend not available";
+  }
+  const auto num_devices = communicator->size();
+  const DeviceIdxType device_id = communicator->deviceId();
+  auto c = makeScatter();
+
+  CommunicationBufferPool pool;
+  for (auto iteration : c10::irange(3)) {
+    auto input = at::arange(num_devices * 8, tensor_options)
+                     .view({(int64_t)num_devices, 8}) +
+        iteration;
+    auto output = allocateCommunicationOutput(device_id, c, input, pool);
+    for (auto& communication :
+         lowerCommunication(device_id, c, input, output, &pool)) {
+      auto work = communication->post(*communicator, backend);
+      if (work) {
+        work->wait();
+      }
+    }
+    EXPECT_TRUE(output.index({0}).equal(input.index({device_id})));
+
+    // Every device receives its slice in its own buffer. They are only
+    // allocated by the first iteration.
+    EXPECT_EQ(
+        pool.bytesAllocated(), (int64_t)(num_devices * 8 * sizeof(float)));
+    EXPECT_EQ(pool.bytesReserved(), pool.bytesAllocated());
+    pool.releaseAll();
+  }
+}
+
+TEST_F(PipelineCommunicationTest, WaitForInFlightBuffer) {
+  constexpr auto backend = CommunicatorBackend::gloo;
+  if (!communicator->isBackendAvailable(backend)) {
+    GTEST_SKIP() << "Backend not available";
+  }
+  const auto num_devices = communicator->size();
+  const DeviceIdxType device_id = communicator->deviceId();
+  auto c = makeScatter();
+
+  auto input = at::arange(num_devices * 8, tensor_options)
+                   .view({(int64_t)num_devices, 8});
+  CommunicationBufferPool pool;
+  auto output = allocateCommunicationOutput(device_id, c, input, pool);
+
+  // The root posts late, so that the buffers of the other devices are still
+  // in flight when they are consumed
+  if (device_id == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  PendingWorks pending_works;
+  for (auto& communication :
+       lowerCommunication(device_id, c, input, output, &pool)) {
+    auto work = communication->post(*communicator, backend);
+    if (work) {
+      pending_works.add({c->in(), c->out()}, work);
+    }
+  }
+  if (device_id != 0) {
+    EXPECT_TRUE(pending_works.isPending(c->out()));
+  }
+
+  // A consumer of the output waits for the communication before reading it
+  pending_works.waitFor(c->out());
+  EXPECT_FALSE(pending_works.isPending(c->out()));
+  EXPECT_TRUE(output.index({0}).equal(input.index({device_id})));
+
+  // The work is still registered under the input, but only released once
+  EXPECT_LE(pending_works.release().size(), 1);
+  EXPECT_FALSE(pending_works.isPending(c->in()));
+}
+
+namespace {
+
+// Builds a Pipeline made of two independent branches. In each of them, a
+// stage on device 0 computes a tensor that is sent to a stage on device 1.
+std::unique_ptr<Pipeline> makeTwoBranchPipeline(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sum(tv0, {0});
+  TensorView* tv2 = set(tv1);
+  TensorView* tv3 = sum(tv2, {0});
+  fusion->addOutput(tv3);
+
+  TensorView* tv4 = makeContigTensor(2);
+  fusion->addInput(tv4);
+  TensorView* tv5 = sum(tv4, {0});
+  TensorView* tv6 = set(tv5);
+  TensorView* tv7 = sum(tv6, {0});
+  fusion->addOutput(tv7);
+
+  PipelineStageDescriptor stage0, stage1, stage2, stage3;
+  stage0.addVal({tv0, tv1});
+  stage1.addVal({tv2, tv3});
+  stage2.addVal({tv4, tv5});
+  stage3.addVal({tv6, tv7});
+  stage0.mesh = {0};
+  stage1.mesh = {1};
+  stage2.mesh = {0};
+  stage3.mesh = {1};
+  PipelineDescriptor descriptor{.stage_descriptors{
+      std::move(stage0),
+      std::move(stage1),
+      std::move(stage2),
+      std::move(stage3)}};
+  return std::make_unique<Pipeline>(fusion, std::move(descriptor));
+}
+
+// Names each expr of a schedule after the index of the descriptor of its
+// stage. A communication is named after the stage producing its input.
+std::vector<std::string> describeSchedule(
+    Pipeline* pipeline,
+    const std::vector<Expr*>& order) {
+  const auto& descriptors = pipeline->descriptor().stage_descriptors;
+  auto stage_index = [&descriptors](PipelineStage* stage) {
+    return std::to_string(stage->descriptor() - descriptors.data());
+  };
+  std::vector<std::string> names;
+  for (auto expr : order) {
+    if (auto c = dynamic_cast<PipelineCommunication*>(expr)) {
+      names.push_back(
+          "communication from stage " +
+          stage_index(c->in()->as<PipelineVal>()->getStage()));
+    } else {
+      names.push_back("stage " + stage_index(expr->as<PipelineStage>()));
+    }
+  }
+  return names;
+}
+
+} // namespace
+
+// Doesn't need any device since the schedule only depends on the Pipeline
+TEST(PipelineScheduleTest, CommunicationsOverlapIndependentStages) {
+  Fusion fusion;
+  auto pipeline = makeTwoBranchPipeline(&fusion);
+  auto order = PipelineExecutor::schedule(pipeline.get());
+  auto names = describeSchedule(pipeline.get(), order);
+  ASSERT_EQ(names.size(), 6) << toDelimitedString(names);
+
+  // Each expr runs once all its inputs are computed
+  std::unordered_set<Val*> computed(
+      pipeline->inputs().begin(), pipeline->inputs().end());
+  for (auto expr : order) {
+    for (auto input : expr->inputs()) {
+      EXPECT_TRUE(computed.count(input)) << toDelimitedString(names);
+    }
+    computed.insert(expr->outputs().begin(), expr->outputs().end());
+  }
+
+  // Each communication is posted right after the stage computing its input
+  EXPECT_EQ(names.front().rfind("communication from ", 0), std::string::npos);
+  for (auto i : c10::irange(1, names.size())) {
+    if (names[i].rfind("communication from ", 0) == 0) {
+      EXPECT_EQ("communication from " + names[i - 1], names[i])
+          << toDelimitedString(names);
+    }
+  }
+
+  // The stages on device 1 consume the communicated tensors, so they run
+  // after the stages on device 0, which don't wait for anything
+  std::vector<std::string> last_stages(names.end() - 2, names.end());
+  std::sort(last_stages.begin(), last_stages.end());
+  EXPECT_EQ(last_stages, std::vector<std::string>({"stage 1", "stage 3"}))
+      << toDelimitedString(names);
+
+  // Another rank building the same Pipeline gets the same order
+  Fusion other_fusion;
+  auto other_pipeline = makeTwoBranchPipeline(&other_fusion);
+  EXPECT_EQ(
+      describeSchedule(
+          other_pipeline.get(),
+          PipelineExecutor::schedule(other_pipeline.get())),
+      names);
+}
+
 auto all_backends =
     ::testing::Values(CommunicatorBackend::nccl, CommunicatorBackend::ucc);
 
@@ -0,0 +1,98 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Compiles every fusion of a serialized FusionCache for the inputs of the
+// kernel runtimes it had, without running any kernel, and reports the compile
+// time of each fusion. Fusion definitions written in Python are compiled with
+// tools/batch_compile.py instead.
+//
+// Usage: nvfuser_batch_compile <serde_file> [--output_dir=<dir>]
+//            [--workers=<n>] [--device=<index>] [--serialize=<file>]
+
+#include <python_frontend/batch_compile.h>
+#include <python_frontend/fusion_cache.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+
+using namespace nvfuser;
+using namespace nvfuser::python_frontend;
+
+namespace {
+
+void printUsage(const char* name) {
+  std::cerr << "Usage: " << name << " <serde_file> [--output_dir=<dir>]"
+            << " [--workers=<n>] [--device=<index>] [--serialize=<file>]\n"
+            << "  --output_dir  write the CUDA source and PTX or cubin of "
+            << "every kernel\n"
+            << "  --workers     number of fusions compiled concurrently, one "
+            << "per hardware thread by default\n"
+            << "  --device      CUDA device to compile for\n"
+            << "  --serialize   save the compiled FusionCache to a file\n"
+            << "Set NVFUSER_ENABLE=kernel_db to persist the kernels in the "
+            << "kernel database.\n";
+}
+
+// Returns the value of --<name>=<value> if arg is that option
+std::optional<std::string> optionValue(
+    const std::string& arg,
+    const std::string& name) {
+  const std::string prefix = "--" + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) {
+    return std::nullopt;
+  }
+  return arg.substr(prefix.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string serde_file;
+  std::string serialize_file;
+  BatchCompileOptions options;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (auto value = optionValue(arg, "output_dir")) {
+      options.output_dir = *value;
+    } else if (auto value = optionValue(arg, "workers")) {
+      options.num_workers = std::stoll(*value);
+    } else if (auto value = optionValue(arg, "device")) {
+      options.device = (int8_t)std::stoi(*value);
+    } else if (auto value = optionValue(arg, "serialize")) {
+      serialize_file = *value;
+    } else if (arg.rfind("--", 0) != 0 && serde_file.empty()) {
+      serde_file = arg;
+    } else {
+      printUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (serde_file.empty()) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  auto fusion_cache = FusionCache::get(
+      /*max_fusions=*/8192, /*load_from_default_workspace=*/false);
+  const auto jobs = loadBatchCompileJobs(serde_file);
+  const auto results = batchCompile(jobs, options);
+  printBatchCompileReport(std::cout, results);
+
+  if (!serialize_file.empty()) {
+    fusion_cache->serialize(serialize_file);
+  }
+
+  for (const auto& result : results) {
+    if (result.error.has_value()) {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
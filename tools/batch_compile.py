@@ -0,0 +1,122 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# "batch_compile.py -h" for help.
+
+import argparse
+import os
+import traceback
+
+import nvfuser
+from nvfuser import FusionDefinition
+
+
+def record_jobs(definition_dir):
+    """
+    Runs every Python file of definition_dir, such as the reproducers printed
+    when a FusionDefinition fails, with FusionDefinition.execute replaced so
+    that nothing is compiled or run. Returns the inputs each fusion was
+    executed with, and the files that failed.
+    """
+    jobs = {}
+    failures = {}
+
+    def record_execute(self, inputs, **kwargs):
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+        jobs.setdefault(self.id(), []).append(list(inputs))
+        return []
+
+    execute = FusionDefinition.execute
+    FusionDefinition.execute = record_execute
+    try:
+        for name in sorted(os.listdir(definition_dir)):
+            if not name.endswith(".py"):
+                continue
+            path = os.path.join(definition_dir, name)
+            try:
+                with open(path) as f:
+                    code = compile(f.read(), path, "exec")
+                exec(code, {"__name__": "__main__", "__file__": path})
+            except Exception:
+                failures[path] = traceback.format_exc()
+    finally:
+        FusionDefinition.execute = execute
+    return list(jobs.items()), failures
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compile a directory of Python fusion definitions without "
+        "running them. Segmentation, scheduling, lowering and code generation "
+        "run for one fusion per worker thread, and the compile time of each "
+        "fusion is reported. Set NVFUSER_ENABLE=kernel_db to persist the "
+        "kernels in the kernel database. Serialized fusion caches are "
+        "compiled by the nvfuser_batch_compile executable."
+    )
+    parser.add_argument(
+        "definition_dir",
+        help="directory of Python files that define and execute fusions",
+    )
+    parser.add_argument(
+        "--output_dir",
+        default="",
+        help="write the CUDA source and PTX or cubin of every kernel here",
+    )
+    parser.add_argument(
+        "--workers",
+        type=int,
+        default=0,
+        help="fusions compiled concurrently, one per hardware thread by default",
+    )
+    parser.add_argument(
+        "--device", type=int, default=None, help="CUDA device to compile for"
+    )
+    parser.add_argument(
+        "--serialize",
+        action="store_true",
+        help="save the compiled fusions to the nvFuser serde cache",
+    )
+    args = parser.parse_args()
+
+    jobs, failures = record_jobs(args.definition_dir)
+    results = nvfuser.batch_compile(
+        jobs,
+        num_workers=args.workers,
+        device=args.device,
+        output_dir=args.output_dir,
+    )
+    if args.serialize:
+        nvfuser.serialize()
+
+    results.sort(key=lambda result: result["compile_time_ms"], reverse=True)
+    total_ms = sum(result["compile_time_ms"] for result in results)
+    num_kernels = sum(result["num_kernels"] for result in results)
+    num_failed = sum(result["error"] is not None for result in results)
+    print(
+        f"Compiled {num_kernels} kernels of {len(results)} fusions in "
+        f"{total_ms:.3f} ms of compile time, {num_failed} failed"
+    )
+    print(f"{'Fusion':>10}{'Runtimes':>12}{'Kernels':>10}{'Time (ms)':>14}  Status")
+    for result in results:
+        status = "ok" if result["error"] is None else "FAILED"
+        print(
+            f"{result['fusion_id']:>10}{result['num_compiled']:>12}"
+            f"{result['num_kernels']:>10}{result['compile_time_ms']:>14.3f}"
+            f"  {status}"
+        )
+    for result in results:
+        if result["error"] is not None:
+            print(f"\nFusion {result['fusion_id']} failed: {result['error']}")
+    for path, error in failures.items():
+        print(f"\nDefinition {path} failed:\n{error}")
+
+    if num_failed > 0 or failures:
+        raise SystemExit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,38 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# "warmup_fusion_cache.py -h" for help.
+
+import argparse
+
+import nvfuser
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compile the kernels recorded in a warmup trace ahead of "
+        "time and save them to the nvFuser serde cache, so that the next "
+        "process using the cache starts warm. The trace is recorded by "
+        "running a workload with NVFUSER_WARMUP_TRACE=<trace_file>, and that "
+        "workload must have saved its fusions with nvfuser.serialize(), e.g. "
+        "via atexit.register(nvfuser.serialize)."
+    )
+    parser.add_argument("trace_file", help="warmup trace to replay")
+    parser.add_argument(
+        "--device", type=int, default=None, help="CUDA device to compile for"
+    )
+    args = parser.parse_args()
+
+    # Loads the fusions saved in the default workspace
+    fusion_cache = nvfuser.FusionCache.get()
+    num_compiled = nvfuser.warmup(args.trace_file, device=args.device)
+    nvfuser.serialize()
+    print(
+        f"Compiled {num_compiled} kernel runtimes for "
+        f"{fusion_cache.num_fusions()} cached fusions"
+    )
+
+
+if __name__ == "__main__":
+    main()